@@ -18,11 +18,13 @@
 #include <MicroOcpp/Model/Boot/BootService.h>
 #include <MicroOcpp/Model/Reset/ResetService.h>
 #include <MicroOcpp/Model/Variables/VariableService.h>
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
 #include <MicroOcpp/Model/Transactions/TransactionService.h>
 #include <MicroOcpp/Model/Certificates/CertificateService.h>
 #include <MicroOcpp/Model/Certificates/CertificateMbedTLS.h>
 #include <MicroOcpp/Model/Availability/AvailabilityService.h>
 #include <MicroOcpp/Model/RemoteControl/RemoteControlService.h>
+#include <MicroOcpp/Core/Configuration.h>
 #include <MicroOcpp/Core/Request.h>
 #include <MicroOcpp/Core/OperationRegistry.h>
 #include <MicroOcpp/Core/FilesystemAdapter.h>
@@ -52,6 +54,10 @@ std::shared_ptr<FilesystemAdapter> filesystem;
 #define MO_NUMCONNECTORS 2
 #endif
 
+//RequestQueue registers the default queue, the PreBoot queue and one Connector and one MeteringConnector per connector
+static_assert(MO_NUM_REQUEST_QUEUES >= 2 + 2 * MO_NUMCONNECTORS + (MO_ENABLE_V201 ? 1 : 0),
+        "MO_NUM_REQUEST_QUEUES too small for MO_NUMCONNECTORS");
+
 #define OCPP_ID_OF_CP 0
 #define OCPP_ID_OF_CONNECTOR 1
 
@@ -289,6 +295,8 @@ void mocpp_initialize(Connection& connection, const char *bootNotificationCreden
             new AvailabilityService(*context, MO_NUM_EVSEID)));
         model.setVariableService(std::unique_ptr<VariableService>(
             new VariableService(*context, filesystem)));
+        model.setMonitoringService(std::unique_ptr<MonitoringService>(
+            new MonitoringService(*context, *model.getVariableService())));
         model.setTransactionService(std::unique_ptr<TransactionService>(
             new TransactionService(*context, filesystem, MO_NUM_EVSEID)));
         model.setRemoteControlService(std::unique_ptr<RemoteControlService>(
@@ -315,7 +323,7 @@ void mocpp_initialize(Connection& connection, const char *bootNotificationCreden
 
 #if MO_ENABLE_RESERVATION
         model.setReservationService(std::unique_ptr<ReservationService>(
-            new ReservationService(*context, MO_NUMCONNECTORS)));
+            new ReservationService(*context, MO_NUMCONNECTORS, filesystem)));
 #endif
 
         model.setResetService(std::unique_ptr<ResetService>(
@@ -377,6 +385,8 @@ void mocpp_initialize(Connection& connection, const char *bootNotificationCreden
 #endif //MO_ENABLE_V201
 
     MO_DBG_INFO("initialized MicroOcpp v" MO_VERSION " running OCPP %i.%i.%i", version.major, version.minor, version.patch);
+
+    MO_MEM_SEAL(); //static-memory mode: serve all further allocations from the pool
 }
 
 void mocpp_deinitialize() {
@@ -406,6 +416,8 @@ void mocpp_deinitialize() {
 
     configuration_deinit();
 
+    MO_MEM_UNSEAL();
+
 #if !MO_HEAP_PROFILER_EXTERNAL_CONTROL
     MO_MEM_DEINIT();
 #endif
@@ -1097,6 +1109,44 @@ void addMeterValueInput(std::unique_ptr<SampledValueSampler> valueInput, unsigne
     model.getMeteringService()->addMeterValueSampler(connectorId, std::move(valueInput));
 }
 
+#if MO_ENABLE_METER_AGGREGATION
+MeterSampleRing *addMeterValueAggregatedInput(MeterAggregation aggregation, const char *measurand, const char *unit, const char *location, const char *phase, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return nullptr;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return nullptr;
+    }
+    #endif
+
+    if (!measurand) {
+        measurand = "Energy.Active.Import.Register";
+        MO_DBG_WARN("measurand unspecified; assume %s", measurand);
+    }
+
+    SampledValueProperties properties;
+    properties.setMeasurand(measurand); //mandatory for MO
+
+    if (unit)
+        properties.setUnit(unit);
+    if (location)
+        properties.setLocation(location);
+    if (phase)
+        properties.setPhase(phase);
+
+    auto& model = context->getModel();
+    if (!model.getMeteringService()) {
+        model.setMeteringSerivce(std::unique_ptr<MeteringService>(
+            new MeteringService(*context, MO_NUMCONNECTORS, filesystem)));
+    }
+    return model.getMeteringService()->addMeterSampleAggregator(connectorId, std::unique_ptr<MeterSampleAggregator>(
+            new MeterSampleAggregator(properties, aggregation)));
+}
+#endif //MO_ENABLE_METER_AGGREGATION
+
 void setOccupiedInput(std::function<bool()> occupied, unsigned int connectorId) {
     if (!context) {
         MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
@@ -1146,6 +1196,143 @@ void setStopTxReadyInput(std::function<bool()> stopTxReady, unsigned int connect
     connector->setStopTxReadyInput(stopTxReady);
 }
 
+void notifyPlugged(bool plugged, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyPlugged(plugged);
+}
+
+void notifyEvReady(bool evReady, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyEvReady(evReady);
+}
+
+void notifyEvseReady(bool evseReady, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyEvseReady(evseReady);
+}
+
+void notifyOccupied(bool occupied, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyOccupied(occupied);
+}
+
+void notifyStartTxReady(bool startTxReady, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyStartTxReady(startTxReady);
+}
+
+void notifyStopTxReady(bool stopTxReady, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyStopTxReady(stopTxReady);
+}
+
+void notifyErrorCode(const char *errorCode, unsigned int connectorId) {
+    notifyErrorData(ErrorData(errorCode), connectorId);
+}
+
+void notifyErrorData(MicroOcpp::ErrorData errorData, unsigned int connectorId) {
+    if (!context) {
+        MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
+        return;
+    }
+    #if MO_ENABLE_V201
+    if (context->getVersion().major == 2) {
+        MO_DBG_ERR("only supported in v16");
+        return;
+    }
+    #endif
+    auto connector = context->getModel().getConnector(connectorId);
+    if (!connector) {
+        MO_DBG_ERR("could not find connector");
+        return;
+    }
+    connector->notifyErrorData(errorData);
+}
+
 void setTxNotificationOutput(std::function<void(MicroOcpp::Transaction*,TxNotification)> notificationOutput, unsigned int connectorId) {
     if (!context) {
         MO_DBG_ERR("OCPP uninitialized"); //need to call mocpp_initialize before
@@ -15,6 +15,7 @@
 #include <MicroOcpp/Core/Connection.h>
 #include <MicroOcpp/Core/Memory.h>
 #include <MicroOcpp/Model/Metering/SampledValue.h>
+#include <MicroOcpp/Model/Metering/MeterSampleAggregator.h>
 #include <MicroOcpp/Model/Transactions/Transaction.h>
 #include <MicroOcpp/Model/ConnectorBase/ChargePointErrorData.h>
 #include <MicroOcpp/Model/ConnectorBase/ChargePointStatus.h>
@@ -119,7 +120,8 @@ void mocpp_initialize(
 void mocpp_deinitialize();
 
 /*
- * To be called in the main loop (e.g. place it inside loop())
+ * To be called in the main loop (e.g. place it inside loop()). To limit the time per call, set a loop budget with
+ * mocpp_set_loop_budget() (see MicroOcpp/Core/LoopBudget.h)
  */
 void mocpp_loop();
 
@@ -325,12 +327,41 @@ void addMeterValueInput(std::function<float ()> valueInput, const char *measuran
 
 void addMeterValueInput(std::unique_ptr<MicroOcpp::SampledValueSampler> valueInput, unsigned int connectorId = 1); //integrate further metering Inputs (more extensive alternative)
 
+#if MO_ENABLE_METER_AGGREGATION
+/*
+ * High-rate metering Input (OCPP 1.6 only). Returns a sample ring for the measurand. The firmware pushes raw
+ * samples into it, e.g. `ring->push(power)` at 10 - 100 Hz from a separate sampling thread or ISR (single
+ * producer). MO reports the aggregate (see MeterAggregation) of each MeterValueSampleInterval and
+ * ClockAlignedDataInterval. The ring is valid until mocpp_deinitialize(). Returns nullptr on failure
+ */
+MicroOcpp::MeterSampleRing *addMeterValueAggregatedInput(MeterAggregation aggregation, const char *measurand, const char *unit = nullptr, const char *location = nullptr, const char *phase = nullptr, unsigned int connectorId = 1);
+#endif //MO_ENABLE_METER_AGGREGATION
+
 void setOccupiedInput(std::function<bool()> occupied, unsigned int connectorId = 1); //Input if instead of Available, send StatusNotification Preparing / Finishing
 
 void setStartTxReadyInput(std::function<bool()> startTxReady, unsigned int connectorId = 1); //Input if the charger is ready for StartTransaction
 
 void setStopTxReadyInput(std::function<bool()> stopTxReady, unsigned int connectorId = 1); //Input if charger is ready for StopTransaction
 
+/*
+ * Push-based alternative to the Inputs above (OCPP 1.6 only). Instead of defining an Input callback which
+ * MO polls on each loop, the firmware notifies MO about state changes, e.g. from the control pilot state
+ * machine. MO keeps the last notified value. Once a value has been notified, the corresponding Input
+ * callback is ignored until it is set again.
+ *
+ * Like the rest of the API, these functions are not thread-safe and must be called from the same thread as
+ * mocpp_loop(). They are not ISR-safe: to forward an interrupt, set a volatile flag in the ISR and call the
+ * notify function from the loop thread.
+ */
+void notifyPlugged(bool plugged, unsigned int connectorId = 1); //EV plugged to this EVSE
+void notifyEvReady(bool evReady, unsigned int connectorId = 1); //EV is ready to charge
+void notifyEvseReady(bool evseReady, unsigned int connectorId = 1); //EVSE allows charge
+void notifyOccupied(bool occupied, unsigned int connectorId = 1); //instead of Available, send StatusNotification Preparing / Finishing
+void notifyStartTxReady(bool startTxReady, unsigned int connectorId = 1); //charger is ready for StartTransaction
+void notifyStopTxReady(bool stopTxReady, unsigned int connectorId = 1); //charger is ready for StopTransaction
+void notifyErrorCode(const char *errorCode, unsigned int connectorId = 1); //set error code or clear with nullptr. The string must stay valid until cleared
+void notifyErrorData(MicroOcpp::ErrorData errorData, unsigned int connectorId = 1); //set error or clear with errorData.isError == false
+
 void setTxNotificationOutput(std::function<void(MicroOcpp::Transaction*,TxNotification)> notificationOutput, unsigned int connectorId = 1); //called when transaction state changes (see TxNotification for possible events). Transaction can be null
 
 #if MO_ENABLE_V201
@@ -4,20 +4,29 @@
 
 #include <MicroOcpp/Core/ConfigurationContainerFlash.h>
 
-#include <algorithm>
 #include <MicroOcpp/Core/FilesystemUtils.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Core/Metrics.h>
 #include <MicroOcpp/Debug.h>
 
 #define MAX_CONFIGURATIONS 50
 
+#define MO_CONFIG_LOG_RECORD_MAXSIZE 256 //longer records are not appended to the log but trigger compaction
+
 namespace MicroOcpp {
 
 class ConfigurationContainerFlash : public ConfigurationContainer, public MemoryManaged {
 private:
     Vector<std::shared_ptr<Configuration>> configurations;
+    Vector<revision_t> storedRevisions; //value revision of each config when it was last persisted, in the order of configurations
     std::shared_ptr<FilesystemAdapter> filesystem;
-    uint16_t revisionSum = 0;
+
+    bool compactionPending = false; //configs file needs a full rewrite, e.g. after removing a config
+
+#if MO_ENABLE_CONFIG_LOG
+    unsigned int logGeneration = 0; //a log only applies to the configs file with the same generation
+    size_t logSize = 0; //0: the next append truncates the log and starts with the gen record
+#endif
 
     bool loaded = false;
 
@@ -36,19 +45,350 @@ private:
         }
     }
 
-    bool configurationsUpdated() {
-        auto revisionSum_old = revisionSum;
+    bool isDirty(size_t i) {
+        return configurations[i]->getValueRevision() != storedRevisions[i];
+    }
 
-        revisionSum = 0;
-        for (auto& config : configurations) {
-            revisionSum += config->getValueRevision();
+    void markStored() {
+        for (size_t i = 0; i < configurations.size(); i++) {
+            storedRevisions[i] = configurations[i]->getValueRevision();
+        }
+    }
+
+    void eraseConfiguration(size_t i) {
+        configurations.erase(configurations.begin() + i);
+        storedRevisions.erase(storedRevisions.begin() + i);
+        compactionPending = true;
+    }
+
+    static bool serializeEntry(Configuration& config, JsonObject stored) {
+        stored["type"] = serializeTConfig(config.getType());
+        stored["key"] = config.getKey();
+
+        switch (config.getType()) {
+            case TConfig::Int:
+                return stored["value"].set(config.getInt());
+            case TConfig::Bool:
+                return stored["value"].set(config.getBool());
+            case TConfig::String:
+                return stored["value"].set(config.getString());
+        }
+        return false;
+    }
+
+    //apply a stored entry of the configs file or the log. Returns false only on OOM of the key
+    bool loadEntry(JsonObject stored) {
+        TConfig type;
+        if (!deserializeTConfig(stored["type"] | "_Undefined", type)) {
+            MO_DBG_ERR("corrupt config");
+            return true;
+        }
+
+        const char *key = stored["key"] | "";
+        if (!*key) {
+            MO_DBG_ERR("corrupt config");
+            return true;
+        }
+
+        if (!stored.containsKey("value")) {
+            MO_DBG_ERR("corrupt config");
+            return true;
+        }
+
+        char *key_pooled = nullptr;
+
+        auto config = getConfiguration(key).get();
+        if (config && config->getType() != type) {
+            MO_DBG_ERR("conflicting type for %s - remove old config", key);
+            remove(config);
+            config = nullptr;
+        }
+        if (!config) {
+            #if MO_ENABLE_HEAP_PROFILER
+            char memoryTag [64];
+            snprintf(memoryTag, sizeof(memoryTag), "%s%s", "v16.Configuration.", key);
+            #else
+            const char *memoryTag = nullptr;
+            (void)memoryTag;
+            #endif
+            key_pooled = static_cast<char*>(MO_MALLOC(memoryTag, strlen(key) + 1));
+            if (!key_pooled) {
+                MO_DBG_ERR("OOM: %s", key);
+                return false;
+            }
+            strcpy(key_pooled, key);
+        }
+
+        switch (type) {
+            case TConfig::Int: {
+                if (!stored["value"].is<int>()) {
+                    MO_DBG_ERR("corrupt config");
+                    MO_FREE(key_pooled);
+                    return true;
+                }
+                int value = stored["value"] | 0;
+                if (!config) {
+                    //create new config
+                    config = createConfiguration(TConfig::Int, key_pooled).get();
+                }
+                if (config) {
+                    config->setInt(value);
+                }
+                break;
+            }
+            case TConfig::Bool: {
+                if (!stored["value"].is<bool>()) {
+                    MO_DBG_ERR("corrupt config");
+                    MO_FREE(key_pooled);
+                    return true;
+                }
+                bool value = stored["value"] | false;
+                if (!config) {
+                    //create new config
+                    config = createConfiguration(TConfig::Bool, key_pooled).get();
+                }
+                if (config) {
+                    config->setBool(value);
+                }
+                break;
+            }
+            case TConfig::String: {
+                if (!stored["value"].is<const char*>()) {
+                    MO_DBG_ERR("corrupt config");
+                    MO_FREE(key_pooled);
+                    return true;
+                }
+                const char *value = stored["value"] | "";
+                if (!config) {
+                    //create new config
+                    config = createConfiguration(TConfig::String, key_pooled).get();
+                }
+                if (config) {
+                    config->setString(value);
+                }
+                break;
+            }
+        }
+
+        if (config) {
+            //success
+
+            if (key_pooled) {
+                //allocated key, need to store
+                keyPool.push_back(std::move(key_pooled));
+            }
+        } else {
+            MO_DBG_ERR("OOM: %s", key);
+            MO_FREE(key_pooled);
+        }
+        return true;
+    }
+
+#if MO_ENABLE_CONFIG_LOG
+    bool printLogFn(char *fn, size_t size) {
+        auto ret = snprintf(fn, size, "%s" MO_CONFIG_LOG_SUFFIX, getFilename());
+        if (ret < 0 || (size_t)ret >= size) {
+            MO_DBG_ERR("fn error: %i", ret);
+            return false;
+        }
+        return true;
+    }
+
+    void removeLog() {
+        char fn [MO_MAX_PATH_SIZE];
+        size_t size;
+        if (printLogFn(fn, sizeof(fn)) && filesystem->stat(fn, &size) == 0 && !filesystem->remove(fn)) {
+            //the stale log is overwritten by the next append
+            MO_DBG_ERR("could not remove %s", fn);
+        }
+        logSize = 0;
+    }
+
+    //apply the records of the log on top of the loaded configs file. Returns false if the log is corrupt
+    bool replayLog() {
+        char fn [MO_MAX_PATH_SIZE];
+        if (!printLogFn(fn, sizeof(fn))) {
+            return false;
+        }
+
+        logSize = 0;
+
+        size_t size;
+        if (filesystem->stat(fn, &size) != 0) {
+            return true; //no changes since last compaction
+        }
+
+        auto file = filesystem->open(fn, "r");
+        if (!file) {
+            MO_DBG_ERR("could not open %s", fn);
+            return false;
+        }
+
+        ArduinoJsonFileAdapter fileReader {file.get()};
+        auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(3) + MO_CONFIG_LOG_RECORD_MAXSIZE);
+
+        //first record: generation of the configs file which this log extends
+        auto err = deserializeJson(record, fileReader);
+        if (err || (record["gen"] | -1) != (int)logGeneration) {
+            MO_DBG_DEBUG("drop outdated log %s", fn);
+            file.reset();
+            filesystem->remove(fn);
+            return true;
         }
 
-        return revisionSum != revisionSum_old;
+        while (true) {
+            record.clear();
+            err = deserializeJson(record, fileReader);
+            if (err == DeserializationError::EmptyInput) {
+                break;
+            } else if (err) {
+                //e.g. power loss during the last append
+                MO_DBG_ERR("config log corrupt: %s", err.c_str());
+                return false;
+            }
+
+            if (!loadEntry(record.as<JsonObject>())) {
+                return false;
+            }
+        }
+
+        logSize = size;
+        return true;
+    }
+
+    //append the changed configs to the log. Returns false if the configs file must be rewritten instead
+    bool appendLog() {
+
+        size_t appendSize = logSize == 0 ? measureGenRecord() : 0;
+        for (size_t i = 0; i < configurations.size(); i++) {
+            if (!isDirty(i)) {
+                continue;
+            }
+            auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(3));
+            if (!serializeEntry(*configurations[i], record.to<JsonObject>()) || record.overflowed()) {
+                return false;
+            }
+            size_t recordSize = measureJson(record) + 1;
+            if (recordSize > MO_CONFIG_LOG_RECORD_MAXSIZE) {
+                return false;
+            }
+            appendSize += recordSize;
+        }
+
+        if (logSize + appendSize > MO_CONFIG_LOG_MAXSIZE) {
+            MO_DBG_DEBUG("compact %s", getFilename());
+            return false;
+        }
+
+        char fn [MO_MAX_PATH_SIZE];
+        if (!printLogFn(fn, sizeof(fn))) {
+            return false;
+        }
+
+        auto file = filesystem->open(fn, logSize == 0 ? "w" : "a");
+        if (!file) {
+            MO_DBG_ERR("could not open %s", fn);
+            return false;
+        }
+
+        ArduinoJsonFileAdapter fileWriter {file.get()};
+        size_t written = 0;
+
+        if (logSize == 0) {
+            auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(1));
+            record["gen"] = logGeneration;
+            written += serializeJson(record, fileWriter);
+            written += file->write("\n", 1);
+        }
+
+        for (size_t i = 0; i < configurations.size(); i++) {
+            if (!isDirty(i)) {
+                continue;
+            }
+            auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(3));
+            serializeEntry(*configurations[i], record.to<JsonObject>());
+            written += serializeJson(record, fileWriter);
+            written += file->write("\n", 1);
+        }
+
+        bool closed = file->close();
+        file.reset();
+
+        MO_METRICS_COUNT(MO_METRICS_FS_BYTES_WRITTEN, written);
+
+        if (written != appendSize || !closed) {
+            MO_DBG_ERR("FS error: %s", fn);
+            //the log may end with a partial record now. Rewrite configs file
+            return false;
+        }
+
+        logSize += written;
+        markStored();
+        return true;
+    }
+
+    size_t measureGenRecord() {
+        auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(1));
+        record["gen"] = logGeneration;
+        return measureJson(record) + 1;
+    }
+#endif //MO_ENABLE_CONFIG_LOG
+
+    //rewrite the whole configs file
+    bool compact() {
+
+        size_t jsonCapacity = 2 * JSON_OBJECT_SIZE(3); //head + configurations + head payload
+        jsonCapacity += JSON_ARRAY_SIZE(configurations.size()); //configurations array
+        jsonCapacity += configurations.size() * JSON_OBJECT_SIZE(3); //config entries in array
+
+        if (jsonCapacity > MO_MAX_JSON_CAPACITY) {
+            MO_DBG_ERR("configs JSON exceeds maximum capacity (%s, %zu entries). Crop configs file (by FCFS)", getFilename(), configurations.size());
+            jsonCapacity = MO_MAX_JSON_CAPACITY;
+        }
+
+        auto doc = initJsonDoc(getMemoryTag(), jsonCapacity);
+        JsonObject head = doc.createNestedObject("head");
+        head["content-type"] = "ocpp_config_file";
+        head["version"] = "2.0";
+#if MO_ENABLE_CONFIG_LOG
+        //invalidates the current log, even if removing it fails below
+        head["logGen"] = logGeneration + 1;
+#endif
+
+        JsonArray configurationsArray = doc.createNestedArray("configurations");
+
+        size_t trackCapacity = 0;
+
+        for (size_t i = 0; i < configurations.size(); i++) {
+            size_t entryCapacity = JSON_OBJECT_SIZE(3) + (JSON_ARRAY_SIZE(2) - JSON_ARRAY_SIZE(1));
+            if (trackCapacity + entryCapacity > MO_MAX_JSON_CAPACITY) {
+                break;
+            }
+
+            trackCapacity += entryCapacity;
+
+            serializeEntry(*configurations[i], configurationsArray.createNestedObject());
+        }
+
+        bool success = FilesystemUtils::storeJson(filesystem, getFilename(), doc);
+
+        if (success) {
+            MO_DBG_DEBUG("Saving configurations finished");
+            compactionPending = false;
+            markStored();
+#if MO_ENABLE_CONFIG_LOG
+            logGeneration++;
+            removeLog();
+#endif
+        } else {
+            MO_DBG_ERR("could not save configs file: %s", getFilename());
+        }
+
+        return success;
     }
 public:
     ConfigurationContainerFlash(std::shared_ptr<FilesystemAdapter> filesystem, const char *filename, bool accessible) :
-            ConfigurationContainer(filename, accessible), MemoryManaged("v16.Configuration.ContainerFlash.", filename), configurations(makeVector<std::shared_ptr<Configuration>>(getMemoryTag())), filesystem(filesystem), keyPool(makeVector<char*>(getMemoryTag())) { }
+            ConfigurationContainer(filename, accessible), MemoryManaged("v16.Configuration.ContainerFlash.", filename), configurations(makeVector<std::shared_ptr<Configuration>>(getMemoryTag())), storedRevisions(makeVector<revision_t>(getMemoryTag())), filesystem(filesystem), keyPool(makeVector<char*>(getMemoryTag())) { }
 
     ~ConfigurationContainerFlash() {
         auto it = keyPool.begin();
@@ -72,6 +412,10 @@ public:
         if (filesystem->stat(getFilename(), &file_size) != 0 // file does not exist
                 || file_size == 0) {                         // file exists, but empty
             MO_DBG_DEBUG("Populate FS: create configuration file");
+#if MO_ENABLE_CONFIG_LOG
+            removeLog(); //a log without configs file is outdated
+#endif
+            compactionPending = true;
             return save();
         }
 
@@ -104,112 +448,21 @@ public:
         }
 
         for (JsonObject stored : configurationsArray) {
-            TConfig type;
-            if (!deserializeTConfig(stored["type"] | "_Undefined", type)) {
-                MO_DBG_ERR("corrupt config");
-                continue;
-            }
-
-            const char *key = stored["key"] | "";
-            if (!*key) {
-                MO_DBG_ERR("corrupt config");
-                continue;
-            }
-
-            if (!stored.containsKey("value")) {
-                MO_DBG_ERR("corrupt config");
-                continue;
-            }
-
-            char *key_pooled = nullptr;
-
-            auto config = getConfiguration(key).get();
-            if (config && config->getType() != type) {
-                MO_DBG_ERR("conflicting type for %s - remove old config", key);
-                remove(config);
-                config = nullptr;
-            }
-            if (!config) {
-                #if MO_ENABLE_HEAP_PROFILER
-                char memoryTag [64];
-                snprintf(memoryTag, sizeof(memoryTag), "%s%s", "v16.Configuration.", key);
-                #else
-                const char *memoryTag = nullptr;
-                (void)memoryTag;
-                #endif
-                key_pooled = static_cast<char*>(MO_MALLOC(memoryTag, strlen(key) + 1));
-                if (!key_pooled) {
-                    MO_DBG_ERR("OOM: %s", key);
-                    return false;
-                }
-                strcpy(key_pooled, key);
-            }
-
-            switch (type) {
-                case TConfig::Int: {
-                    if (!stored["value"].is<int>()) {
-                        MO_DBG_ERR("corrupt config");
-                        MO_FREE(key_pooled);
-                        continue;
-                    }
-                    int value = stored["value"] | 0;
-                    if (!config) {
-                        //create new config
-                        config = createConfiguration(TConfig::Int, key_pooled).get();
-                    }
-                    if (config) {
-                        config->setInt(value);
-                    }
-                    break;
-                }
-                case TConfig::Bool: {
-                    if (!stored["value"].is<bool>()) {
-                        MO_DBG_ERR("corrupt config");
-                        MO_FREE(key_pooled);
-                        continue;
-                    }
-                    bool value = stored["value"] | false;
-                    if (!config) {
-                        //create new config
-                        config = createConfiguration(TConfig::Bool, key_pooled).get();
-                    }
-                    if (config) {
-                        config->setBool(value);
-                    }
-                    break;
-                }
-                case TConfig::String: {
-                    if (!stored["value"].is<const char*>()) {
-                        MO_DBG_ERR("corrupt config");
-                        MO_FREE(key_pooled);
-                        continue;
-                    }
-                    const char *value = stored["value"] | "";
-                    if (!config) {
-                        //create new config
-                        config = createConfiguration(TConfig::String, key_pooled).get();
-                    }
-                    if (config) {
-                        config->setString(value);
-                    }
-                    break;
-                }
+            if (!loadEntry(stored)) {
+                return false;
             }
+        }
 
-            if (config) {
-                //success
+#if MO_ENABLE_CONFIG_LOG
+        logGeneration = configHeader["logGen"] | 0U;
+        doc.reset();
 
-                if (key_pooled) {
-                    //allocated key, need to store
-                    keyPool.push_back(std::move(key_pooled));
-                }
-            } else {
-                MO_DBG_ERR("OOM: %s", key);
-                MO_FREE(key_pooled);
-            }
+        if (!replayLog()) {
+            compactionPending = true; //drop corrupt log with next save
         }
+#endif
 
-        configurationsUpdated();
+        markStored();
 
         MO_DBG_DEBUG("Initialization finished");
         loaded = true;
@@ -222,7 +475,12 @@ public:
             return false;
         }
 
-        if (!configurationsUpdated()) {
+        bool dirty = compactionPending;
+        for (size_t i = 0; i < configurations.size() && !dirty; i++) {
+            dirty |= isDirty(i);
+        }
+
+        if (!dirty) {
             return true; //nothing to be done
         }
 
@@ -234,61 +492,13 @@ public:
             }
         }
 
-        size_t jsonCapacity = 2 * JSON_OBJECT_SIZE(2); //head + configurations + head payload
-        jsonCapacity += JSON_ARRAY_SIZE(configurations.size()); //configurations array
-        jsonCapacity += configurations.size() * JSON_OBJECT_SIZE(3); //config entries in array
-
-        if (jsonCapacity > MO_MAX_JSON_CAPACITY) {
-            MO_DBG_ERR("configs JSON exceeds maximum capacity (%s, %zu entries). Crop configs file (by FCFS)", getFilename(), configurations.size());
-            jsonCapacity = MO_MAX_JSON_CAPACITY;
-        }
-
-        auto doc = initJsonDoc(getMemoryTag(), jsonCapacity);
-        JsonObject head = doc.createNestedObject("head");
-        head["content-type"] = "ocpp_config_file";
-        head["version"] = "2.0";
-
-        JsonArray configurationsArray = doc.createNestedArray("configurations");
-
-        size_t trackCapacity = 0;
-
-        for (size_t i = 0; i < configurations.size(); i++) {
-            auto& config = *configurations[i];
-
-            size_t entryCapacity = JSON_OBJECT_SIZE(3) + (JSON_ARRAY_SIZE(2) - JSON_ARRAY_SIZE(1));
-            if (trackCapacity + entryCapacity > MO_MAX_JSON_CAPACITY) {
-                break;
-            }
-
-            trackCapacity += entryCapacity;
-
-            auto stored = configurationsArray.createNestedObject();
-
-            stored["type"] = serializeTConfig(config.getType());
-            stored["key"] = config.getKey();
-            
-            switch (config.getType()) {
-                case TConfig::Int:
-                    stored["value"] = config.getInt();
-                    break;
-                case TConfig::Bool:
-                    stored["value"] = config.getBool();
-                    break;
-                case TConfig::String:
-                    stored["value"] = config.getString();
-                    break;
-            }
-        }
-
-        bool success = FilesystemUtils::storeJson(filesystem, getFilename(), doc);
-
-        if (success) {
-            MO_DBG_DEBUG("Saving configurations finished");
-        } else {
-            MO_DBG_ERR("could not save configs file: %s", getFilename());
+#if MO_ENABLE_CONFIG_LOG
+        if (!compactionPending && appendLog()) {
+            return true;
         }
+#endif
 
-        return success;
+        return compact();
     }
 
     std::shared_ptr<Configuration> createConfiguration(TConfig type, const char *key) override {
@@ -299,15 +509,18 @@ public:
             return nullptr;
         }
         configurations.push_back(res);
+        storedRevisions.push_back(res->getValueRevision());
         return res;
     }
 
     void remove(Configuration *config) override {
         const char *key = config->getKey();
-        configurations.erase(std::remove_if(configurations.begin(), configurations.end(),
-            [config] (std::shared_ptr<Configuration>& entry) {
-                return entry.get() == config;
-            }), configurations.end());
+        for (size_t i = 0; i < configurations.size(); i++) {
+            if (configurations[i].get() == config) {
+                eraseConfiguration(i);
+                break;
+            }
+        }
         if (key) {
             clearKeyPool(key);
         }
@@ -341,10 +554,10 @@ public:
         auto key = keyPool.begin();
         while (key != keyPool.end()) {
 
-            for (auto config = configurations.begin(); config != configurations.end(); ++config) {
-                if ((*config)->getKey() == *key) {
-                    MO_DBG_DEBUG("remove unused config %s", (*config)->getKey());
-                    configurations.erase(config);
+            for (size_t i = 0; i < configurations.size(); i++) {
+                if (configurations[i]->getKey() == *key) {
+                    MO_DBG_DEBUG("remove unused config %s", configurations[i]->getKey());
+                    eraseConfiguration(i);
                     break;
                 }
             }
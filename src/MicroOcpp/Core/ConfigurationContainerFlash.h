@@ -8,6 +8,23 @@
 #include <MicroOcpp/Core/ConfigurationContainer.h>
 #include <MicroOcpp/Core/FilesystemAdapter.h>
 
+/*
+ * Incremental persistence: changed configs are appended as small records to a key-value log next to the
+ * configs file (filename + MO_CONFIG_LOG_SUFFIX). When the log exceeds MO_CONFIG_LOG_MAXSIZE, or when a config
+ * is removed, the configs file is rewritten and the log is dropped
+ */
+#ifndef MO_ENABLE_CONFIG_LOG
+#define MO_ENABLE_CONFIG_LOG 1
+#endif
+
+#ifndef MO_CONFIG_LOG_SUFFIX
+#define MO_CONFIG_LOG_SUFFIX ".log"
+#endif
+
+#ifndef MO_CONFIG_LOG_MAXSIZE
+#define MO_CONFIG_LOG_MAXSIZE 1024 //log size in bytes which triggers compaction
+#endif
+
 namespace MicroOcpp {
 
 std::unique_ptr<ConfigurationContainer> makeConfigurationContainerFlash(std::shared_ptr<FilesystemAdapter> filesystem, const char *filename, bool accessible);
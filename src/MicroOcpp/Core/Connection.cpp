@@ -118,4 +118,8 @@ bool WSClient::isConnected() {
     return wsock->isConnected();
 }
 
+bool WSClient::sendPing() {
+    return wsock->sendPing();
+}
+
 #endif
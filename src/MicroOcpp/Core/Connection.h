@@ -70,6 +70,13 @@ public:
      * connection status is uncertain, it's best to return true by default.
      */
     virtual bool isConnected() {return true;} //MO ignores true. This default implementation keeps backwards-compatibility
+
+    /*
+     * Optional keepalive hook. Sends a transport-level ping (e.g. WebSocket ping frame) and returns true, or
+     * returns false if not supported. MO uses it instead of a Heartbeat when Heartbeats are suppressed and the
+     * clock doesn't need to be synchronized
+     */
+    virtual bool sendPing() {return false;}
 };
 
 class LoopbackConnection : public Connection, public MemoryManaged {
@@ -123,6 +130,8 @@ public:
     unsigned long getLastConnected() override; //get last connection creation in millis
 
     bool isConnected() override;
+
+    bool sendPing() override;
 };
 
 } //end namespace EspWiFi
@@ -0,0 +1,256 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/ConnectionQueue.h>
+
+#if MO_ENABLE_CONNECTION_QUEUE
+
+#include <string.h>
+
+#include <MicroOcpp/Platform.h>
+#include <MicroOcpp/Debug.h>
+
+#define MO_FRAME_HEADER sizeof(size_t)
+#define MO_FRAME_WRAP ((size_t) -1) //header value which tells the consumer to continue at the buffer start
+
+using namespace MicroOcpp;
+
+static size_t frameSize(size_t len) {
+    //header + payload, aligned to the header size so that each header is properly aligned
+    return MO_FRAME_HEADER + ((len + MO_FRAME_HEADER - 1) / MO_FRAME_HEADER) * MO_FRAME_HEADER;
+}
+
+SpscFrameQueue::SpscFrameQueue(size_t size) : MemoryManaged("ConnectionQueue") {
+
+    //capacity must be a power of two so that the free-running positions stay consistent on overflow
+    capacity = 4 * MO_FRAME_HEADER;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    buf = static_cast<char*>(MO_MALLOC(getMemoryTag(), capacity));
+    if (!buf) {
+        MO_DBG_ERR("OOM");
+        capacity = 0;
+    }
+}
+
+SpscFrameQueue::~SpscFrameQueue() {
+    MO_FREE(buf);
+    buf = nullptr;
+}
+
+bool SpscFrameQueue::push(const char *frame, size_t len) {
+    return push(nullptr, 0, frame, len);
+}
+
+bool SpscFrameQueue::push(const char *prefix, size_t prefixLen, const char *frame, size_t len) {
+    if (!buf) {
+        return false;
+    }
+
+    size_t frameLen = prefixLen + len;
+    size_t need = frameSize(frameLen);
+    if (need > capacity / 2) {
+        //with at most half the capacity, a frame always fits into the empty queue, even if it needs to wrap around
+        return false;
+    }
+
+    size_t w = head.load(std::memory_order_relaxed);
+    size_t r = tail.load(std::memory_order_acquire);
+    size_t available = capacity - (w - r);
+
+    size_t index = w & (capacity - 1);
+    size_t contiguous = capacity - index;
+
+    size_t skip = 0;
+    if (contiguous < need) {
+        //frame doesn't fit before the buffer end. Skip the remainder and write it to the buffer start
+        skip = contiguous;
+    }
+
+    if (available < skip + need) {
+        return false; //full
+    }
+
+    if (skip) {
+        if (contiguous >= MO_FRAME_HEADER) {
+            size_t wrap = MO_FRAME_WRAP;
+            memcpy(buf + index, &wrap, MO_FRAME_HEADER);
+        } //else: consumer skips remainders which are too small for a header without marker
+        index = 0;
+    }
+
+    memcpy(buf + index, &frameLen, MO_FRAME_HEADER);
+    if (prefixLen) {
+        memcpy(buf + index + MO_FRAME_HEADER, prefix, prefixLen);
+    }
+    memcpy(buf + index + MO_FRAME_HEADER + prefixLen, frame, len);
+
+    head.store(w + skip + need, std::memory_order_release); //publish frame
+    return true;
+}
+
+const char *SpscFrameQueue::front(size_t *len) {
+    if (!buf) {
+        return nullptr;
+    }
+
+    size_t r = tail.load(std::memory_order_relaxed);
+    size_t w = head.load(std::memory_order_acquire);
+
+    if (r == w) {
+        return nullptr; //empty
+    }
+
+    size_t index = r & (capacity - 1);
+    size_t contiguous = capacity - index;
+
+    size_t header = MO_FRAME_WRAP;
+    if (contiguous >= MO_FRAME_HEADER) {
+        memcpy(&header, buf + index, MO_FRAME_HEADER);
+    }
+
+    if (header == MO_FRAME_WRAP) {
+        //producer continued at buffer start
+        r += contiguous;
+        tail.store(r, std::memory_order_release);
+        if (r == w) {
+            return nullptr;
+        }
+        index = 0;
+        memcpy(&header, buf, MO_FRAME_HEADER);
+    }
+
+    if (len) {
+        *len = header;
+    }
+    return buf + index + MO_FRAME_HEADER;
+}
+
+void SpscFrameQueue::pop() {
+    size_t len = 0;
+    if (!front(&len)) { //also skips the wrap marker, if any
+        return;
+    }
+    size_t r = tail.load(std::memory_order_relaxed);
+    tail.store(r + frameSize(len), std::memory_order_release);
+}
+
+bool SpscFrameQueue::empty() const {
+    return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+}
+
+QueuedConnection::QueuedConnection(Connection& transport, size_t inboundSize, size_t outboundSize)
+        : MemoryManaged("ConnectionQueue"), transport(transport), inbound(inboundSize), outbound(outboundSize) {
+
+    ReceiveTXTcallback onReceive = [this] (const char *payload, size_t length) {
+        //executed on network thread
+        if (inbound.push(payload, length)) {
+            return true;
+        } else {
+            inboundDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    };
+    this->transport.setReceiveTXTcallback(onReceive);
+
+    connected.store(this->transport.isConnected());
+    lastConnected.store(this->transport.getLastConnected());
+    lastRecv.store(this->transport.getLastRecv());
+}
+
+void QueuedConnection::networkLoop() {
+    transport.loop();
+
+    //forward outgoing frames until the transport doesn't accept more
+    size_t len;
+    while (const char *frame = outbound.front(&len)) {
+        unsigned long enqueued;
+        memcpy(&enqueued, frame, sizeof(enqueued));
+
+        if (MO_CONNECTION_QUEUE_OUTBOUND_TTL > 0 &&
+                ocppTime.load(std::memory_order_relaxed) - enqueued >= (unsigned long) MO_CONNECTION_QUEUE_OUTBOUND_TTL) {
+            //stale, e.g. after a connection loss. The OCPP layer has timed out or resent it meanwhile
+            outbound.pop();
+            outboundExpired.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (len == sizeof(enqueued)) {
+            //empty frame: ping. OCPP messages are never empty
+            pingSent.store(transport.sendPing(), std::memory_order_relaxed);
+            outbound.pop();
+            continue;
+        }
+
+        if (!transport.sendTXT(frame + sizeof(enqueued), len - sizeof(enqueued))) {
+            break; //retry in next loop
+        }
+        outbound.pop();
+    }
+
+    connected.store(transport.isConnected(), std::memory_order_relaxed);
+    lastConnected.store(transport.getLastConnected(), std::memory_order_relaxed);
+    lastRecv.store(transport.getLastRecv(), std::memory_order_relaxed);
+}
+
+void QueuedConnection::loop() {
+
+    ocppTime.store(mocpp_tick_ms(), std::memory_order_relaxed);
+
+    if (auto dropped = inboundDropped.exchange(0, std::memory_order_relaxed)) {
+        MO_DBG_WARN("inbound queue full, dropped %zu frames", dropped);
+    }
+
+    if (auto expired = outboundExpired.exchange(0, std::memory_order_relaxed)) {
+        MO_DBG_WARN("dropped %zu outgoing frames after %ums", expired, (unsigned int) MO_CONNECTION_QUEUE_OUTBOUND_TTL);
+    }
+
+    if (!receiveTXT) {
+        return;
+    }
+
+    size_t len;
+    const char *frame;
+    for (size_t n = 0; n < MO_CONNECTION_QUEUE_FRAMES_PER_LOOP && (frame = inbound.front(&len)); n++) {
+        receiveTXT(frame, len); //in-place processing, the frame remains valid until pop()
+        inbound.pop();
+    }
+}
+
+bool QueuedConnection::sendTXT(const char *msg, size_t length) {
+    unsigned long now = mocpp_tick_ms();
+    ocppTime.store(now, std::memory_order_relaxed);
+    return outbound.push(reinterpret_cast<const char*>(&now), sizeof(now), msg, length);
+}
+
+bool QueuedConnection::sendPing() {
+    unsigned long now = mocpp_tick_ms();
+    ocppTime.store(now, std::memory_order_relaxed);
+    if (!outbound.push(reinterpret_cast<const char*>(&now), sizeof(now), "", 0)) {
+        return false;
+    }
+
+    //the network thread executes the ping later. Report if the transport supports pings, i.e. if the previous one went through
+    return pingSent.load(std::memory_order_relaxed);
+}
+
+void QueuedConnection::setReceiveTXTcallback(ReceiveTXTcallback &receiveTXT) {
+    this->receiveTXT = receiveTXT;
+}
+
+unsigned long QueuedConnection::getLastRecv() {
+    return lastRecv.load(std::memory_order_relaxed);
+}
+
+unsigned long QueuedConnection::getLastConnected() {
+    return lastConnected.load(std::memory_order_relaxed);
+}
+
+bool QueuedConnection::isConnected() {
+    return connected.load(std::memory_order_relaxed);
+}
+
+#endif //MO_ENABLE_CONNECTION_QUEUE
@@ -0,0 +1,134 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_CONNECTIONQUEUE_H
+#define MO_CONNECTIONQUEUE_H
+
+/*
+ * Decouples the WebSocket I/O from the OCPP engine thread.
+ *
+ * By default, MO expects that the WebSocket is operated on the same thread as mocpp_loop(), because the
+ * receiveTXT callback executes the incoming OCPP message immediately. QueuedConnection wraps the actual
+ * transport and buffers the frames in two bounded single-producer / single-consumer ring buffers:
+ *
+ *     network thread:                         OCPP thread:
+ *         queuedConnection.networkLoop();         mocpp_loop(); //calls queuedConnection.loop()
+ *
+ * The network thread operates the transport (calls its loop(), sendTXT() and sendPing()) and the OCPP
+ * thread processes the frames. Both threads only synchronize over atomic indices of the ring buffers, i.e.
+ * there is no mutex on the hot path. Each function must only be called from its designated thread.
+ *
+ * Both threads read the clock: the OCPP thread stamps the outgoing frames and the transport calls
+ * mocpp_tick_ms() on the network thread (e.g. WSClient in its callbacks). The timer passed with
+ * mocpp_set_timer() must be safe to call from both threads.
+ *
+ * Usage:
+ *
+ *     MicroOcpp::QueuedConnection queuedConnection {myWebSocketAdapter};
+ *     mocpp_initialize(queuedConnection, ...);
+ */
+
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Memory.h>
+
+#ifndef MO_ENABLE_CONNECTION_QUEUE
+#define MO_ENABLE_CONNECTION_QUEUE 0
+#endif
+
+#if MO_ENABLE_CONNECTION_QUEUE
+
+#include <atomic>
+
+#ifndef MO_CONNECTION_QUEUE_INBOUND_SIZE
+#define MO_CONNECTION_QUEUE_INBOUND_SIZE 8192 //bytes, rounded up to the next power of two. Max frame size is half of it
+#endif
+
+#ifndef MO_CONNECTION_QUEUE_OUTBOUND_SIZE
+#define MO_CONNECTION_QUEUE_OUTBOUND_SIZE 8192 //bytes, rounded up to the next power of two. Max frame size is half of it
+#endif
+
+#ifndef MO_CONNECTION_QUEUE_OUTBOUND_TTL
+#define MO_CONNECTION_QUEUE_OUTBOUND_TTL 20000 //ms; outgoing frames which wait longer are dropped, as the Request has timed out meanwhile. 0 = never
+#endif
+
+#ifndef MO_CONNECTION_QUEUE_FRAMES_PER_LOOP
+#define MO_CONNECTION_QUEUE_FRAMES_PER_LOOP 1 //incoming frames processed per loop(). The RequestQueue sends one response per loop
+#endif
+
+namespace MicroOcpp {
+
+/*
+ * Bounded ring buffer of variable-length frames for exactly one producer and one consumer thread.
+ * Frames are stored contiguously, so that the consumer can process them in place. The maximum frame
+ * size is half of the capacity.
+ */
+class SpscFrameQueue : public MemoryManaged {
+private:
+    char *buf = nullptr;
+    size_t capacity = 0; //power of two
+
+    std::atomic<size_t> head {0}; //write position, free running, only modified by producer
+    std::atomic<size_t> tail {0}; //read position, free running, only modified by consumer
+public:
+    SpscFrameQueue(size_t capacity);
+    ~SpscFrameQueue();
+
+    SpscFrameQueue(const SpscFrameQueue&) = delete;
+    SpscFrameQueue& operator=(const SpscFrameQueue&) = delete;
+
+    //producer side. Returns false if the frame doesn't fit into the free space
+    bool push(const char *frame, size_t len);
+    bool push(const char *prefix, size_t prefixLen, const char *frame, size_t len); //store prefix + frame as one frame
+
+    //consumer side. Returns the oldest frame which stays valid until pop(), or nullptr if empty
+    const char *front(size_t *len);
+    void pop();
+
+    bool empty() const;
+    size_t getCapacity() const {return capacity;}
+};
+
+class QueuedConnection : public Connection, public MemoryManaged {
+private:
+    Connection& transport;
+
+    SpscFrameQueue inbound;  //producer: network thread, consumer: OCPP thread
+    SpscFrameQueue outbound; //producer: OCPP thread, consumer: network thread
+
+    ReceiveTXTcallback receiveTXT;
+
+    //transport status mirrored by the network thread
+    std::atomic<bool> connected {false};
+    std::atomic<unsigned long> lastConnected {0};
+    std::atomic<unsigned long> lastRecv {0};
+
+    std::atomic<size_t> inboundDropped {0}; //counted on network thread, reported on OCPP thread
+    std::atomic<size_t> outboundExpired {0}; //counted on network thread, reported on OCPP thread
+
+    std::atomic<unsigned long> ocppTime {0}; //mocpp_tick_ms() of the OCPP thread, reference time for the TTL of outgoing frames
+    std::atomic<bool> pingSent {false}; //if the last ping went through the transport, set by network thread
+public:
+    QueuedConnection(Connection& transport, size_t inboundSize = MO_CONNECTION_QUEUE_INBOUND_SIZE, size_t outboundSize = MO_CONNECTION_QUEUE_OUTBOUND_SIZE);
+
+    /*
+     * Network thread: operate the transport, forward outgoing frames and update connection status
+     */
+    void networkLoop();
+
+    /*
+     * OCPP thread: Connection interface used by MO
+     */
+    void loop() override; //processes pending incoming frames
+    bool sendTXT(const char *msg, size_t length) override; //enqueues frame with timestamp; returns false if outbound queue is full
+    bool sendPing() override; //enqueues ping for the network thread; returns if the previous ping went through
+    void setReceiveTXTcallback(ReceiveTXTcallback &receiveTXT) override;
+    unsigned long getLastRecv() override;
+    unsigned long getLastConnected() override;
+    bool isConnected() override;
+};
+
+} //end namespace MicroOcpp
+
+#endif //MO_ENABLE_CONNECTION_QUEUE
+#endif
@@ -5,6 +5,9 @@
 #include <MicroOcpp/Core/Context.h>
 #include <MicroOcpp/Core/Request.h>
 #include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/Metrics.h>
+#include <MicroOcpp/Core/LoopBudget.h>
 #include <MicroOcpp/Model/Model.h>
 
 #include <MicroOcpp/Debug.h>
@@ -12,7 +15,7 @@
 using namespace MicroOcpp;
 
 Context::Context(Connection& connection, std::shared_ptr<FilesystemAdapter> filesystem, uint16_t bootNr, ProtocolVersion version)
-        : MemoryManaged("Context"), connection(connection), model{version, bootNr}, reqQueue{connection, operationRegistry} {
+        : MemoryManaged("Context"), connection(connection), model{version, bootNr}, reqQueue{connection, operationRegistry, timerWheel}, filesystem(filesystem) {
 
 }
 
@@ -21,17 +24,24 @@ Context::~Context() {
 }
 
 void Context::loop() {
+    MO_METRICS_TIME_SCOPE(MO_METRICS_LOOP_TIME);
+    LoopBudget::begin();
     connection.loop();
+    timerWheel.loop();
     reqQueue.loop();
     model.loop();
+    if (filesystem) {
+        filesystem->loop();
+    }
+    LoopBudget::end();
 }
 
-void Context::initiateRequest(std::unique_ptr<Request> op) {
+bool Context::initiateRequest(std::unique_ptr<Request> op) {
     if (!op) {
         MO_DBG_ERR("invalid arg");
-        return;
+        return false;
     }
-    reqQueue.sendRequest(std::move(op));
+    return reqQueue.sendRequest(std::move(op));
 }
 
 Model& Context::getModel() {
@@ -54,6 +64,10 @@ RequestQueue& Context::getRequestQueue() {
     return reqQueue;
 }
 
+TimerWheel& Context::getTimerWheel() {
+    return timerWheel;
+}
+
 void Context::setFtpClient(std::unique_ptr<FtpClient> ftpClient) {
     this->ftpClient = std::move(ftpClient);
 }
@@ -9,6 +9,7 @@
 
 #include <MicroOcpp/Core/OperationRegistry.h>
 #include <MicroOcpp/Core/RequestQueue.h>
+#include <MicroOcpp/Core/TimerWheel.h>
 #include <MicroOcpp/Core/Memory.h>
 #include <MicroOcpp/Core/Ftp.h>
 #include <MicroOcpp/Model/Model.h>
@@ -22,9 +23,11 @@ class FilesystemAdapter;
 class Context : public MemoryManaged {
 private:
     Connection& connection;
+    TimerWheel timerWheel; //shared by all modules. Outlives the timers of the other members
     OperationRegistry operationRegistry;
     Model model;
     RequestQueue reqQueue;
+    std::shared_ptr<FilesystemAdapter> filesystem;
 
     std::unique_ptr<FtpClient> ftpClient;
 
@@ -34,7 +37,7 @@ public:
 
     void loop();
 
-    void initiateRequest(std::unique_ptr<Request> op);
+    bool initiateRequest(std::unique_ptr<Request> op); //returns false if the request could not be enqueued
 
     Model& getModel();
 
@@ -46,6 +49,8 @@ public:
 
     RequestQueue& getRequestQueue();
 
+    TimerWheel& getTimerWheel();
+
     void setFtpClient(std::unique_ptr<FtpClient> ftpClient);
     FtpClient *getFtpClient();
 };
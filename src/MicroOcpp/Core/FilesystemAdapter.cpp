@@ -20,6 +20,101 @@
  * You can add support for other file systems by passing a custom adapter to mocpp_initialize(...)
  */
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+
+#define MO_MAX_TMP_PATH_SIZE (MO_MAX_PATH_SIZE + sizeof(MO_TMPFILE_SUFFIX) - 1)
+
+namespace MicroOcpp {
+
+bool makeTmpPath(char *tmpPath, size_t size, const char *path) {
+    auto ret = snprintf(tmpPath, size, "%s" MO_TMPFILE_SUFFIX, path);
+    if (ret < 0 || (size_t)ret >= size) {
+        MO_DBG_ERR("fn error: %i", ret);
+        return false;
+    }
+    return true;
+}
+
+bool isTmpFname(const char *fname) {
+    size_t len = strlen(fname);
+    size_t suffixLen = sizeof(MO_TMPFILE_SUFFIX) - 1;
+    return len >= suffixLen && !strcmp(fname + len - suffixLen, MO_TMPFILE_SUFFIX);
+}
+
+/*
+ * Writes into a temporary file and replaces the target file when closed. If a write, the flush or the close
+ * of the temporary file fails, the temporary file is discarded and the target file remains untouched. A
+ * power loss at any point leaves either the old or the new version of the target file
+ */
+class AtomicFileAdapter : public FileAdapter, public MemoryManaged {
+private:
+    std::unique_ptr<FileAdapter> file;
+    char path [MO_MAX_PATH_SIZE];
+    char tmpPath [MO_MAX_TMP_PATH_SIZE];
+    bool (*replaceFile)(const char *tmpPath, const char *path);
+    bool (*removeFile)(const char *path);
+
+    bool writeError = false;
+    bool closed = false;
+    bool committed = false;
+public:
+    AtomicFileAdapter(std::unique_ptr<FileAdapter> file, const char *path, const char *tmpPath, bool (*replaceFile)(const char*, const char*), bool (*removeFile)(const char*))
+            : MemoryManaged("Filesystem"), file(std::move(file)), replaceFile(replaceFile), removeFile(removeFile) {
+        snprintf(this->path, sizeof(this->path), "%s", path);
+        snprintf(this->tmpPath, sizeof(this->tmpPath), "%s", tmpPath);
+    }
+
+    ~AtomicFileAdapter() {
+        close();
+    }
+
+    bool close() override {
+        if (closed) {
+            return committed;
+        }
+        closed = true;
+
+        bool success = file->close() && !writeError; //flush and close temporary file
+        file.reset();
+
+        if (!success) {
+            MO_DBG_ERR("write error, keep previous version of %s", path);
+            removeFile(tmpPath);
+        } else if (!replaceFile(tmpPath, path)) {
+            MO_DBG_ERR("could not replace %s", path);
+            removeFile(tmpPath);
+        } else {
+            committed = true;
+        }
+
+        return committed;
+    }
+
+    size_t read(char *buf, size_t len) override {
+        return file->read(buf, len);
+    }
+
+    size_t write(const char *buf, size_t len) override {
+        auto ret = file->write(buf, len);
+        if (ret != len) {
+            writeError = true;
+        }
+        return ret;
+    }
+
+    size_t seek(size_t offset) override {
+        return file->seek(offset);
+    }
+
+    int read() override {
+        return file->read();
+    }
+};
+
+} //end namespace MicroOcpp
+
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
 #if MO_ENABLE_FILE_INDEX
 
 #include <algorithm>
@@ -35,13 +130,20 @@ private:
     std::unique_ptr<FileAdapter> file;
 
     size_t written = 0;
+    bool replace = false; //true: failed close keeps the previous version of the file
+    bool closed = false;
+    bool closeResult = false;
 public:
-    IndexedFileAdapter(FilesystemAdapterIndex& index, const char *fn, std::unique_ptr<FileAdapter> file)
-            : MemoryManaged("FilesystemIndex"), index(index), file(std::move(file)) {
+    IndexedFileAdapter(FilesystemAdapterIndex& index, const char *fn, std::unique_ptr<FileAdapter> file, size_t written = 0, bool replace = false)
+            : MemoryManaged("FilesystemIndex"), index(index), file(std::move(file)), written(written), replace(replace) {
         snprintf(this->fn, sizeof(this->fn), "%s", fn);
     }
 
-    ~IndexedFileAdapter(); // destructor updates file index with written size
+    ~IndexedFileAdapter() {
+        close();
+    }
+
+    bool close() override; // updates file index with written size
 
     size_t read(char *buf, size_t len) override {
         return file->read(buf, len);
@@ -136,6 +238,10 @@ public:
                 return nullptr;
             }
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+            //the previous version of the file remains valid until the new file is closed. Update index then
+            return std::unique_ptr<IndexedFileAdapter>(new IndexedFileAdapter(*this, fn, std::move(file), 0, true));
+#else
             IndexEntry *entry = nullptr;
             if (!(entry = getEntryByFname(fn))) {
                 index.emplace_back(fn, 0);
@@ -150,8 +256,31 @@ public:
             entry->size = 0; //write always empties the file
 
             return std::unique_ptr<IndexedFileAdapter>(new IndexedFileAdapter(*this, entry->fname.c_str(), std::move(file)));
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+        } else if (!strcmp(mode, "a")) {
+
+            if (strlen(path) < sizeof(MO_FILENAME_PREFIX) - 1) {
+                MO_DBG_ERR("invalid fn");
+                return nullptr;
+            }
+
+            const char *fn = path + sizeof(MO_FILENAME_PREFIX) - 1;
+
+            auto file = filesystem->open(path, "a");
+            if (!file) {
+                return nullptr;
+            }
+
+            IndexEntry *entry = nullptr;
+            if (!(entry = getEntryByFname(fn))) {
+                index.emplace_back(fn, 0);
+                entry = &index.back();
+            }
+
+            //appended data starts at the current end of the file
+            return std::unique_ptr<IndexedFileAdapter>(new IndexedFileAdapter(*this, entry->fname.c_str(), std::move(file), entry->size));
         } else {
-            MO_DBG_ERR("only support r or w");
+            MO_DBG_ERR("only support r, w or a");
             return nullptr;
         }
     }
@@ -188,6 +317,18 @@ public:
         return 0;
     }
 
+    void loop() override {
+        filesystem->loop();
+    }
+
+    bool flush() override {
+        return filesystem->flush();
+    }
+
+    bool flush(const char *path) override {
+        return filesystem->flush(path);
+    }
+
     bool createIndex() {
         if (!index.empty()) {
             return false;
@@ -225,11 +366,28 @@ public:
             entry->size = size;
             MO_DBG_DEBUG("update index: %s (%zuB)", entry->fname.c_str(), entry->size);
         }
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+        else {
+            index.emplace_back(fn, size);
+            MO_DBG_DEBUG("add file to index: %s (%zuB)", fn, size);
+        }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
     }
 };
 
-IndexedFileAdapter::~IndexedFileAdapter() {
-    index.updateFilesize(fn, written);
+bool IndexedFileAdapter::close() {
+    if (closed) {
+        return closeResult;
+    }
+    closed = true;
+
+    closeResult = file->close();
+    file.reset();
+
+    if (closeResult || !replace) {
+        index.updateFilesize(fn, written);
+    }
+    return closeResult;
 }
 
 std::shared_ptr<FilesystemAdapter> decorateIndex(std::shared_ptr<FilesystemAdapter> filesystem, void (*onDestruct)(void*) = nullptr) {
@@ -267,13 +425,25 @@ namespace MicroOcpp {
 
 class ArduinoFileAdapter : public FileAdapter, public MemoryManaged {
     File file;
+    bool closed = false;
+    bool closeResult = false;
 public:
     ArduinoFileAdapter(File&& file) : MemoryManaged("Filesystem"), file(file) {}
 
     ~ArduinoFileAdapter() {
-        if (file) {
-            file.close();
+        close();
+    }
+
+    bool close() override {
+        if (closed) {
+            return closeResult;
         }
+        closed = true;
+
+        file.flush();
+        closeResult = !file.getWriteError();
+        file.close();
+        return closeResult;
     }
     
     int read() override {
@@ -290,6 +460,69 @@ public:
     }
 };
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+
+bool replaceFileArduino(const char *tmpPath, const char *path) {
+#if MO_USE_FILEAPI == ARDUINO_SPIFFS
+    //SPIFFS cannot rename onto an existing file. Remove the target first; collectTmpFilesArduino() completes an interrupted replacement
+    if (USE_FS.exists(path) && !USE_FS.remove(path)) {
+        return false;
+    }
+#endif
+    return USE_FS.rename(tmpPath, path); //LittleFS replaces the target atomically
+}
+
+bool removeFileArduino(const char *path) {
+    return USE_FS.remove(path);
+}
+
+/*
+ * Mount-time pass over the temporary files left behind by a power loss. A temporary file next to its target
+ * is an incomplete write and is removed. On SPIFFS, a temporary file without target is a replacement which
+ * has been interrupted after removing the target and is completed. Afterwards, no further recovery is needed
+ */
+void collectTmpFilesArduino() {
+#if MO_USE_FILEAPI == ARDUINO_LITTLEFS
+    auto dir = USE_FS.open(MO_FILENAME_PREFIX);
+    if (!dir) {
+        return;
+    }
+
+    while (auto entry = dir.openNextFile()) {
+        char tmpPath [MO_MAX_TMP_PATH_SIZE];
+        auto ret = snprintf(tmpPath, sizeof(tmpPath), MO_FILENAME_PREFIX "%s", entry.name());
+        entry.close();
+
+        if (ret < 0 || (size_t)ret >= sizeof(tmpPath) || !isTmpFname(tmpPath)) {
+            continue;
+        }
+
+        //LittleFS renames atomically, so the temporary file is always an incomplete write
+        MO_DBG_DEBUG("collect incomplete write %s", tmpPath);
+        USE_FS.remove(tmpPath);
+    }
+#elif MO_USE_FILEAPI == ARDUINO_SPIFFS
+    auto dir = USE_FS.openDir(MO_FILENAME_PREFIX);
+    while (dir.next()) {
+        auto tmpPath = dir.fileName();
+        if (!tmpPath.c_str() || !isTmpFname(tmpPath.c_str())) {
+            continue;
+        }
+
+        auto path = tmpPath.substring(0, tmpPath.length() - (sizeof(MO_TMPFILE_SUFFIX) - 1));
+        if (USE_FS.exists(path)) {
+            MO_DBG_DEBUG("collect incomplete write %s", tmpPath.c_str());
+            USE_FS.remove(tmpPath);
+        } else {
+            MO_DBG_DEBUG("complete interrupted replacement of %s", path.c_str());
+            USE_FS.rename(tmpPath, path);
+        }
+    }
+#endif
+}
+
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
 class ArduinoFilesystemAdapter : public FilesystemAdapter, public MemoryManaged {
 private:
     bool valid = false;
@@ -323,6 +556,11 @@ public:
 #endif
         } //end if mustMount()
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+        if (valid) {
+            collectTmpFilesArduino();
+        }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
     }
 
     ~ArduinoFilesystemAdapter() {
@@ -377,6 +615,21 @@ public:
     } //end stat
 
     std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) override {
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+        if (!strcmp(mode, "w")) {
+            char tmpPath [MO_MAX_TMP_PATH_SIZE];
+            if (!makeTmpPath(tmpPath, sizeof(tmpPath), fn)) {
+                return nullptr;
+            }
+            File file = USE_FS.open(tmpPath, "w");
+            if (!file || file.isDirectory()) {
+                return nullptr;
+            }
+            return std::unique_ptr<FileAdapter>(new AtomicFileAdapter(
+                    std::unique_ptr<FileAdapter>(new ArduinoFileAdapter(std::move(file))),
+                    fn, tmpPath, replaceFileArduino, removeFileArduino));
+        }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
         File file = USE_FS.open(fn, mode);
         if (file && !file.isDirectory()) {
             MO_DBG_DEBUG("File open successful: %s", fn);
@@ -408,6 +661,12 @@ public:
                 return -1;
             }
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+            if (isTmpFname(fname)) {
+                continue; //file which is currently being written
+            }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
             err = fn(fname);
             if (err) {
                 break;
@@ -419,6 +678,11 @@ public:
         int err = 0;
         while (dir.next()) {
             auto fname = dir.fileName();
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+            if (fname.c_str() && isTmpFname(fname.c_str())) {
+                continue; //file which is currently being written
+            }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
             if (fname.c_str()) {
                 err = fn(fname.c_str() + strlen(MO_FILENAME_PREFIX));
             } else {
@@ -485,11 +749,23 @@ namespace MicroOcpp {
 
 class EspIdfFileAdapter : public FileAdapter, public MemoryManaged {
     FILE *file {nullptr};
+    bool closeResult = false;
 public:
     EspIdfFileAdapter(FILE *file) : MemoryManaged("Filesystem"), file(file) {}
 
     ~EspIdfFileAdapter() {
-        fclose(file);
+        close();
+    }
+
+    bool close() override {
+        if (!file) {
+            return closeResult;
+        }
+
+        closeResult = fflush(file) == 0 && !ferror(file);
+        closeResult &= fclose(file) == 0;
+        file = nullptr;
+        return closeResult;
     }
 
     size_t read(char *buf, size_t len) override {
@@ -509,6 +785,66 @@ public:
     }
 };
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+
+/*
+ * SPIFFS cannot rename onto an existing file. Remove the target first, which leaves a short window with only
+ * the temporary file on the flash. collectTmpFilesEspIdf() completes the replacement after a power loss in this window
+ */
+bool replaceFileEspIdf(const char *tmpPath, const char *path) {
+    struct ::stat st;
+    if (::stat(path, &st) == 0 && unlink(path) != 0) {
+        return false;
+    }
+    return rename(tmpPath, path) == 0;
+}
+
+bool removeFileEspIdf(const char *path) {
+    return unlink(path) == 0;
+}
+
+/*
+ * Mount-time pass over the temporary files left behind by a power loss. A temporary file next to its target
+ * is an incomplete write and is removed. A temporary file without target is a replacement which has been
+ * interrupted after removing the target and is completed. Afterwards, no further recovery is needed
+ */
+void collectTmpFilesEspIdf(const char *dname) {
+    auto dir = opendir(dname);
+    if (!dir) {
+        return;
+    }
+
+    while (auto entry = readdir(dir)) {
+        if (!isTmpFname(entry->d_name)) {
+            continue;
+        }
+
+        char tmpPath [MO_MAX_TMP_PATH_SIZE];
+        char path [MO_MAX_PATH_SIZE];
+        auto ret = snprintf(tmpPath, sizeof(tmpPath), MO_FILENAME_PREFIX "%s", entry->d_name);
+        if (ret < 0 || (size_t)ret >= sizeof(tmpPath)) {
+            continue;
+        }
+        ret = snprintf(path, sizeof(path), "%.*s", (int)(strlen(tmpPath) - (sizeof(MO_TMPFILE_SUFFIX) - 1)), tmpPath);
+        if (ret < 0 || (size_t)ret >= sizeof(path)) {
+            continue;
+        }
+
+        struct ::stat st;
+        if (::stat(path, &st) == 0) {
+            MO_DBG_DEBUG("collect incomplete write %s", tmpPath);
+            unlink(tmpPath);
+        } else {
+            MO_DBG_DEBUG("complete interrupted replacement of %s", path);
+            rename(tmpPath, path);
+        }
+    }
+
+    closedir(dir);
+}
+
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
 class EspIdfFilesystemAdapter : public FilesystemAdapter, public MemoryManaged {
 public:
     FilesystemOpt config;
@@ -538,6 +874,22 @@ public:
     }
 
     std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) override {
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+        if (!strcmp(mode, "w")) {
+            char tmpPath [MO_MAX_TMP_PATH_SIZE];
+            if (!makeTmpPath(tmpPath, sizeof(tmpPath), fn)) {
+                return nullptr;
+            }
+            auto file = fopen(tmpPath, "w");
+            if (!file) {
+                MO_DBG_DEBUG("Failed to open file path %s", tmpPath);
+                return nullptr;
+            }
+            return std::unique_ptr<FileAdapter>(new AtomicFileAdapter(
+                    std::unique_ptr<FileAdapter>(new EspIdfFileAdapter(file)),
+                    fn, tmpPath, replaceFileEspIdf, removeFileEspIdf));
+        }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
         auto file = fopen(fn, mode);
         if (file) {
             return std::unique_ptr<FileAdapter>(new EspIdfFileAdapter(std::move(file)));
@@ -573,6 +925,11 @@ public:
 
         int err = 0;
         while (auto entry = readdir(dir)) {
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+            if (isTmpFname(entry->d_name)) {
+                continue; //file which is currently being written
+            }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
             err = fn(entry->d_name);
             if (err) {
                 break;
@@ -645,6 +1002,17 @@ std::shared_ptr<FilesystemAdapter> makeDefaultFilesystemAdapter(FilesystemOpt co
     }
 
     if (mounted) {
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+        {
+            char dname [MO_MAX_PATH_SIZE];
+            auto dlen = snprintf(dname, MO_MAX_PATH_SIZE, "%s", MO_FILENAME_PREFIX);
+            if (dlen >= 2 && dlen < MO_MAX_PATH_SIZE && dname[dlen - 1] == '/') {
+                dname[dlen - 1] = '\0'; // trim trailing '/' if not root directory
+            }
+            collectTmpFilesEspIdf(dname);
+        }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
         auto fs = std::shared_ptr<FilesystemAdapter>(new EspIdfFilesystemAdapter(config, resetFilesystemCache), std::default_delete<FilesystemAdapter>(), makeAllocator<FilesystemAdapter>("Filesystem"));
 
 #if MO_ENABLE_FILE_INDEX
@@ -666,15 +1034,41 @@ std::shared_ptr<FilesystemAdapter> makeDefaultFilesystemAdapter(FilesystemOpt co
 #include <sys/stat.h>
 #include <dirent.h>
 
+#if MO_ENABLE_MMAP || MO_ENABLE_ATOMIC_FILE_WRITE
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if MO_ENABLE_MMAP
+#include <sys/mman.h>
+#endif
+
 namespace MicroOcpp {
 
 class PosixFileAdapter : public FileAdapter, public MemoryManaged {
     FILE *file {nullptr};
+    bool sync = false;
+    bool closeResult = false;
 public:
-    PosixFileAdapter(FILE *file) : MemoryManaged("Filesystem"), file(file) {}
+    PosixFileAdapter(FILE *file, bool sync = false) : MemoryManaged("Filesystem"), file(file), sync(sync) {}
 
     ~PosixFileAdapter() {
-        fclose(file);
+        close();
+    }
+
+    bool close() override {
+        if (!file) {
+            return closeResult;
+        }
+
+        closeResult = fflush(file) == 0 && !ferror(file);
+        if (sync) {
+            //write through to the storage before closing
+            closeResult &= fsync(fileno(file)) == 0;
+        }
+        closeResult &= fclose(file) == 0;
+        file = nullptr;
+        return closeResult;
     }
 
     size_t read(char *buf, size_t len) override {
@@ -694,6 +1088,126 @@ public:
     }
 };
 
+#if MO_ENABLE_MMAP
+
+class PosixMmapFileAdapter : public FileAdapter, public MemoryManaged {
+private:
+    const char *mapped = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+public:
+    PosixMmapFileAdapter(const char *mapped, size_t size) : MemoryManaged("Filesystem"), mapped(mapped), size(size) { }
+
+    ~PosixMmapFileAdapter() {
+        munmap((void*)mapped, size);
+    }
+
+    size_t read(char *buf, size_t len) override {
+        if (len > size - pos) {
+            len = size - pos;
+        }
+        memcpy(buf, mapped + pos, len);
+        pos += len;
+        return len;
+    }
+
+    size_t write(const char *buf, size_t len) override {
+        return 0; //read-only
+    }
+
+    size_t seek(size_t offset) override {
+        if (offset > size) {
+            return -1;
+        }
+        pos = offset;
+        return 0;
+    }
+
+    int read() override {
+        if (pos >= size) {
+            return -1;
+        }
+        return (unsigned char) mapped[pos++];
+    }
+
+    const char *data(size_t *size) override {
+        *size = this->size;
+        return mapped;
+    }
+};
+
+std::unique_ptr<FileAdapter> openMmap(const char *fn) {
+    int fd = ::open(fn, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<FileAdapter> file;
+
+    struct ::stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            file = std::unique_ptr<FileAdapter>(new PosixMmapFileAdapter((const char*)mapped, st.st_size));
+        }
+    } //else: empty files cannot be mapped
+
+    close(fd); //mapping remains valid after closing the file descriptor
+    return file;
+}
+
+#endif //MO_ENABLE_MMAP
+
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+
+bool replaceFilePosix(const char *tmpPath, const char *path) {
+    if (::rename(tmpPath, path) != 0) { //atomic on POSIX
+        return false;
+    }
+
+    //persist directory entry
+    int dir = ::open(MO_FILENAME_PREFIX, O_RDONLY);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+    return true;
+}
+
+bool removeFilePosix(const char *path) {
+    return ::remove(path) == 0;
+}
+
+/*
+ * Mount-time pass over the temporary files left behind by a power loss. rename() is atomic, so a temporary
+ * file is always an incomplete write and is removed. Afterwards, no further recovery is needed
+ */
+void collectTmpFilesPosix() {
+    auto dir = opendir(MO_FILENAME_PREFIX);
+    if (!dir) {
+        return;
+    }
+
+    while (auto entry = readdir(dir)) {
+        if (!isTmpFname(entry->d_name)) {
+            continue;
+        }
+
+        char tmpPath [MO_MAX_TMP_PATH_SIZE];
+        auto ret = snprintf(tmpPath, sizeof(tmpPath), MO_FILENAME_PREFIX "%s", entry->d_name);
+        if (ret < 0 || (size_t)ret >= sizeof(tmpPath)) {
+            continue;
+        }
+
+        MO_DBG_DEBUG("collect incomplete write %s", tmpPath);
+        ::remove(tmpPath);
+    }
+
+    closedir(dir);
+}
+
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
 class PosixFilesystemAdapter : public FilesystemAdapter, public MemoryManaged {
 public:
     FilesystemOpt config;
@@ -718,6 +1232,29 @@ public:
     }
 
     std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) override {
+#if MO_ENABLE_MMAP
+        if (!strcmp(mode, "r")) {
+            if (auto mapped = openMmap(fn)) {
+                return mapped;
+            } //else: fall back to buffered I/O
+        }
+#endif //MO_ENABLE_MMAP
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+        if (!strcmp(mode, "w")) {
+            char tmpPath [MO_MAX_TMP_PATH_SIZE];
+            if (!makeTmpPath(tmpPath, sizeof(tmpPath), fn)) {
+                return nullptr;
+            }
+            auto file = fopen(tmpPath, "w");
+            if (!file) {
+                MO_DBG_DEBUG("Failed to open file path %s", tmpPath);
+                return nullptr;
+            }
+            return std::unique_ptr<FileAdapter>(new AtomicFileAdapter(
+                    std::unique_ptr<FileAdapter>(new PosixFileAdapter(file, true)),
+                    fn, tmpPath, replaceFilePosix, removeFilePosix));
+        }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
         auto file = fopen(fn, mode);
         if (file) {
             return std::unique_ptr<FileAdapter>(new PosixFileAdapter(std::move(file)));
@@ -743,6 +1280,11 @@ public:
             if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
                 continue; //files . and .. are specific to desktop systems and rarely appear on microcontroller filesystems. Filter them
             }
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+            if (isTmpFname(entry->d_name)) {
+                continue; //file which is currently being written
+            }
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
             err = fn(entry->d_name);
             if (err) {
                 break;
@@ -775,6 +1317,10 @@ std::shared_ptr<FilesystemAdapter> makeDefaultFilesystemAdapter(FilesystemOpt co
         MO_DBG_DEBUG("Skip mounting on UNIX host");
     }
 
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+    collectTmpFilesPosix();
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
+
     auto fs = std::shared_ptr<FilesystemAdapter>(new PosixFilesystemAdapter(config, resetFilesystemCache), std::default_delete<FilesystemAdapter>(), makeAllocator<FilesystemAdapter>("Filesystem"));
 
 #if MO_ENABLE_FILE_INDEX
@@ -55,6 +55,22 @@
 #define MO_ENABLE_FILE_INDEX 0
 #endif
 
+// replace files atomically: write into a temporary file which is renamed to the target file when closed
+#ifndef MO_ENABLE_ATOMIC_FILE_WRITE
+#define MO_ENABLE_ATOMIC_FILE_WRITE 1
+#endif
+
+#define MO_TMPFILE_SUFFIX "~"
+
+// memory-map files opened for reading on POSIX systems
+#ifndef MO_ENABLE_MMAP
+#if MO_USE_FILEAPI == POSIX_FILEAPI
+#define MO_ENABLE_MMAP 1
+#else
+#define MO_ENABLE_MMAP 0
+#endif
+#endif
+
 namespace MicroOcpp {
 
 class FileAdapter {
@@ -65,15 +81,32 @@ public:
     virtual size_t seek(size_t offset) = 0;
 
     virtual int read() = 0;
+
+    /*
+     * Optional: direct access to the whole file content in a contiguous memory region, e.g. if the file is
+     * memory-mapped. Returns nullptr if not supported. The data remains valid until the FileAdapter is destroyed
+     */
+    virtual const char *data(size_t *size) {return nullptr;}
+
+    /*
+     * Flush and close the file. Returns false if the written data could not be persisted. With atomic file
+     * writes, this replaces the previous version of the file only on success. Further accesses are invalid.
+     * Files which are destroyed without close() are closed implicitly, but without error reporting
+     */
+    virtual bool close() {return true;}
 };
 
 class FilesystemAdapter {
 public:
     virtual ~FilesystemAdapter() = default;
     virtual int stat(const char *path, size_t *size) = 0;
-    virtual std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) = 0;
+    virtual std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) = 0; //mode: "r", "w" (replace file) or "a" (append to file)
     virtual bool remove(const char *fn) = 0;
     virtual int ftw_root(std::function<int(const char *fpath)> fn) = 0; //enumerate the files in the mo_store root folder
+
+    virtual void loop() { } //called by mocpp_loop(). Optional, e.g. for buffering adapters
+    virtual bool flush() {return true;} //durability barrier: returns after all buffered writes are persisted
+    virtual bool flush(const char *path) {return flush();} //durability barrier for the buffered writes of a single file
 };
 
 /*
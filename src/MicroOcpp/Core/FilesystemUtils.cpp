@@ -5,6 +5,7 @@
 #include <MicroOcpp/Core/FilesystemAdapter.h>
 #include <MicroOcpp/Core/FilesystemUtils.h>
 #include <MicroOcpp/Core/ConfigurationOptions.h> //FilesystemOpt
+#include <MicroOcpp/Core/Metrics.h>
 #include <MicroOcpp/Debug.h>
 
 using namespace MicroOcpp;
@@ -19,6 +20,8 @@ std::unique_ptr<JsonDoc> FilesystemUtils::loadJson(std::shared_ptr<FilesystemAda
         MO_DBG_ERR("Fn too long: %.*s", MO_MAX_PATH_SIZE, fn);
         return nullptr;
     }
+
+    MO_METRICS_TIME_SCOPE(MO_METRICS_FS_LOAD_TIME);
     
     size_t fsize = 0;
     if (filesystem->stat(fn, &fsize) != 0) {
@@ -54,10 +57,18 @@ std::unique_ptr<JsonDoc> FilesystemUtils::loadJson(std::shared_ptr<FilesystemAda
     DeserializationError err = DeserializationError::NoMemory;
     ArduinoJsonFileAdapter fileReader {file.get()};
 
+    //if the file content is accessible in memory (e.g. mmap), parse directly from there instead of reading byte-wise
+    size_t mappedSize = 0;
+    const char *mapped = file->data(&mappedSize);
+
     while (err == DeserializationError::NoMemory && capacity <= MO_MAX_JSON_CAPACITY) {
 
         doc = makeJsonDoc(memoryTag, capacity);
-        err = deserializeJson(*doc, fileReader);
+        if (mapped) {
+            err = deserializeJson(*doc, mapped, mappedSize);
+        } else {
+            err = deserializeJson(*doc, fileReader);
+        }
 
         capacity *= 2;
 
@@ -91,6 +102,8 @@ bool FilesystemUtils::storeJson(std::shared_ptr<FilesystemAdapter> filesystem, c
         return false;
     }
 
+    MO_METRICS_TIME_SCOPE(MO_METRICS_FS_STORE_TIME);
+
     auto file = filesystem->open(fn, "w");
     if (!file) {
         MO_DBG_ERR("Could not open file %s", fn);
@@ -101,16 +114,22 @@ bool FilesystemUtils::storeJson(std::shared_ptr<FilesystemAdapter> filesystem, c
 
     size_t written = serializeJson(doc, fileWriter);
 
-    if (written < 2) {
+    bool closed = file->close(); //with atomic file writes, this replaces the previous version
+    file.reset();
+
+    if (written < 2 || !closed) {
         MO_DBG_ERR("Error writing file %s", fn);
         size_t file_size = 0;
-        if (filesystem->stat(fn, &file_size) == 0) {
+        if (filesystem->stat(fn, &file_size) == 0 && file_size < 2) {
+            //atomic file writes keep the previous version of the file. Only collect if the file is corrupt
             MO_DBG_DEBUG("Collect invalid file %s", fn);
             filesystem->remove(fn);
         }
         return false;
     }
 
+    MO_METRICS_COUNT(MO_METRICS_FS_BYTES_WRITTEN, written);
+
     MO_DBG_DEBUG("Wrote JSON file: %s", fn);
     return true;
 }
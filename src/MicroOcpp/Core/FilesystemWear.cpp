@@ -0,0 +1,244 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/FilesystemWear.h>
+
+#if MO_ENABLE_FS_WEAR
+
+#include <string.h>
+
+#include <MicroOcpp/Debug.h>
+
+using namespace MicroOcpp;
+
+namespace MicroOcpp {
+
+/*
+ * Forwards all accesses to the FileAdapter of the underlying filesystem and counts the written bytes
+ */
+class WearAccountingFileAdapter : public FileAdapter, public MemoryManaged {
+private:
+    WearAccountingFilesystemAdapter& filesystem;
+    std::unique_ptr<FileAdapter> file;
+    FsWriteClass cls;
+public:
+    WearAccountingFileAdapter(WearAccountingFilesystemAdapter& filesystem, std::unique_ptr<FileAdapter> file, FsWriteClass cls)
+            : MemoryManaged("FilesystemWear"), filesystem(filesystem), file(std::move(file)), cls(cls) { }
+
+    size_t read(char *buf, size_t len) override {
+        return file->read(buf, len);
+    }
+
+    size_t write(const char *buf, size_t len) override {
+        auto ret = file->write(buf, len);
+        filesystem.countWrite(cls, ret);
+        return ret;
+    }
+
+    size_t seek(size_t offset) override {
+        return file->seek(offset);
+    }
+
+    int read() override {
+        return file->read();
+    }
+
+    const char *data(size_t *size) override {
+        return file->data(size);
+    }
+
+    bool close() override {
+        return file->close();
+    }
+};
+
+const char *serializeFsWriteClass(FsWriteClass cls) {
+    switch (cls) {
+        case FsWriteClass::Transaction:
+            return "Transaction";
+        case FsWriteClass::StopTxData:
+            return "StopTxData";
+        case FsWriteClass::ChargingProfile:
+            return "ChargingProfile";
+        case FsWriteClass::Configuration:
+            return "Configuration";
+        case FsWriteClass::LocalAuthList:
+            return "LocalAuthList";
+        case FsWriteClass::Reservation:
+            return "Reservation";
+        case FsWriteClass::Certificate:
+            return "Certificate";
+        case FsWriteClass::Boot:
+            return "Boot";
+        default:
+            return "Other";
+    }
+}
+
+FsWriteClass getFsWriteClass(const char *path) {
+    const char *fname = path;
+    if (!strncmp(path, MO_FILENAME_PREFIX, sizeof(MO_FILENAME_PREFIX) - 1)) {
+        fname += sizeof(MO_FILENAME_PREFIX) - 1;
+    }
+
+    if (!strncmp(fname, "tx", strlen("tx"))) {
+        return FsWriteClass::Transaction;
+    } else if (!strncmp(fname, "sd", strlen("sd"))) {
+        return FsWriteClass::StopTxData;
+    } else if (!strncmp(fname, "sc-", strlen("sc-"))) {
+        return FsWriteClass::ChargingProfile;
+    } else if (!strncmp(fname, "ocpp-config", strlen("ocpp-config")) ||
+            !strncmp(fname, "ocpp-vars-", strlen("ocpp-vars-")) ||
+            !strncmp(fname, "client-state", strlen("client-state"))) {
+        return FsWriteClass::Configuration;
+    } else if (!strncmp(fname, "localauth", strlen("localauth"))) {
+        return FsWriteClass::LocalAuthList;
+    } else if (!strncmp(fname, "rsv-", strlen("rsv-")) ||
+            !strncmp(fname, "reservations", strlen("reservations"))) {
+        return FsWriteClass::Reservation;
+    } else if (!strncmp(fname, "cert-", strlen("cert-"))) {
+        return FsWriteClass::Certificate;
+    } else if (!strncmp(fname, "bootstats", strlen("bootstats"))) {
+        return FsWriteClass::Boot;
+    }
+    return FsWriteClass::Other;
+}
+
+} //end namespace MicroOcpp
+
+WearAccountingFilesystemAdapter::WearAccountingFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem)
+        : MemoryManaged("FilesystemWear"), filesystem(std::move(filesystem)) {
+    for (size_t i = 0; i < (size_t) FsWriteClass::COUNT; i++) {
+        windows[i] = MO_FS_WEAR_WINDOW;
+    }
+}
+
+int WearAccountingFilesystemAdapter::stat(const char *path, size_t *size) {
+    return filesystem->stat(path, size);
+}
+
+std::unique_ptr<FileAdapter> WearAccountingFilesystemAdapter::open(const char *path, const char *mode) {
+    auto file = filesystem->open(path, mode);
+    if (!file || !strcmp(mode, "r")) {
+        return file;
+    }
+
+    auto cls = getFsWriteClass(path);
+    stats[(size_t) cls].fileWrites++;
+    return std::unique_ptr<FileAdapter>(new WearAccountingFileAdapter(*this, std::move(file), cls));
+}
+
+bool WearAccountingFilesystemAdapter::remove(const char *path) {
+    stats[(size_t) getFsWriteClass(path)].removes++;
+    return filesystem->remove(path);
+}
+
+int WearAccountingFilesystemAdapter::ftw_root(std::function<int(const char *fpath)> fn) {
+    return filesystem->ftw_root(fn);
+}
+
+void WearAccountingFilesystemAdapter::loop() {
+    filesystem->loop();
+}
+
+bool WearAccountingFilesystemAdapter::flush() {
+    return filesystem->flush();
+}
+
+bool WearAccountingFilesystemAdapter::flush(const char *path) {
+    return filesystem->flush(path);
+}
+
+void WearAccountingFilesystemAdapter::countWrite(FsWriteClass cls, size_t len) {
+    auto i = (size_t) cls;
+    stats[i].bytesWritten += len;
+
+    if (isOverBudget(cls) && !overBudgetReported[i]) {
+        MO_DBG_WARN("%s files exceeded write budget (%zu B). Coalesce with %lums", serializeFsWriteClass(cls), budgets[i], (unsigned long) MO_FS_WEAR_OVERBUDGET_WINDOW);
+        overBudgetReported[i] = true;
+    }
+}
+
+const FsWriteStats& WearAccountingFilesystemAdapter::getStats(FsWriteClass cls) const {
+    return stats[(size_t) cls];
+}
+
+FsWriteStats WearAccountingFilesystemAdapter::getTotalStats() const {
+    FsWriteStats total;
+    for (size_t i = 0; i < (size_t) FsWriteClass::COUNT; i++) {
+        total.bytesWritten += stats[i].bytesWritten;
+        total.fileWrites += stats[i].fileWrites;
+        total.removes += stats[i].removes;
+    }
+    return total;
+}
+
+void WearAccountingFilesystemAdapter::resetStats() {
+    for (size_t i = 0; i < (size_t) FsWriteClass::COUNT; i++) {
+        stats[i] = FsWriteStats();
+        overBudgetReported[i] = false;
+    }
+}
+
+void WearAccountingFilesystemAdapter::setBudget(FsWriteClass cls, size_t bytes) {
+    budgets[(size_t) cls] = bytes;
+}
+
+bool WearAccountingFilesystemAdapter::isOverBudget(FsWriteClass cls) const {
+    auto i = (size_t) cls;
+    return budgets[i] > 0 && stats[i].bytesWritten > budgets[i];
+}
+
+void WearAccountingFilesystemAdapter::setCoalescingWindow(FsWriteClass cls, unsigned long ms) {
+    windows[(size_t) cls] = ms;
+}
+
+unsigned long WearAccountingFilesystemAdapter::getCoalescingWindow(const char *path) const {
+    auto cls = getFsWriteClass(path);
+    if (isOverBudget(cls) && windows[(size_t) cls] < MO_FS_WEAR_OVERBUDGET_WINDOW) {
+        return MO_FS_WEAR_OVERBUDGET_WINDOW;
+    }
+    return windows[(size_t) cls];
+}
+
+int WearAccountingFilesystemAdapter::writeReportJson(char *buf, size_t size) const {
+    auto doc = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE((size_t) FsWriteClass::COUNT + 1) + ((size_t) FsWriteClass::COUNT + 1) * JSON_OBJECT_SIZE(4));
+
+    auto writeStats = [] (JsonObject entry, const FsWriteStats& stats, size_t budget) {
+        entry["bytes"] = stats.bytesWritten;
+        entry["writes"] = stats.fileWrites;
+        entry["removes"] = stats.removes;
+        entry["budget"] = budget;
+    };
+
+    for (size_t i = 0; i < (size_t) FsWriteClass::COUNT; i++) {
+        if (stats[i].fileWrites == 0 && stats[i].removes == 0) {
+            continue;
+        }
+        writeStats(doc.createNestedObject(serializeFsWriteClass((FsWriteClass) i)), stats[i], budgets[i]);
+    }
+
+    writeStats(doc.createNestedObject("total"), getTotalStats(), 0);
+
+    if (doc.overflowed() || measureJson(doc) >= size) {
+        MO_DBG_ERR("report exceeds buffer");
+        return -1;
+    }
+
+    return (int)serializeJson(doc, buf, size);
+}
+
+namespace MicroOcpp {
+
+std::shared_ptr<WearAccountingFilesystemAdapter> makeWearAccountingFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem) {
+    if (!filesystem) {
+        return nullptr;
+    }
+
+    return std::allocate_shared<WearAccountingFilesystemAdapter>(makeAllocator<WearAccountingFilesystemAdapter>("FilesystemWear"), std::move(filesystem));
+}
+
+} //end namespace MicroOcpp
+
+#endif //MO_ENABLE_FS_WEAR
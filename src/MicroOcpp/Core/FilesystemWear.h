@@ -0,0 +1,116 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_FILESYSTEMWEAR_H
+#define MO_FILESYSTEMWEAR_H
+
+/*
+ * Wear accounting decorator for the FilesystemAdapter which accesses the flash.
+ *
+ * Counts the bytes written, the file writes and the removals per file class (transactions, StopTxData,
+ * charging profiles, configs, etc.). Each class has an optional write budget in bytes per accounting period
+ * (i.e. since the last resetStats()). A class which exceeds its budget is reported and gets the longer
+ * coalescing window MO_FS_WEAR_OVERBUDGET_WINDOW.
+ *
+ * The decorator doesn't buffer writes itself. Rapid successive rewrites are coalesced by the write-behind
+ * decorator on top of it, which takes the coalescing window per file class from this decorator:
+ *
+ *     auto flash = MicroOcpp::makeDefaultFilesystemAdapter(MicroOcpp::FilesystemOpt::Use_Mount_FormatOnFail);
+ *     auto wear = MicroOcpp::makeWearAccountingFilesystemAdapter(flash);
+ *     auto writeBehind = MicroOcpp::makeWriteBehindFilesystemAdapter(wear);
+ *     writeBehind->setCoalescingWindow([wear] (const char *path) {return wear->getCoalescingWindow(path);});
+ *     mocpp_initialize(connection, credentials, writeBehind);
+ *
+ * The decorator is not thread-safe. In the write-behind background mode, only read the report while the
+ * background thread is idle.
+ */
+
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/Memory.h>
+
+#ifndef MO_ENABLE_FS_WEAR
+#define MO_ENABLE_FS_WEAR 0
+#endif
+
+#if MO_ENABLE_FS_WEAR
+
+#ifndef MO_FS_WEAR_WINDOW
+#define MO_FS_WEAR_WINDOW 100 //ms; default coalescing window of all file classes
+#endif
+
+#ifndef MO_FS_WEAR_OVERBUDGET_WINDOW
+#define MO_FS_WEAR_OVERBUDGET_WINDOW 5000 //ms; coalescing window of file classes which exceeded their write budget
+#endif
+
+namespace MicroOcpp {
+
+enum class FsWriteClass {
+    Transaction,     //tx*
+    StopTxData,      //sd*
+    ChargingProfile, //sc-*
+    Configuration,   //ocpp-config*, ocpp-vars-*, client-state*
+    LocalAuthList,   //localauth*
+    Reservation,     //rsv-*, reservations*
+    Certificate,     //cert-*
+    Boot,            //bootstats*
+    Other,
+    COUNT
+};
+
+const char *serializeFsWriteClass(FsWriteClass cls);
+
+FsWriteClass getFsWriteClass(const char *path);
+
+struct FsWriteStats {
+    size_t bytesWritten = 0;
+    unsigned int fileWrites = 0; //number of files opened for writing or appending
+    unsigned int removes = 0;
+};
+
+class WearAccountingFilesystemAdapter : public FilesystemAdapter, public MemoryManaged {
+private:
+    std::shared_ptr<FilesystemAdapter> filesystem;
+
+    FsWriteStats stats [(size_t) FsWriteClass::COUNT];
+    size_t budgets [(size_t) FsWriteClass::COUNT] = {0}; //0: unlimited
+    unsigned long windows [(size_t) FsWriteClass::COUNT];
+    bool overBudgetReported [(size_t) FsWriteClass::COUNT] = {false};
+public:
+    WearAccountingFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem);
+
+    int stat(const char *path, size_t *size) override;
+    std::unique_ptr<FileAdapter> open(const char *path, const char *mode) override;
+    bool remove(const char *path) override;
+    int ftw_root(std::function<int(const char *fpath)> fn) override;
+
+    void loop() override;
+    bool flush() override;
+    bool flush(const char *path) override;
+
+    void countWrite(FsWriteClass cls, size_t len); //used by the accounting FileAdapter
+
+    const FsWriteStats& getStats(FsWriteClass cls) const;
+    FsWriteStats getTotalStats() const;
+    void resetStats(); //start new accounting period
+
+    void setBudget(FsWriteClass cls, size_t bytes); //write budget per accounting period. 0: unlimited
+    bool isOverBudget(FsWriteClass cls) const;
+
+    void setCoalescingWindow(FsWriteClass cls, unsigned long ms);
+    unsigned long getCoalescingWindow(const char *path) const;
+
+    /*
+     * Write the stats of the current accounting period as JSON object:
+     *     {"Transaction":{"bytes":1234,"writes":5,"removes":1,"budget":0},...,"total":{...}}
+     * Classes without any writes are omitted. Returns the number of bytes written or -1 if buf is too small
+     */
+    int writeReportJson(char *buf, size_t size) const;
+};
+
+std::shared_ptr<WearAccountingFilesystemAdapter> makeWearAccountingFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem);
+
+} //end namespace MicroOcpp
+
+#endif //MO_ENABLE_FS_WEAR
+#endif
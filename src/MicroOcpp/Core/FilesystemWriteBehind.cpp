@@ -0,0 +1,438 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/FilesystemWriteBehind.h>
+
+#if MO_ENABLE_FS_WRITE_BEHIND
+
+#include <string.h>
+#include <algorithm>
+
+#include <MicroOcpp/Core/LoopBudget.h>
+#include <MicroOcpp/Platform.h>
+#include <MicroOcpp/Debug.h>
+
+#if MO_FS_WRITE_BEHIND_THREADSAFE
+#define MO_WB_LOCK(mtx) std::lock_guard<decltype(mtx)> lock_##mtx {mtx}
+#else
+#define MO_WB_LOCK(mtx) (void)0
+#endif
+
+using namespace MicroOcpp;
+
+namespace MicroOcpp {
+
+/*
+ * Collects the written data in RAM and commits it to the pending queue when closed
+ */
+class WriteBehindFileAdapter : public FileAdapter, public MemoryManaged {
+private:
+    WriteBehindFilesystemAdapter& filesystem;
+    std::shared_ptr<WriteBehindFilesystemAdapter::PendingWrite> file;
+    size_t pos = 0;
+public:
+    WriteBehindFileAdapter(WriteBehindFilesystemAdapter& filesystem, std::shared_ptr<WriteBehindFilesystemAdapter::PendingWrite> file)
+            : MemoryManaged("FilesystemWriteBehind"), filesystem(filesystem), file(std::move(file)) { }
+
+    ~WriteBehindFileAdapter() {
+        close();
+    }
+
+    bool close() override {
+        if (file) {
+            filesystem.commit(std::move(file));
+        }
+        return true; //errors of the underlying filesystem are reported by flush()
+    }
+
+    size_t read(char *buf, size_t len) override {
+        return 0;
+    }
+
+    size_t write(const char *buf, size_t len) override {
+        auto& data = file->data;
+        if (pos + len > data.size()) {
+            data.resize(pos + len);
+        }
+        memcpy(data.data() + pos, buf, len);
+        pos += len;
+        return len;
+    }
+
+    size_t seek(size_t offset) override {
+        if (offset > file->data.size()) {
+            return -1;
+        }
+        pos = offset;
+        return 0;
+    }
+
+    int read() override {
+        return -1;
+    }
+};
+
+/*
+ * Reads the data of a pending write. Pending writes are immutable after the commit, so the data can be
+ * shared with the flush routine
+ */
+class PendingFileAdapter : public FileAdapter, public MemoryManaged {
+private:
+    std::shared_ptr<WriteBehindFilesystemAdapter::PendingWrite> file;
+    size_t pos = 0;
+public:
+    PendingFileAdapter(std::shared_ptr<WriteBehindFilesystemAdapter::PendingWrite> file)
+            : MemoryManaged("FilesystemWriteBehind"), file(std::move(file)) { }
+
+    size_t read(char *buf, size_t len) override {
+        auto& data = file->data;
+        len = std::min(len, data.size() - pos);
+        memcpy(buf, data.data() + pos, len);
+        pos += len;
+        return len;
+    }
+
+    size_t write(const char *buf, size_t len) override {
+        return 0;
+    }
+
+    size_t seek(size_t offset) override {
+        if (offset > file->data.size()) {
+            return -1;
+        }
+        pos = offset;
+        return 0;
+    }
+
+    int read() override {
+        if (pos >= file->data.size()) {
+            return -1;
+        }
+        return (unsigned char) file->data[pos++];
+    }
+
+    const char *data(size_t *size) override {
+        *size = file->data.size();
+        return file->data.data();
+    }
+};
+
+} //end namespace MicroOcpp
+
+WriteBehindFilesystemAdapter::PendingWrite::PendingWrite(const char *path)
+        : MemoryManaged("FilesystemWriteBehind"), path(makeString(getMemoryTag(), path)), data(makeVector<char>(getMemoryTag())) {
+
+}
+
+WriteBehindFilesystemAdapter::WriteBehindFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem, bool backgroundFlush)
+        : MemoryManaged("FilesystemWriteBehind"), filesystem(std::move(filesystem)), backgroundFlush(backgroundFlush), pending(makeVector<std::shared_ptr<PendingWrite>>(getMemoryTag())) {
+
+}
+
+WriteBehindFilesystemAdapter::~WriteBehindFilesystemAdapter() {
+    flush();
+}
+
+std::shared_ptr<WriteBehindFilesystemAdapter::PendingWrite> WriteBehindFilesystemAdapter::getLatest(const char *path) {
+    for (auto it = pending.rbegin(); it != pending.rend(); it++) {
+        if ((*it)->path.compare(path) == 0) {
+            return *it;
+        }
+    }
+    return nullptr;
+}
+
+void WriteBehindFilesystemAdapter::commit(std::shared_ptr<PendingWrite> write) {
+    if (!write) {
+        return;
+    }
+
+    write->timestamp = mocpp_tick_ms();
+
+    size_t pendingCount = 0;
+
+    {
+        MO_WB_LOCK(pendingMutex);
+
+        auto latest = getLatest(write->path.c_str());
+        if (latest && !latest->inflight) {
+            //coalesce: latest write wins. Move to the back to keep the commit order across files, but keep the
+            //time of the first pending write, so that frequently updated files don't starve
+            write->timestamp = latest->timestamp;
+            pending.erase(std::remove(pending.begin(), pending.end(), latest), pending.end());
+        }
+        pending.push_back(std::move(write));
+
+        pendingCount = pending.size();
+    }
+
+    if (pendingCount > MO_FS_WRITE_BEHIND_MAX_PENDING) {
+        MO_DBG_DEBUG("write-behind queue full, write synchronously");
+        flushNext(true);
+    }
+}
+
+bool WriteBehindFilesystemAdapter::flushNext(bool force) {
+    MO_WB_LOCK(ioMutex); //at most one flush routine at a time
+
+    std::shared_ptr<PendingWrite> write;
+
+    {
+        MO_WB_LOCK(pendingMutex);
+
+        if (pending.empty()) {
+            return false;
+        }
+
+        if (force) {
+            write = pending.front();
+        } else {
+            //oldest write whose coalescing window has elapsed. Files with a long window don't block the others
+            auto now = mocpp_tick_ms();
+            for (auto& candidate : pending) {
+                unsigned long delay = coalescingWindow ? coalescingWindow(candidate->path.c_str()) : MO_FS_WRITE_BEHIND_DELAY;
+                delay = std::min(delay, (unsigned long) MO_FS_WRITE_BEHIND_MAX_DEFERRAL);
+                if (now - candidate->timestamp >= delay) {
+                    write = candidate;
+                    break;
+                }
+            }
+
+            if (!write) {
+                return false; //wait for further writes to coalesce
+            }
+        }
+    }
+
+    return persist(std::move(write));
+}
+
+bool WriteBehindFilesystemAdapter::persist(std::shared_ptr<PendingWrite> write) {
+
+    {
+        MO_WB_LOCK(pendingMutex);
+
+        if (std::find(pending.begin(), pending.end(), write) == pending.end()) {
+            return true; //superseded in the meantime
+        }
+
+        write->inflight = true; //further writes to this file are appended to the queue
+    }
+
+    bool success = true;
+
+    if (write->remove) {
+        size_t size;
+        if (filesystem->stat(write->path.c_str(), &size) == 0) {
+            success = filesystem->remove(write->path.c_str());
+        }
+    } else {
+        auto file = filesystem->open(write->path.c_str(), "w");
+        if (file) {
+            success = file->write(write->data.data(), write->data.size()) == write->data.size();
+            success &= file->close();
+        } else {
+            success = false;
+        }
+    }
+
+    {
+        MO_WB_LOCK(pendingMutex);
+
+        write->inflight = false;
+
+        if (success || getLatest(write->path.c_str()) != write) {
+            pending.erase(std::remove(pending.begin(), pending.end(), write), pending.end());
+        } else {
+            //keep the failed write in the queue and retry after the coalescing window
+            MO_DBG_ERR("FS error: %s", write->path.c_str());
+            write->timestamp = mocpp_tick_ms();
+        }
+    }
+
+    return success;
+}
+
+int WriteBehindFilesystemAdapter::stat(const char *path, size_t *size) {
+    std::shared_ptr<PendingWrite> latest;
+    {
+        MO_WB_LOCK(pendingMutex);
+        latest = getLatest(path);
+    }
+
+    if (latest) {
+        if (latest->remove) {
+            return -1;
+        }
+        *size = latest->data.size();
+        return 0;
+    }
+
+    MO_WB_LOCK(ioMutex);
+    return filesystem->stat(path, size);
+}
+
+std::unique_ptr<FileAdapter> WriteBehindFilesystemAdapter::open(const char *path, const char *mode) {
+    if (!strcmp(mode, "r")) {
+        std::shared_ptr<PendingWrite> latest;
+        {
+            MO_WB_LOCK(pendingMutex);
+            latest = getLatest(path);
+        }
+
+        if (latest) {
+            if (latest->remove) {
+                return nullptr;
+            }
+            return std::unique_ptr<FileAdapter>(new PendingFileAdapter(std::move(latest)));
+        }
+
+        MO_WB_LOCK(ioMutex);
+        return filesystem->open(path, "r");
+    } else if (!strcmp(mode, "w")) {
+        auto write = std::allocate_shared<PendingWrite>(makeAllocator<PendingWrite>(getMemoryTag()), path);
+        return std::unique_ptr<FileAdapter>(new WriteBehindFileAdapter(*this, std::move(write)));
+    } else if (!strcmp(mode, "a")) {
+        //appends bypass the buffer. Persist pending writes first, so that the append extends the latest file version
+        MO_WB_LOCK(ioMutex);
+        if (!flush(path)) {
+            MO_DBG_ERR("cannot append to %s", path);
+            return nullptr;
+        }
+        return filesystem->open(path, "a");
+    } else {
+        MO_DBG_ERR("only support r, w or a");
+        return nullptr;
+    }
+}
+
+bool WriteBehindFilesystemAdapter::remove(const char *path) {
+    size_t size;
+    bool exists = stat(path, &size) == 0;
+
+    auto write = std::allocate_shared<PendingWrite>(makeAllocator<PendingWrite>(getMemoryTag()), path);
+    write->remove = true;
+    commit(std::move(write));
+
+    return exists;
+}
+
+int WriteBehindFilesystemAdapter::ftw_root(std::function<int(const char *fpath)> fn) {
+
+    //snapshot of the pending state. fn may modify the pending queue
+    auto pendingFiles = makeVector<String>(getMemoryTag()); //files created by pending writes
+    auto shadowedFiles = makeVector<String>(getMemoryTag()); //files whose latest state is pending
+
+    {
+        MO_WB_LOCK(pendingMutex);
+        for (auto& write : pending) {
+            if (write->path.size() < sizeof(MO_FILENAME_PREFIX) - 1) {
+                continue;
+            }
+            auto fname = makeString(getMemoryTag(), write->path.c_str() + sizeof(MO_FILENAME_PREFIX) - 1);
+            if (std::find(shadowedFiles.begin(), shadowedFiles.end(), fname) == shadowedFiles.end()) {
+                shadowedFiles.push_back(fname);
+            }
+            if (getLatest(write->path.c_str()) == write && !write->remove) {
+                pendingFiles.push_back(std::move(fname));
+            }
+        }
+    }
+
+    int err = 0;
+
+    {
+        MO_WB_LOCK(ioMutex);
+        err = filesystem->ftw_root([&shadowedFiles, &fn] (const char *fname) -> int {
+            for (auto& shadowed : shadowedFiles) {
+                if (shadowed.compare(fname) == 0) {
+                    return 0; //skip; will be reported with the pending files
+                }
+            }
+            return fn(fname);
+        });
+    }
+
+    if (err) {
+        return err;
+    }
+
+    for (auto& fname : pendingFiles) {
+        err = fn(fname.c_str());
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+void WriteBehindFilesystemAdapter::loop() {
+    if (!backgroundFlush) {
+        if (!LoopBudget::exhausted()) {
+            flushNext(false);
+        } else if (getPendingCount() > 0) {
+            LoopBudget::countYield(); //write pending file in the next loop
+        }
+    }
+    filesystem->loop();
+}
+
+bool WriteBehindFilesystemAdapter::flush() {
+    MO_WB_LOCK(ioMutex); //block background thread until barrier has finished
+
+    decltype(pending) snapshot = makeVector<std::shared_ptr<PendingWrite>>(getMemoryTag());
+    {
+        MO_WB_LOCK(pendingMutex);
+        snapshot = pending;
+    }
+
+    bool success = true;
+    for (auto& write : snapshot) {
+        success &= persist(write);
+    }
+
+    return filesystem->flush() && success;
+}
+
+bool WriteBehindFilesystemAdapter::flush(const char *path) {
+    MO_WB_LOCK(ioMutex);
+
+    std::shared_ptr<PendingWrite> write;
+    {
+        MO_WB_LOCK(pendingMutex);
+        write = getLatest(path);
+    }
+
+    bool success = !write || persist(std::move(write));
+
+    return filesystem->flush(path) && success;
+}
+
+bool WriteBehindFilesystemAdapter::flushStep() {
+    return flushNext(false);
+}
+
+size_t WriteBehindFilesystemAdapter::getPendingCount() {
+    MO_WB_LOCK(pendingMutex);
+    return pending.size();
+}
+
+void WriteBehindFilesystemAdapter::setCoalescingWindow(std::function<unsigned long(const char *path)> window) {
+    coalescingWindow = std::move(window);
+}
+
+namespace MicroOcpp {
+
+std::shared_ptr<WriteBehindFilesystemAdapter> makeWriteBehindFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem, bool backgroundFlush) {
+    if (!filesystem) {
+        return nullptr;
+    }
+
+    return std::allocate_shared<WriteBehindFilesystemAdapter>(makeAllocator<WriteBehindFilesystemAdapter>("FilesystemWriteBehind"), std::move(filesystem), backgroundFlush);
+}
+
+} //end namespace MicroOcpp
+
+#endif //MO_ENABLE_FS_WRITE_BEHIND
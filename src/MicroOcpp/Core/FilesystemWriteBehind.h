@@ -0,0 +1,127 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_FILESYSTEMWRITEBEHIND_H
+#define MO_FILESYSTEMWRITEBEHIND_H
+
+/*
+ * Write-behind decorator for any FilesystemAdapter.
+ *
+ * Files opened in "w" mode are buffered in RAM and committed to a pending queue when the FileAdapter is
+ * destroyed. Pending writes are persisted later, either one file per loop() call (timeslice mode) or by a
+ * background thread which calls flushStep() (background mode). Repeated writes to the same file are
+ * coalesced before they reach the flash, i.e. only the latest version gets written. All read accesses
+ * (stat, open "r", ftw_root) see the pending state, so that the decorator is transparent to MO. Files opened
+ * in "a" mode are written through to the underlying filesystem after persisting all pending writes.
+ *
+ * flush() is the durability barrier: it returns after all pending writes have been persisted. flush(path) does
+ * the same for a single file; MO calls it for the transaction files after each commit. Failed writes stay in
+ * the queue and are retried.
+ *
+ * Usage:
+ *
+ *     auto filesystem = MicroOcpp::makeDefaultFilesystemAdapter(MicroOcpp::FilesystemOpt::Use_Mount_FormatOnFail);
+ *     mocpp_initialize(connection, credentials, MicroOcpp::makeWriteBehindFilesystemAdapter(filesystem));
+ */
+
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/Memory.h>
+
+#ifndef MO_ENABLE_FS_WRITE_BEHIND
+#define MO_ENABLE_FS_WRITE_BEHIND 0
+#endif
+
+#if MO_ENABLE_FS_WRITE_BEHIND
+
+#ifndef MO_FS_WRITE_BEHIND_THREADSAFE
+#define MO_FS_WRITE_BEHIND_THREADSAFE 1 //set to 0 on toolchains without std::mutex. Then only the timeslice mode is available
+#endif
+
+#ifndef MO_FS_WRITE_BEHIND_DELAY
+#define MO_FS_WRITE_BEHIND_DELAY 100 //ms; keep pending writes for this time so that subsequent writes to the same file can be coalesced
+#endif
+
+#ifndef MO_FS_WRITE_BEHIND_MAX_DEFERRAL
+#define MO_FS_WRITE_BEHIND_MAX_DEFERRAL 30000 //ms; upper limit for the coalescing windows per file
+#endif
+
+#ifndef MO_FS_WRITE_BEHIND_MAX_PENDING
+#define MO_FS_WRITE_BEHIND_MAX_PENDING 16 //max number of buffered files. If exceeded, the oldest file is written synchronously
+#endif
+
+#if MO_FS_WRITE_BEHIND_THREADSAFE
+#include <mutex>
+#endif
+
+namespace MicroOcpp {
+
+class WriteBehindFilesystemAdapter : public FilesystemAdapter, public MemoryManaged {
+public:
+    struct PendingWrite : public MemoryManaged {
+        String path;
+        Vector<char> data;
+        bool remove = false; //true: pending write is a file deletion
+        bool inflight = false; //currently being written to the underlying filesystem
+        unsigned long timestamp = 0; //first write since the file was last persisted
+
+        PendingWrite(const char *path);
+    };
+private:
+    std::shared_ptr<FilesystemAdapter> filesystem;
+    bool backgroundFlush = false;
+
+    Vector<std::shared_ptr<PendingWrite>> pending; //in commit order
+
+    std::function<unsigned long(const char *path)> coalescingWindow; //optional, overrides MO_FS_WRITE_BEHIND_DELAY per file
+
+#if MO_FS_WRITE_BEHIND_THREADSAFE
+    std::mutex pendingMutex; //guards pending
+    std::recursive_mutex ioMutex; //guards access to underlying filesystem
+#endif
+
+    std::shared_ptr<PendingWrite> getLatest(const char *path); //caller must hold pendingMutex
+
+    bool flushNext(bool force);
+    bool persist(std::shared_ptr<PendingWrite> write); //caller must hold ioMutex
+public:
+    WriteBehindFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem, bool backgroundFlush = false);
+    ~WriteBehindFilesystemAdapter();
+
+    int stat(const char *path, size_t *size) override;
+    std::unique_ptr<FileAdapter> open(const char *path, const char *mode) override;
+    bool remove(const char *path) override;
+    int ftw_root(std::function<int(const char *fpath)> fn) override;
+
+    void loop() override; //timeslice mode: write at most one pending file
+    bool flush() override; //durability barrier: write all pending files. Returns false on FS errors
+    bool flush(const char *path) override; //write pending state of this file only
+
+    /*
+     * Background mode: write the oldest pending file whose coalescing delay has elapsed. Call repeatedly
+     * from the background thread. Returns true if a file has been written
+     */
+    bool flushStep();
+
+    size_t getPendingCount();
+
+    /*
+     * Coalescing delay per file in ms, e.g. by file class (see FilesystemWear.h). Defaults to
+     * MO_FS_WRITE_BEHIND_DELAY for all files and is capped at MO_FS_WRITE_BEHIND_MAX_DEFERRAL. The delay
+     * counts from the first write after the file was last persisted. Set before mocpp_initialize()
+     */
+    void setCoalescingWindow(std::function<unsigned long(const char *path)> window);
+
+    void commit(std::shared_ptr<PendingWrite> write); //used by the buffering FileAdapter
+};
+
+/*
+ * Wrap filesystem into the write-behind decorator. If backgroundFlush is true, then mocpp_loop() doesn't
+ * write pending files and the host application must call flushStep() from a separate thread
+ */
+std::shared_ptr<WriteBehindFilesystemAdapter> makeWriteBehindFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem, bool backgroundFlush = false);
+
+} //end namespace MicroOcpp
+
+#endif //MO_ENABLE_FS_WRITE_BEHIND
+#endif
@@ -87,6 +87,22 @@ public:
                 std::function<void(MO_FtpCloseReason reason)> onClose,
                 const char *ca_cert = nullptr) = 0; // nullptr to disable cert check; will be ignored for non-TLS connections
 
+    /*
+     * Continue a previous download at byte `offset` (FTP REST). fileWriter receives the file content after offset.
+     * FTP clients which don't support resuming can keep this default implementation which only accepts offset 0
+     */
+    virtual std::unique_ptr<FtpDownload> getFileFrom(
+                const char *ftp_url, // ftp[s]://[user[:pass]@]host[:port][/directory]/filename
+                size_t offset,
+                std::function<size_t(unsigned char *data, size_t len)> fileWriter,
+                std::function<void(MO_FtpCloseReason reason)> onClose,
+                const char *ca_cert = nullptr) {
+        if (offset > 0) {
+            return nullptr;
+        }
+        return getFile(ftp_url, fileWriter, onClose, ca_cert);
+    }
+
     virtual std::unique_ptr<FtpUpload> postFile(
                 const char *ftp_url, // ftp[s]://[user[:pass]@]host[:port][/directory]/filename
                 std::function<size_t(unsigned char *out, size_t buffsize)> fileReader, //write at most buffsize bytes into out-buffer. Return number of bytes written
@@ -17,6 +17,7 @@
 #include "mbedtls/error.h"
 
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Core/LoopBudget.h>
 #include <MicroOcpp/Debug.h>
 
 namespace MicroOcpp {
@@ -66,6 +67,9 @@ private:
     std::function<size_t(unsigned char *out, size_t bufsize)> fileReader;
     std::function<void(MO_FtpCloseReason)> onClose;
 
+    size_t restOffset = 0; //resume download at this offset
+    bool restPending = false; //sent REST, awaiting 350
+
     enum class Method {
         Retrieve,  //download file
         Store,     //upload file
@@ -85,10 +89,10 @@ private:
     void send_cmd(const char *cmd, const char *arg = nullptr, bool disable_tls_policy = false);
 
     void process_ctrl();
-    void process_data();
+    bool process_data(); //returns true if data has been transferred and process_data can be called again
 
     unsigned char *data_buf = nullptr;
-    size_t data_buf_size = 4096;
+    size_t data_buf_size = MO_FTP_DATA_BUF_SIZE;
     size_t data_buf_avail = 0;
     size_t data_buf_offs = 0;
 
@@ -103,7 +107,8 @@ public:
     bool getFile(const char *ftp_url, // ftp[s]://[user[:pass]@]host[:port][/directory]/filename
             std::function<size_t(unsigned char *data, size_t len)> fileWriter,
             std::function<void(MO_FtpCloseReason)> onClose,
-            const char *ca_cert = nullptr); // nullptr to disable cert check; will be ignored for non-TLS connections
+            const char *ca_cert = nullptr, // nullptr to disable cert check; will be ignored for non-TLS connections
+            size_t offset = 0); // resume download at offset
 
     bool postFile(const char *ftp_url, // ftp[s]://[user[:pass]@]host[:port][/directory]/filename
             std::function<size_t(unsigned char *out, size_t buffsize)> fileReader, //write at most buffsize bytes into out-buffer. Return number of bytes written
@@ -125,6 +130,12 @@ public:
             std::function<void(MO_FtpCloseReason)> onClose,
             const char *ca_cert = nullptr) override; // nullptr to disable cert check; will be ignored for non-TLS connections
 
+    std::unique_ptr<FtpDownload> getFileFrom(const char *ftp_url, // ftp[s]://[user[:pass]@]host[:port][/directory]/filename
+            size_t offset,
+            std::function<size_t(unsigned char *data, size_t len)> fileWriter,
+            std::function<void(MO_FtpCloseReason)> onClose,
+            const char *ca_cert = nullptr) override; // nullptr to disable cert check; will be ignored for non-TLS connections
+
     std::unique_ptr<FtpUpload> postFile(const char *ftp_url, // ftp[s]://[user[:pass]@]host[:port][/directory]/filename
             std::function<size_t(unsigned char *out, size_t buffsize)> fileReader, //write at most buffsize bytes into out-buffer. Return number of bytes written
             std::function<void(MO_FtpCloseReason)> onClose,
@@ -452,7 +463,7 @@ void FtpTransferMbedTLS::send_cmd(const char *cmd, const char *arg, bool disable
     }
 }
 
-bool FtpTransferMbedTLS::getFile(const char *ftp_url_raw, std::function<size_t(unsigned char *data, size_t len)> fileWriter, std::function<void(MO_FtpCloseReason)> onClose, const char *ca_cert) {
+bool FtpTransferMbedTLS::getFile(const char *ftp_url_raw, std::function<size_t(unsigned char *data, size_t len)> fileWriter, std::function<void(MO_FtpCloseReason)> onClose, const char *ca_cert, size_t offset) {
 
     if (method != Method::UNDEFINED) {
         MO_DBG_ERR("FTP Client reuse not supported");
@@ -468,13 +479,14 @@ bool FtpTransferMbedTLS::getFile(const char *ftp_url_raw, std::function<size_t(u
     this->method = Method::Retrieve;
     this->fileWriter = fileWriter;
     this->onClose = onClose;
+    this->restOffset = offset;
 
     if (!read_url_ctrl(ftp_url_raw)) {
         MO_DBG_ERR("could not parse URL");
         return false;
     }
 
-    MO_DBG_DEBUG("init download from %s: %s", ctrl_host.c_str(), fname.c_str());
+    MO_DBG_DEBUG("init download from %s: %s, offset %zu", ctrl_host.c_str(), fname.c_str(), offset);
 
     if (auto ret = setup_tls()) {
         MO_DBG_ERR("could not setup MbedTLS: %i", ret);
@@ -636,7 +648,13 @@ void FtpTransferMbedTLS::process_ctrl() {
                 return;
             }
 
-            if (method == Method::Retrieve) {
+            if (method == Method::Retrieve && restOffset > 0) {
+                MO_DBG_DEBUG("resume download at %zu", restOffset);
+                char offsetStr [24];
+                snprintf(offsetStr, sizeof(offsetStr), "%zu", restOffset);
+                restPending = true;
+                send_cmd("REST", offsetStr);
+            } else if (method == Method::Retrieve) {
                 MO_DBG_DEBUG("request download for %s", fname.c_str());
                 send_cmd("RETR", fname.c_str());
             } else if (method == Method::Store) {
@@ -648,6 +666,14 @@ void FtpTransferMbedTLS::process_ctrl() {
                 return;
             }
 
+        } else if (restPending && !strncmp("350", line, 3)) { // Requested file action pending further information (REST accepted)
+            restPending = false;
+            MO_DBG_DEBUG("request download for %s", fname.c_str());
+            send_cmd("RETR", fname.c_str());
+        } else if (restPending) {
+            MO_DBG_WARN("FTP server doesn't support REST: %s", line);
+            send_cmd("QUIT");
+            return;
         } else if (!strncmp("150", line, 3)    // File status okay; about to open data connection
                 || !strncmp("125", line, 3)) { // Data connection already open
             MO_DBG_DEBUG("data connection accepted");
@@ -674,9 +700,9 @@ void FtpTransferMbedTLS::process_ctrl() {
     }
 }
 
-void FtpTransferMbedTLS::process_data() {
+bool FtpTransferMbedTLS::process_data() {
     if (!data_conn_accepted) {
-        return;
+        return false;
     }
 
     if (isSecure && !data_ssl_established) {
@@ -684,7 +710,7 @@ void FtpTransferMbedTLS::process_data() {
         MO_DBG_ERR("internal error");
         close_data(MO_FtpCloseReason_Failure);
         send_cmd("QUIT", nullptr, true);
-        return;
+        return false;
     }
 
     if (method == Method::Retrieve) {
@@ -703,16 +729,16 @@ void FtpTransferMbedTLS::process_data() {
 
             if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
                 //no new input data to be processed
-                return;
+                return false;
             } else if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || ret == 0) {
                 //download finished
                 close_data(MO_FtpCloseReason_Success);
-                return;
+                return false;
             } else if (ret < 0) {
                 MO_DBG_ERR("mbedtls_net_recv: %i", ret);
                 close_data(MO_FtpCloseReason_Failure);
                 send_cmd("QUIT");
-                return;
+                return false;
             }
 
             data_buf_avail = ret;
@@ -724,7 +750,7 @@ void FtpTransferMbedTLS::process_data() {
             MO_DBG_ERR("fileWriter aborted download");
             close_data(MO_FtpCloseReason_Failure);
             send_cmd("QUIT");
-            return;
+            return false;
         } else if (ret <= data_buf_avail) {
             data_buf_avail -= ret;
             data_buf_offs += ret;
@@ -732,10 +758,11 @@ void FtpTransferMbedTLS::process_data() {
             MO_DBG_ERR("write error");
             close_data(MO_FtpCloseReason_Failure);
             send_cmd("QUIT");
-            return;
+            return false;
         }
 
         //success
+        return true;
     } else if (method == Method::Store) {
 
         if (data_buf_avail == 0) {
@@ -757,23 +784,26 @@ void FtpTransferMbedTLS::process_data() {
 
             if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
                 //no data sent, wait
-                return;
+                return false;
             } else if (ret <= 0) {
                 MO_DBG_ERR("mbedtls_ssl_write: %i", ret);
                 close_data(MO_FtpCloseReason_Failure);
                 send_cmd("QUIT");
-                return;
+                return false;
             }
 
             //successful write
             data_buf_avail -= ret;
             data_buf_offs += ret;
+            return true;
         } else {
             //no data in fileReader anymore
             MO_DBG_DEBUG("finished file reading");
             close_data(MO_FtpCloseReason_Success);
         }
     }
+
+    return false;
 }
 
 void FtpTransferMbedTLS::loop() {
@@ -782,8 +812,15 @@ void FtpTransferMbedTLS::loop() {
         process_ctrl();
     }
 
-    if (data_opened) {
-        process_data();
+    //transfer a few chunks per call to keep up with fast links without blocking the loop for too long
+    for (unsigned int i = 0; data_opened && i < MO_FTP_DATA_CHUNKS_PER_LOOP; i++) {
+        if (i > 0 && LoopBudget::exhausted()) {
+            LoopBudget::countYield();
+            break;
+        }
+        if (!process_data()) {
+            break;
+        }
     }
 }
 
@@ -934,6 +971,23 @@ std::unique_ptr<FtpDownload> FtpClientMbedTLS::getFile(const char *ftp_url_raw,
     }
 }
 
+std::unique_ptr<FtpDownload> FtpClientMbedTLS::getFileFrom(const char *ftp_url_raw, size_t offset, std::function<size_t(unsigned char *data, size_t len)> fileWriter, std::function<void(MO_FtpCloseReason)> onClose, const char *ca_cert) {
+
+    auto ftp_handle = std::unique_ptr<FtpTransferMbedTLS>(new FtpTransferMbedTLS(tls_only, client_cert, client_key));
+    if (!ftp_handle) {
+        MO_DBG_ERR("OOM");
+        return nullptr;
+    }
+
+    bool success = ftp_handle->getFile(ftp_url_raw, fileWriter, onClose, ca_cert, offset);
+
+    if (success) {
+        return ftp_handle;
+    } else {
+        return nullptr;
+    }
+}
+
 std::unique_ptr<FtpUpload> FtpClientMbedTLS::postFile(const char *ftp_url_raw, std::function<size_t(unsigned char *out, size_t buffsize)> fileReader, std::function<void(MO_FtpCloseReason)> onClose, const char *ca_cert) {
     
     auto ftp_handle = std::unique_ptr<FtpTransferMbedTLS>(new FtpTransferMbedTLS(tls_only, client_cert, client_key));
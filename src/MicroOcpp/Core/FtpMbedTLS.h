@@ -29,6 +29,15 @@
 
 #include <MicroOcpp/Core/Ftp.h>
 
+#ifndef MO_FTP_DATA_BUF_SIZE
+#define MO_FTP_DATA_BUF_SIZE 4096 //receive / send buffer of the data connection. Larger buffers take fewer socket reads
+#endif
+
+//max number of socket reads / writes on the data connection per loop call
+#ifndef MO_FTP_DATA_CHUNKS_PER_LOOP
+#define MO_FTP_DATA_CHUNKS_PER_LOOP 4
+#endif
+
 namespace MicroOcpp {
 
 std::unique_ptr<FtpClient> makeFtpClientMbedTLS(bool tls_only = false, const char *client_cert = nullptr, const char *client_key = nullptr);
@@ -0,0 +1,358 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/JsonScanner.h>
+
+#if MO_ENABLE_JSON_SCANNER
+
+#include <string.h>
+
+#include <ArduinoJson.h>
+
+#if MO_JSON_SCANNER_SIMD && (defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)))
+#define MO_JSON_SCANNER_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define MO_JSON_SCANNER_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if MO_JSON_SCANNER_SIMD && defined(__ARM_NEON) && defined(__aarch64__)
+#define MO_JSON_SCANNER_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define MO_JSON_SCANNER_BLOCK 64
+
+using namespace MicroOcpp;
+
+namespace MicroOcpp {
+namespace JsonScanner {
+
+/*
+ * Classify one block of MO_JSON_SCANNER_BLOCK bytes. Bit i of each mask refers to block[i]
+ */
+typedef void (*ClassifyFn)(const char *block, uint64_t& quotes, uint64_t& backslashes, uint64_t& structurals);
+
+void classifyScalar(const char *block, uint64_t& quotes, uint64_t& backslashes, uint64_t& structurals) {
+    quotes = 0;
+    backslashes = 0;
+    structurals = 0;
+    for (unsigned int i = 0; i < MO_JSON_SCANNER_BLOCK; i++) {
+        switch (block[i]) {
+            case '"':
+                quotes |= (uint64_t)1 << i;
+                break;
+            case '\\':
+                backslashes |= (uint64_t)1 << i;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                structurals |= (uint64_t)1 << i;
+                break;
+        }
+    }
+}
+
+#if MO_JSON_SCANNER_SSE2
+void classifySSE2(const char *block, uint64_t& quotes, uint64_t& backslashes, uint64_t& structurals) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lowerCase = _mm_set1_epi8(0x20); //'[' | 0x20 == '{', ']' | 0x20 == '}'
+    const __m128i curlyOpen = _mm_set1_epi8('{');
+    const __m128i curlyClose = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+
+    quotes = 0;
+    backslashes = 0;
+    structurals = 0;
+    for (unsigned int i = 0; i < MO_JSON_SCANNER_BLOCK; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (block + i));
+        __m128i vl = _mm_or_si128(v, lowerCase);
+        __m128i s = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(vl, curlyOpen), _mm_cmpeq_epi8(vl, curlyClose)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        quotes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << i;
+        backslashes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)) << i;
+        structurals |= (uint64_t)(uint16_t)_mm_movemask_epi8(s) << i;
+    }
+}
+#endif //MO_JSON_SCANNER_SSE2
+
+#if MO_JSON_SCANNER_AVX2
+__attribute__((target("avx2")))
+void classifyAVX2(const char *block, uint64_t& quotes, uint64_t& backslashes, uint64_t& structurals) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lowerCase = _mm256_set1_epi8(0x20);
+    const __m256i curlyOpen = _mm256_set1_epi8('{');
+    const __m256i curlyClose = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+
+    quotes = 0;
+    backslashes = 0;
+    structurals = 0;
+    for (unsigned int i = 0; i < MO_JSON_SCANNER_BLOCK; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (block + i));
+        __m256i vl = _mm256_or_si256(v, lowerCase);
+        __m256i s = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(vl, curlyOpen), _mm256_cmpeq_epi8(vl, curlyClose)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+        quotes |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)) << i;
+        backslashes |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)) << i;
+        structurals |= (uint64_t)(uint32_t)_mm256_movemask_epi8(s) << i;
+    }
+}
+#endif //MO_JSON_SCANNER_AVX2
+
+#if MO_JSON_SCANNER_NEON
+uint16_t movemaskNEON(uint8x16_t v) {
+    const uint8_t bitsInit [16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vandq_u8(v, vld1q_u8(bitsInit));
+    //reduce horizontally: three pairwise adds leave the low and high byte of the mask in the first two lanes
+    bits = vpaddq_u8(bits, bits);
+    bits = vpaddq_u8(bits, bits);
+    bits = vpaddq_u8(bits, bits);
+    return vgetq_lane_u16(vreinterpretq_u16_u8(bits), 0);
+}
+
+void classifyNEON(const char *block, uint64_t& quotes, uint64_t& backslashes, uint64_t& structurals) {
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t lowerCase = vdupq_n_u8(0x20);
+    const uint8x16_t curlyOpen = vdupq_n_u8('{');
+    const uint8x16_t curlyClose = vdupq_n_u8('}');
+    const uint8x16_t colon = vdupq_n_u8(':');
+    const uint8x16_t comma = vdupq_n_u8(',');
+
+    quotes = 0;
+    backslashes = 0;
+    structurals = 0;
+    for (unsigned int i = 0; i < MO_JSON_SCANNER_BLOCK; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t*) (block + i));
+        uint8x16_t vl = vorrq_u8(v, lowerCase);
+        uint8x16_t s = vorrq_u8(
+                vorrq_u8(vceqq_u8(vl, curlyOpen), vceqq_u8(vl, curlyClose)),
+                vorrq_u8(vceqq_u8(v, colon), vceqq_u8(v, comma)));
+        quotes |= (uint64_t)movemaskNEON(vceqq_u8(v, quote)) << i;
+        backslashes |= (uint64_t)movemaskNEON(vceqq_u8(v, backslash)) << i;
+        structurals |= (uint64_t)movemaskNEON(s) << i;
+    }
+}
+#endif //MO_JSON_SCANNER_NEON
+
+ClassifyFn getClassifyFn(JsonScanImpl impl) {
+    switch (impl) {
+        case JsonScanImpl::Scalar:
+            return classifyScalar;
+#if MO_JSON_SCANNER_SSE2
+        case JsonScanImpl::SSE2:
+            return classifySSE2;
+#endif
+#if MO_JSON_SCANNER_AVX2
+        case JsonScanImpl::AVX2:
+            return classifyAVX2;
+#endif
+#if MO_JSON_SCANNER_NEON
+        case JsonScanImpl::NEON:
+            return classifyNEON;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+//bit i of the result is the XOR of the bits 0 to i of x
+uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+unsigned int countTrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_ctzll(x);
+#else
+    unsigned int n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+} //namespace JsonScanner
+} //namespace MicroOcpp
+
+bool JsonScanner::isSupported(JsonScanImpl impl) {
+    switch (impl) {
+        case JsonScanImpl::Auto:
+        case JsonScanImpl::Scalar:
+            return true;
+#if MO_JSON_SCANNER_SSE2
+        case JsonScanImpl::SSE2:
+            return true;
+#endif
+#if MO_JSON_SCANNER_AVX2
+        case JsonScanImpl::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#if MO_JSON_SCANNER_NEON
+        case JsonScanImpl::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+JsonScanImpl JsonScanner::getDefaultImpl() {
+    static JsonScanImpl defaultImpl = JsonScanImpl::Auto;
+    if (defaultImpl == JsonScanImpl::Auto) {
+        if (isSupported(JsonScanImpl::AVX2)) {
+            defaultImpl = JsonScanImpl::AVX2;
+        } else if (isSupported(JsonScanImpl::SSE2)) {
+            defaultImpl = JsonScanImpl::SSE2;
+        } else if (isSupported(JsonScanImpl::NEON)) {
+            defaultImpl = JsonScanImpl::NEON;
+        } else {
+            defaultImpl = JsonScanImpl::Scalar;
+        }
+    }
+    return defaultImpl;
+}
+
+const char *JsonScanner::getImplName(JsonScanImpl impl) {
+    switch (impl) {
+        case JsonScanImpl::Auto:
+            return "Auto";
+        case JsonScanImpl::Scalar:
+            return "Scalar";
+        case JsonScanImpl::SSE2:
+            return "SSE2";
+        case JsonScanImpl::AVX2:
+            return "AVX2";
+        case JsonScanImpl::NEON:
+            return "NEON";
+    }
+    return "Unknown";
+}
+
+bool JsonScanner::scan(const char *json, size_t len, JsonScanResult& result, uint32_t *index, size_t indexCapacity, JsonScanImpl impl) {
+    result = JsonScanResult();
+
+    if (impl == JsonScanImpl::Auto) {
+        impl = getDefaultImpl();
+    }
+    auto classify = isSupported(impl) ? getClassifyFn(impl) : nullptr;
+    if (!classify) {
+        return false;
+    }
+
+    bool inString = false;
+    bool escapeNext = false; //the last block ended with an unpaired backslash
+    size_t stringStart = 0;
+    size_t depth = 0;
+
+    for (size_t offset = 0; offset < len; offset += MO_JSON_SCANNER_BLOCK) {
+
+        const char *block = json + offset;
+        size_t blockLen = len - offset;
+        char padded [MO_JSON_SCANNER_BLOCK];
+        if (blockLen < MO_JSON_SCANNER_BLOCK) {
+            memcpy(padded, block, blockLen);
+            memset(padded + blockLen, ' ', MO_JSON_SCANNER_BLOCK - blockLen);
+            block = padded;
+        }
+
+        uint64_t quotes, backslashes, structurals;
+        classify(block, quotes, backslashes, structurals);
+
+        if (backslashes || escapeNext) {
+            //remove escaped quotes. Backslashes are rare in OCPP messages, so resolve them sequentially
+            uint64_t escaped = 0;
+            for (unsigned int i = 0; i < MO_JSON_SCANNER_BLOCK; i++) {
+                if (escapeNext) {
+                    escaped |= (uint64_t)1 << i;
+                    escapeNext = false;
+                } else if (backslashes & ((uint64_t)1 << i)) {
+                    escapeNext = true;
+                }
+            }
+            quotes &= ~escaped;
+        }
+
+        //bits from each opening quote to the character before the closing quote
+        uint64_t stringMask = prefixXor(quotes) ^ (inString ? ~(uint64_t)0 : 0);
+        inString = stringMask >> (MO_JSON_SCANNER_BLOCK - 1);
+
+        uint64_t tokens = (structurals & ~stringMask) | quotes;
+        while (tokens) {
+            unsigned int i = countTrailingZeros(tokens);
+            tokens &= tokens - 1;
+
+            size_t pos = offset + i;
+
+            if (index && result.nStructurals < indexCapacity) {
+                index[result.nStructurals] = (uint32_t) pos;
+            }
+            result.nStructurals++;
+
+            if (quotes & ((uint64_t)1 << i)) {
+                if (stringMask & ((uint64_t)1 << i)) {
+                    stringStart = pos + 1;
+                    result.nStrings++;
+                } else {
+                    result.stringBytes += pos - stringStart;
+                }
+                continue;
+            }
+
+            switch (json[pos]) {
+                case '{':
+                case '[':
+                    result.nContainers++;
+                    depth++;
+                    if (depth > result.maxDepth) {
+                        result.maxDepth = depth;
+                    }
+                    break;
+                case '}':
+                case ']':
+                    if (depth == 0) {
+                        return false; //unbalanced
+                    }
+                    depth--;
+                    break;
+                case ',':
+                    result.nSeparators++;
+                    break;
+            }
+        }
+    }
+
+    result.valid = !inString && depth == 0 && result.nContainers > 0;
+    return result.valid;
+}
+
+size_t JsonScanner::estimateCapacity(const JsonScanResult& result) {
+    //each array element and object member occupies one slot. Non-empty containers have one element more than commas
+    size_t nSlots = result.nSeparators + result.nContainers;
+    //strings are copied into the JsonDoc with a terminating zero. Escape sequences only shrink the copy
+    return JSON_ARRAY_SIZE(nSlots) + result.stringBytes + result.nStrings;
+}
+
+#endif //MO_ENABLE_JSON_SCANNER
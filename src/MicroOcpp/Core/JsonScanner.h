@@ -0,0 +1,77 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Structural scanner for JSON input. It classifies 64-byte blocks of the input at once, locates the quotes,
+ * brackets, colons and commas outside of strings, and summarizes the document layout. The RequestQueue uses
+ * the summary to allocate the exact JsonDoc capacity for incoming messages, so that deserializeJson() runs
+ * only once per message and oversized messages are rejected without parsing them.
+ *
+ * The classification uses SSE2, AVX2 or NEON if the target supports it, with a scalar fallback. AVX2 is
+ * selected at runtime.
+ */
+
+#ifndef MO_JSONSCANNER_H
+#define MO_JSONSCANNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <MicroOcpp/Platform.h>
+
+#ifndef MO_ENABLE_JSON_SCANNER
+#if MO_PLATFORM == MO_PLATFORM_UNIX
+#define MO_ENABLE_JSON_SCANNER 1
+#else
+#define MO_ENABLE_JSON_SCANNER 0
+#endif
+#endif
+
+// use vector instructions if available. Set to 0 to always use the scalar implementation
+#ifndef MO_JSON_SCANNER_SIMD
+#define MO_JSON_SCANNER_SIMD 1
+#endif
+
+#if MO_ENABLE_JSON_SCANNER
+
+namespace MicroOcpp {
+
+enum class JsonScanImpl : uint8_t {
+    Auto, //fastest implementation which is supported by the CPU
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+struct JsonScanResult {
+    bool valid = false; //strings are terminated and brackets are balanced. Doesn't replace the JSON validation
+    size_t nStructurals = 0; //brackets, colons and commas outside of strings, plus opening and closing quotes
+    size_t nContainers = 0; //objects and arrays
+    size_t nSeparators = 0; //commas
+    size_t nStrings = 0; //keys and string values
+    size_t stringBytes = 0; //raw length of all strings, without quotes
+    size_t maxDepth = 0;
+};
+
+namespace JsonScanner {
+
+bool isSupported(JsonScanImpl impl);
+JsonScanImpl getDefaultImpl();
+const char *getImplName(JsonScanImpl impl);
+
+/*
+ * Scan json. If index is given, it receives the offsets of the first indexCapacity structural characters in
+ * ascending order (see JsonScanResult::nStructurals). Returns result.valid
+ */
+bool scan(const char *json, size_t len, JsonScanResult& result, uint32_t *index = nullptr, size_t indexCapacity = 0, JsonScanImpl impl = JsonScanImpl::Auto);
+
+//Upper bound of the JsonDoc capacity which deserializeJson() needs for the scanned input
+size_t estimateCapacity(const JsonScanResult& result);
+
+} //namespace JsonScanner
+} //namespace MicroOcpp
+
+#endif //MO_ENABLE_JSON_SCANNER
+#endif
@@ -0,0 +1,489 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/JsonView.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+using namespace MicroOcpp;
+
+namespace MicroOcpp {
+namespace JsonViewUtils {
+
+const char *skipWs(const char *p, const char *limit) {
+    while (p < limit && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+//p points to the opening quote. Returns the position after the closing quote or nullptr if not terminated
+const char *skipString(const char *p, const char *limit) {
+    for (p++; p < limit; p++) {
+        if (*p == '\\') {
+            p++;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+//Returns the position after the value starting at p or nullptr if malformatted
+const char *skipValue(const char *p, const char *limit) {
+    if (p >= limit) {
+        return nullptr;
+    }
+
+    if (*p == '"') {
+        return skipString(p, limit);
+    }
+
+    if (*p == '{' || *p == '[') {
+        size_t depth = 0;
+        while (p < limit) {
+            if (*p == '"') {
+                p = skipString(p, limit);
+                if (!p) {
+                    return nullptr;
+                }
+                continue;
+            }
+            if (*p == '{' || *p == '[') {
+                depth++;
+            } else if (*p == '}' || *p == ']') {
+                depth--;
+                if (depth == 0) {
+                    return p + 1;
+                }
+            }
+            p++;
+        }
+        return nullptr;
+    }
+
+    //number or literal
+    const char *begin = p;
+    while (p < limit && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') {
+        p++;
+    }
+    return p > begin ? p : nullptr;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool readCodeUnit(const char *p, const char *end, unsigned long& codeUnit) {
+    if (end - p < 4) {
+        return false;
+    }
+    codeUnit = 0;
+    for (int i = 0; i < 4; i++) {
+        int h = hexValue(p[i]);
+        if (h < 0) {
+            return false;
+        }
+        codeUnit = (codeUnit << 4) | (unsigned long) h;
+    }
+    return true;
+}
+
+/*
+ * Decode the next character of a raw string at p (without quotes) into out. Advances p. Returns the number of
+ * bytes in out (at most 4) or 0 if the escape sequence is invalid
+ */
+size_t decodeChar(const char*& p, const char *end, char *out) {
+    if (*p != '\\') {
+        out[0] = *p++;
+        return 1;
+    }
+
+    p++;
+    if (p >= end) {
+        return 0;
+    }
+
+    char c = *p++;
+    switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            out[0] = c;
+            return 1;
+        case 'b':
+            out[0] = '\b';
+            return 1;
+        case 'f':
+            out[0] = '\f';
+            return 1;
+        case 'n':
+            out[0] = '\n';
+            return 1;
+        case 'r':
+            out[0] = '\r';
+            return 1;
+        case 't':
+            out[0] = '\t';
+            return 1;
+        case 'u':
+            break;
+        default:
+            return 0;
+    }
+
+    unsigned long codepoint;
+    if (!readCodeUnit(p, end, codepoint)) {
+        return 0;
+    }
+    p += 4;
+
+    unsigned long low;
+    if (codepoint >= 0xD800 && codepoint < 0xDC00 &&
+            end - p >= 6 && p[0] == '\\' && p[1] == 'u' && readCodeUnit(p + 2, end, low) &&
+            low >= 0xDC00 && low < 0xE000) {
+        //surrogate pair
+        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+        p += 6;
+    }
+
+    //UTF-8
+    if (codepoint < 0x80) {
+        out[0] = (char) codepoint;
+        return 1;
+    } else if (codepoint < 0x800) {
+        out[0] = (char) (0xC0 | (codepoint >> 6));
+        out[1] = (char) (0x80 | (codepoint & 0x3F));
+        return 2;
+    } else if (codepoint < 0x10000) {
+        out[0] = (char) (0xE0 | (codepoint >> 12));
+        out[1] = (char) (0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (codepoint & 0x3F));
+        return 3;
+    } else {
+        out[0] = (char) (0xF0 | (codepoint >> 18));
+        out[1] = (char) (0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = (char) (0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = (char) (0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+}
+
+} //namespace JsonViewUtils
+} //namespace MicroOcpp
+
+using namespace MicroOcpp::JsonViewUtils;
+
+JsonView::JsonView(const char *value, const char *limit) : value(value), limit(limit) {
+    if (this->value && this->value >= this->limit) {
+        this->value = nullptr;
+    }
+}
+
+JsonView::JsonView(const char *json, size_t len) : JsonView(json ? skipWs(json, json + len) : nullptr, json ? json + len : nullptr) {
+
+}
+
+bool JsonView::isNull() const {
+    return !value || (limit - value >= 4 && !strncmp(value, "null", 4));
+}
+
+bool JsonView::isObject() const {
+    return value && *value == '{';
+}
+
+bool JsonView::isArray() const {
+    return value && *value == '[';
+}
+
+bool JsonView::isString() const {
+    return value && *value == '"';
+}
+
+bool JsonView::isNumber() const {
+    return value && (*value == '-' || (*value >= '0' && *value <= '9'));
+}
+
+bool JsonView::isBool() const {
+    return value && (*value == 't' || *value == 'f');
+}
+
+JsonView JsonView::get(const char *key) const {
+    if (!isObject() || !key) {
+        return JsonView();
+    }
+
+    size_t keyLen = strlen(key);
+
+    const char *p = skipWs(value + 1, limit);
+    while (p < limit && *p == '"') {
+        const char *keyBegin = p + 1;
+        p = skipString(p, limit);
+        if (!p) {
+            return JsonView();
+        }
+        const char *keyEnd = p - 1;
+
+        p = skipWs(p, limit);
+        if (p >= limit || *p != ':') {
+            return JsonView();
+        }
+        p = skipWs(p + 1, limit);
+
+        if ((size_t) (keyEnd - keyBegin) == keyLen && !strncmp(keyBegin, key, keyLen)) {
+            return JsonView(p, limit);
+        }
+
+        p = skipValue(p, limit);
+        if (!p) {
+            return JsonView();
+        }
+        p = skipWs(p, limit);
+        if (p >= limit || *p != ',') {
+            break;
+        }
+        p = skipWs(p + 1, limit);
+    }
+
+    return JsonView();
+}
+
+JsonView JsonView::at(size_t index) const {
+    if (!isArray()) {
+        return JsonView();
+    }
+
+    const char *p = skipWs(value + 1, limit);
+    if (p >= limit || *p == ']') {
+        return JsonView();
+    }
+
+    for (size_t i = 0; i < index; i++) {
+        p = skipValue(p, limit);
+        if (!p) {
+            return JsonView();
+        }
+        p = skipWs(p, limit);
+        if (p >= limit || *p != ',') {
+            return JsonView();
+        }
+        p = skipWs(p + 1, limit);
+    }
+
+    return JsonView(p, limit);
+}
+
+JsonView JsonView::getPath(const char *path) const {
+    JsonView view = *this;
+
+    while (path && *path) {
+        const char *sep = strchr(path, '/');
+        size_t len = sep ? (size_t) (sep - path) : strlen(path);
+
+        char segment [64];
+        if (len >= sizeof(segment)) {
+            return JsonView();
+        }
+        memcpy(segment, path, len);
+        segment[len] = '\0';
+
+        if (view.isArray()) {
+            char *endptr;
+            unsigned long index = strtoul(segment, &endptr, 10);
+            if (endptr == segment || *endptr != '\0') {
+                return JsonView();
+            }
+            view = view.at((size_t) index);
+        } else {
+            view = view.get(segment);
+        }
+
+        path = sep ? sep + 1 : nullptr;
+    }
+
+    return view;
+}
+
+size_t JsonView::size() const {
+    if (!isObject() && !isArray()) {
+        return 0;
+    }
+
+    char close = isObject() ? '}' : ']';
+
+    const char *p = skipWs(value + 1, limit);
+    if (p >= limit || *p == close) {
+        return 0;
+    }
+
+    size_t n = 0;
+    while (p < limit) {
+        if (isObject()) {
+            //skip key and colon
+            p = skipValue(p, limit);
+            if (!p) {
+                return n;
+            }
+            p = skipWs(p, limit);
+            if (p >= limit || *p != ':') {
+                return n;
+            }
+            p = skipWs(p + 1, limit);
+        }
+        p = skipValue(p, limit);
+        if (!p) {
+            return n;
+        }
+        n++;
+        p = skipWs(p, limit);
+        if (p >= limit || *p != ',') {
+            break;
+        }
+        p = skipWs(p + 1, limit);
+    }
+    return n;
+}
+
+bool JsonView::getString(const char*& str, size_t& len) const {
+    if (!isString()) {
+        return false;
+    }
+    const char *end = skipString(value, limit);
+    if (!end) {
+        return false;
+    }
+    str = value + 1;
+    len = (size_t) (end - 1 - str);
+    return true;
+}
+
+bool JsonView::equals(const char *str) const {
+    const char *raw;
+    size_t rawLen;
+    if (!str || !getString(raw, rawLen)) {
+        return false;
+    }
+
+    const char *p = raw;
+    const char *end = raw + rawLen;
+    while (p < end) {
+        char decoded [4];
+        size_t n = decodeChar(p, end, decoded);
+        if (n == 0 || strncmp(str, decoded, n)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (!*str) {
+                return false;
+            }
+            str++;
+        }
+    }
+    return *str == '\0';
+}
+
+bool JsonView::copyString(char *buf, size_t size) const {
+    const char *raw;
+    size_t rawLen;
+    if (!buf || size == 0 || !getString(raw, rawLen)) {
+        return false;
+    }
+
+    size_t written = 0;
+    const char *p = raw;
+    const char *end = raw + rawLen;
+    while (p < end) {
+        char decoded [4];
+        size_t n = decodeChar(p, end, decoded);
+        if (n == 0 || written + n >= size) {
+            buf[0] = '\0';
+            return false;
+        }
+        memcpy(buf + written, decoded, n);
+        written += n;
+    }
+    buf[written] = '\0';
+    return true;
+}
+
+int JsonView::asInt(int defaultValue) const {
+    if (!isNumber()) {
+        return defaultValue;
+    }
+
+    const char *p = value;
+    bool negative = false;
+    if (*p == '-') {
+        negative = true;
+        p++;
+    }
+
+    //magnitude of INT_MAX or INT_MIN. Check the range before each step, so that the accumulator never overflows
+    const unsigned long maxMagnitude = (unsigned long) INT_MAX + (negative ? 1UL : 0UL);
+
+    unsigned long result = 0;
+    bool digits = false;
+    while (p < limit && *p >= '0' && *p <= '9') {
+        unsigned long digit = (unsigned long) (*p - '0');
+        if (result > (maxMagnitude - digit) / 10UL) {
+            return defaultValue; //out of range
+        }
+        result = result * 10UL + digit;
+        digits = true;
+        p++;
+    }
+
+    if (!digits) {
+        return defaultValue;
+    }
+
+    if (negative) {
+        return result == maxMagnitude ? INT_MIN : -(int) result;
+    }
+    return (int) result;
+}
+
+float JsonView::asFloat(float defaultValue) const {
+    if (!isNumber()) {
+        return defaultValue;
+    }
+
+    const char *end = skipValue(value, limit);
+    if (!end) {
+        return defaultValue;
+    }
+
+    char buf [32]; //the input isn't zero-terminated
+    size_t len = (size_t) (end - value);
+    if (len >= sizeof(buf)) {
+        return defaultValue;
+    }
+    memcpy(buf, value, len);
+    buf[len] = '\0';
+
+    char *endptr;
+    float result = strtof(buf, &endptr);
+    if (endptr == buf) {
+        return defaultValue;
+    }
+    return result;
+}
+
+bool JsonView::asBool(bool defaultValue) const {
+    if (value && limit - value >= 4 && !strncmp(value, "true", 4)) {
+        return true;
+    } else if (value && limit - value >= 5 && !strncmp(value, "false", 5)) {
+        return false;
+    }
+    return defaultValue;
+}
@@ -0,0 +1,68 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Read-only view on raw JSON input. Lookups scan the input on demand and string values are returned as
+ * slices of the input, so reading a few fields of a message doesn't need a JsonDoc. The view doesn't validate
+ * the parts of the input which it skips; malformed input results in undefined (isNull) values.
+ *
+ * The RequestQueue passes responses as JsonView to the pending Operation. Operations which only read a few
+ * fields implement Operation::processConfView(), Operations without conf payload set Operation::hasEmptyConf(); all
+ * other Operations receive the deserialized JsonObject.
+ */
+
+#ifndef MO_JSONVIEW_H
+#define MO_JSONVIEW_H
+
+#include <stddef.h>
+
+#ifndef MO_ENABLE_JSON_VIEW
+#define MO_ENABLE_JSON_VIEW 1
+#endif
+
+namespace MicroOcpp {
+
+class JsonView {
+private:
+    const char *value = nullptr; //first character of the value or nullptr if undefined
+    const char *limit = nullptr; //end of the input
+
+    JsonView(const char *value, const char *limit);
+public:
+    JsonView() = default;
+    JsonView(const char *json, size_t len);
+
+    bool isNull() const; //undefined or JSON null
+    bool isObject() const;
+    bool isArray() const;
+    bool isString() const;
+    bool isNumber() const;
+    bool isBool() const;
+
+    JsonView get(const char *key) const; //object member
+    JsonView at(size_t index) const; //array element
+
+    /*
+     * Resolve a path of object keys and array indexes, separated by '/'. For example "idTagInfo/status" or
+     * "localAuthorizationList/0/idTag"
+     */
+    JsonView getPath(const char *path) const;
+
+    size_t size() const; //number of array elements or object members
+
+    //slice of the input between the quotes. Escape sequences are not resolved
+    bool getString(const char*& str, size_t& len) const;
+    bool equals(const char *str) const; //compare string value with str, resolving escape sequences
+
+    //copy string value with resolved escape sequences and terminating zero. Returns false if it doesn't fit
+    bool copyString(char *buf, size_t size) const;
+
+    int asInt(int defaultValue = 0) const;
+    float asFloat(float defaultValue = 0.f) const;
+    bool asBool(bool defaultValue = false) const;
+};
+
+} //namespace MicroOcpp
+
+#endif
@@ -0,0 +1,41 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/LoopBudget.h>
+#include <MicroOcpp/Core/Metrics.h>
+
+namespace MicroOcpp {
+namespace LoopBudget {
+
+unsigned long budget_us = MO_LOOP_BUDGET_US;
+unsigned long t_start = 0;
+bool running = false;
+
+void begin() {
+    t_start = mocpp_tick_us();
+    running = true;
+}
+
+void end() {
+    running = false;
+}
+
+bool exhausted() {
+    return running && budget_us > 0 && mocpp_tick_us() - t_start >= budget_us;
+}
+
+void countYield() {
+    MO_METRICS_COUNT(MO_METRICS_LOOP_YIELDS);
+}
+
+} //namespace LoopBudget
+} //namespace MicroOcpp
+
+void mocpp_set_loop_budget(unsigned long budget_us) {
+    MicroOcpp::LoopBudget::budget_us = budget_us;
+}
+
+unsigned long mocpp_get_loop_budget() {
+    return MicroOcpp::LoopBudget::budget_us;
+}
@@ -0,0 +1,52 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Time budget for one mocpp_loop() call. Between their steps, the services check if the budget is used up. If so,
+ * they yield and continue in the next mocpp_loop() call. The worst-case loop time is the budget plus the longest
+ * single step (e.g. writing one file or processing one message).
+ *
+ * The worst-case loop time can be measured with the Metrics histogram MO_METRICS_LOOP_TIME (max_us) and the
+ * number of yields with the counter MO_METRICS_LOOP_YIELDS.
+ */
+
+#ifndef MO_LOOPBUDGET_H
+#define MO_LOOPBUDGET_H
+
+#include <MicroOcpp/Platform.h>
+
+#ifndef MO_LOOP_BUDGET_US
+#define MO_LOOP_BUDGET_US 0 //default budget in microseconds. 0 disables the time slicing
+#endif
+
+#ifndef MO_LOOP_MIN_TASKS
+#define MO_LOOP_MIN_TASKS 2 //services which run per mocpp_loop() call even if the budget is used up. Connectors always run
+#endif
+
+/*
+ * Set the time budget of mocpp_loop() in microseconds. 0 runs all services to completion in each call. The budget
+ * is measured with mocpp_tick_us()
+ */
+MO_EXTERN_C void mocpp_set_loop_budget(unsigned long budget_us);
+
+MO_EXTERN_C unsigned long mocpp_get_loop_budget();
+
+#ifdef __cplusplus
+
+namespace MicroOcpp {
+namespace LoopBudget {
+
+void begin(); //start of mocpp_loop()
+void end(); //end of mocpp_loop()
+
+//true if the current mocpp_loop() call has used up its budget. Always false outside of mocpp_loop() or without budget
+bool exhausted();
+
+void countYield(); //record that a service has deferred work to the next call
+
+} //namespace LoopBudget
+} //namespace MicroOcpp
+
+#endif //__cplusplus
+#endif
@@ -96,6 +96,104 @@ void (*free_override)(void*);
 }
 }
 
+#if MO_ENABLE_STATIC_MEMORY
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <cstddef>
+#include <algorithm>
+
+#if MO_STATIC_MEMORY_THREADSAFE
+#include <mutex>
+#endif
+
+namespace MicroOcpp {
+namespace Memory {
+
+/*
+ * First-fit allocator on a fixed buffer. The blocks are laid out back to back, each starting with a header.
+ * Free neighbours are merged lazily when an allocation walks over them
+ */
+struct PoolBlock {
+    size_t size; //including header
+    size_t used; //0 if free
+};
+
+#define MO_POOL_ALIGN alignof(std::max_align_t)
+#define MO_POOL_ALIGN_UP(SIZE) (((SIZE) + MO_POOL_ALIGN - 1) & ~((size_t)MO_POOL_ALIGN - 1))
+#define MO_POOL_HEADER MO_POOL_ALIGN_UP(sizeof(PoolBlock))
+
+void *poolBuf; //as passed to mo_mem_set_pool(), before alignment
+unsigned char *pool;
+size_t poolSize;
+bool poolOwned; //pool has been reserved from the heap by mo_mem_seal()
+bool poolSealed;
+mo_mem_pool_stats poolStats;
+void (*poolExhaustedCb)(const char *tag, size_t size);
+
+#if MO_STATIC_MEMORY_THREADSAFE
+std::mutex poolMutex;
+#define MO_POOL_LOCK() std::lock_guard<std::mutex> poolLock(poolMutex)
+#else
+#define MO_POOL_LOCK() (void)0
+#endif
+
+bool poolContains(void *ptr) {
+    return pool && (unsigned char*)ptr >= pool && (unsigned char*)ptr < pool + poolSize;
+}
+
+void *poolMalloc(size_t size) {
+    size_t need = MO_POOL_HEADER + MO_POOL_ALIGN_UP(size > 0 ? size : 1);
+    if (need < size) {
+        return nullptr; //overflow
+    }
+
+    unsigned char *end = pool + poolSize;
+    for (unsigned char *p = pool; p < end; p += ((PoolBlock*)p)->size) {
+        auto block = (PoolBlock*)p;
+        if (block->used) {
+            continue;
+        }
+
+        while (p + block->size < end && !((PoolBlock*)(p + block->size))->used) {
+            block->size += ((PoolBlock*)(p + block->size))->size;
+        }
+
+        if (block->size < need) {
+            continue;
+        }
+
+        if (block->size - need >= MO_POOL_HEADER + MO_POOL_ALIGN) {
+            auto rest = (PoolBlock*)(p + need);
+            rest->size = block->size - need;
+            rest->used = 0;
+            block->size = need;
+        }
+
+        block->used = 1;
+        poolStats.used += block->size;
+        poolStats.max_used = std::max(poolStats.max_used, poolStats.used);
+        return p + MO_POOL_HEADER;
+    }
+
+    return nullptr;
+}
+
+void poolFree(void *ptr) {
+    auto block = (PoolBlock*)((unsigned char*)ptr - MO_POOL_HEADER);
+    if (!block->used) {
+        MO_DBG_ERR("double free");
+        return;
+    }
+    block->used = 0;
+    poolStats.used -= block->size;
+}
+
+} //namespace Memory
+} //namespace MicroOcpp
+
+#endif //MO_ENABLE_STATIC_MEMORY
+
 using namespace MicroOcpp::Memory;
 
 void mo_mem_set_malloc_free(void* (*malloc_override)(size_t), void (*free_override)(void*)) {
@@ -106,11 +204,39 @@ void mo_mem_set_malloc_free(void* (*malloc_override)(size_t), void (*free_overri
 void *mo_mem_malloc(const char *tag, size_t size) {
     MO_DBG_VERBOSE("malloc %zu B (%s)", size, tag ? tag : "unspecified");
 
-    void *ptr;
-    if (malloc_override) {
-        ptr = malloc_override(size);
-    } else {
-        ptr = malloc(size);
+    void *ptr = nullptr;
+
+    #if MO_ENABLE_STATIC_MEMORY
+    bool fromPool = false;
+    if (poolSealed) {
+        MO_POOL_LOCK();
+        ptr = poolMalloc(size);
+        if (ptr) {
+            fromPool = true;
+        } else {
+            poolStats.failed++;
+            #if MO_STATIC_MEMORY_STRICT
+            MO_DBG_ERR("static memory pool exhausted: %zu B (%s)", size, tag ? tag : "unspecified");
+            if (poolExhaustedCb) {
+                poolExhaustedCb(tag, size);
+            } else {
+                abort();
+            }
+            return nullptr;
+            #else
+            poolStats.heap_allocs++;
+            MO_DBG_WARN("static memory pool exhausted, use heap: %zu B (%s)", size, tag ? tag : "unspecified");
+            #endif
+        }
+    }
+    if (!fromPool)
+    #endif //MO_ENABLE_STATIC_MEMORY
+    {
+        if (malloc_override) {
+            ptr = malloc_override(size);
+        } else {
+            ptr = malloc(size);
+        }
     }
 
     #if MO_ENABLE_HEAP_PROFILER
@@ -145,6 +271,14 @@ void mo_mem_free(void* ptr) {
     }
     #endif
 
+    #if MO_ENABLE_STATIC_MEMORY
+    if (poolContains(ptr)) {
+        MO_POOL_LOCK();
+        poolFree(ptr);
+        return;
+    }
+    #endif
+
     if (free_override) {
         free_override(ptr);
     } else {
@@ -152,6 +286,116 @@ void mo_mem_free(void* ptr) {
     }
 }
 
+#if MO_ENABLE_STATIC_MEMORY
+
+bool mo_mem_set_pool(void *buf, size_t size) {
+    MO_POOL_LOCK();
+
+    if (poolStats.used > 0) {
+        MO_DBG_ERR("static memory pool still in use (%zu B)", poolStats.used);
+        return false;
+    }
+
+    if (poolOwned) {
+        if (free_override) {
+            free_override(poolBuf);
+        } else {
+            free(poolBuf);
+        }
+        poolOwned = false;
+    }
+
+    poolBuf = nullptr;
+    pool = nullptr;
+    poolSize = 0;
+    poolStats = mo_mem_pool_stats();
+
+    if (!buf) {
+        poolSealed = false;
+        return true;
+    }
+
+    auto offs = MO_POOL_ALIGN_UP((uintptr_t)buf) - (uintptr_t)buf;
+    if (size < offs + MO_POOL_HEADER + MO_POOL_ALIGN) {
+        MO_DBG_ERR("static memory pool too small");
+        poolSealed = false;
+        return false;
+    }
+
+    poolBuf = buf;
+    pool = (unsigned char*)buf + offs;
+    poolSize = (size - offs) & ~((size_t)MO_POOL_ALIGN - 1);
+
+    auto block = (PoolBlock*)pool;
+    block->size = poolSize;
+    block->used = 0;
+
+    poolStats.size = poolSize;
+
+    MO_DBG_DEBUG("static memory pool: %zu B", poolSize);
+    return true;
+}
+
+void mo_mem_seal() {
+    if (!pool && MO_STATIC_MEMORY_POOL_SIZE > 0) {
+        void *buf = malloc_override ? malloc_override(MO_STATIC_MEMORY_POOL_SIZE) : malloc(MO_STATIC_MEMORY_POOL_SIZE);
+        if (buf && mo_mem_set_pool(buf, MO_STATIC_MEMORY_POOL_SIZE)) {
+            poolOwned = true;
+        } else if (buf) {
+            if (free_override) {
+                free_override(buf);
+            } else {
+                free(buf);
+            }
+        }
+    }
+
+    MO_POOL_LOCK();
+
+    if (!pool) {
+        MO_DBG_DEBUG("no static memory pool set. Continue with heap");
+        return;
+    }
+
+    poolSealed = true;
+}
+
+void mo_mem_unseal() {
+    bool release = false;
+    {
+        MO_POOL_LOCK();
+        poolSealed = false;
+
+        MO_DBG_DEBUG("static memory pool: %zu B in use (max. %zu B of %zu B, failed: %lu, heap: %lu)",
+                poolStats.used, poolStats.max_used, poolStats.size, poolStats.failed, poolStats.heap_allocs);
+
+        if (poolOwned && poolStats.used > 0) {
+            MO_DBG_WARN("keep static memory pool while in use (%zu B)", poolStats.used);
+        } else if (poolOwned) {
+            release = true;
+        }
+    }
+
+    if (release) {
+        mo_mem_set_pool(nullptr, 0); //release reserved pool
+    }
+}
+
+void mo_mem_set_pool_exhausted_cb(void (*cb)(const char *tag, size_t size)) {
+    poolExhaustedCb = cb;
+}
+
+bool mo_mem_get_pool_stats(mo_mem_pool_stats *out) {
+    if (!out) {
+        return false;
+    }
+    MO_POOL_LOCK();
+    *out = poolStats;
+    return pool != nullptr;
+}
+
+#endif //MO_ENABLE_STATIC_MEMORY
+
 #endif //MO_OVERRIDE_ALLOCATION
 
 #if MO_OVERRIDE_ALLOCATION && MO_ENABLE_HEAP_PROFILER
@@ -70,6 +70,66 @@ void mo_mem_print_stats();
 #endif //MO_OVERRIDE_ALLOCATION && MO_ENABLE_HEAP_PROFILER
 
 
+/*
+ * Static-memory mode: after initialization, all MO_MALLOC calls are served from a fixed pool instead of the
+ * heap. The host passes the pool with mo_mem_set_pool() before mocpp_initialize(), or sets
+ * MO_STATIC_MEMORY_POOL_SIZE to let mocpp_initialize() reserve it. mocpp_initialize() seals the allocator when
+ * it has finished, i.e. the objects created during initialization stay on the heap and every later allocation
+ * comes from the pool. mocpp_deinitialize() unseals it again.
+ *
+ * Allocations which don't fit into the pool are fatal (MO_STATIC_MEMORY_STRICT, see
+ * mo_mem_set_pool_exhausted_cb()) or fall back to the heap and are counted as heap_allocs. Allocations which
+ * bypass MO_MALLOC (e.g. plain new of non-MemoryManaged classes or std::function captures) are not covered
+ */
+#ifndef MO_ENABLE_STATIC_MEMORY
+#define MO_ENABLE_STATIC_MEMORY 0
+#endif
+
+#if MO_OVERRIDE_ALLOCATION && MO_ENABLE_STATIC_MEMORY
+
+#ifndef MO_STATIC_MEMORY_POOL_SIZE
+#define MO_STATIC_MEMORY_POOL_SIZE 0 //if > 0 and no pool has been set, mocpp_initialize() reserves a pool of this size
+#endif
+
+#ifndef MO_STATIC_MEMORY_STRICT
+#define MO_STATIC_MEMORY_STRICT 1 //1: pool exhaustion is fatal; 0: fall back to heap
+#endif
+
+#ifndef MO_STATIC_MEMORY_THREADSAFE
+#define MO_STATIC_MEMORY_THREADSAFE 1 //set to 0 on toolchains without std::mutex
+#endif
+
+typedef struct {
+    size_t size;               //usable pool size
+    size_t used;               //currently allocated, incl. block headers
+    size_t max_used;
+    unsigned long failed;      //allocations which didn't fit into the pool
+    unsigned long heap_allocs; //allocations served by the heap while sealed
+} mo_mem_pool_stats;
+
+bool mo_mem_set_pool(void *buf, size_t size); //buf must remain valid. Pass NULL to detach. Fails if the current pool is in use
+
+void mo_mem_seal(); //serve all further MO_MALLOC calls from the pool
+void mo_mem_unseal();
+
+bool mo_mem_get_pool_stats(mo_mem_pool_stats *out);
+
+/*
+ * Strict mode: called when an allocation doesn't fit into the pool. The library doesn't recover from failed
+ * allocations, so the callback must not return, but e.g. bring the charger into a safe state and reset. If
+ * not set, pool exhaustion calls abort(). Unit tests may return from the callback, then MO_MALLOC returns NULL
+ */
+void mo_mem_set_pool_exhausted_cb(void (*cb)(const char *tag, size_t size));
+
+#define MO_MEM_SEAL mo_mem_seal
+#define MO_MEM_UNSEAL mo_mem_unseal
+
+#else
+#define MO_MEM_SEAL(...) (void)0
+#define MO_MEM_UNSEAL(...) (void)0
+#endif //MO_OVERRIDE_ALLOCATION && MO_ENABLE_STATIC_MEMORY
+
+
 #if MO_ENABLE_EXTERNAL_RAM
 
 void mo_mem_set_malloc_free_ext(void* (*malloc_override)(size_t), void (*free_override)(void*)); //pass malloc and free function to external RAM to be used with the OCPP lib. If not set or NULL, defaults to standard malloc
@@ -143,7 +203,7 @@ protected:
         #endif
     }
 public:
-    void *operator new(size_t size) {
+    void *operator new(size_t size) noexcept { //noexcept: new returns nullptr without constructing if MO_MALLOC fails
         return MO_MALLOC(nullptr, size);
     }
     void operator delete(void * ptr) {
@@ -438,6 +498,46 @@ String makeString(const char *tag, const char *val = nullptr);
 JsonDoc initJsonDoc(const char *tag, size_t capacity = 0);
 std::unique_ptr<JsonDoc> makeJsonDoc(const char *tag, size_t capacity = 0);
 
+/*
+ * Vector with compile-time capacity N which stores its elements inline, i.e. without heap allocation. For
+ * containers whose maximum size is a build flag. T must be default-constructible
+ */
+template<class T, size_t N>
+class InlineVector {
+private:
+    T elements [N > 0 ? N : 1];
+    size_t len = 0;
+public:
+    T *begin() {return elements;}
+    T *end() {return elements + len;}
+    const T *begin() const {return elements;}
+    const T *end() const {return elements + len;}
+
+    size_t size() const {return len;}
+    bool empty() const {return len == 0;}
+    static constexpr size_t capacity() {return N;}
+
+    T& operator[](size_t i) {return elements[i];}
+    const T& operator[](size_t i) const {return elements[i];}
+    T& back() {return elements[len - 1];}
+    const T& back() const {return elements[len - 1];}
+
+    //return false if the capacity is exceeded
+    bool push_back(const T& val) {
+        if (len >= N) {
+            return false;
+        }
+        elements[len++] = val;
+        return true;
+    }
+
+    bool emplace_back() {
+        return push_back(T());
+    }
+
+    void clear() {len = 0;}
+};
+
 }
 
 #endif //__cplusplus
@@ -0,0 +1,216 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/Metrics.h>
+
+#if MO_ENABLE_METRICS
+
+#include <string.h>
+#include <stdio.h>
+
+#include <ArduinoJson.h>
+
+#include <MicroOcpp/Platform.h>
+#include <MicroOcpp/Debug.h>
+
+namespace MicroOcpp {
+namespace Metrics {
+
+const unsigned long bucketBounds [MO_METRICS_BUCKETS - 1] = {100UL, 1000UL, 5000UL, 10000UL, 50000UL, 100000UL, 500000UL, 1000000UL, 5000000UL, 10000000UL};
+
+void recordHistogram(mo_metrics_histogram& hist, unsigned long us) {
+    size_t bucket = 0;
+    while (bucket < MO_METRICS_BUCKETS - 1 && us > bucketBounds[bucket]) {
+        bucket++;
+    }
+    hist.buckets[bucket]++;
+    hist.count++;
+    hist.sum_us += us;
+    if (us > hist.max_us) {
+        hist.max_us = us;
+    }
+}
+
+struct OperationMetrics {
+    char operationType [MO_METRICS_OPNAME_SIZE];
+    mo_metrics_histogram histograms [MO_METRICS_OP_HISTOGRAM_COUNT];
+    unsigned long counters [MO_METRICS_OP_COUNTER_COUNT];
+};
+
+//static storage, so that the metrics don't distort the heap statistics
+mo_metrics_histogram histograms [MO_METRICS_HISTOGRAM_COUNT];
+unsigned long counters [MO_METRICS_COUNTER_COUNT];
+OperationMetrics operations [MO_METRICS_MAX_OPERATIONS];
+size_t operationsSize = 0;
+
+OperationMetrics *getOperation(const char *operationType, bool create) {
+    if (!operationType) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < operationsSize; i++) {
+        if (!strncmp(operations[i].operationType, operationType, MO_METRICS_OPNAME_SIZE - 1)) {
+            return &operations[i];
+        }
+    }
+    if (!create) {
+        return nullptr;
+    }
+    if (operationsSize >= MO_METRICS_MAX_OPERATIONS) {
+        MO_DBG_WARN("exceeded MO_METRICS_MAX_OPERATIONS, skip %s", operationType);
+        return nullptr;
+    }
+    auto& op = operations[operationsSize];
+    memset(&op, 0, sizeof(op));
+    snprintf(op.operationType, sizeof(op.operationType), "%s", operationType);
+    operationsSize++;
+    return &op;
+}
+
+void record(mo_metrics_histogram_type type, unsigned long us) {
+    if ((size_t) type >= MO_METRICS_HISTOGRAM_COUNT) {
+        return;
+    }
+    recordHistogram(histograms[type], us);
+}
+
+void count(mo_metrics_counter_type type, unsigned long n) {
+    if ((size_t) type >= MO_METRICS_COUNTER_COUNT) {
+        return;
+    }
+    counters[type] += n;
+}
+
+void recordOp(const char *operationType, mo_metrics_op_histogram_type type, unsigned long us) {
+    if ((size_t) type >= MO_METRICS_OP_HISTOGRAM_COUNT) {
+        return;
+    }
+    if (auto op = getOperation(operationType, true)) {
+        recordHistogram(op->histograms[type], us);
+    }
+}
+
+void countOp(const char *operationType, mo_metrics_op_counter_type type) {
+    if ((size_t) type >= MO_METRICS_OP_COUNTER_COUNT) {
+        return;
+    }
+    if (auto op = getOperation(operationType, true)) {
+        op->counters[type]++;
+    }
+}
+
+ScopedTimer::ScopedTimer(mo_metrics_histogram_type type) : type(type), t_start(mocpp_tick_us()) {
+
+}
+
+ScopedTimer::~ScopedTimer() {
+    record(type, mocpp_tick_us() - t_start);
+}
+
+const char *histogramNames [MO_METRICS_HISTOGRAM_COUNT] = {"loop", "fs_load", "fs_store"};
+const char *counterNames [MO_METRICS_COUNTER_COUNT] = {"msg_sent", "msg_received", "bytes_sent", "bytes_received", "fs_bytes_written", "loop_yields"};
+const char *opHistogramNames [MO_METRICS_OP_HISTOGRAM_COUNT] = {"queue_time", "roundtrip_time", "processing_time"};
+const char *opCounterNames [MO_METRICS_OP_COUNTER_COUNT] = {"req_sent", "conf_received", "err_received", "timeout", "req_received"};
+
+void writeHistogram(JsonObject out, const mo_metrics_histogram& hist) {
+    out["count"] = hist.count;
+    out["max_us"] = hist.max_us;
+    out["avg_us"] = hist.count ? (unsigned long) (hist.sum_us / hist.count) : 0UL;
+    JsonArray buckets = out.createNestedArray("buckets");
+    for (size_t i = 0; i < MO_METRICS_BUCKETS; i++) {
+        buckets.add(hist.buckets[i]);
+    }
+}
+
+} //namespace Metrics
+} //namespace MicroOcpp
+
+using namespace MicroOcpp::Metrics;
+
+void mo_metrics_reset() {
+    memset(histograms, 0, sizeof(histograms));
+    memset(counters, 0, sizeof(counters));
+    memset(operations, 0, sizeof(operations));
+    operationsSize = 0;
+}
+
+bool mo_metrics_get_histogram(mo_metrics_histogram_type type, mo_metrics_histogram *out) {
+    if ((size_t) type >= MO_METRICS_HISTOGRAM_COUNT || !out) {
+        return false;
+    }
+    *out = histograms[type];
+    return true;
+}
+
+bool mo_metrics_get_counter(mo_metrics_counter_type type, unsigned long *out) {
+    if ((size_t) type >= MO_METRICS_COUNTER_COUNT || !out) {
+        return false;
+    }
+    *out = counters[type];
+    return true;
+}
+
+bool mo_metrics_get_op_histogram(const char *operationType, mo_metrics_op_histogram_type type, mo_metrics_histogram *out) {
+    if ((size_t) type >= MO_METRICS_OP_HISTOGRAM_COUNT || !out) {
+        return false;
+    }
+    auto op = getOperation(operationType, false);
+    if (!op) {
+        return false;
+    }
+    *out = op->histograms[type];
+    return true;
+}
+
+bool mo_metrics_get_op_counter(const char *operationType, mo_metrics_op_counter_type type, unsigned long *out) {
+    if ((size_t) type >= MO_METRICS_OP_COUNTER_COUNT || !out) {
+        return false;
+    }
+    auto op = getOperation(operationType, false);
+    if (!op) {
+        return false;
+    }
+    *out = op->counters[type];
+    return true;
+}
+
+int mo_metrics_write_stats_json(char *buf, size_t size) {
+    DynamicJsonDocument doc {size * 2};
+
+    JsonArray bounds = doc.createNestedArray("bucket_bounds_us");
+    for (size_t i = 0; i < MO_METRICS_BUCKETS - 1; i++) {
+        bounds.add(bucketBounds[i]);
+    }
+
+    for (size_t i = 0; i < MO_METRICS_HISTOGRAM_COUNT; i++) {
+        writeHistogram(doc.createNestedObject(histogramNames[i]), histograms[i]);
+    }
+
+    JsonObject countersJson = doc.createNestedObject("counters");
+    for (size_t i = 0; i < MO_METRICS_COUNTER_COUNT; i++) {
+        countersJson[counterNames[i]] = counters[i];
+    }
+
+    JsonArray operationsJson = doc.createNestedArray("operations");
+    for (size_t i = 0; i < operationsSize; i++) {
+        JsonObject entry = operationsJson.createNestedObject();
+        entry["operation"] = (const char*) operations[i].operationType;
+        for (size_t j = 0; j < MO_METRICS_OP_COUNTER_COUNT; j++) {
+            entry[opCounterNames[j]] = operations[i].counters[j];
+        }
+        for (size_t j = 0; j < MO_METRICS_OP_HISTOGRAM_COUNT; j++) {
+            if (operations[i].histograms[j].count > 0) {
+                writeHistogram(entry.createNestedObject(opHistogramNames[j]), operations[i].histograms[j]);
+            }
+        }
+    }
+
+    if (doc.overflowed()) {
+        MO_DBG_ERR("exceeded JSON capacity");
+        return -1;
+    }
+
+    return (int)serializeJson(doc, buf, size);
+}
+
+#endif //MO_ENABLE_METRICS
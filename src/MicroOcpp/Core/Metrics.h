@@ -0,0 +1,133 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_METRICS_H
+#define MO_METRICS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifndef MO_ENABLE_METRICS
+#define MO_ENABLE_METRICS 0
+#endif
+
+#if MO_ENABLE_METRICS
+
+#ifndef MO_METRICS_MAX_OPERATIONS
+#define MO_METRICS_MAX_OPERATIONS 40 //number of distinct operation types which can be tracked
+#endif
+
+#ifndef MO_METRICS_OPNAME_SIZE
+#define MO_METRICS_OPNAME_SIZE 32 //max length of the operation type name (incl. terminating 0)
+#endif
+
+/*
+ * Not thread-safe: the counters and histograms are plain integers without synchronization, because 64-bit atomics
+ * aren't lock-free on most MCUs. MO records all metrics on the mocpp_loop() thread (WebSocket callbacks included,
+ * see ConnectionQueue.h for running the socket on another thread). Read them from the same thread.
+ */
+
+/*
+ * Latency histograms have fixed bucket bounds (upper bounds, in microseconds):
+ *     100us, 1ms, 5ms, 10ms, 50ms, 100ms, 500ms, 1s, 5s, 10s, +inf
+ */
+#define MO_METRICS_BUCKETS 11
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    unsigned long count;
+    unsigned long max_us;
+    unsigned long long sum_us;
+    unsigned long buckets [MO_METRICS_BUCKETS];
+} mo_metrics_histogram;
+
+typedef enum {
+    MO_METRICS_LOOP_TIME,         //duration of one mocpp_loop() call
+    MO_METRICS_FS_LOAD_TIME,      //duration of FilesystemUtils::loadJson
+    MO_METRICS_FS_STORE_TIME,     //duration of FilesystemUtils::storeJson
+    MO_METRICS_HISTOGRAM_COUNT
+} mo_metrics_histogram_type;
+
+typedef enum {
+    MO_METRICS_MSG_SENT,          //number of WebSocket messages sent
+    MO_METRICS_MSG_RECEIVED,      //number of WebSocket messages received
+    MO_METRICS_BYTES_SENT,        //payload bytes sent
+    MO_METRICS_BYTES_RECEIVED,    //payload bytes received
+    MO_METRICS_FS_BYTES_WRITTEN,  //bytes written by FilesystemUtils::storeJson
+    MO_METRICS_LOOP_YIELDS,       //number of times a service deferred work because the loop budget was used up
+    MO_METRICS_COUNTER_COUNT
+} mo_metrics_counter_type;
+
+typedef enum {
+    MO_METRICS_OP_QUEUE_TIME,      //time between creating a request and sending it
+    MO_METRICS_OP_ROUNDTRIP_TIME,  //time between sending a request and receiving its response
+    MO_METRICS_OP_PROCESSING_TIME, //time for executing an incoming request
+    MO_METRICS_OP_HISTOGRAM_COUNT
+} mo_metrics_op_histogram_type;
+
+typedef enum {
+    MO_METRICS_OP_REQ_SENT,        //requests sent by this device
+    MO_METRICS_OP_CONF_RECEIVED,   //confirmations received for requests sent by this device
+    MO_METRICS_OP_ERR_RECEIVED,    //CallErrors received for requests sent by this device
+    MO_METRICS_OP_TIMEOUT,         //requests sent by this device which timed out
+    MO_METRICS_OP_REQ_RECEIVED,    //requests received from the server
+    MO_METRICS_OP_COUNTER_COUNT
+} mo_metrics_op_counter_type;
+
+void mo_metrics_reset(); //set all counters and histograms to zero and forget operation types
+
+bool mo_metrics_get_histogram(mo_metrics_histogram_type type, mo_metrics_histogram *out);
+bool mo_metrics_get_counter(mo_metrics_counter_type type, unsigned long *out);
+
+//per-operation metrics. Return false if operationType has not been seen yet
+bool mo_metrics_get_op_histogram(const char *operationType, mo_metrics_op_histogram_type type, mo_metrics_histogram *out);
+bool mo_metrics_get_op_counter(const char *operationType, mo_metrics_op_counter_type type, unsigned long *out);
+
+int mo_metrics_write_stats_json(char *buf, size_t size); //returns number of bytes written or -1 on error
+
+#ifdef __cplusplus
+}
+
+namespace MicroOcpp {
+namespace Metrics {
+
+void record(mo_metrics_histogram_type type, unsigned long us);
+void count(mo_metrics_counter_type type, unsigned long n = 1);
+
+void recordOp(const char *operationType, mo_metrics_op_histogram_type type, unsigned long us);
+void countOp(const char *operationType, mo_metrics_op_counter_type type);
+
+//records the lifetime of this object into a histogram
+class ScopedTimer {
+private:
+    mo_metrics_histogram_type type;
+    unsigned long t_start;
+public:
+    ScopedTimer(mo_metrics_histogram_type type);
+    ~ScopedTimer();
+};
+
+} //namespace Metrics
+} //namespace MicroOcpp
+
+#define MO_METRICS_RECORD(TYPE, US) MicroOcpp::Metrics::record(TYPE, US)
+#define MO_METRICS_COUNT(...) MicroOcpp::Metrics::count(__VA_ARGS__)
+#define MO_METRICS_RECORD_OP(OP, TYPE, US) MicroOcpp::Metrics::recordOp(OP, TYPE, US)
+#define MO_METRICS_COUNT_OP(OP, TYPE) MicroOcpp::Metrics::countOp(OP, TYPE)
+#define MO_METRICS_TIME_SCOPE(TYPE) MicroOcpp::Metrics::ScopedTimer _mo_metrics_timer {TYPE}
+
+#endif //__cplusplus
+
+#else
+#define MO_METRICS_RECORD(...) (void)0
+#define MO_METRICS_COUNT(...) (void)0
+#define MO_METRICS_RECORD_OP(...) (void)0
+#define MO_METRICS_COUNT_OP(...) (void)0
+#define MO_METRICS_TIME_SCOPE(...) (void)0
+#endif //MO_ENABLE_METRICS
+
+#endif
@@ -21,6 +21,7 @@
 #include <memory>
 #include <ArduinoJson.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Core/JsonView.h>
 
 namespace MicroOcpp {
 
@@ -46,6 +47,24 @@ public:
 
 
     virtual void processConf(JsonObject payload);
+
+    /*
+     * Returns true if the confirmation payload has no fields. Then the response is accepted on the raw input and
+     * processConf(JsonObject) is called with an empty object
+     */
+    virtual bool hasEmptyConf() {return false;}
+
+    /*
+     * Process the confirmation payload on the raw input without deserializing it. Operations which only read a
+     * few fields can implement this and return true. Returns false if processConf(JsonObject) is needed instead
+     */
+    virtual bool processConfView(const JsonView& payload) {
+        if (!hasEmptyConf()) {
+            return false;
+        }
+        processConf(JsonObject());
+        return true;
+    }
     
     /*
      * returns if the operation must be aborted
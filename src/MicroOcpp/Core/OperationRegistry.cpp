@@ -7,35 +7,87 @@
 #include <MicroOcpp/Core/Request.h>
 #include <MicroOcpp/Core/OcppError.h>
 #include <MicroOcpp/Debug.h>
-#include <algorithm>
 
 using namespace MicroOcpp;
 
-OperationRegistry::OperationRegistry() : registry(makeVector<OperationCreator>("OperationRegistry")) {
+namespace MicroOcpp {
 
+uint32_t hashOperationType(const char *operationType) {
+    //FNV-1a
+    uint32_t hash = 2166136261U;
+    for (const char *c = operationType; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+    }
+    return hash;
+}
+
+} //namespace MicroOcpp
+
+OperationRegistry::OperationRegistry() : registry(makeVector<OperationCreator>("OperationRegistry")), index(makeVector<size_t>("OperationRegistry")) {
+
+}
+
+void OperationRegistry::addToIndex(size_t position) {
+
+    //grow at a load factor of 3/4
+    if (4 * registry.size() > 3 * index.size()) {
+        size_t capacity = index.empty() ? 64 : 2 * index.size();
+        index.assign(capacity, 0);
+
+        size_t mask = capacity - 1;
+        for (size_t p = 0; p < registry.size(); p++) {
+            size_t i = registry[p].hash & mask;
+            while (index[i]) {
+                i = (i + 1) & mask;
+            }
+            index[i] = p + 1;
+        }
+        return; //the rehash includes the new entry
+    }
+
+    size_t mask = index.size() - 1;
+    size_t i = registry[position].hash & mask;
+    while (index[i]) {
+        i = (i + 1) & mask;
+    }
+    index[i] = position + 1;
 }
 
 OperationCreator *OperationRegistry::findCreator(const char *operationType) {
-    for (auto it = registry.begin(); it != registry.end(); ++it) {
-        if (!strcmp(it->operationType, operationType)) {
-            return &*it;
+    if (index.empty()) {
+        return nullptr;
+    }
+
+    uint32_t hash = hashOperationType(operationType);
+    size_t mask = index.size() - 1;
+    for (size_t i = hash & mask; index[i]; i = (i + 1) & mask) {
+        auto& entry = registry[index[i] - 1];
+        if (entry.hash == hash && !strcmp(entry.operationType, operationType)) {
+            return &entry;
         }
     }
     return nullptr;
 }
 
 void OperationRegistry::registerOperation(const char *operationType, std::function<Operation*()> creator) {
-    registry.erase(std::remove_if(registry.begin(), registry.end(),
-                [operationType] (const OperationCreator& el) {
-                    return !strcmp(operationType, el.operationType);
-                }),
-            registry.end());
-    
+
+    if (auto entry = findCreator(operationType)) {
+        //replace existing entry, including its listeners
+        entry->operationType = operationType;
+        entry->creator = creator;
+        entry->onRequest = nullptr;
+        entry->onResponse = nullptr;
+        MO_DBG_DEBUG("registered operation %s", operationType);
+        return;
+    }
+
     OperationCreator entry;
     entry.operationType = operationType;
+    entry.hash = hashOperationType(operationType);
     entry.creator = creator;
 
     registry.push_back(entry);
+    addToIndex(registry.size() - 1);
 
     MO_DBG_DEBUG("registered operation %s", operationType);
 }
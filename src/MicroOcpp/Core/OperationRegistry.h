@@ -5,6 +5,7 @@
 #ifndef MO_OPERATIONREGISTRY_H
 #define MO_OPERATIONREGISTRY_H
 
+#include <stdint.h>
 #include <functional>
 #include <memory>
 #include <MicroOcpp/Core/Memory.h>
@@ -15,8 +16,11 @@ namespace MicroOcpp {
 class Operation;
 class Request;
 
+uint32_t hashOperationType(const char *operationType); //FNV-1a hash of the action name, used by the registry index
+
 struct OperationCreator {
     const char *operationType {nullptr};
+    uint32_t hash {0};
     std::function<Operation*()> creator {nullptr};
     OnReceiveReqListener onRequest {nullptr};
     OnSendConfListener onResponse {nullptr};
@@ -25,6 +29,15 @@ struct OperationCreator {
 class OperationRegistry {
 private:
     Vector<OperationCreator> registry;
+
+    /*
+     * Hash index over registry. Open addressing with linear probing, the capacity is a power of two. Each slot
+     * holds the registry position + 1, or 0 if empty. Operations are never unregistered, so there are no
+     * tombstones
+     */
+    Vector<size_t> index;
+    void addToIndex(size_t position);
+
     OperationCreator *findCreator(const char *operationType);
 
 public:
@@ -33,6 +33,13 @@ using namespace MicroOcpp;
 Request::Request(std::unique_ptr<Operation> msg) : MemoryManaged("Request.", msg->getOperationType()), messageID(makeString(getMemoryTag())), operation(std::move(msg)) {
     timeout_start = mocpp_tick_ms();
     debugRequest_start = mocpp_tick_ms();
+#if MO_ENABLE_METRICS
+    metrics_created = mocpp_tick_ms();
+#endif
+    timeoutTimer.setCallback([this] () {
+        MO_DBG_INFO("operation timeout: %s", getOperationType());
+        executeTimeout();
+    });
 }
 
 Request::~Request(){
@@ -45,6 +52,9 @@ Operation *Request::getOperation(){
 
 void Request::setTimeout(unsigned long timeout) {
     this->timeout_period = timeout;
+    if (timeoutTimer.isScheduled()) {
+        scheduleTimeout(*timeoutTimer.getWheel());
+    }
 }
 
 bool Request::isTimeoutExceeded() {
@@ -53,12 +63,27 @@ bool Request::isTimeoutExceeded() {
 
 void Request::executeTimeout() {
     if (!timed_out) {
+        MO_METRICS_COUNT_OP(getOperationType(), MO_METRICS_OP_TIMEOUT);
         onTimeoutListener();
         onAbortListener();
     }
     timed_out = true;
 }
 
+void Request::scheduleTimeout(TimerWheel& timerWheel) {
+    if (timed_out || !timeout_period) {
+        timeoutTimer.cancel();
+        return;
+    }
+
+    unsigned long elapsed = mocpp_tick_ms() - timeout_start;
+    timerWheel.schedule(timeoutTimer, elapsed < timeout_period ? timeout_period - elapsed : 0);
+}
+
+bool Request::isTimedOut() {
+    return timed_out;
+}
+
 void Request::setMessageID(const char *id){
     if (!messageID.empty()){
         MO_DBG_ERR("messageID already defined");
@@ -126,6 +151,11 @@ bool Request::receiveResponse(JsonArray response){
 
     if (messageTypeId == MESSAGE_TYPE_CALLRESULT) {
 
+#if MO_ENABLE_METRICS
+        MO_METRICS_RECORD_OP(getOperationType(), MO_METRICS_OP_ROUNDTRIP_TIME, (mocpp_tick_ms() - metrics_sent) * 1000UL);
+        MO_METRICS_COUNT_OP(getOperationType(), MO_METRICS_OP_CONF_RECEIVED);
+#endif
+
         /*
         * Hand the payload over to the Operation object
         */
@@ -143,6 +173,11 @@ bool Request::receiveResponse(JsonArray response){
         return true;
     } else if (messageTypeId == MESSAGE_TYPE_CALLERROR) {
 
+#if MO_ENABLE_METRICS
+        MO_METRICS_RECORD_OP(getOperationType(), MO_METRICS_OP_ROUNDTRIP_TIME, (mocpp_tick_ms() - metrics_sent) * 1000UL);
+        MO_METRICS_COUNT_OP(getOperationType(), MO_METRICS_OP_ERR_RECEIVED);
+#endif
+
         /*
         * Hand the error over to the Operation object
         */
@@ -164,6 +199,37 @@ bool Request::receiveResponse(JsonArray response){
 
 }
 
+bool Request::receiveResponse(const JsonView& message) {
+
+    if (hasConfListener) {
+        return false;
+    }
+
+    //CALLRESULT frame: [3, "<messageId>", {<payload>}]. Anything else is left to the DOM path
+    if (!message.isArray() || message.size() != 3) {
+        return false;
+    }
+
+    JsonView messageTypeId = message.at(0);
+    JsonView msgId = message.at(1);
+    if (!messageTypeId.isNumber() || messageTypeId.asInt(-1) != MESSAGE_TYPE_CALLRESULT ||
+            !msgId.isString() || !msgId.equals(messageID.c_str())) {
+        return false;
+    }
+
+    JsonView payload = message.at(2);
+    if (!payload.isObject() || !operation->processConfView(payload)) {
+        return false;
+    }
+
+#if MO_ENABLE_METRICS
+    MO_METRICS_RECORD_OP(getOperationType(), MO_METRICS_OP_ROUNDTRIP_TIME, (mocpp_tick_ms() - metrics_sent) * 1000UL);
+    MO_METRICS_COUNT_OP(getOperationType(), MO_METRICS_OP_CONF_RECEIVED);
+#endif
+
+    return true;
+}
+
 bool Request::receiveRequest(JsonArray request) {
 
     if (!request[1].is<const char*>()) {
@@ -172,6 +238,11 @@ bool Request::receiveRequest(JsonArray request) {
     }
   
     setMessageID(request[1].as<const char*>());
+
+#if MO_ENABLE_METRICS
+    MO_METRICS_COUNT_OP(getOperationType(), MO_METRICS_OP_REQ_RECEIVED);
+    auto metrics_start = mocpp_tick_us();
+#endif
     
     /*
      * Hand the payload over to the Request object
@@ -184,6 +255,10 @@ bool Request::receiveRequest(JsonArray request) {
      */
     onReceiveReqListener(payload);
 
+#if MO_ENABLE_METRICS
+    MO_METRICS_RECORD_OP(getOperationType(), MO_METRICS_OP_PROCESSING_TIME, mocpp_tick_us() - metrics_start);
+#endif
+
     return true; //success
 }
 
@@ -237,8 +312,10 @@ Request::CreateResponseResult Request::createResponse(JsonDoc& response) {
 }
 
 void Request::setOnReceiveConfListener(OnReceiveConfListener onReceiveConf){
-    if (onReceiveConf)
+    if (onReceiveConf) {
         onReceiveConfListener = onReceiveConf;
+        hasConfListener = true;
+    }
 }
 
 /**
@@ -275,6 +352,12 @@ const char *Request::getOperationType() {
 
 void Request::setRequestSent() {
     requestSent = true;
+
+#if MO_ENABLE_METRICS
+    metrics_sent = mocpp_tick_ms();
+    MO_METRICS_RECORD_OP(getOperationType(), MO_METRICS_OP_QUEUE_TIME, (metrics_sent - metrics_created) * 1000UL);
+    MO_METRICS_COUNT_OP(getOperationType(), MO_METRICS_OP_REQ_SENT);
+#endif
 }
 
 bool Request::isRequestSent() {
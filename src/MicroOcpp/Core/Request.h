@@ -14,6 +14,9 @@
 #include <MicroOcpp/Core/RequestCallbacks.h>
 
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Core/Metrics.h>
+#include <MicroOcpp/Core/TimerWheel.h>
+#include <MicroOcpp/Core/JsonView.h>
 
 namespace MicroOcpp {
 
@@ -31,14 +34,21 @@ private:
     OnTimeoutListener onTimeoutListener = [] () {};
     OnReceiveErrorListener onReceiveErrorListener = [] (const char *code, const char *description, JsonObject details) {};
     OnAbortListener onAbortListener = [] () {};
+    bool hasConfListener = false; //onReceiveConfListener requires the deserialized payload
 
     unsigned long timeout_start = 0;
     unsigned long timeout_period = 40000;
     bool timed_out = false;
+    Timer timeoutTimer;
     
     unsigned long debugRequest_start = 0;
 
     bool requestSent = false;
+
+#if MO_ENABLE_METRICS
+    unsigned long metrics_created = 0; //timestamps for queue time and round-trip time
+    unsigned long metrics_sent = 0;
+#endif
 public:
 
     Request(std::unique_ptr<Operation> msg);
@@ -50,6 +60,8 @@ public:
     void setTimeout(unsigned long timeout); //0 = disable timeout
     bool isTimeoutExceeded();
     void executeTimeout(); //call Timeout Listener
+    void scheduleTimeout(TimerWheel& timerWheel); //execute timeout via timer wheel
+    bool isTimedOut(); //if executeTimeout() has been called
     void setOnTimeoutListener(OnTimeoutListener onTimeout);
 
     /**
@@ -73,6 +85,12 @@ public:
     */
     bool receiveResponse(JsonArray json);
 
+    /*
+     * Processes a CALLRESULT on the raw input if the Operation supports it (see Operation::processConfView) and no
+     * conf listener is set. Returns false if the message must be deserialized and passed to receiveResponse(JsonArray)
+     */
+    bool receiveResponse(const JsonView& message);
+
     /**
      * Processes the request in the JSON document. Returns true on success, false on error.
      * 
@@ -3,12 +3,17 @@
 // MIT License
 
 #include <limits>
+#include <algorithm>
 
 #include <MicroOcpp/Core/RequestQueue.h>
 #include <MicroOcpp/Core/Request.h>
 #include <MicroOcpp/Core/Connection.h>
 #include <MicroOcpp/Core/OcppError.h>
 #include <MicroOcpp/Core/OperationRegistry.h>
+#include <MicroOcpp/Core/TimerWheel.h>
+#include <MicroOcpp/Core/JsonScanner.h>
+#include <MicroOcpp/Core/JsonView.h>
+#include <MicroOcpp/Core/Metrics.h>
 #include <MicroOcpp/Operations/StatusNotification.h>
 
 #include <MicroOcpp/Debug.h>
@@ -26,32 +31,24 @@ VolatileRequestQueue::~VolatileRequestQueue() = default;
 void VolatileRequestQueue::loop() {
 
     /*
-     * Drop timed out operations
+     * Drop timed out operations. The timer wheel has already executed their timeout listeners. Close the gaps
+     * in one pass
      */
-    size_t i = 0;
-    while (i < len) {
-        size_t index = (front + i) % MO_REQUEST_CACHE_MAXSIZE;
-        auto& request = requests[index];
-
-        if (request->isTimeoutExceeded()) {
-            MO_DBG_INFO("operation timeout: %s", request->getOperationType());
-            request->executeTimeout();
-
-            if (index == front) {
-                requests[front].reset();
-                front = (front + 1) % MO_REQUEST_CACHE_MAXSIZE;
-                len--;
-            } else {
-                requests[index].reset();
-                for (size_t i = (index + MO_REQUEST_CACHE_MAXSIZE - front) % MO_REQUEST_CACHE_MAXSIZE; i < len - 1; i++) {
-                    requests[(front + i) % MO_REQUEST_CACHE_MAXSIZE] = std::move(requests[(front + i + 1) % MO_REQUEST_CACHE_MAXSIZE]);
-                }
-                len--;
-            }
-        } else {
-            i++;
+    size_t kept = 0;
+    for (size_t i = 0; i < len; i++) {
+        auto& request = requests[(front + i) % MO_REQUEST_CACHE_MAXSIZE];
+
+        if (request->isTimedOut()) {
+            request.reset();
+            continue;
+        }
+
+        if (kept != i) {
+            requests[(front + kept) % MO_REQUEST_CACHE_MAXSIZE] = std::move(request);
         }
+        kept++;
     }
+    len = kept;
 }
 
 unsigned int VolatileRequestQueue::getFrontRequestOpNr() {
@@ -119,8 +116,8 @@ bool VolatileRequestQueue::pushRequestBack(std::unique_ptr<Request> request) {
     return true;
 }
 
-RequestQueue::RequestQueue(Connection& connection, OperationRegistry& operationRegistry)
-            : MemoryManaged("RequestQueue"), connection(connection), operationRegistry(operationRegistry) {
+RequestQueue::RequestQueue(Connection& connection, OperationRegistry& operationRegistry, TimerWheel& timerWheel)
+            : MemoryManaged("RequestQueue"), connection(connection), operationRegistry(operationRegistry), timerWheel(timerWheel) {
 
     ReceiveTXTcallback callback = [this] (const char *payload, size_t length) {
         return this->receiveMessage(payload, length);
@@ -135,21 +132,21 @@ RequestQueue::RequestQueue(Connection& connection, OperationRegistry& operationR
 void RequestQueue::loop() {
 
     /*
-     * Check if front request timed out
+     * Drop timed out requests. The timeouts are executed by the timer wheel, so only check the queue if a timer
+     * has fired since the last loop
      */
-    if (sendReqFront && sendReqFront->isTimeoutExceeded()) {
-        MO_DBG_INFO("operation timeout: %s", sendReqFront->getOperationType());
-        sendReqFront->executeTimeout();
+    if (sendReqFront && sendReqFront->isTimedOut()) {
         sendReqFront.reset();
     }
 
-    if (recvReqFront && recvReqFront->isTimeoutExceeded()) {
-        MO_DBG_INFO("operation timeout: %s", recvReqFront->getOperationType());
-        recvReqFront->executeTimeout();
+    if (recvReqFront && recvReqFront->isTimedOut()) {
         recvReqFront.reset();
     }
 
-    defaultSendQueue.loop();
+    if (timerWheel.getFiredCount() != trackTimerWheelFiredCount) {
+        trackTimerWheelFiredCount = timerWheel.getFiredCount();
+        defaultSendQueue.loop();
+    }
 
     if (!connection.isConnected()) {
         return;
@@ -163,6 +160,9 @@ void RequestQueue::loop() {
 
     if (!recvReqFront) {
         recvReqFront = recvQueue.fetchFrontRequest();
+        if (recvReqFront) {
+            recvReqFront->scheduleTimeout(timerWheel);
+        }
     }
 
     if (recvReqFront) {
@@ -178,6 +178,10 @@ void RequestQueue::loop() {
 
             if (success) {
                 MO_DBG_TRAFFIC_OUT(out.c_str());
+                MO_METRICS_COUNT(MO_METRICS_MSG_SENT);
+                MO_METRICS_COUNT(MO_METRICS_BYTES_SENT, out.length());
+                trackLastSend = mocpp_tick_ms();
+                trackSendValid = true;
                 recvReqFront.reset();
             }
 
@@ -203,6 +207,9 @@ void RequestQueue::loop() {
 
         if (index < MO_NUM_REQUEST_QUEUES) {
             sendReqFront = sendQueues[index]->fetchFrontRequest();
+            if (sendReqFront) {
+                sendReqFront->scheduleTimeout(timerWheel);
+            }
         }
     }
 
@@ -221,6 +228,10 @@ void RequestQueue::loop() {
 
             if (success) {
                 MO_DBG_TRAFFIC_OUT(out.c_str());
+                MO_METRICS_COUNT(MO_METRICS_MSG_SENT);
+                MO_METRICS_COUNT(MO_METRICS_BYTES_SENT, out.length());
+                trackLastSend = mocpp_tick_ms();
+                trackSendValid = true;
                 sendReqFront->setRequestSent(); //mask as sent and wait for response / timeout
             }
 
@@ -229,8 +240,9 @@ void RequestQueue::loop() {
     }
 }
 
-void RequestQueue::sendRequest(std::unique_ptr<Request> op){
-    defaultSendQueue.pushRequestBack(std::move(op));
+bool RequestQueue::sendRequest(std::unique_ptr<Request> op){
+    op->scheduleTimeout(timerWheel);
+    return defaultSendQueue.pushRequestBack(std::move(op));
 }
 
 void RequestQueue::sendRequestPreBoot(std::unique_ptr<Request> op){
@@ -238,6 +250,7 @@ void RequestQueue::sendRequestPreBoot(std::unique_ptr<Request> op){
         MO_DBG_ERR("did not set PreBoot queue");
         return;
     }
+    op->scheduleTimeout(timerWheel);
     preBootSendQueue->pushRequestBack(std::move(op));
 }
 
@@ -260,9 +273,31 @@ unsigned int RequestQueue::getNextOpNr() {
     return nextOpNr++;
 }
 
+bool RequestQueue::getLastSend(unsigned long& lastSendOut) {
+    lastSendOut = trackLastSend;
+    return trackSendValid;
+}
+
+bool RequestQueue::getLastRecv(unsigned long& lastRecvOut) {
+    lastRecvOut = trackLastRecv;
+    return trackRecvValid;
+}
+
 bool RequestQueue::receiveMessage(const char* payload, size_t length) {
 
     MO_DBG_TRAFFIC_IN((int) length, payload);
+    MO_METRICS_COUNT(MO_METRICS_MSG_RECEIVED);
+    MO_METRICS_COUNT(MO_METRICS_BYTES_RECEIVED, length);
+
+#if MO_ENABLE_JSON_VIEW
+    if (sendReqFront && sendReqFront->receiveResponse(JsonView(payload, length))) {
+        //the pending Operation processed the response on the raw input. No deserialization needed
+        sendReqFront.reset();
+        trackLastRecv = mocpp_tick_ms();
+        trackRecvValid = true;
+        return true;
+    }
+#endif //MO_ENABLE_JSON_VIEW
 
     size_t capacity_init = (3 * length) / 2;
 
@@ -275,17 +310,24 @@ bool RequestQueue::receiveMessage(const char* payload, size_t length) {
     if (capacity > MO_MAX_JSON_CAPACITY) {
         capacity = MO_MAX_JSON_CAPACITY;
     }
+
+#if MO_ENABLE_JSON_SCANNER
+    JsonScanResult scanResult;
+    if (JsonScanner::scan(payload, length, scanResult)) {
+        //sufficient capacity for a single deserialization pass. Clamp to the limit, the estimate is an upper bound
+        capacity = std::min(JsonScanner::estimateCapacity(scanResult), (size_t) MO_MAX_JSON_CAPACITY);
+    }
+#endif //MO_ENABLE_JSON_SCANNER
     
     auto doc = initJsonDoc(getMemoryTag());
     DeserializationError err = DeserializationError::NoMemory;
 
-    while (err == DeserializationError::NoMemory && capacity <= MO_MAX_JSON_CAPACITY) {
-
+    do {
         doc = initJsonDoc(getMemoryTag(), capacity);
         err = deserializeJson(doc, payload, length);
 
         capacity *= 2;
-    }
+    } while (err == DeserializationError::NoMemory && capacity <= MO_MAX_JSON_CAPACITY);
 
     bool success = false;
 
@@ -341,6 +383,12 @@ bool RequestQueue::receiveMessage(const char* payload, size_t length) {
             break;
     }
 
+    if (success) {
+        //the server is alive
+        trackLastRecv = mocpp_tick_ms();
+        trackRecvValid = true;
+    }
+
     return success;
 }
 
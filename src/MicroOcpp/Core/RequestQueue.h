@@ -9,6 +9,7 @@
 
 #include <MicroOcpp/Core/Connection.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Profile.h>
 
 #include <memory>
 #include <ArduinoJson.h>
@@ -26,6 +27,7 @@ namespace MicroOcpp {
 class Connection;
 class OperationRegistry;
 class Request;
+class TimerWheel;
 
 class RequestEmitter {
 public:
@@ -42,7 +44,7 @@ private:
 public:
     VolatileRequestQueue();
     ~VolatileRequestQueue();
-    void loop();
+    void loop(); //drop requests which have timed out
 
     unsigned int getFrontRequestOpNr() override;
     std::unique_ptr<Request> fetchFrontRequest() override;
@@ -54,6 +56,8 @@ class RequestQueue : public MemoryManaged {
 private:
     Connection& connection;
     OperationRegistry& operationRegistry;
+    TimerWheel& timerWheel;
+    unsigned long trackTimerWheelFiredCount = 0;
 
     RequestEmitter* sendQueues [MO_NUM_REQUEST_QUEUES];
     VolatileRequestQueue defaultSendQueue;
@@ -70,23 +74,32 @@ private:
 
     unsigned long sockTrackLastConnected = 0;
 
+    //keepalive tracking: mocpp_tick_ms() of the last message which has been sent / received successfully
+    unsigned long trackLastSend = 0;
+    bool trackSendValid = false;
+    unsigned long trackLastRecv = 0;
+    bool trackRecvValid = false;
+
     unsigned int nextOpNr = 10; //Nr 0 - 9 reservered for internal purposes
 public:
     RequestQueue() = delete;
     RequestQueue(const RequestQueue&) = delete;
     RequestQueue(const RequestQueue&&) = delete;
 
-    RequestQueue(Connection& connection, OperationRegistry& operationRegistry);
+    RequestQueue(Connection& connection, OperationRegistry& operationRegistry, TimerWheel& timerWheel);
 
     void loop(); //polls all reqQueues and decides which request to send (if any)
 
-    void sendRequest(std::unique_ptr<Request> request); //send an OCPP operation request to the server; adds request to default queue
+    bool sendRequest(std::unique_ptr<Request> request); //send an OCPP operation request to the server; adds request to default queue
     void sendRequestPreBoot(std::unique_ptr<Request> request); //send an OCPP operation request to the server; adds request to preBootQueue
 
     void addSendQueue(RequestEmitter* sendQueue);
     void setPreBootSendQueue(VolatileRequestQueue *preBootQueue);
 
     unsigned int getNextOpNr();
+
+    bool getLastSend(unsigned long& lastSendOut); //returns false if no message has been sent yet
+    bool getLastRecv(unsigned long& lastRecvOut); //returns false if no message has been received yet
 };
 
 } //end namespace MicroOcpp
@@ -351,10 +351,16 @@ bool Clock::setTime(const char* jsonDateString) {
 
     currentTime = mocpp_basetime;
     lastUpdate = system_basetime;
+    synced = true;
 
     return true;
 }
 
+bool Clock::getLastSync(decltype(mocpp_tick_ms())& lastSyncOut) const {
+    lastSyncOut = system_basetime;
+    return synced;
+}
+
 const Timestamp &Clock::now() {
     auto tReading = mocpp_tick_ms();
     auto delta = tReading - lastUpdate;
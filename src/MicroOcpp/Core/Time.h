@@ -103,6 +103,7 @@ private:
     Timestamp mocpp_basetime = Timestamp();
     decltype(mocpp_tick_ms()) system_basetime = 0; //the value of mocpp_tick_ms() when OCPP server's time was taken
     decltype(mocpp_tick_ms()) lastUpdate = 0;
+    bool synced = false; //if setTime() has been called
 
     Timestamp currentTime = Timestamp();
 
@@ -130,6 +131,11 @@ public:
      */
     bool setTime(const char* jsonDateString);
 
+    /*
+     * mocpp_tick_ms() of the last successful setTime() call. Returns false if the time has never been set
+     */
+    bool getLastSync(decltype(mocpp_tick_ms())& lastSyncOut) const;
+
     /*
      * Timestamps which were taken before the Clock was initially set can be adjusted retrospectively. Two
      * conditions must be true: the Clock was set in the meantime and the Timestamp was taken at the same
@@ -0,0 +1,176 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/TimerWheel.h>
+#include <MicroOcpp/Platform.h>
+#include <MicroOcpp/Debug.h>
+
+using namespace MicroOcpp;
+
+Timer::~Timer() {
+    cancel();
+}
+
+void Timer::setCallback(std::function<void()> callback) {
+    this->callback = callback;
+}
+
+bool Timer::isScheduled() const {
+    return pprev != nullptr;
+}
+
+TimerWheel *Timer::getWheel() const {
+    return wheel;
+}
+
+void Timer::cancel() {
+    if (!pprev) {
+        return;
+    }
+
+    *pprev = next;
+    if (next) {
+        next->pprev = pprev;
+    }
+    next = nullptr;
+    pprev = nullptr;
+
+    if (wheel) {
+        wheel->scheduled--;
+    }
+}
+
+TimerWheel::TimerWheel() : MemoryManaged("TimerWheel") {
+
+}
+
+TimerWheel::~TimerWheel() {
+    //timers may outlive the wheel. Unlink them without touching the lists anymore
+    for (size_t i = 0; i < MO_TIMERWHEEL_SLOTS; i++) {
+        detachAll(inner[i]);
+        detachAll(outer[i]);
+    }
+    detachAll(overflow);
+    detachAll(firing);
+}
+
+void TimerWheel::detachAll(Timer *&list) {
+    while (list) {
+        Timer *timer = list;
+        list = timer->next;
+        timer->next = nullptr;
+        timer->pprev = nullptr;
+        timer->wheel = nullptr;
+    }
+}
+
+void TimerWheel::start() {
+    if (!started) {
+        tickTime = mocpp_tick_ms();
+        started = true;
+    }
+}
+
+void TimerWheel::insert(Timer& timer) {
+    unsigned long delta = timer.expiry - ticks;
+
+    Timer **list;
+    if (delta < MO_TIMERWHEEL_SLOTS) {
+        list = &inner[timer.expiry % MO_TIMERWHEEL_SLOTS];
+    } else if (delta < (unsigned long)MO_TIMERWHEEL_SLOTS * MO_TIMERWHEEL_SLOTS) {
+        list = &outer[(timer.expiry / MO_TIMERWHEEL_SLOTS) % MO_TIMERWHEEL_SLOTS];
+    } else {
+        list = &overflow;
+    }
+
+    timer.next = *list;
+    if (*list) {
+        (*list)->pprev = &timer.next;
+    }
+    *list = &timer;
+    timer.pprev = list;
+}
+
+void TimerWheel::cascade(Timer *&list) {
+    //take list and distribute its timers onto the wheel again
+    Timer *timer = list;
+    list = nullptr;
+    while (timer) {
+        Timer *next = timer->next;
+        insert(*timer);
+        timer = next;
+    }
+}
+
+void TimerWheel::schedule(Timer& timer, unsigned long delay_ms) {
+    timer.cancel();
+    start();
+
+    //the wheel position lags behind if loop() hasn't been called recently. Round up to never fire early
+    unsigned long delay = (mocpp_tick_ms() - tickTime) + delay_ms;
+    unsigned long delayTicks = (delay + MO_TIMERWHEEL_RESOLUTION - 1) / MO_TIMERWHEEL_RESOLUTION;
+    if (delayTicks < 1) {
+        delayTicks = 1; //the current slot has already been executed
+    }
+
+    timer.wheel = this;
+    timer.expiry = ticks + delayTicks;
+    insert(timer);
+    scheduled++;
+}
+
+void TimerWheel::loop() {
+    start();
+
+    auto now = mocpp_tick_ms();
+
+    if (!scheduled) {
+        //nothing to execute. Skip forward
+        unsigned long steps = (now - tickTime) / MO_TIMERWHEEL_RESOLUTION;
+        if (steps >= MO_TIMERWHEEL_SLOTS) {
+            ticks += steps;
+            tickTime += steps * MO_TIMERWHEEL_RESOLUTION;
+        }
+    }
+
+    while (now - tickTime >= MO_TIMERWHEEL_RESOLUTION) {
+        tickTime += MO_TIMERWHEEL_RESOLUTION;
+        ticks++;
+
+        if (ticks % MO_TIMERWHEEL_SLOTS == 0) {
+            if (ticks % ((unsigned long)MO_TIMERWHEEL_SLOTS * MO_TIMERWHEEL_SLOTS) == 0) {
+                cascade(overflow);
+            }
+            cascade(outer[(ticks / MO_TIMERWHEEL_SLOTS) % MO_TIMERWHEEL_SLOTS]);
+        }
+
+        auto& slot = inner[ticks % MO_TIMERWHEEL_SLOTS];
+        if (!slot) {
+            continue;
+        }
+
+        //move due timers to a separate list. Callbacks can schedule and cancel any timer meanwhile
+        firing = slot;
+        firing->pprev = &firing;
+        slot = nullptr;
+
+        while (firing) {
+            Timer *timer = firing;
+            timer->cancel();
+            firedCount++;
+            if (timer->callback) {
+                auto callback = timer->callback; //the callback may destroy the timer
+                callback();
+            }
+        }
+    }
+}
+
+size_t TimerWheel::getScheduledCount() const {
+    return scheduled;
+}
+
+unsigned long TimerWheel::getFiredCount() const {
+    return firedCount;
+}
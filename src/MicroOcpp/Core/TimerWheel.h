@@ -0,0 +1,93 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Hierarchical timer wheel for deadlines which are checked on every loop iteration. Scheduling and cancelling
+ * a timer is O(1), and advancing the wheel only touches the timers which are due.
+ *
+ * The inner wheel has MO_TIMERWHEEL_SLOTS slots with a resolution of MO_TIMERWHEEL_RESOLUTION ms. The outer wheel
+ * has the same number of slots, each spanning one full turn of the inner wheel. Timers beyond the outer wheel are
+ * kept in an overflow list which is redistributed once per turn of the outer wheel. Timers never fire early and
+ * at most one resolution step late.
+ */
+
+#ifndef MO_TIMERWHEEL_H
+#define MO_TIMERWHEEL_H
+
+#include <functional>
+
+#include <MicroOcpp/Core/Memory.h>
+
+#ifndef MO_TIMERWHEEL_RESOLUTION
+#define MO_TIMERWHEEL_RESOLUTION 100 //in ms
+#endif
+
+#ifndef MO_TIMERWHEEL_SLOTS
+#define MO_TIMERWHEEL_SLOTS 64
+#endif
+
+namespace MicroOcpp {
+
+class TimerWheel;
+
+//Intrusive timer node. The owner embeds the Timer; destroying it cancels the timer
+class Timer {
+private:
+    friend class TimerWheel;
+
+    TimerWheel *wheel = nullptr;
+    Timer *next = nullptr;
+    Timer **pprev = nullptr; //pointer to the pointer which refers to this timer
+    unsigned long expiry = 0; //in ticks of the wheel
+
+    std::function<void()> callback;
+public:
+    Timer() = default;
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    ~Timer();
+
+    void setCallback(std::function<void()> callback);
+
+    bool isScheduled() const;
+    TimerWheel *getWheel() const; //wheel of the last schedule() call, or nullptr
+
+    void cancel();
+};
+
+class TimerWheel : public MemoryManaged {
+private:
+    friend class Timer;
+
+    Timer *inner [MO_TIMERWHEEL_SLOTS] = {nullptr};
+    Timer *outer [MO_TIMERWHEEL_SLOTS] = {nullptr};
+    Timer *overflow = nullptr;
+    Timer *firing = nullptr;
+
+    unsigned long ticks = 0; //current position
+    unsigned long tickTime = 0; //mocpp_tick_ms() of the current position
+    bool started = false;
+
+    size_t scheduled = 0;
+    unsigned long firedCount = 0;
+
+    void start();
+    void insert(Timer& timer);
+    void cascade(Timer *&list);
+    void detachAll(Timer *&list);
+public:
+    TimerWheel();
+    ~TimerWheel();
+
+    void schedule(Timer& timer, unsigned long delay_ms); //(re)schedule timer to fire after delay_ms
+
+    void loop(); //advance to mocpp_tick_ms() and execute due timers
+
+    size_t getScheduledCount() const;
+    unsigned long getFiredCount() const; //increments whenever a timer fires. Lets owners skip cleanup if nothing happened
+};
+
+} //namespace MicroOcpp
+
+#endif
@@ -13,6 +13,7 @@
 #include <mbedtls/md.h>
 #include <mbedtls/error.h>
 
+#include <MicroOcpp/Core/FilesystemUtils.h>
 #include <MicroOcpp/Debug.h>
 
 bool ocpp_get_cert_hash(mbedtls_x509_crt& cacert, HashAlgorithmType hashAlg, ocpp_cert_hash *out) {
@@ -138,6 +139,112 @@ class CertificateStoreMbedTLS : public CertificateStore, public MemoryManaged {
 private:
     std::shared_ptr<FilesystemAdapter> filesystem;
 
+#if MO_ENABLE_CERT_STORE_INDEX
+    struct IndexEntry {
+        bool valid = false;
+        size_t fsize = 0; //size of the cert file when the hash was computed
+        CertificateHash hash; //SHA256
+    };
+
+    IndexEntry index [2] [MO_CERT_STORE_SIZE]; //CSMS root, Manufacturer root
+    bool indexDirty = false;
+
+    static int getIndexType(const char *certTypeFnStr) {
+        return !strcmp(certTypeFnStr, MO_CERT_FN_CSMS_ROOT) ? 0 :
+               !strcmp(certTypeFnStr, MO_CERT_FN_MANUFACTURER_ROOT) ? 1 : -1;
+    }
+
+    void loadIndex() {
+        auto doc = FilesystemUtils::loadJson(filesystem, MO_FILENAME_PREFIX MO_CERT_FN_PREFIX MO_CERT_FN_INDEX, getMemoryTag());
+        if (!doc) {
+            return; //no index yet, or index file corrupt. Will be rebuilt on the next access
+        }
+
+        const char *certTypeFnStrs [] = {MO_CERT_FN_CSMS_ROOT, MO_CERT_FN_MANUFACTURER_ROOT};
+        for (size_t type = 0; type < 2; type++) {
+            JsonArray slots = (*doc)[certTypeFnStrs[type]];
+            for (size_t i = 0; i < MO_CERT_STORE_SIZE && i < slots.size(); i++) {
+                JsonObject entryJson = slots[i];
+                if (entryJson.isNull()) {
+                    continue;
+                }
+
+                IndexEntry& entry = index[type][i];
+                entry.fsize = entryJson["size"] | (size_t)0;
+                entry.hash.hashAlgorithm = HashAlgorithmType_SHA256;
+                entry.valid = entry.fsize > 0 &&
+                        ocpp_cert_set_issuerNameHash(&entry.hash, entryJson["issuerNameHash"] | "", HashAlgorithmType_SHA256) >= 0 &&
+                        ocpp_cert_set_issuerKeyHash(&entry.hash, entryJson["issuerKeyHash"] | "", HashAlgorithmType_SHA256) >= 0 &&
+                        ocpp_cert_set_serialNumber(&entry.hash, entryJson["serialNumber"] | "") >= 0;
+            }
+        }
+    }
+
+    bool storeIndex() {
+        if (!indexDirty) {
+            return true;
+        }
+
+        auto doc = makeJsonDoc(getMemoryTag(),
+                2 * JSON_ARRAY_SIZE(MO_CERT_STORE_SIZE) +
+                2 * MO_CERT_STORE_SIZE * (JSON_OBJECT_SIZE(4) + 2 * MO_CERT_HASH_ISSUER_NAME_KEY_SIZE + MO_CERT_HASH_SERIAL_NUMBER_SIZE) +
+                JSON_OBJECT_SIZE(2));
+
+        const char *certTypeFnStrs [] = {MO_CERT_FN_CSMS_ROOT, MO_CERT_FN_MANUFACTURER_ROOT};
+        for (size_t type = 0; type < 2; type++) {
+            JsonArray slots = doc->createNestedArray(certTypeFnStrs[type]);
+            for (size_t i = 0; i < MO_CERT_STORE_SIZE; i++) {
+                IndexEntry& entry = index[type][i];
+                if (!entry.valid) {
+                    slots.add(nullptr);
+                    continue;
+                }
+
+                JsonObject entryJson = slots.createNestedObject();
+                entryJson["size"] = entry.fsize;
+
+                char buf [MO_CERT_HASH_ISSUER_NAME_KEY_SIZE];
+                ocpp_cert_print_issuerNameHash(&entry.hash, buf, sizeof(buf));
+                entryJson["issuerNameHash"] = buf; //char* is copied into doc
+                ocpp_cert_print_issuerKeyHash(&entry.hash, buf, sizeof(buf));
+                entryJson["issuerKeyHash"] = buf;
+                ocpp_cert_print_serialNumber(&entry.hash, buf, sizeof(buf));
+                entryJson["serialNumber"] = buf;
+            }
+        }
+
+        if (doc->overflowed()) {
+            MO_DBG_ERR("index overflow");
+            return false;
+        }
+
+        if (!FilesystemUtils::storeJson(filesystem, MO_FILENAME_PREFIX MO_CERT_FN_PREFIX MO_CERT_FN_INDEX, *doc)) {
+            MO_DBG_ERR("failed to store cert index");
+            return false;
+        }
+
+        indexDirty = false;
+        return true;
+    }
+
+    void updateIndex(const char *certTypeFnStr, size_t slot, size_t fsize, const CertificateHash *hash) {
+        int type = getIndexType(certTypeFnStr);
+        if (type < 0 || slot >= MO_CERT_STORE_SIZE) {
+            return;
+        }
+        IndexEntry& entry = index[type][slot];
+        if (hash && hash->hashAlgorithm == HashAlgorithmType_SHA256) {
+            entry.valid = true;
+            entry.fsize = fsize;
+            entry.hash = *hash;
+            indexDirty = true;
+        } else if (entry.valid) {
+            entry.valid = false;
+            indexDirty = true;
+        }
+    }
+#endif //MO_ENABLE_CERT_STORE_INDEX
+
     bool getCertHash(const char *fn, HashAlgorithmType hashAlg, CertificateHash& out) {
         size_t fsize;
         if (filesystem->stat(fn, &fsize) != 0) {
@@ -183,10 +290,60 @@ private:
         MO_FREE(buf);
         return success;
     }
+
+    /*
+     * Get the hash of the cert at slot, from the index if possible. Returns false if the slot is empty or the hash
+     * can't be computed. `exists` tells both cases apart
+     */
+    bool getSlotHash(const char *certTypeFnStr, size_t slot, HashAlgorithmType hashAlg, CertificateHash& out, bool& exists) {
+        exists = false;
+
+        char fn [MO_MAX_PATH_SIZE];
+        if (!printCertFn(certTypeFnStr, slot, fn, MO_MAX_PATH_SIZE)) {
+            MO_DBG_ERR("internal error");
+            return false;
+        }
+
+        size_t fsize;
+        if (filesystem->stat(fn, &fsize) != 0) {
+#if MO_ENABLE_CERT_STORE_INDEX
+            updateIndex(certTypeFnStr, slot, 0, nullptr); //cert has been removed
+#endif
+            return false; //no cert installed at this slot
+        }
+
+        exists = true;
+
+#if MO_ENABLE_CERT_STORE_INDEX
+        int type = getIndexType(certTypeFnStr);
+        if (type >= 0 && hashAlg == HashAlgorithmType_SHA256) {
+            const IndexEntry& entry = index[type][slot];
+            if (entry.valid && entry.fsize == fsize) {
+                out = entry.hash;
+                return true;
+            }
+        }
+#endif
+
+        if (!getCertHash(fn, hashAlg, out)) {
+            MO_DBG_ERR("could not create hash: %s", fn);
+            return false;
+        }
+
+#if MO_ENABLE_CERT_STORE_INDEX
+        if (hashAlg == HashAlgorithmType_SHA256) {
+            updateIndex(certTypeFnStr, slot, fsize, &out);
+        }
+#endif
+        return true;
+    }
 public:
     CertificateStoreMbedTLS(std::shared_ptr<FilesystemAdapter> filesystem)
             : MemoryManaged("v201.Certificates.CertificateStoreMbedTLS"), filesystem(filesystem) {
 
+#if MO_ENABLE_CERT_STORE_INDEX
+        loadIndex();
+#endif
     }
 
     GetInstalledCertificateStatus getCertificateIds(const Vector<GetCertificateIdType>& certificateType, Vector<CertificateChainHash>& out) override {
@@ -211,31 +368,23 @@ public:
             }
 
             for (size_t i = 0; i < MO_CERT_STORE_SIZE; i++) {
-                char fn [MO_MAX_PATH_SIZE];
-                if (!printCertFn(certTypeFnStr, i, fn, MO_MAX_PATH_SIZE)) {
-                    MO_DBG_ERR("internal error");
-                    out.clear();
-                    break;
-                }
-
-                size_t msize;
-                if (filesystem->stat(fn, &msize) != 0) {
-                    continue; //no cert installed at this slot
-                }
-
                 out.emplace_back();
                 CertificateChainHash& rootCert = out.back();
 
                 rootCert.certificateType = certType;
 
-                if (!getCertHash(fn, HashAlgorithmType_SHA256, rootCert.certificateHashData)) {
-                    MO_DBG_ERR("could not create hash: %s", fn);
+                bool exists;
+                if (!getSlotHash(certTypeFnStr, i, HashAlgorithmType_SHA256, rootCert.certificateHashData, exists)) {
                     out.pop_back();
                     continue;
                 }
             }
         }
 
+#if MO_ENABLE_CERT_STORE_INDEX
+        storeIndex();
+#endif
+
         return out.empty() ?
                 GetInstalledCertificateStatus_NotFound :
                 GetInstalledCertificateStatus_Accepted;
@@ -248,29 +397,31 @@ public:
         for (const char *certTypeFnStr : {MO_CERT_FN_CSMS_ROOT, MO_CERT_FN_MANUFACTURER_ROOT}) {
             for (size_t i = 0; i < MO_CERT_STORE_SIZE; i++) {
 
-                char fn [MO_MAX_PATH_SIZE] = {'\0'}; //cert fn on flash storage
-
-                if (!printCertFn(certTypeFnStr, i, fn, MO_MAX_PATH_SIZE)) {
-                    MO_DBG_ERR("internal error");
-                    return DeleteCertificateStatus_Failed;
-                }
-
-                size_t msize;
-                if (filesystem->stat(fn, &msize) != 0) {
-                    continue; //no cert installed at this slot
-                }
-
                 CertificateHash probe;
-                if (!getCertHash(fn, hash.hashAlgorithm, probe)) {
-                    MO_DBG_ERR("could not create hash: %s", fn);
-                    err = true;
+                bool exists;
+                if (!getSlotHash(certTypeFnStr, i, hash.hashAlgorithm, probe, exists)) {
+                    if (exists) {
+                        err = true;
+                    }
                     continue;
                 }
 
                 if (ocpp_cert_equals(&probe, &hash)) {
                     //found, delete
 
+                    char fn [MO_MAX_PATH_SIZE] = {'\0'}; //cert fn on flash storage
+                    if (!printCertFn(certTypeFnStr, i, fn, MO_MAX_PATH_SIZE)) {
+                        MO_DBG_ERR("internal error");
+                        return DeleteCertificateStatus_Failed;
+                    }
+
                     bool success = filesystem->remove(fn);
+#if MO_ENABLE_CERT_STORE_INDEX
+                    if (success) {
+                        updateIndex(certTypeFnStr, i, 0, nullptr);
+                    }
+                    storeIndex();
+#endif
                     return success ?
                         DeleteCertificateStatus_Accepted :
                         DeleteCertificateStatus_Failed;
@@ -278,6 +429,10 @@ public:
             }
         }
 
+#if MO_ENABLE_CERT_STORE_INDEX
+        storeIndex();
+#endif
+
         return err ?
             DeleteCertificateStatus_Failed :
             DeleteCertificateStatus_NotFound;
@@ -343,10 +498,11 @@ public:
         }
 
         char fn [MO_MAX_PATH_SIZE] = {'\0'}; //cert fn on flash storage
+        size_t slot = 0;
 
         //check for free cert slot
-        for (size_t i = 0; i < MO_CERT_STORE_SIZE; i++) {
-            if (!printCertFn(certTypeFnStr, i, fn, MO_MAX_PATH_SIZE)) {
+        for (; slot < MO_CERT_STORE_SIZE; slot++) {
+            if (!printCertFn(certTypeFnStr, slot, fn, MO_MAX_PATH_SIZE)) {
                 MO_DBG_ERR("invalid cert fn");
                 return InstallCertificateStatus_Failed;
             }
@@ -374,13 +530,19 @@ public:
 
         size_t cert_len = strlen(certificate);
         auto written = file->write(certificate, cert_len);
-        if (written < cert_len) {
+        if (written < cert_len || !file->close()) {
             MO_DBG_ERR("file write error");
             file.reset();
             filesystem->remove(fn);
             return InstallCertificateStatus_Failed;
         }
 
+#if MO_ENABLE_CERT_STORE_INDEX
+        file.reset(); //file closed, update the index
+        updateIndex(certTypeFnStr, slot, cert_len, &certId);
+        storeIndex();
+#endif
+
         MO_DBG_INFO("installed certificate: %s", fn);
         return InstallCertificateStatus_Accepted;
     }
@@ -56,6 +56,18 @@ bool ocpp_get_cert_hash(const unsigned char *cert, size_t len, enum HashAlgorith
 #define MO_CERT_STORE_SIZE 3 //max number of certs per certificate type (e.g. CSMS root CA, Manufacturer root CA)
 #endif
 
+/*
+ * Keep the SHA256 cert hashes of all slots in an index file, so that certificate management requests don't need
+ * to parse the stored certs again. Index entries are validated by the file size of the cert
+ */
+#ifndef MO_ENABLE_CERT_STORE_INDEX
+#define MO_ENABLE_CERT_STORE_INDEX 1
+#endif
+
+#ifndef MO_CERT_FN_INDEX
+#define MO_CERT_FN_INDEX "index.jsn"
+#endif
+
 namespace MicroOcpp {
 
 std::unique_ptr<CertificateStore> makeCertificateStoreMbedTLS(std::shared_ptr<FilesystemAdapter> filesystem);
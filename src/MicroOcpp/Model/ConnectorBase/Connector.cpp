@@ -35,7 +35,7 @@ using namespace MicroOcpp;
 
 Connector::Connector(Context& context, std::shared_ptr<FilesystemAdapter> filesystem, unsigned int connectorId)
         : MemoryManaged("v16.ConnectorBase.Connector"), context(context), model(context.getModel()), filesystem(filesystem), connectorId(connectorId),
-          errorDataInputs(makeVector<std::function<ErrorData ()>>(getMemoryTag())), trackErrorDataInputs(makeVector<bool>(getMemoryTag())) {
+          errorDataInputs(makeVector<ConnectorInputErrorData>(getMemoryTag())), trackErrorDataInputs(makeVector<bool>(getMemoryTag())) {
 
     context.getRequestQueue().addSendQueue(this); //register at RequestQueue as Request emitter
 
@@ -454,34 +454,12 @@ void Connector::loop() {
     if (model.getVersion().major == 1 && model.getClock().now() >= MIN_TIME) {
         //OCPP 1.6: use StatusNotification to send error codes
 
-        if (reportedErrorIndex >= 0) {
-            auto error = errorDataInputs[reportedErrorIndex].operator()();
-            if (error.isError) {
-                errorData = error;
-                errorDataIndex = reportedErrorIndex;
-            }
-        }
-
-        for (auto i = std::min(errorDataInputs.size(), trackErrorDataInputs.size()); i >= 1; i--) {
-            auto index = i - 1;
-            ErrorData error {nullptr};
-            if ((int)index != errorDataIndex) {
-                error = errorDataInputs[index].operator()();
-            } else {
-                error = errorData;
-            }
-            if (error.isError && !trackErrorDataInputs[index] && error.severity >= errorData.severity) {
-                //new error
-                errorData = error;
-                errorDataIndex = index;
-            } else if (error.isError && error.severity > errorData.severity) {
-                errorData = error;
-                errorDataIndex = index;
-            } else if (!error.isError && trackErrorDataInputs[index]) {
-                //reset error
-                trackErrorDataInputs[index] = false;
-            }
+        if (errorInputsPolled || errorInputsDirty) {
+            //skip if there are only pushed error Inputs and none changed since the last evaluation
+            evaluateErrorInputs();
         }
+        errorData = evaluatedErrorData;
+        errorDataIndex = evaluatedErrorIndex;
 
         if (errorDataIndex != reportedErrorIndex) {
             if (errorDataIndex >= 0 || MO_REPORT_NOERROR) {
@@ -511,6 +489,7 @@ void Connector::loop() {
         reportedErrorIndex = errorDataIndex;
         if (errorDataIndex >= 0) {
             trackErrorDataInputs[errorDataIndex] = true;
+            errorInputsDirty = true; //the evaluation depends on which errors have been reported
         }
         Timestamp reportedTimestamp = model.getClock().now();
         reportedTimestamp -= (mocpp_tick_ms() - t_statusTransition) / 1000UL;
@@ -532,6 +511,46 @@ void Connector::loop() {
     return;
 }
 
+void Connector::evaluateErrorInputs() {
+
+    ErrorData errorData {nullptr};
+    errorData.severity = 0;
+    int errorDataIndex = -1;
+
+    if (reportedErrorIndex >= 0) {
+        auto error = errorDataInputs[reportedErrorIndex].operator()();
+        if (error.isError) {
+            errorData = error;
+            errorDataIndex = reportedErrorIndex;
+        }
+    }
+
+    for (auto i = std::min(errorDataInputs.size(), trackErrorDataInputs.size()); i >= 1; i--) {
+        auto index = i - 1;
+        ErrorData error {nullptr};
+        if ((int)index != errorDataIndex) {
+            error = errorDataInputs[index].operator()();
+        } else {
+            error = errorData;
+        }
+        if (error.isError && !trackErrorDataInputs[index] && error.severity >= errorData.severity) {
+            //new error
+            errorData = error;
+            errorDataIndex = index;
+        } else if (error.isError && error.severity > errorData.severity) {
+            errorData = error;
+            errorDataIndex = index;
+        } else if (!error.isError && trackErrorDataInputs[index]) {
+            //reset error
+            trackErrorDataInputs[index] = false;
+        }
+    }
+
+    evaluatedErrorData = errorData;
+    evaluatedErrorIndex = errorDataIndex;
+    errorInputsDirty = false;
+}
+
 bool Connector::isFaulted() {
     //for (auto i = errorDataInputs.begin(); i != errorDataInputs.end(); ++i) {
     for (size_t i = 0; i < errorDataInputs.size(); i++) {
@@ -1030,15 +1049,15 @@ void Connector::setAvailabilityVolatile(bool available) {
 }
 
 void Connector::setConnectorPluggedInput(std::function<bool()> connectorPlugged) {
-    this->connectorPluggedInput = connectorPlugged;
+    this->connectorPluggedInput.setPoll(connectorPlugged);
 }
 
 void Connector::setEvReadyInput(std::function<bool()> evRequestsEnergy) {
-    this->evReadyInput = evRequestsEnergy;
+    this->evReadyInput.setPoll(evRequestsEnergy);
 }
 
 void Connector::setEvseReadyInput(std::function<bool()> connectorEnergized) {
-    this->evseReadyInput = connectorEnergized;
+    this->evseReadyInput.setPoll(connectorEnergized);
 }
 
 void Connector::addErrorCodeInput(std::function<const char*()> connectorErrorCode) {
@@ -1048,8 +1067,10 @@ void Connector::addErrorCodeInput(std::function<const char*()> connectorErrorCod
 }
 
 void Connector::addErrorDataInput(std::function<ErrorData ()> errorDataInput) {
-    this->errorDataInputs.push_back(errorDataInput);
+    this->errorDataInputs.push_back(ConnectorInputErrorData(errorDataInput));
     this->trackErrorDataInputs.push_back(false);
+    errorInputsPolled = true;
+    errorInputsDirty = true;
 }
 
 #if MO_ENABLE_CONNECTOR_LOCK
@@ -1063,15 +1084,52 @@ std::function<UnlockConnectorResult()> Connector::getOnUnlockConnector() {
 #endif //MO_ENABLE_CONNECTOR_LOCK
 
 void Connector::setStartTxReadyInput(std::function<bool()> startTxReady) {
-    this->startTxReadyInput = startTxReady;
+    this->startTxReadyInput.setPoll(startTxReady);
 }
 
 void Connector::setStopTxReadyInput(std::function<bool()> stopTxReady) {
-    this->stopTxReadyInput = stopTxReady;
+    this->stopTxReadyInput.setPoll(stopTxReady);
 }
 
 void Connector::setOccupiedInput(std::function<bool()> occupied) {
-    this->occupiedInput = occupied;
+    this->occupiedInput.setPoll(occupied);
+}
+
+void Connector::notifyPlugged(bool plugged) {
+    connectorPluggedInput.push(plugged);
+}
+
+void Connector::notifyEvReady(bool evReady) {
+    evReadyInput.push(evReady);
+}
+
+void Connector::notifyEvseReady(bool evseReady) {
+    evseReadyInput.push(evseReady);
+}
+
+void Connector::notifyOccupied(bool occupied) {
+    occupiedInput.push(occupied);
+}
+
+void Connector::notifyStartTxReady(bool startTxReady) {
+    startTxReadyInput.push(startTxReady);
+}
+
+void Connector::notifyStopTxReady(bool stopTxReady) {
+    stopTxReadyInput.push(stopTxReady);
+}
+
+void Connector::notifyErrorData(ErrorData errorData) {
+    if (pushedErrorIndex < 0) {
+        if (!errorData.isError) {
+            return; //nothing to clear
+        }
+        pushedErrorIndex = (int)errorDataInputs.size();
+        errorDataInputs.push_back(ConnectorInputErrorData());
+        trackErrorDataInputs.push_back(false);
+    }
+    errorDataInputs[pushedErrorIndex].push(errorData);
+    errorInputsDirty = true;
 }
 
 void Connector::setTxNotificationOutput(std::function<void(Transaction*, TxNotification)> txNotificationOutput) {
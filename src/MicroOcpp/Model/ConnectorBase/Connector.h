@@ -32,6 +32,35 @@ class Context;
 class Model;
 class Operation;
 
+/*
+ * Hardware Input of a connector. The value is either polled via callback on each loop (compatibility mode) or
+ * pushed by the notify functions into a snapshot. A pushed value takes precedence over the callback
+ */
+class ConnectorInputBool {
+private:
+    std::function<bool()> poll;
+    bool value = false;
+    bool pushed = false;
+public:
+    void setPoll(std::function<bool()> poll) {this->poll = poll; pushed = false;}
+    void push(bool value) {this->value = value; pushed = true;}
+    bool isPolled() const {return !pushed && poll;}
+    explicit operator bool() const {return pushed || poll;} //if the Input is defined
+    bool operator()() const {return pushed ? value : poll();}
+};
+
+class ConnectorInputErrorData {
+private:
+    std::function<ErrorData()> poll;
+    ErrorData value {nullptr};
+public:
+    ConnectorInputErrorData() = default; //pushed Input
+    explicit ConnectorInputErrorData(std::function<ErrorData()> poll) : poll(poll) { }
+    void push(ErrorData value) {this->value = value;}
+    bool isPolled() const {return (bool)poll;}
+    ErrorData operator()() const {return poll ? poll() : value;}
+};
+
 class Connector : public RequestEmitter, public MemoryManaged {
 private:
     Context& context;
@@ -46,12 +75,18 @@ private:
     char availabilityBoolKey [sizeof(MO_CONFIG_EXT_PREFIX "AVAIL_CONN_xxxx") + 1];
     bool availabilityVolatile = true;
 
-    std::function<bool()> connectorPluggedInput;
-    std::function<bool()> evReadyInput;
-    std::function<bool()> evseReadyInput;
-    Vector<std::function<ErrorData ()>> errorDataInputs;
+    ConnectorInputBool connectorPluggedInput;
+    ConnectorInputBool evReadyInput;
+    ConnectorInputBool evseReadyInput;
+    Vector<ConnectorInputErrorData> errorDataInputs;
     Vector<bool> trackErrorDataInputs;
     int reportedErrorIndex = -1; //last reported error
+    int pushedErrorIndex = -1; //index of the pushed Input in errorDataInputs or -1 if notifyErrorData wasn't used
+    bool errorInputsPolled = false; //if any error Input is polled, evaluate all on each loop
+    bool errorInputsDirty = true; //if a pushed error changed since the last evaluation
+    ErrorData evaluatedErrorData {nullptr};
+    int evaluatedErrorIndex = -1;
+    void evaluateErrorInputs();
     bool isFaulted();
     const char *getErrorCode();
 
@@ -64,9 +99,9 @@ private:
     std::function<UnlockConnectorResult()> onUnlockConnector;
 #endif //MO_ENABLE_CONNECTOR_LOCK
 
-    std::function<bool()> startTxReadyInput; //the StartTx request will be delayed while this Input is false
-    std::function<bool()> stopTxReadyInput; //the StopTx request will be delayed while this Input is false
-    std::function<bool()> occupiedInput; //instead of Available, go into Preparing / Finishing state
+    ConnectorInputBool startTxReadyInput; //the StartTx request will be delayed while this Input is false
+    ConnectorInputBool stopTxReadyInput; //the StopTx request will be delayed while this Input is false
+    ConnectorInputBool occupiedInput; //instead of Available, go into Preparing / Finishing state
 
     std::function<void(Transaction*,TxNotification)> txNotificationOutput;
 
@@ -149,6 +184,24 @@ public:
     void setStopTxReadyInput(std::function<bool()> stopTxReady);
     void setOccupiedInput(std::function<bool()> occupied);
 
+    /*
+     * Push-based alternative to the Input callbacks above. The hardware integration calls these on
+     * state changes instead of letting the Connector poll the callbacks on each loop. Once an Input has
+     * been pushed, its callback is ignored until it is set again
+     */
+    void notifyPlugged(bool plugged);
+    void notifyEvReady(bool evReady);
+    void notifyEvseReady(bool evseReady);
+    void notifyOccupied(bool occupied);
+    void notifyStartTxReady(bool startTxReady);
+    void notifyStopTxReady(bool stopTxReady);
+
+    /*
+     * Set or clear (errorData.isError == false) the pushed error condition. The strings of errorData
+     * must stay valid until the error is cleared or replaced
+     */
+    void notifyErrorData(ErrorData errorData);
+
     void setTxNotificationOutput(std::function<void(Transaction*,TxNotification)> txNotificationOutput);
     void updateTxNotification(TxNotification event);
 
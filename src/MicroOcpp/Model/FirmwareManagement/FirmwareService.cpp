@@ -17,6 +17,10 @@
 #include <MicroOcpp/Platform.h>
 #include <MicroOcpp/Debug.h>
 
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+#include <mbedtls/md.h>
+#endif
+
 //debug option: update immediately and don't wait for the retreive date
 #ifndef MO_IGNORE_FW_RETR_DATE
 #define MO_IGNORE_FW_RETR_DATE 0
@@ -26,6 +30,34 @@ using MicroOcpp::FirmwareService;
 using MicroOcpp::Ocpp16::FirmwareStatus;
 using MicroOcpp::Request;
 
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+struct FirmwareService::DownloadHash {
+    mbedtls_md_context_t ctx;
+    bool valid = false;
+
+    DownloadHash() {
+        mbedtls_md_init(&ctx);
+        valid = !mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0);
+    }
+
+    ~DownloadHash() {
+        mbedtls_md_free(&ctx);
+    }
+
+    void start() {
+        valid = valid && !mbedtls_md_starts(&ctx);
+    }
+
+    void update(const unsigned char *buf, size_t size) {
+        valid = valid && !mbedtls_md_update(&ctx, buf, size);
+    }
+
+    bool finish(unsigned char *sha256) {
+        return valid && !mbedtls_md_finish(&ctx, sha256);
+    }
+};
+#endif //MO_ENABLE_FW_DOWNLOAD_HASH
+
 FirmwareService::FirmwareService(Context& context) : MemoryManaged("v16.Firmware.FirmwareService"), context(context), buildNumber(makeString(getMemoryTag())), location(makeString(getMemoryTag())) {
     
     context.getOperationRegistry().registerOperation("UpdateFirmware", [this] () {
@@ -36,6 +68,8 @@ FirmwareService::FirmwareService(Context& context) : MemoryManaged("v16.Firmware
         return new Ocpp16::FirmwareStatusNotification(getFirmwareStatus());});
 }
 
+FirmwareService::~FirmwareService() = default;
+
 void FirmwareService::setBuildNumber(const char *buildNumber) {
     if (buildNumber == nullptr)
         return;
@@ -216,6 +250,9 @@ void FirmwareService::scheduleFirmwareUpdate(const char *location, Timestamp ret
     this->retries = retries;
     this->retryInterval = retryInterval;
 
+    downloadOffset = 0; //new FW image
+    downloadStarted = false;
+
     if (MO_IGNORE_FW_RETR_DATE) {
         MO_DBG_DEBUG("ignore FW update retreive date");
         this->retreiveDate = context.getModel().getClock().now();
@@ -343,18 +380,76 @@ void FirmwareService::setDownloadFileWriter(std::function<size_t(const unsigned
             return false;
         }
 
-        this->ftpDownload = ftpClient->getFile(location, firmwareWriter,
-            [this, onClose] (MO_FtpCloseReason reason) -> void {
-                if (reason == MO_FtpCloseReason_Success) {
-                    MO_DBG_INFO("FTP download success");
-                    this->ftpDownloadStatus = DownloadStatus::Downloaded;
-                } else {
-                    MO_DBG_INFO("FTP download failure (%i)", reason);
-                    this->ftpDownloadStatus = DownloadStatus::DownloadFailed;
+        this->ftpDownload.reset(); //close previous attempt, if still open
+
+        if (!onResumeDownload) {
+            downloadOffset = 0; //start over
+        } else if (downloadStarted && !onResumeDownload(downloadOffset)) {
+            downloadOffset = 0; //writer discarded partial image
+        }
+        downloadStarted = true;
+
+        auto writer = [this, firmwareWriter] (unsigned char *data, size_t len) -> size_t {
+            auto ret = firmwareWriter(data, len);
+            if (ret <= len) {
+                downloadOffset += ret;
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+                if (downloadHash) {
+                    downloadHash->update(data, ret);
+                }
+#endif
+            }
+            return ret;
+        };
+
+        auto onFtpClose = [this, onClose] (MO_FtpCloseReason reason) -> void {
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+            if (reason == MO_FtpCloseReason_Success && downloadHash && downloadVerifier) {
+                unsigned char sha256 [32];
+                if (!downloadHash->finish(sha256) || !downloadVerifier(sha256)) {
+                    MO_DBG_ERR("FW image verification failed");
+                    reason = MO_FtpCloseReason_Failure;
+                    downloadOffset = 0; //don't resume a corrupt image
+                }
+            }
+#endif //MO_ENABLE_FW_DOWNLOAD_HASH
+
+            if (reason == MO_FtpCloseReason_Success) {
+                MO_DBG_INFO("FTP download success");
+                this->ftpDownloadStatus = DownloadStatus::Downloaded;
+            } else {
+                MO_DBG_INFO("FTP download failure (%i) at %zu bytes", reason, downloadOffset);
+                this->ftpDownloadStatus = DownloadStatus::DownloadFailed;
+
+                if (downloadOffset == downloadOffsetAtStart && downloadOffset > 0) {
+                    //resuming didn't transfer any data. Maybe the FTP server doesn't support it. Next attempt starts over
+                    downloadOffset = 0;
                 }
+            }
+
+            onClose(reason);
+        };
+
+        if (downloadOffset > 0) {
+            MO_DBG_INFO("resume FW download at %zu bytes", downloadOffset);
+            this->ftpDownload = ftpClient->getFileFrom(location, downloadOffset, writer, onFtpClose, ftpServerCert);
+            if (!this->ftpDownload) {
+                MO_DBG_WARN("FTP client can't resume. Start over");
+                downloadOffset = 0;
+                onResumeDownload(0);
+            }
+        }
+
+        if (downloadOffset == 0) {
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+            if (downloadHash) {
+                downloadHash->start();
+            }
+#endif
+            this->ftpDownload = ftpClient->getFile(location, writer, onFtpClose, ftpServerCert);
+        }
 
-                onClose(reason);
-            });
+        downloadOffsetAtStart = downloadOffset;
 
         if (this->ftpDownload) {
             this->ftpDownloadStatus = DownloadStatus::NotDownloaded;
@@ -370,6 +465,19 @@ void FirmwareService::setDownloadFileWriter(std::function<size_t(const unsigned
     };
 }
 
+void FirmwareService::setDownloadResumeHandler(std::function<bool(size_t offset)> onResume) {
+    this->onResumeDownload = onResume;
+}
+
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+void FirmwareService::setDownloadVerifier(std::function<bool(const unsigned char *sha256)> verifier) {
+    this->downloadVerifier = verifier;
+    if (verifier && !downloadHash) {
+        downloadHash.reset(new DownloadHash());
+    }
+}
+#endif //MO_ENABLE_FW_DOWNLOAD_HASH
+
 void FirmwareService::setFtpServerCert(const char *cert) {
     this->ftpServerCert = cert;
 }
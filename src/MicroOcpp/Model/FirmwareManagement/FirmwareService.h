@@ -13,6 +13,12 @@
 #include <MicroOcpp/Core/Time.h>
 #include <MicroOcpp/Core/Ftp.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Platform.h>
+
+//compute the SHA-256 digest of FTP downloads while they are written (see setDownloadVerifier)
+#ifndef MO_ENABLE_FW_DOWNLOAD_HASH
+#define MO_ENABLE_FW_DOWNLOAD_HASH MO_ENABLE_MBEDTLS
+#endif
 
 namespace MicroOcpp {
 
@@ -45,6 +51,17 @@ private:
     DownloadStatus ftpDownloadStatus = DownloadStatus::NotDownloaded;
     const char *ftpServerCert = nullptr;
 
+    size_t downloadOffset = 0; //number of bytes of the FW image which the firmwareWriter has accepted
+    size_t downloadOffsetAtStart = 0; //offset of the current download attempt
+    bool downloadStarted = false; //firmwareWriter may hold a partial image
+    std::function<bool(size_t offset)> onResumeDownload;
+
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+    struct DownloadHash;
+    std::unique_ptr<DownloadHash> downloadHash;
+    std::function<bool(const unsigned char *sha256)> downloadVerifier;
+#endif
+
     std::function<InstallationStatus()> installationStatusInput;
     bool installationIssued = false;
 
@@ -79,6 +96,7 @@ private:
 
 public:
     FirmwareService(Context& context);
+    ~FirmwareService();
 
     void setBuildNumber(const char *buildNumber);
 
@@ -101,6 +119,25 @@ public:
 
     void setFtpServerCert(const char *cert); //zero-copy mode, i.e. cert must outlive MO
 
+    /*
+     * Resume interrupted FTP downloads instead of downloading the whole file again. Before each retry of the download,
+     * MO executes `onResume` with the number of bytes which `firmwareWriter` has accepted so far. Return true to continue
+     * writing at this offset. Return false to discard the partial image; then MO downloads the whole file again. If
+     * `offset` is 0, the partial image must be discarded. Without this handler, each attempt starts at offset 0.
+     *
+     * Requires an FTP client which supports `getFileFrom` (e.g. the built-in client for MbedTLS)
+     */
+    void setDownloadResumeHandler(std::function<bool(size_t offset)> onResume);
+
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+    /*
+     * Verify FTP downloads. MO computes the SHA-256 digest of the image incrementally while passing it to `firmwareWriter`.
+     * After the transfer, MO executes `verifier` with the 32 byte digest of the whole image. If it returns false, the
+     * download fails
+     */
+    void setDownloadVerifier(std::function<bool(const unsigned char *sha256)> verifier);
+#endif
+
     /*
      * Manual alternative for FTP download handler `setDownloadFileWriter`
      */
@@ -5,15 +5,18 @@
 #include <MicroOcpp/Model/Heartbeat/HeartbeatService.h>
 #include <MicroOcpp/Core/Context.h>
 #include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Core/Connection.h>
 #include <MicroOcpp/Core/Configuration.h>
 #include <MicroOcpp/Operations/Heartbeat.h>
 #include <MicroOcpp/Platform.h>
+#include <MicroOcpp/Debug.h>
 
 using namespace MicroOcpp;
 
 HeartbeatService::HeartbeatService(Context& context) : MemoryManaged("v16.Heartbeat.HeartbeatService"), context(context) {
     heartbeatIntervalInt = declareConfiguration<int>("HeartbeatInterval", 86400);
     registerConfigurationValidator("HeartbeatInterval", VALIDATE_UNSIGNED_INT);
+    heartbeatSuppressionBool = declareConfiguration<bool>(MO_CONFIG_EXT_PREFIX "HeartbeatSuppression", false);
     lastHeartbeat = mocpp_tick_ms();
 
     //Register message handler for TriggerMessage operation
@@ -27,6 +30,11 @@ void HeartbeatService::loop() {
     unsigned long now = mocpp_tick_ms();
 
     if (now - lastHeartbeat >= hbInterval) {
+
+        if (heartbeatSuppressionBool->getBool() && isHeartbeatSuppressible(now, hbInterval)) {
+            return;
+        }
+
         lastHeartbeat = now;
 
         auto heartbeat = makeRequest(new Ocpp16::Heartbeat(context.getModel()));
@@ -35,3 +43,31 @@ void HeartbeatService::loop() {
         context.initiateRequest(std::move(heartbeat));
     }
 }
+
+bool HeartbeatService::isHeartbeatSuppressible(unsigned long now, unsigned long hbInterval) {
+
+    decltype(mocpp_tick_ms()) lastSync;
+    if (!context.getModel().getClock().getLastSync(lastSync) ||
+            now - lastSync >= MO_HEARTBEAT_CLOCKSYNC_INTERVAL * 1000UL) {
+        //clock needs to be synchronized via Heartbeat
+        return false;
+    }
+
+    //other messages within the HeartbeatInterval have the same effect as a Heartbeat, but only if the server responded
+    unsigned long lastSend, lastRecv;
+    auto& reqQueue = context.getRequestQueue();
+    if (reqQueue.getLastSend(lastSend) && reqQueue.getLastRecv(lastRecv) &&
+            now - lastSend < hbInterval && now - lastRecv < hbInterval) {
+        //restart interval with the older of both messages
+        lastHeartbeat = (now - lastSend > now - lastRecv) ? lastSend : lastRecv;
+        return true;
+    }
+
+    if (context.getConnection().sendPing()) {
+        MO_DBG_DEBUG("replaced Heartbeat by ping");
+        lastHeartbeat = now;
+        return true;
+    }
+
+    return false;
+}
@@ -10,6 +10,15 @@
 #include <MicroOcpp/Core/ConfigurationKeyValue.h>
 #include <MicroOcpp/Core/Memory.h>
 
+/*
+ * With Heartbeat suppression enabled, MO skips the Heartbeat if other messages have been exchanged within the
+ * HeartbeatInterval, or if the Connection can send a transport-level ping instead. Every
+ * MO_HEARTBEAT_CLOCKSYNC_INTERVAL, MO sends a Heartbeat anyway to synchronize the clock
+ */
+#ifndef MO_HEARTBEAT_CLOCKSYNC_INTERVAL
+#define MO_HEARTBEAT_CLOCKSYNC_INTERVAL 86400UL //in s
+#endif
+
 namespace MicroOcpp {
 
 class Context;
@@ -20,6 +29,9 @@ private:
 
     unsigned long lastHeartbeat;
     std::shared_ptr<Configuration> heartbeatIntervalInt;
+    std::shared_ptr<Configuration> heartbeatSuppressionBool;
+
+    bool isHeartbeatSuppressible(unsigned long now, unsigned long hbInterval); //updates lastHeartbeat if true
 
 public:
     HeartbeatService(Context& context);
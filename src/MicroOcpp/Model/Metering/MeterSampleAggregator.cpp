@@ -0,0 +1,170 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Model/Metering/MeterSampleAggregator.h>
+
+#if MO_ENABLE_METER_AGGREGATION
+
+#include <MicroOcpp/Platform.h>
+#include <MicroOcpp/Debug.h>
+
+static_assert((MO_METER_SAMPLE_RING_SIZE & (MO_METER_SAMPLE_RING_SIZE - 1)) == 0, "MO_METER_SAMPLE_RING_SIZE must be a power of two");
+
+#define MO_METER_SAMPLE_RING_MASK ((uint32_t) MO_METER_SAMPLE_RING_SIZE - 1)
+
+using namespace MicroOcpp;
+
+bool MeterSampleRing::push(float value) {
+    return push(value, mocpp_tick_ms());
+}
+
+bool MeterSampleRing::push(float value, unsigned long t_ms) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= MO_METER_SAMPLE_RING_SIZE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    samples[h & MO_METER_SAMPLE_RING_MASK].value = value;
+    samples[h & MO_METER_SAMPLE_RING_MASK].t = t_ms;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool MeterSampleRing::pop(float& value, unsigned long& t_ms) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    value = samples[t & MO_METER_SAMPLE_RING_MASK].value;
+    t_ms = samples[t & MO_METER_SAMPLE_RING_MASK].t;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+uint32_t MeterSampleRing::getDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void MeterSampleAggregator::Interval::add(float value, float heldValue, bool held, unsigned long t) {
+    //zero-order hold: the previous sample is valid until this sample
+    if (held && (long) (t - tIntegrated) > 0) {
+        integral += (double) heldValue * (double) (t - tIntegrated);
+        tIntegrated = t;
+    } else if (!held) {
+        tIntegrated = t;
+    }
+
+    if (count == 0 || value < min) {
+        min = value;
+    }
+    if (count == 0 || value > max) {
+        max = value;
+    }
+    sum += value;
+    count++;
+}
+
+void MeterSampleAggregator::Interval::close(float heldValue, bool held, unsigned long t) {
+    if (held && (long) (t - tIntegrated) > 0) {
+        integral += (double) heldValue * (double) (t - tIntegrated);
+        tIntegrated = t;
+    }
+}
+
+float MeterSampleAggregator::Interval::getValue(MeterAggregation aggregation, float heldValue) const {
+    if (aggregation == MeterAggregation_Integral) {
+        return (float) (integral / 3600000.); //ms -> h
+    }
+
+    if (count == 0) {
+        return heldValue; //no new sample in this interval
+    }
+
+    switch (aggregation) {
+        case MeterAggregation_Average:
+            return (float) (sum / (double) count);
+        case MeterAggregation_Minimum:
+            return min;
+        case MeterAggregation_Maximum:
+            return max;
+        default:
+            return heldValue;
+    }
+}
+
+MeterSampleAggregator::MeterSampleAggregator(SampledValueProperties properties, MeterAggregation aggregation) :
+        SampledValueSampler(properties), MemoryManaged("v16.Metering.MeterSampleAggregator"), aggregation(aggregation) {
+
+}
+
+void MeterSampleAggregator::drain() {
+    float value;
+    unsigned long t;
+    while (ring.pop(value, t)) {
+        periodic.current.add(value, heldValue, held, t);
+        clock.current.add(value, heldValue, held, t);
+        heldValue = value;
+        held = true;
+    }
+}
+
+float MeterSampleAggregator::closeWindow(Window& window, unsigned long now) {
+    window.current.close(heldValue, held, now);
+    float value = window.current.getValue(aggregation, heldValue);
+
+    auto tIntegrated = window.current.tIntegrated;
+    window.current = Interval();
+    window.current.tIntegrated = tIntegrated;
+
+    window.closedValue = value;
+    window.closed = true;
+    return value;
+}
+
+void MeterSampleAggregator::closeInterval(ReadingContext context) {
+    drain();
+    closeWindow(context == ReadingContext_SampleClock ? clock : periodic, mocpp_tick_ms());
+}
+
+void MeterSampleAggregator::restartInterval(ReadingContext context) {
+    drain();
+    auto& window = context == ReadingContext_SampleClock ? clock : periodic;
+    closeWindow(window, mocpp_tick_ms());
+    window.closed = false; //don't report the discarded interval
+}
+
+std::unique_ptr<SampledValue> MeterSampleAggregator::takeValue(ReadingContext context) {
+    drain();
+    auto now = mocpp_tick_ms();
+
+    float value;
+    if (context == ReadingContext_SamplePeriodic || context == ReadingContext_SampleClock) {
+        //value of the current sampling point. If no interval has been closed yet, close it now
+        auto& window = context == ReadingContext_SamplePeriodic ? periodic : clock;
+        if (window.closed) {
+            value = window.closedValue;
+        } else {
+            value = closeWindow(window, now);
+        }
+    } else {
+        //Trigger, TransactionBegin, etc.: report the running periodic interval without closing it
+        Interval preview = periodic.current;
+        preview.close(heldValue, held, now);
+        value = preview.getValue(aggregation, heldValue);
+    }
+
+    return std::unique_ptr<SampledValueConcrete<float, SampledValueDeSerializer<float>>>(new SampledValueConcrete<float, SampledValueDeSerializer<float>>(
+        properties,
+        context,
+        std::move(value)));
+}
+
+std::unique_ptr<SampledValue> MeterSampleAggregator::deserializeValue(JsonObject svJson) {
+    return std::unique_ptr<SampledValueConcrete<float, SampledValueDeSerializer<float>>>(new SampledValueConcrete<float, SampledValueDeSerializer<float>>(
+        properties,
+        deserializeReadingContext(svJson["context"] | "NOT_SET"),
+        SampledValueDeSerializer<float>::deserialize(svJson["value"] | "")));
+}
+
+#endif //MO_ENABLE_METER_AGGREGATION
@@ -0,0 +1,124 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * High-rate metering. The host pushes raw meter samples (e.g. 10 - 100 Hz) into a lock-free ring from its
+ * sampling thread or ISR. MO drains the ring on each loop into running aggregates of the current
+ * MeterValueSampleInterval and ClockAlignedDataInterval. When MO takes a MeterValue, the sampler reports the
+ * aggregate of the elapsed interval instead of an instantaneous reading.
+ *
+ * Memory usage is constant: one ring with MO_METER_SAMPLE_RING_SIZE entries and two aggregates per measurand.
+ */
+
+#ifndef MO_METERSAMPLEAGGREGATOR_H
+#define MO_METERSAMPLEAGGREGATOR_H
+
+#ifndef MO_ENABLE_METER_AGGREGATION
+#define MO_ENABLE_METER_AGGREGATION 1
+#endif
+
+typedef enum {
+    MeterAggregation_Average,  //arithmetic mean of the samples in the interval
+    MeterAggregation_Minimum,
+    MeterAggregation_Maximum,
+    MeterAggregation_Integral, //integral over the interval in value-hours, e.g. W -> Wh for Energy.Active.Import.Interval
+    MeterAggregation_Last      //last sample
+}   MeterAggregation;
+
+#if MO_ENABLE_METER_AGGREGATION && defined(__cplusplus)
+
+#include <atomic>
+#include <stdint.h>
+
+#include <MicroOcpp/Model/Metering/SampledValue.h>
+#include <MicroOcpp/Core/Memory.h>
+
+#ifndef MO_METER_SAMPLE_RING_SIZE
+#define MO_METER_SAMPLE_RING_SIZE 64 //must be a power of two. Should hold the samples of at least a few loop iterations
+#endif
+
+namespace MicroOcpp {
+
+/*
+ * Single-producer single-consumer ring. push() may be called from one sampling thread or ISR, pop() is called
+ * by MO from the loop
+ */
+class MeterSampleRing {
+private:
+    struct Sample {
+        float value;
+        unsigned long t; //tick ms
+    };
+    Sample samples [MO_METER_SAMPLE_RING_SIZE];
+    std::atomic<uint32_t> head {0}; //next write position, written by producer
+    std::atomic<uint32_t> tail {0}; //next read position, written by consumer
+    std::atomic<uint32_t> dropped {0};
+public:
+    MeterSampleRing() = default;
+    MeterSampleRing(const MeterSampleRing&) = delete;
+    MeterSampleRing& operator=(const MeterSampleRing&) = delete;
+
+    bool push(float value); //timestamp the sample with mocpp_tick_ms()
+    bool push(float value, unsigned long t_ms); //returns false and drops the sample if the ring is full
+
+    bool pop(float& value, unsigned long& t_ms);
+
+    uint32_t getDropped() const; //number of samples which didn't fit into the ring
+};
+
+class MeterSampleAggregator : public SampledValueSampler, public MemoryManaged {
+private:
+    struct Interval {
+        unsigned int count = 0;
+        float min = 0.f;
+        float max = 0.f;
+        double sum = 0.;
+        double integral = 0.; //value * ms
+        unsigned long tIntegrated = 0; //integral is complete until this time
+
+        void add(float value, float heldValue, bool held, unsigned long t);
+        void close(float heldValue, bool held, unsigned long t);
+        float getValue(MeterAggregation aggregation, float heldValue) const;
+    };
+
+    struct Window {
+        Interval current;
+        float closedValue = 0.f; //aggregate of the last closed interval
+        bool closed = false;
+    };
+
+    const MeterAggregation aggregation;
+    MeterSampleRing ring;
+
+    Window periodic; //MeterValueSampleInterval
+    Window clock; //ClockAlignedDataInterval
+
+    float heldValue = 0.f; //last sample, held until the next sample. 0 if no sample has been pushed yet
+    bool held = false;
+
+    float closeWindow(Window& window, unsigned long now);
+public:
+    MeterSampleAggregator(SampledValueProperties properties, MeterAggregation aggregation);
+
+    MeterSampleRing& getRing() {return ring;}
+
+    void drain(); //move all pushed samples into the running aggregates
+
+    /*
+     * Close the running SamplePeriodic or SampleClock interval at a sampling point. MO calls this for every
+     * aggregator, regardless of whether the measurand is selected. All readers of the sampling point (e.g.
+     * MeterValuesSampledData and StopTxnSampledData) get the closed interval from takeValue()
+     */
+    void closeInterval(ReadingContext context);
+
+    void restartInterval(ReadingContext context); //discard the running SamplePeriodic or SampleClock interval
+
+    std::unique_ptr<SampledValue> takeValue(ReadingContext context) override;
+    std::unique_ptr<SampledValue> deserializeValue(JsonObject svJson) override;
+};
+
+} //namespace MicroOcpp
+
+#endif //MO_ENABLE_METER_AGGREGATION && defined(__cplusplus)
+#endif
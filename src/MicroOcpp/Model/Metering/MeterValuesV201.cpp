@@ -114,6 +114,18 @@ bool SampledValue::toJson(JsonDoc& out) {
     return true;
 }
 
+double SampledValue::getValue() const {
+    return value;
+}
+
+ReadingContext SampledValue::getReadingContext() const {
+    return readingContext;
+}
+
+const SampledValueProperties& SampledValue::getProperties() const {
+    return properties;
+}
+
 SampledValueInput::SampledValueInput(std::function<double(ReadingContext)> valueInput, const SampledValueProperties& properties)
         : MemoryManaged("v201.MeterValues.SampledValueInput"), valueInput(valueInput), properties(properties) {
 
@@ -180,6 +192,14 @@ const MicroOcpp::Timestamp& MeterValue::getTimestamp() {
     return timestamp;
 }
 
+size_t MeterValue::getSampledValueSize() const {
+    return sampledValueSize;
+}
+
+SampledValue& MeterValue::getSampledValue(size_t index) {
+    return *sampledValue[index];
+}
+
 MeteringServiceEvse::MeteringServiceEvse(Model& model, unsigned int evseId)
         : MemoryManaged("v201.MeterValues.MeteringServiceEvse"), model(model), evseId(evseId), sampledValueInputs(makeVector<SampledValueInput>(getMemoryTag())) {
 
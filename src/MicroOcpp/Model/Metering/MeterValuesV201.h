@@ -64,6 +64,10 @@ public:
     SampledValue(double value, ReadingContext readingContext, SampledValueProperties& properties);
 
     bool toJson(JsonDoc& out);
+
+    double getValue() const;
+    ReadingContext getReadingContext() const;
+    const SampledValueProperties& getProperties() const;
 };
 
 #define MO_MEASURAND_TYPE_TXSTARTED (1 << 0)
@@ -98,6 +102,9 @@ public:
     bool toJson(JsonDoc& out);
 
     const Timestamp& getTimestamp();
+
+    size_t getSampledValueSize() const;
+    SampledValue& getSampledValue(size_t index);
 };
 
 class MeteringServiceEvse : public MemoryManaged {
@@ -10,6 +10,7 @@
 #include <MicroOcpp/Core/Context.h>
 #include <MicroOcpp/Core/Configuration.h>
 #include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
 #include <MicroOcpp/Operations/MeterValues.h>
 #include <MicroOcpp/Platform.h>
 #include <MicroOcpp/Debug.h>
@@ -20,8 +21,16 @@
 using namespace MicroOcpp;
 using namespace MicroOcpp::Ocpp16;
 
-MeteringConnector::MeteringConnector(Context& context, int connectorId, MeterStore& meterStore)
-        : MemoryManaged("v16.Metering.MeteringConnector"), context(context), model(context.getModel()), connectorId{connectorId}, meterStore(meterStore), meterData(makeVector<std::unique_ptr<MeterValue>>(getMemoryTag())), samplers(makeVector<std::unique_ptr<SampledValueSampler>>(getMemoryTag())) {
+static_assert(MO_METERVALUES_CACHE_MAXSIZE >= 1, "MO_METERVALUES_CACHE_MAXSIZE must be at least 1");
+
+#define MO_METERVALUES_SPILL_FN_PREFIX "mvq-"
+
+MeteringConnector::MeteringConnector(Context& context, int connectorId, MeterStore& meterStore, std::shared_ptr<FilesystemAdapter> filesystem)
+        : MemoryManaged("v16.Metering.MeteringConnector"), context(context), model(context.getModel()), connectorId{connectorId}, meterStore(meterStore), filesystem(filesystem), samplers(makeVector<std::unique_ptr<SampledValueSampler>>(getMemoryTag()))
+#if MO_ENABLE_METER_AGGREGATION
+        , aggregators(makeVector<MeterSampleAggregator*>(getMemoryTag()))
+#endif
+        {
 
     context.getRequestQueue().addSendQueue(this);
 
@@ -46,6 +55,21 @@ MeteringConnector::MeteringConnector(Context& context, int connectorId, MeterSto
     transactionMessageAttemptsInt = declareConfiguration<int>("TransactionMessageAttempts", 3);
     transactionMessageRetryIntervalInt = declareConfiguration<int>("TransactionMessageRetryInterval", 60);
 
+    meterValuesCacheOverflowString = declareConfiguration<const char*>(MO_CONFIG_EXT_PREFIX "MeterValuesCacheOverflow", MO_METERVALUES_CACHE_OVERFLOW);
+    registerConfigurationValidator(MO_CONFIG_EXT_PREFIX "MeterValuesCacheOverflow", [] (const char *policy) {
+        return !strcmp(policy, "DropOldest") || !strcmp(policy, "Downsample") || !strcmp(policy, "Spill");
+    });
+
+    if (filesystem) {
+        //spilled MeterValues of the previous run are outdated
+        char fnPrefix [sizeof(MO_METERVALUES_SPILL_FN_PREFIX) + 12];
+        snprintf(fnPrefix, sizeof(fnPrefix), MO_METERVALUES_SPILL_FN_PREFIX "%i-", connectorId);
+        size_t fnPrefixLen = strlen(fnPrefix);
+        FilesystemUtils::remove_if(filesystem, [fnPrefix, fnPrefixLen] (const char *fn) {
+            return !strncmp(fn, fnPrefix, fnPrefixLen);
+        });
+    }
+
     sampledDataBuilder = std::unique_ptr<MeterValueBuilder>(new MeterValueBuilder(samplers, meterValuesSampledDataString));
     alignedDataBuilder = std::unique_ptr<MeterValueBuilder>(new MeterValueBuilder(samplers, meterValuesAlignedDataString));
     stopTxnSampledDataBuilder = std::unique_ptr<MeterValueBuilder>(new MeterValueBuilder(samplers, stopTxnSampledDataString));
@@ -54,6 +78,12 @@ MeteringConnector::MeteringConnector(Context& context, int connectorId, MeterSto
 
 void MeteringConnector::loop() {
 
+#if MO_ENABLE_METER_AGGREGATION
+    for (size_t i = 0; i < aggregators.size(); i++) {
+        aggregators[i]->drain();
+    }
+#endif
+
     bool txBreak = false;
     if (model.getConnector(connectorId)) {
         auto &curTx = model.getConnector(connectorId)->getTransaction();
@@ -63,6 +93,11 @@ void MeteringConnector::loop() {
 
     if (txBreak) {
         lastSampleTime = mocpp_tick_ms();
+#if MO_ENABLE_METER_AGGREGATION
+        for (size_t i = 0; i < aggregators.size(); i++) {
+            aggregators[i]->restartInterval(ReadingContext_SamplePeriodic);
+        }
+#endif
     }
 
     if (model.getConnector(connectorId)) {
@@ -100,16 +135,18 @@ void MeteringConnector::loop() {
                 "in time (tolerance <= 60s)" : "off, e.g. because of first run. Ignore");
             if (abs(dt) <= 60) { //is measurement still "clock-aligned"?
 
+#if MO_ENABLE_METER_AGGREGATION
+                for (size_t i = 0; i < aggregators.size(); i++) {
+                    aggregators[i]->closeInterval(ReadingContext_SampleClock);
+                }
+#endif
+
                 if (auto alignedMeterValue = alignedDataBuilder->takeSample(model.getClock().now(), ReadingContext_SampleClock)) {
-                    if (meterData.size() >= MO_METERVALUES_CACHE_MAXSIZE) {
-                        MO_DBG_INFO("MeterValue cache full. Drop old MV");
-                        meterData.erase(meterData.begin());
-                    }
                     alignedMeterValue->setOpNr(context.getRequestQueue().getNextOpNr());
                     if (transaction) {
                         alignedMeterValue->setTxNr(transaction->getTxNr());
                     }
-                    meterData.push_back(std::move(alignedMeterValue));
+                    enqueueMeterValue(std::move(alignedMeterValue));
                 }
 
                 if (stopTxnData) {
@@ -119,6 +156,14 @@ void MeteringConnector::loop() {
                     }
                 }
             }
+#if MO_ENABLE_METER_AGGREGATION
+            else {
+                //the next interval is the first which is clock-aligned
+                for (size_t i = 0; i < aggregators.size(); i++) {
+                    aggregators[i]->restartInterval(ReadingContext_SampleClock);
+                }
+            }
+#endif
 
             Timestamp midnightBase = Timestamp(2010,0,0,0,0,0);
             auto intervall = timestampNow - midnightBase;
@@ -140,16 +185,17 @@ void MeteringConnector::loop() {
         //record periodic tx data
 
         if (mocpp_tick_ms() - lastSampleTime >= (unsigned long) (meterValueSampleIntervalInt->getInt() * 1000)) {
+#if MO_ENABLE_METER_AGGREGATION
+            for (size_t i = 0; i < aggregators.size(); i++) {
+                aggregators[i]->closeInterval(ReadingContext_SamplePeriodic);
+            }
+#endif
             if (auto sampledMeterValue = sampledDataBuilder->takeSample(model.getClock().now(), ReadingContext_SamplePeriodic)) {
-                if (meterData.size() >= MO_METERVALUES_CACHE_MAXSIZE) {
-                    MO_DBG_INFO("MeterValue cache full. Drop old MV");
-                    meterData.erase(meterData.begin());
-                }
                 sampledMeterValue->setOpNr(context.getRequestQueue().getNextOpNr());
                 if (transaction) {
                     sampledMeterValue->setTxNr(transaction->getTxNr());
                 }
-                meterData.push_back(std::move(sampledMeterValue));
+                enqueueMeterValue(std::move(sampledMeterValue));
             }
 
             if (stopTxnData && stopTxnDataCapturePeriodicBool->getBool()) {
@@ -186,6 +232,15 @@ void MeteringConnector::addMeterValueSampler(std::unique_ptr<SampledValueSampler
     samplers.push_back(std::move(meterValueSampler));
 }
 
+#if MO_ENABLE_METER_AGGREGATION
+MeterSampleRing *MeteringConnector::addMeterSampleAggregator(std::unique_ptr<MeterSampleAggregator> aggregator) {
+    auto aggregatorPtr = aggregator.get();
+    aggregators.push_back(aggregatorPtr);
+    addMeterValueSampler(std::move(aggregator));
+    return &aggregatorPtr->getRing();
+}
+#endif //MO_ENABLE_METER_AGGREGATION
+
 std::unique_ptr<SampledValue> MeteringConnector::readTxEnergyMeter(ReadingContext model) {
     if (energySamplerIndex >= 0 && (size_t) energySamplerIndex < samplers.size()) {
         return samplers[energySamplerIndex]->takeValue(model);
@@ -249,11 +304,145 @@ bool MeteringConnector::existsSampler(const char *measurand, size_t len) {
     return false;
 }
 
+void MeteringConnector::enqueueMeterValue(std::unique_ptr<MeterValue> mv) {
+    if (meterDataSize >= MO_METERVALUES_CACHE_MAXSIZE) {
+        const char *policy = meterValuesCacheOverflowString->getString();
+        if (!strcmp(policy, "Downsample") && MO_METERVALUES_CACHE_MAXSIZE >= 2) {
+            MO_DBG_INFO("MeterValue cache full. Downsample");
+            downsampleMeterData();
+        } else {
+            auto oldest = std::move(meterData[meterDataBegin]);
+            meterDataBegin = (meterDataBegin + 1) % MO_METERVALUES_CACHE_MAXSIZE;
+            meterDataSize--;
+            if (!strcmp(policy, "Spill") && spillMeterValue(std::move(oldest))) {
+                MO_DBG_DEBUG("MeterValue cache full. Spill old MV");
+            } else {
+                MO_DBG_INFO("MeterValue cache full. Drop old MV");
+            }
+        }
+    }
+
+    meterData[(meterDataBegin + meterDataSize) % MO_METERVALUES_CACHE_MAXSIZE] = std::move(mv);
+    meterDataSize++;
+}
+
+std::unique_ptr<MeterValue> MeteringConnector::dequeueMeterValue() {
+    if (spillBegin != spillEnd) {
+        if (auto mv = restoreSpilledMeterValue()) {
+            return mv;
+        }
+    }
+
+    if (meterDataSize == 0) {
+        return nullptr;
+    }
+
+    auto mv = std::move(meterData[meterDataBegin]);
+    meterDataBegin = (meterDataBegin + 1) % MO_METERVALUES_CACHE_MAXSIZE;
+    meterDataSize--;
+    return mv;
+}
+
+void MeteringConnector::downsampleMeterData() {
+    //keep every second MeterValue, starting with the oldest
+    size_t kept = 0;
+    for (size_t i = 0; i < meterDataSize; i += 2) {
+        if (kept != i) {
+            meterData[(meterDataBegin + kept) % MO_METERVALUES_CACHE_MAXSIZE] = std::move(meterData[(meterDataBegin + i) % MO_METERVALUES_CACHE_MAXSIZE]);
+        }
+        kept++;
+    }
+    for (size_t i = kept; i < meterDataSize; i++) {
+        meterData[(meterDataBegin + i) % MO_METERVALUES_CACHE_MAXSIZE].reset();
+    }
+    meterDataSize = kept;
+}
+
+bool MeteringConnector::spillMeterValue(std::unique_ptr<MeterValue> mv) {
+    if (!filesystem) {
+        return false;
+    }
+
+    char fn [MO_MAX_PATH_SIZE];
+
+    if (spillEnd - spillBegin >= MO_METERVALUES_SPILL_MAXSIZE) {
+        MO_DBG_INFO("MeterValue spill full. Drop old MV");
+        auto ret = snprintf(fn, sizeof(fn), MO_FILENAME_PREFIX MO_METERVALUES_SPILL_FN_PREFIX "%i-%u.jsn", connectorId, spillBegin);
+        if (ret < 0 || (size_t)ret >= sizeof(fn)) {
+            MO_DBG_ERR("fn error: %i", ret);
+            return false;
+        }
+        filesystem->remove(fn);
+        spillBegin++;
+    }
+
+    auto ret = snprintf(fn, sizeof(fn), MO_FILENAME_PREFIX MO_METERVALUES_SPILL_FN_PREFIX "%i-%u.jsn", connectorId, spillEnd);
+    if (ret < 0 || (size_t)ret >= sizeof(fn)) {
+        MO_DBG_ERR("fn error: %i", ret);
+        return false;
+    }
+
+    auto mvDoc = mv->toJson();
+    if (!mvDoc) {
+        MO_DBG_ERR("MV not ready yet");
+        return false;
+    }
+
+    auto doc = initJsonDoc(getMemoryTag(), mvDoc->memoryUsage() + JSON_OBJECT_SIZE(3));
+    doc["mv"] = *mvDoc;
+    doc["opNr"] = mv->getOpNr();
+    if (mv->getTxNr() >= 0) {
+        doc["txNr"] = mv->getTxNr();
+    }
+
+    if (!FilesystemUtils::storeJson(filesystem, fn, doc)) {
+        MO_DBG_ERR("FS error");
+        return false;
+    }
+
+    spillEnd++;
+    return true;
+}
+
+std::unique_ptr<MeterValue> MeteringConnector::restoreSpilledMeterValue() {
+    while (spillBegin != spillEnd) {
+        char fn [MO_MAX_PATH_SIZE];
+        auto ret = snprintf(fn, sizeof(fn), MO_FILENAME_PREFIX MO_METERVALUES_SPILL_FN_PREFIX "%i-%u.jsn", connectorId, spillBegin);
+        spillBegin++;
+        if (ret < 0 || (size_t)ret >= sizeof(fn)) {
+            MO_DBG_ERR("fn error: %i", ret);
+            continue;
+        }
+
+        auto doc = FilesystemUtils::loadJson(filesystem, fn, getMemoryTag());
+        filesystem->remove(fn);
+        if (!doc) {
+            MO_DBG_ERR("failed to load %s", fn);
+            continue;
+        }
+
+        auto mv = sampledDataBuilder->deserializeSample((*doc)["mv"]);
+        if (!mv) {
+            MO_DBG_ERR("failed to deserialize %s", fn);
+            continue;
+        }
+
+        mv->setOpNr((*doc)["opNr"] | 1U);
+        int txNr = (*doc)["txNr"] | -1;
+        if (txNr >= 0) {
+            mv->setTxNr((unsigned int)txNr);
+        }
+        return mv;
+    }
+    return nullptr;
+}
+
 unsigned int MeteringConnector::getFrontRequestOpNr() {
-    if (!meterDataFront && !meterData.empty()) {
-        MO_DBG_DEBUG("advance MV front");
-        meterDataFront = std::move(meterData.front());
-        meterData.erase(meterData.begin());
+    if (!meterDataFront) {
+        meterDataFront = dequeueMeterValue();
+        if (meterDataFront) {
+            MO_DBG_DEBUG("advance MV front");
+        }
     }
     if (meterDataFront) {
         return meterDataFront->getOpNr();
@@ -293,12 +482,14 @@ std::unique_ptr<Request> MeteringConnector::fetchFrontRequest() {
         return nullptr;
     }
 
-    auto meterValues = makeRequest(new MeterValues(model, meterDataFront.get(), connectorId, tx));
-    meterValues->setOnReceiveConfListener([this] (JsonObject) {
+    //MeterValues drops meterDataFront on confirmation. Without a conf listener, the response can take the JsonView path
+    return makeRequest(new MeterValues(model, *this, meterDataFront.get(), connectorId, tx));
+}
+
+void MeteringConnector::confirmMeterValue(const MeterValue *meterValue) {
+    if (meterDataFront && meterDataFront.get() == meterValue) {
         //operation success
         MO_DBG_DEBUG("drop MV front");
         meterDataFront.reset();
-    });
-
-    return meterValues;
+    }
 }
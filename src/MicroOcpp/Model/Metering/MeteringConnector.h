@@ -10,15 +10,34 @@
 
 #include <MicroOcpp/Model/Metering/MeterValue.h>
 #include <MicroOcpp/Model/Metering/MeterStore.h>
+#include <MicroOcpp/Model/Metering/MeterSampleAggregator.h>
 #include <MicroOcpp/Model/Transactions/Transaction.h>
 #include <MicroOcpp/Core/ConfigurationKeyValue.h>
 #include <MicroOcpp/Core/RequestQueue.h>
+#include <MicroOcpp/Core/FilesystemAdapter.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Profile.h>
 
 #ifndef MO_METERVALUES_CACHE_MAXSIZE
 #define MO_METERVALUES_CACHE_MAXSIZE MO_REQUEST_CACHE_MAXSIZE
 #endif
 
+/*
+ * Behavior when the MeterValues cache is full (e.g. while offline). Factory default of the configuration
+ * MO_CONFIG_EXT_PREFIX "MeterValuesCacheOverflow":
+ *     "DropOldest": discard the oldest MeterValue
+ *     "Downsample": discard every second cached MeterValue, i.e. halve the time resolution of the backlog
+ *     "Spill": move the oldest MeterValue to the filesystem and send it from there later. Falls back to
+ *              DropOldest without filesystem or when MO_METERVALUES_SPILL_MAXSIZE is exceeded
+ */
+#ifndef MO_METERVALUES_CACHE_OVERFLOW
+#define MO_METERVALUES_CACHE_OVERFLOW "DropOldest"
+#endif
+
+#ifndef MO_METERVALUES_SPILL_MAXSIZE
+#define MO_METERVALUES_SPILL_MAXSIZE 100 //max number of MeterValues on flash per connector
+#endif
+
 namespace MicroOcpp {
 
 class Context;
@@ -32,9 +51,22 @@ private:
     Model& model;
     const int connectorId;
     MeterStore& meterStore;
-    
-    Vector<std::unique_ptr<MeterValue>> meterData;
+    std::shared_ptr<FilesystemAdapter> filesystem;
+
+    std::unique_ptr<MeterValue> meterData [MO_METERVALUES_CACHE_MAXSIZE]; //ring buffer of queued MeterValues
+    size_t meterDataBegin = 0; //index of the oldest MeterValue
+    size_t meterDataSize = 0;
     std::unique_ptr<MeterValue> meterDataFront;
+
+    unsigned int spillBegin = 0; //MeterValues on flash, older than the cached MeterValues
+    unsigned int spillEnd = 0;
+    std::shared_ptr<Configuration> meterValuesCacheOverflowString;
+
+    void enqueueMeterValue(std::unique_ptr<MeterValue> mv);
+    std::unique_ptr<MeterValue> dequeueMeterValue(); //oldest MeterValue, from flash first
+    bool spillMeterValue(std::unique_ptr<MeterValue> mv);
+    std::unique_ptr<MeterValue> restoreSpilledMeterValue();
+    void downsampleMeterData();
     std::shared_ptr<TransactionMeterData> stopTxnData;
 
     std::unique_ptr<MeterValueBuilder> sampledDataBuilder;
@@ -55,6 +87,10 @@ private:
     Vector<std::unique_ptr<SampledValueSampler>> samplers;
     int energySamplerIndex {-1};
 
+#if MO_ENABLE_METER_AGGREGATION
+    Vector<MeterSampleAggregator*> aggregators; //subset of samplers which need to be drained on each loop
+#endif
+
     std::shared_ptr<Configuration> meterValueSampleIntervalInt;
 
     std::shared_ptr<Configuration> clockAlignedDataIntervalInt;
@@ -65,12 +101,16 @@ private:
     std::shared_ptr<Configuration> transactionMessageAttemptsInt;
     std::shared_ptr<Configuration> transactionMessageRetryIntervalInt;
 public:
-    MeteringConnector(Context& context, int connectorId, MeterStore& meterStore);
+    MeteringConnector(Context& context, int connectorId, MeterStore& meterStore, std::shared_ptr<FilesystemAdapter> filesystem = nullptr);
 
     void loop();
 
     void addMeterValueSampler(std::unique_ptr<SampledValueSampler> meterValueSampler);
 
+#if MO_ENABLE_METER_AGGREGATION
+    MeterSampleRing *addMeterSampleAggregator(std::unique_ptr<MeterSampleAggregator> aggregator);
+#endif
+
     std::unique_ptr<SampledValue> readTxEnergyMeter(ReadingContext model);
 
     std::unique_ptr<Operation> takeTriggeredMeterValues();
@@ -85,6 +125,8 @@ public:
 
     bool existsSampler(const char *measurand, size_t len);
 
+    void confirmMeterValue(const MeterValue *meterValue); //called by the MeterValues operation when the server has confirmed meterValue
+
     //RequestEmitter implementation
     unsigned int getFrontRequestOpNr() override;
     std::unique_ptr<Request> fetchFrontRequest() override;
@@ -24,7 +24,7 @@ MeteringService::MeteringService(Context& context, int numConn, std::shared_ptr<
     
     connectors.reserve(numConn);
     for (int i = 0; i < numConn; i++) {
-        connectors.emplace_back(new MeteringConnector(context, i, meterStore));
+        connectors.emplace_back(new MeteringConnector(context, i, meterStore, filesystem));
     }
 
     std::function<bool(const char*)> validateSelectString = [this] (const char *csl) {
@@ -87,6 +87,16 @@ void MeteringService::addMeterValueSampler(int connectorId, std::unique_ptr<Samp
     connectors[connectorId]->addMeterValueSampler(std::move(meterValueSampler));
 }
 
+#if MO_ENABLE_METER_AGGREGATION
+MeterSampleRing *MeteringService::addMeterSampleAggregator(int connectorId, std::unique_ptr<MeterSampleAggregator> aggregator) {
+    if (connectorId < 0 || connectorId >= (int) connectors.size()) {
+        MO_DBG_ERR("connectorId is out of bounds");
+        return nullptr;
+    }
+    return connectors[connectorId]->addMeterSampleAggregator(std::move(aggregator));
+}
+#endif //MO_ENABLE_METER_AGGREGATION
+
 std::unique_ptr<SampledValue> MeteringService::readTxEnergyMeter(int connectorId, ReadingContext context) {
     if (connectorId < 0 || (size_t) connectorId >= connectors.size()) {
         MO_DBG_ERR("connectorId is out of bounds");
@@ -32,6 +32,10 @@ public:
 
     void addMeterValueSampler(int connectorId, std::unique_ptr<SampledValueSampler> meterValueSampler);
 
+#if MO_ENABLE_METER_AGGREGATION
+    MeterSampleRing *addMeterSampleAggregator(int connectorId, std::unique_ptr<MeterSampleAggregator> aggregator);
+#endif
+
     std::unique_ptr<SampledValue> readTxEnergyMeter(int connectorId, ReadingContext reason);
 
     std::unique_ptr<Request> takeTriggeredMeterValues(int connectorId); //snapshot of all meters now
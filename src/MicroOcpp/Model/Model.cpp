@@ -17,12 +17,14 @@
 #include <MicroOcpp/Model/Boot/BootService.h>
 #include <MicroOcpp/Model/Reset/ResetService.h>
 #include <MicroOcpp/Model/Variables/VariableService.h>
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
 #include <MicroOcpp/Model/Transactions/TransactionService.h>
 #include <MicroOcpp/Model/Certificates/CertificateService.h>
 #include <MicroOcpp/Model/Availability/AvailabilityService.h>
 #include <MicroOcpp/Model/RemoteControl/RemoteControlService.h>
 
 #include <MicroOcpp/Core/Configuration.h>
+#include <MicroOcpp/Core/LoopBudget.h>
 
 #include <MicroOcpp/Debug.h>
 
@@ -49,46 +51,106 @@ void Model::loop() {
         return;
     }
 
+    //connectors drive the charging sessions and run on every call, regardless of the loop budget
     for (auto& connector : connectors) {
         connector->loop();
     }
 
-    if (chargeControlCommon)
-        chargeControlCommon->loop();
-
-    if (smartChargingService)
-        smartChargingService->loop();
-
-    if (heartbeatService)
-        heartbeatService->loop();
-
-    if (meteringService)
-        meteringService->loop();
-
-    if (diagnosticsService)
-        diagnosticsService->loop();
-
-    if (firmwareService)
-        firmwareService->loop();
+    //run each service once, starting at the cursor. If the loop budget is used up, continue there in the next call
+    size_t taskCount = getTaskCount();
+    loopCursor %= taskCount;
+    for (size_t i = 0; i < taskCount; i++) {
+        if (i >= MO_LOOP_MIN_TASKS && LoopBudget::exhausted()) {
+            LoopBudget::countYield();
+            break;
+        }
+        loopTask(loopCursor);
+        loopCursor = (loopCursor + 1) % taskCount;
+    }
+}
 
+enum ModelTask {
+    ModelTask_ChargeControlCommon,
+    ModelTask_SmartCharging,
+    ModelTask_Heartbeat,
+    ModelTask_Metering,
+    ModelTask_Diagnostics,
+    ModelTask_Firmware,
 #if MO_ENABLE_RESERVATION
-    if (reservationService)
-        reservationService->loop();
-#endif //MO_ENABLE_RESERVATION
-
-    if (resetService)
-        resetService->loop();
-
+    ModelTask_Reservation,
+#endif
+    ModelTask_Reset,
 #if MO_ENABLE_V201
-    if (availabilityService)
-        availabilityService->loop();
-
-    if (transactionService)
-        transactionService->loop();
-    
-    if (resetServiceV201)
-        resetServiceV201->loop();
+    ModelTask_Availability,
+    ModelTask_Transaction,
+    ModelTask_ResetV201,
+    ModelTask_Monitoring,
 #endif
+    ModelTask_COUNT
+};
+
+size_t Model::getTaskCount() {
+    return ModelTask_COUNT;
+}
+
+void Model::loopTask(size_t index) {
+
+    switch (index) {
+        case ModelTask_ChargeControlCommon:
+            if (chargeControlCommon)
+                chargeControlCommon->loop();
+            break;
+        case ModelTask_SmartCharging:
+            if (smartChargingService)
+                smartChargingService->loop();
+            break;
+        case ModelTask_Heartbeat:
+            if (heartbeatService)
+                heartbeatService->loop();
+            break;
+        case ModelTask_Metering:
+            if (meteringService)
+                meteringService->loop();
+            break;
+        case ModelTask_Diagnostics:
+            if (diagnosticsService)
+                diagnosticsService->loop();
+            break;
+        case ModelTask_Firmware:
+            if (firmwareService)
+                firmwareService->loop();
+            break;
+#if MO_ENABLE_RESERVATION
+        case ModelTask_Reservation:
+            if (reservationService)
+                reservationService->loop();
+            break;
+#endif //MO_ENABLE_RESERVATION
+        case ModelTask_Reset:
+            if (resetService)
+                resetService->loop();
+            break;
+#if MO_ENABLE_V201
+        case ModelTask_Availability:
+            if (availabilityService)
+                availabilityService->loop();
+            break;
+        case ModelTask_Transaction:
+            if (transactionService)
+                transactionService->loop();
+            break;
+        case ModelTask_ResetV201:
+            if (resetServiceV201)
+                resetServiceV201->loop();
+            break;
+        case ModelTask_Monitoring:
+            if (monitoringService)
+                monitoringService->loop();
+            break;
+#endif //MO_ENABLE_V201
+        default:
+            break;
+    }
 }
 
 void Model::setTransactionStore(std::unique_ptr<TransactionStore> ts) {
@@ -238,6 +300,15 @@ VariableService *Model::getVariableService() const {
     return variableService.get();
 }
 
+void Model::setMonitoringService(std::unique_ptr<MonitoringService> ms) {
+    this->monitoringService = std::move(ms);
+    capabilitiesUpdated = true;
+}
+
+MonitoringService *Model::getMonitoringService() const {
+    return monitoringService.get();
+}
+
 void Model::setTransactionService(std::unique_ptr<TransactionService> ts) {
     this->transactionService = std::move(ts);
     capabilitiesUpdated = true;
@@ -39,6 +39,7 @@ class CertificateService;
 #if MO_ENABLE_V201
 class AvailabilityService;
 class VariableService;
+class MonitoringService;
 class TransactionService;
 class RemoteControlService;
 
@@ -76,6 +77,7 @@ private:
 #if MO_ENABLE_V201
     std::unique_ptr<AvailabilityService> availabilityService;
     std::unique_ptr<VariableService> variableService;
+    std::unique_ptr<MonitoringService> monitoringService;
     std::unique_ptr<TransactionService> transactionService;
     std::unique_ptr<Ocpp201::ResetService> resetServiceV201;
     std::unique_ptr<Ocpp201::MeteringService> meteringServiceV201;
@@ -91,6 +93,10 @@ private:
 
     bool runTasks = false;
 
+    size_t loopCursor = 0; //next service to run. The services rotate when the loop budget is used up
+    size_t getTaskCount();
+    void loopTask(size_t index);
+
     const uint16_t bootNr = 0; //each boot of this lib has a unique number
 
 public:
@@ -154,6 +160,9 @@ public:
     void setVariableService(std::unique_ptr<VariableService> vs);
     VariableService *getVariableService() const;
 
+    void setMonitoringService(std::unique_ptr<MonitoringService> ms);
+    MonitoringService *getMonitoringService() const;
+
     void setTransactionService(std::unique_ptr<TransactionService> ts);
     TransactionService *getTransactionService() const;
 
@@ -7,58 +7,23 @@
 #if MO_ENABLE_RESERVATION
 
 #include <MicroOcpp/Model/Reservation/Reservation.h>
+#include <MicroOcpp/Model/Reservation/ReservationService.h>
 #include <MicroOcpp/Model/Model.h>
 #include <MicroOcpp/Debug.h>
 
 using namespace MicroOcpp;
 
-Reservation::Reservation(Model& model, unsigned int slot) : MemoryManaged("v16.Reservation.Reservation"), model(model), slot(slot) {
-    
-    snprintf(connectorIdKey, sizeof(connectorIdKey), MO_RESERVATION_CID_KEY "%u", slot);
-    connectorIdInt = declareConfiguration<int>(connectorIdKey, -1, RESERVATION_FN, false, false, false);
+Reservation::Reservation(Model& model, ReservationService& service, unsigned int slot) : MemoryManaged("v16.Reservation.Reservation"), model(model), service(service), slot(slot) {
 
-    snprintf(expiryDateRawKey, sizeof(expiryDateRawKey), MO_RESERVATION_EXPDATE_KEY "%u", slot);
-    expiryDateRawString = declareConfiguration<const char*>(expiryDateRawKey, "", RESERVATION_FN, false, false, false);
-    
-    snprintf(idTagKey, sizeof(idTagKey), MO_RESERVATION_IDTAG_KEY "%u", slot);
-    idTagString = declareConfiguration<const char*>(idTagKey, "", RESERVATION_FN, false, false, false);
-
-    snprintf(reservationIdKey, sizeof(reservationIdKey), MO_RESERVATION_RESID_KEY "%u", slot);
-    reservationIdInt = declareConfiguration<int>(reservationIdKey, -1, RESERVATION_FN, false, false, false);
-
-    snprintf(parentIdTagKey, sizeof(parentIdTagKey), MO_RESERVATION_PARENTID_KEY "%u", slot);
-    parentIdTagString = declareConfiguration<const char*>(parentIdTagKey, "", RESERVATION_FN, false, false, false);
-
-    if (!connectorIdInt || !expiryDateRawString || !idTagString || !reservationIdInt || !parentIdTagString) {
-        MO_DBG_ERR("initialization failure");
-    }
-}
-
-Reservation::~Reservation() {
-    if (connectorIdInt->getKey() == connectorIdKey) {
-        connectorIdInt->setKey(nullptr);
-    }
-    if (expiryDateRawString->getKey() == expiryDateRawKey) {
-        expiryDateRawString->setKey(nullptr);
-    }
-    if (idTagString->getKey() == idTagKey) {
-        idTagString->setKey(nullptr);
-    }
-    if (reservationIdInt->getKey() == reservationIdKey) {
-        reservationIdInt->setKey(nullptr);
-    }
-    if (parentIdTagString->getKey() == parentIdTagKey) {
-        parentIdTagString->setKey(nullptr);
-    }
 }
 
 bool Reservation::isActive() {
-    if (connectorIdInt->getInt() < 0) {
+    if (connectorId < 0) {
         //reservation invalidated
         return false;
     }
 
-    if (model.getClock().now() > getExpiryDate()) {
+    if (model.getClock().now() > expiryDate) {
         //reservation expired
         return false;
     }
@@ -67,7 +32,7 @@ bool Reservation::isActive() {
 }
 
 bool Reservation::matches(unsigned int connectorId) {
-    return (int) connectorId == connectorIdInt->getInt();
+    return (int) connectorId == this->connectorId;
 }
 
 bool Reservation::matches(const char *idTag, const char *parentIdTag) {
@@ -75,11 +40,11 @@ bool Reservation::matches(const char *idTag, const char *parentIdTag) {
         return true;
     }
 
-    if (idTag && !strcmp(idTag, idTagString->getString())) {
+    if (idTag && !strcmp(idTag, this->idTag)) {
         return true;
     }
 
-    if (parentIdTag && !strcmp(parentIdTag, parentIdTagString->getString())) {
+    if (parentIdTag && !strcmp(parentIdTag, this->parentIdTag)) {
         return true;
     }
 
@@ -87,51 +52,52 @@ bool Reservation::matches(const char *idTag, const char *parentIdTag) {
 }
 
 int Reservation::getConnectorId() {
-    return connectorIdInt->getInt();
+    return connectorId;
 }
 
 Timestamp& Reservation::getExpiryDate() {
-    if (expiryDate == MIN_TIME && *expiryDateRawString->getString()) {
-        expiryDate.setTime(expiryDateRawString->getString());
-    }
     return expiryDate;
 }
 
 const char *Reservation::getIdTag() {
-    return idTagString->getString();
+    return idTag;
 }
 
 int Reservation::getReservationId() {
-    return reservationIdInt->getInt();
+    return reservationId;
 }
 
 const char *Reservation::getParentIdTag() {
-    return parentIdTagString->getString();
+    return parentIdTag;
+}
+
+unsigned int Reservation::getSlot() {
+    return slot;
 }
 
 void Reservation::update(int reservationId, unsigned int connectorId, Timestamp expiryDate, const char *idTag, const char *parentIdTag) {
-    reservationIdInt->setInt(reservationId);
-    connectorIdInt->setInt((int) connectorId);
+    service.unindex(*this);
+
+    this->reservationId = reservationId;
+    this->connectorId = (int) connectorId;
     this->expiryDate = expiryDate;
-    char expiryDate_cstr [JSONDATE_LENGTH + 1];
-    if (this->expiryDate.toJsonString(expiryDate_cstr, JSONDATE_LENGTH + 1)) {
-        expiryDateRawString->setString(expiryDate_cstr);
-    }
-    idTagString->setString(idTag);
-    parentIdTagString->setString(parentIdTag);
+    snprintf(this->idTag, sizeof(this->idTag), "%s", idTag ? idTag : "");
+    snprintf(this->parentIdTag, sizeof(this->parentIdTag), "%s", parentIdTag ? parentIdTag : "");
 
-    configuration_save();
+    service.index(*this);
+    service.store(*this);
 }
 
 void Reservation::clear() {
-    connectorIdInt->setInt(-1);
+    service.unindex(*this);
+
+    connectorId = -1;
     expiryDate = MIN_TIME;
-    expiryDateRawString->setString("");
-    idTagString->setString("");
-    reservationIdInt->setInt(-1);
-    parentIdTagString->setString("");
+    idTag[0] = '\0';
+    reservationId = -1;
+    parentIdTag[0] = '\0';
 
-    configuration_save();
+    service.store(*this);
 }
 
 #endif //MO_ENABLE_RESERVATION
@@ -9,50 +9,55 @@
 
 #if MO_ENABLE_RESERVATION
 
-#include <MicroOcpp/Core/Configuration.h>
 #include <MicroOcpp/Core/Time.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Operations/CiStrings.h>
 
+//legacy storage of all reservations in one Configurations file. Removed during startup
 #ifndef RESERVATION_FN
 #define RESERVATION_FN (MO_FILENAME_PREFIX "reservations.jsn")
 #endif
 
-#define MO_RESERVATION_CID_KEY "cid_"
-#define MO_RESERVATION_EXPDATE_KEY "expdt_"
-#define MO_RESERVATION_IDTAG_KEY "idt_"
-#define MO_RESERVATION_RESID_KEY "rsvid_"
-#define MO_RESERVATION_PARENTID_KEY "pidt_"
+//each reservation slot is stored in a separate record file "<prefix><slot><suffix>"
+#ifndef MO_RESERVATION_FN_PREFIX
+#define MO_RESERVATION_FN_PREFIX (MO_FILENAME_PREFIX "rsv-")
+#endif
+
+#ifndef MO_RESERVATION_FN_SUFFIX
+#define MO_RESERVATION_FN_SUFFIX ".jsn"
+#endif
 
 namespace MicroOcpp {
 
 class Model;
+class ReservationService;
 
 class Reservation : public MemoryManaged {
 private:
     Model& model;
+    ReservationService& service;
     const unsigned int slot;
 
-    std::shared_ptr<Configuration> connectorIdInt;
-    char connectorIdKey [sizeof(MO_RESERVATION_CID_KEY "xxx") + 1]; //"xxx" = placeholder for digits
-    std::shared_ptr<Configuration> expiryDateRawString;
-    char expiryDateRawKey [sizeof(MO_RESERVATION_EXPDATE_KEY "xxx") + 1];
-
+    int connectorId = -1; //-1 = slot is free
     Timestamp expiryDate = MIN_TIME;
-    std::shared_ptr<Configuration> idTagString;
-    char idTagKey [sizeof(MO_RESERVATION_IDTAG_KEY "xxx") + 1];
-    std::shared_ptr<Configuration> reservationIdInt;
-    char reservationIdKey [sizeof(MO_RESERVATION_RESID_KEY "xxx") + 1];
-    std::shared_ptr<Configuration> parentIdTagString;
-    char parentIdTagKey [sizeof(MO_RESERVATION_PARENTID_KEY "xxx") + 1];
+    char idTag [IDTAG_LEN_MAX + 1] = {'\0'};
+    int reservationId = -1;
+    char parentIdTag [IDTAG_LEN_MAX + 1] = {'\0'};
+
+    //index nodes, managed by ReservationService
+    friend class ReservationService;
+    Reservation *nextByConnector = nullptr;
+    Reservation *nextById = nullptr;
+    Reservation *nextByIdTag = nullptr;
+    Reservation *nextByParentIdTag = nullptr;
+    size_t heapPos = 0;
 
 public:
-    Reservation(Model& model, unsigned int slot);
+    Reservation(Model& model, ReservationService& service, unsigned int slot);
     Reservation(const Reservation&) = delete;
     Reservation(Reservation&&) = delete;
     Reservation& operator=(const Reservation&) = delete;
 
-    ~Reservation();
-
     bool isActive(); //if this object contains a valid, unexpired reservation
 
     bool matches(unsigned int connectorId);
@@ -64,6 +69,8 @@ public:
     int getReservationId();
     const char *getParentIdTag();
 
+    unsigned int getSlot();
+
     void update(int reservationId, unsigned int connectorId, Timestamp expiryDate, const char *idTag, const char *parentIdTag = nullptr);
     void clear();
 };
@@ -13,17 +13,80 @@
 #include <MicroOcpp/Model/Transactions/Transaction.h>
 #include <MicroOcpp/Operations/CancelReservation.h>
 #include <MicroOcpp/Operations/ReserveNow.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
 
 #include <MicroOcpp/Debug.h>
 
 using namespace MicroOcpp;
 
-ReservationService::ReservationService(Context& context, unsigned int numConnectors) : MemoryManaged("v16.Reservation.ReservationService"), context(context), maxReservations((int) numConnectors - 1), reservations(makeVector<std::unique_ptr<Reservation>>(getMemoryTag())) {
+namespace MicroOcpp {
+namespace Ocpp16 {
+
+uint32_t hashReservationKey(const char *key) {
+    //FNV-1a
+    uint32_t hash = 2166136261U;
+    for (const char *c = key; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+    }
+    return hash;
+}
+
+uint32_t hashReservationKey(int key) {
+    uint32_t hash = (uint32_t) key;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bU;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+//remove element from an intrusive list which is chained via the member next
+void unlinkReservation(Reservation *&head, Reservation *element, Reservation *Reservation::*next) {
+    for (Reservation **it = &head; *it; it = &((*it)->*next)) {
+        if (*it == element) {
+            *it = element->*next;
+            element->*next = nullptr;
+            return;
+        }
+    }
+}
+
+} //namespace Ocpp16
+} //namespace MicroOcpp
+
+using namespace MicroOcpp::Ocpp16;
+
+ReservationService::ReservationService(Context& context, unsigned int numConnectors, std::shared_ptr<FilesystemAdapter> filesystem) :
+        MemoryManaged("v16.Reservation.ReservationService"),
+        context(context),
+        filesystem(filesystem),
+        maxReservations((int) numConnectors - 1),
+        reservations(makeVector<std::unique_ptr<Reservation>>(getMemoryTag())),
+        byConnector(makeVector<Reservation*>(getMemoryTag())),
+        byId(makeVector<Reservation*>(getMemoryTag())),
+        byIdTag(makeVector<Reservation*>(getMemoryTag())),
+        byParentIdTag(makeVector<Reservation*>(getMemoryTag())),
+        expiryHeap(makeVector<Reservation*>(getMemoryTag())) {
+
     if (maxReservations > 0) {
         reservations.reserve((size_t) maxReservations);
         for (int i = 0; i < maxReservations; i++) {
-            reservations.emplace_back(new Reservation(context.getModel(), i));
+            reservations.emplace_back(new Reservation(context.getModel(), *this, i));
         }
+
+        byConnector.resize(numConnectors, nullptr);
+
+        size_t nBuckets = 1;
+        while (nBuckets < (size_t) maxReservations) {
+            nBuckets *= 2;
+        }
+        byId.resize(nBuckets, nullptr);
+        byIdTag.resize(nBuckets, nullptr);
+        byParentIdTag.resize(nBuckets, nullptr);
+        bucketMask = nBuckets - 1;
+
+        expiryHeap.reserve((size_t) maxReservations);
+
+        load();
     }
 
     reserveConnectorZeroSupportedBool = declareConfiguration<bool>("ReserveConnectorZeroSupported", true, CONFIGURATION_VOLATILE, true);
@@ -34,41 +97,256 @@ ReservationService::ReservationService(Context& context, unsigned int numConnect
         return new Ocpp16::ReserveNow(context.getModel());});
 }
 
-void ReservationService::loop() {
-    //check if to end reservations
+void ReservationService::index(Reservation& reservation) {
+    if (reservation.connectorId < 0 || (size_t) reservation.connectorId >= byConnector.size()) {
+        return;
+    }
+
+    reservation.nextByConnector = byConnector[reservation.connectorId];
+    byConnector[reservation.connectorId] = &reservation;
+    if (reservation.connectorId == 0) {
+        connectorZeroCount++;
+    }
+
+    auto& idBucket = byId[hashReservationKey(reservation.reservationId) & bucketMask];
+    reservation.nextById = idBucket;
+    idBucket = &reservation;
+
+    auto& idTagBucket = byIdTag[hashReservationKey(reservation.idTag) & bucketMask];
+    reservation.nextByIdTag = idTagBucket;
+    idTagBucket = &reservation;
+
+    if (*reservation.parentIdTag) {
+        auto& parentIdTagBucket = byParentIdTag[hashReservationKey(reservation.parentIdTag) & bucketMask];
+        reservation.nextByParentIdTag = parentIdTagBucket;
+        parentIdTagBucket = &reservation;
+    }
+
+    reservation.heapPos = expiryHeap.size();
+    expiryHeap.push_back(&reservation);
+    heapSiftUp(reservation.heapPos);
+}
+
+void ReservationService::unindex(Reservation& reservation) {
+    if (reservation.connectorId < 0 || (size_t) reservation.connectorId >= byConnector.size()) {
+        return;
+    }
+
+    unlinkReservation(byConnector[reservation.connectorId], &reservation, &Reservation::nextByConnector);
+    if (reservation.connectorId == 0) {
+        connectorZeroCount--;
+    }
+
+    unlinkReservation(byId[hashReservationKey(reservation.reservationId) & bucketMask], &reservation, &Reservation::nextById);
+    unlinkReservation(byIdTag[hashReservationKey(reservation.idTag) & bucketMask], &reservation, &Reservation::nextByIdTag);
+    if (*reservation.parentIdTag) {
+        unlinkReservation(byParentIdTag[hashReservationKey(reservation.parentIdTag) & bucketMask], &reservation, &Reservation::nextByParentIdTag);
+    }
+
+    size_t pos = reservation.heapPos;
+    size_t last = expiryHeap.size() - 1;
+    if (pos != last) {
+        heapSwap(pos, last);
+    }
+    expiryHeap.pop_back();
+    if (pos < expiryHeap.size()) {
+        heapSiftUp(pos);
+        heapSiftDown(pos);
+    }
+}
+
+void ReservationService::heapSwap(size_t i, size_t j) {
+    auto tmp = expiryHeap[i];
+    expiryHeap[i] = expiryHeap[j];
+    expiryHeap[j] = tmp;
+    expiryHeap[i]->heapPos = i;
+    expiryHeap[j]->heapPos = j;
+}
+
+void ReservationService::heapSiftUp(size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!(expiryHeap[pos]->expiryDate < expiryHeap[parent]->expiryDate)) {
+            break;
+        }
+        heapSwap(pos, parent);
+        pos = parent;
+    }
+}
+
+void ReservationService::heapSiftDown(size_t pos) {
+    while (true) {
+        size_t min = pos;
+        size_t left = 2 * pos + 1;
+        size_t right = 2 * pos + 2;
+        if (left < expiryHeap.size() && expiryHeap[left]->expiryDate < expiryHeap[min]->expiryDate) {
+            min = left;
+        }
+        if (right < expiryHeap.size() && expiryHeap[right]->expiryDate < expiryHeap[min]->expiryDate) {
+            min = right;
+        }
+        if (min == pos) {
+            break;
+        }
+        heapSwap(pos, min);
+        pos = min;
+    }
+}
+
+void ReservationService::expire() {
+    auto& now = context.getModel().getClock().now();
+    while (!expiryHeap.empty() && now > expiryHeap.front()->expiryDate) {
+        MO_DBG_DEBUG("reservation %i expired", expiryHeap.front()->reservationId);
+        expiryHeap.front()->clear();
+    }
+}
+
+bool ReservationService::store(Reservation& reservation) {
+    if (!filesystem) {
+        return true; //no persistency
+    }
+
+    char fn [MO_MAX_PATH_SIZE];
+    auto ret = snprintf(fn, sizeof(fn), "%s%u%s", MO_RESERVATION_FN_PREFIX, reservation.slot, MO_RESERVATION_FN_SUFFIX);
+    if (ret < 0 || (size_t)ret >= sizeof(fn)) {
+        MO_DBG_ERR("fn error: %i", ret);
+        return false;
+    }
+
+    if (reservation.connectorId < 0) {
+        //slot is free
+        size_t msize;
+        if (filesystem->stat(fn, &msize) == 0) {
+            return filesystem->remove(fn);
+        }
+        return true;
+    }
+
+    char expiryDate_cstr [JSONDATE_LENGTH + 1];
+    if (!reservation.expiryDate.toJsonString(expiryDate_cstr, sizeof(expiryDate_cstr))) {
+        MO_DBG_ERR("serialization error");
+        return false;
+    }
+
+    auto doc = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(5));
+    doc["cid"] = reservation.connectorId;
+    doc["rsvid"] = reservation.reservationId;
+    doc["expdt"] = (const char*) expiryDate_cstr; //force zero-copy
+    doc["idt"] = (const char*) reservation.idTag;
+    if (*reservation.parentIdTag) {
+        doc["pidt"] = (const char*) reservation.parentIdTag;
+    }
+
+    if (!FilesystemUtils::storeJson(filesystem, fn, doc)) {
+        MO_DBG_ERR("FS error");
+        return false;
+    }
+    return true;
+}
+
+bool ReservationService::load() {
+    if (!filesystem) {
+        return true; //no persistency
+    }
+
+    size_t msize;
+    if (filesystem->stat(RESERVATION_FN, &msize) == 0) {
+        MO_DBG_INFO("remove legacy reservations file");
+        filesystem->remove(RESERVATION_FN);
+    }
+
+    bool success = true;
 
     for (auto& reservation : reservations) {
-        if (!reservation->isActive()) {
+        char fn [MO_MAX_PATH_SIZE];
+        auto ret = snprintf(fn, sizeof(fn), "%s%u%s", MO_RESERVATION_FN_PREFIX, reservation->slot, MO_RESERVATION_FN_SUFFIX);
+        if (ret < 0 || (size_t)ret >= sizeof(fn)) {
+            MO_DBG_ERR("fn error: %i", ret);
+            return false;
+        }
+
+        if (filesystem->stat(fn, &msize) != 0) {
+            continue; //slot is free
+        }
+
+        auto doc = FilesystemUtils::loadJson(filesystem, fn, getMemoryTag());
+        Timestamp expiryDate;
+        if (!doc ||
+                !(*doc)["cid"].is<int>() || (*doc)["cid"].as<int>() < 0 ||
+                !(*doc)["rsvid"].is<int>() ||
+                !expiryDate.setTime((*doc)["expdt"] | "_Invalid") ||
+                !(*doc)["idt"].is<const char*>()) {
+            MO_DBG_ERR("invalid record %s", fn);
+            filesystem->remove(fn);
+            success = false;
             continue;
         }
 
-        if (auto connector = context.getModel().getConnector(reservation->getConnectorId())) {
+        reservation->connectorId = (*doc)["cid"];
+        reservation->reservationId = (*doc)["rsvid"];
+        reservation->expiryDate = expiryDate;
+        snprintf(reservation->idTag, sizeof(reservation->idTag), "%s", (*doc)["idt"].as<const char*>());
+        snprintf(reservation->parentIdTag, sizeof(reservation->parentIdTag), "%s", (*doc)["pidt"] | "");
+
+        index(*reservation);
+    }
+
+    return success;
+}
+
+void ReservationService::loop() {
+    //check if to end reservations
 
+    expire();
+
+    if (expiryHeap.empty()) {
+        return;
+    }
+
+    auto& model = context.getModel();
+
+    for (unsigned int cId = 0; cId < model.getNumConnectors() && !expiryHeap.empty(); cId++) {
+        auto connector = model.getConnector(cId);
+        if (!connector) {
+            continue;
+        }
+
+        if (cId < byConnector.size() && byConnector[cId]) {
             //check if connector went inoperative
             auto cStatus = connector->getStatus();
             if (cStatus == ChargePointStatus_Faulted || cStatus == ChargePointStatus_Unavailable) {
-                reservation->clear();
+                while (byConnector[cId]) {
+                    byConnector[cId]->clear();
+                }
                 continue;
             }
+        }
 
-            //check if other tx started at this connector (e.g. due to RemoteStartTransaction)
-            if (connector->getTransaction() && connector->getTransaction()->isAuthorized()) {
-                reservation->clear();
-                continue;
+        auto& transaction = connector->getTransaction();
+        if (cId == 0 || !transaction || !transaction->isAuthorized()) {
+            continue;
+        }
+
+        //check if other tx started at this connector (e.g. due to RemoteStartTransaction)
+        if (cId < byConnector.size()) {
+            while (byConnector[cId]) {
+                byConnector[cId]->clear();
             }
         }
 
         //check if tx with same idTag or reservationId has started
-        for (unsigned int cId = 1; cId < context.getModel().getNumConnectors(); cId++) {
-            auto& transaction = context.getModel().getConnector(cId)->getTransaction();
-            if (transaction && transaction->isAuthorized()) {
-                const char *cIdTag = transaction->getIdTag();
-                if (transaction->getReservationId() == reservation->getReservationId() || 
-                        (cIdTag && !strcmp(cIdTag, reservation->getIdTag()))) {
+        while (auto reservation = getReservationById(transaction->getReservationId())) {
+            reservation->clear();
+        }
 
+        if (const char *cIdTag = transaction->getIdTag()) {
+            auto reservation = byIdTag[hashReservationKey(cIdTag) & bucketMask];
+            while (reservation) {
+                auto next = reservation->nextByIdTag;
+                if (!strcmp(cIdTag, reservation->idTag)) {
                     reservation->clear();
-                    break;
                 }
+                reservation = next;
             }
         }
     }
@@ -80,13 +358,13 @@ Reservation *ReservationService::getReservation(unsigned int connectorId) {
         return nullptr; //cannot fetch for connectorId 0 because multiple reservations are possible at a time
     }
 
-    for (auto& reservation : reservations) {
-        if (reservation->isActive() && reservation->matches(connectorId)) {
-            return reservation.get();
-        }
+    expire();
+
+    if (connectorId >= byConnector.size()) {
+        return nullptr;
     }
-    
-    return nullptr;
+
+    return byConnector[connectorId];
 }
 
 Reservation *ReservationService::getReservation(const char *idTag, const char *parentIdTag) {
@@ -95,20 +373,32 @@ Reservation *ReservationService::getReservation(const char *idTag, const char *p
         return nullptr;
     }
 
-    Reservation *connectorReservation = nullptr;
+    expire();
 
-    for (auto& reservation : reservations) {
-        if (!reservation->isActive()) {
-            continue;
-        }
+    if (expiryHeap.empty()) {
+        return nullptr;
+    }
 
-        //TODO check for parentIdTag
+    Reservation *connectorReservation = nullptr;
 
-        if (reservation->matches(idTag, parentIdTag)) {
-            if (reservation->getConnectorId() == 0) {
-                return reservation.get(); //reservation at connectorId 0 has higher priority
+    for (auto reservation = byIdTag[hashReservationKey(idTag) & bucketMask]; reservation; reservation = reservation->nextByIdTag) {
+        if (!strcmp(idTag, reservation->idTag)) {
+            if (reservation->connectorId == 0) {
+                return reservation; //reservation at connectorId 0 has higher priority
             } else {
-                connectorReservation = reservation.get();
+                connectorReservation = reservation;
+            }
+        }
+    }
+
+    if (parentIdTag && *parentIdTag) {
+        for (auto reservation = byParentIdTag[hashReservationKey(parentIdTag) & bucketMask]; reservation; reservation = reservation->nextByParentIdTag) {
+            if (!strcmp(parentIdTag, reservation->parentIdTag)) {
+                if (reservation->connectorId == 0) {
+                    return reservation;
+                } else {
+                    connectorReservation = reservation;
+                }
             }
         }
     }
@@ -139,17 +429,18 @@ Reservation *ReservationService::getReservation(unsigned int connectorId, const
     }
 
     //connectorZero check
-    Reservation *blockingReservation = nullptr; //any reservation which blocks this connector now
+    expire();
 
-    //Check if there are enough free connectors to satisfy all reservations at connectorId 0
-    unsigned int unspecifiedReservations = 0;
-    for (auto& reservation : reservations) {
-        if (reservation->isActive() && reservation->getConnectorId() == 0) {
-            unspecifiedReservations++;
-            blockingReservation = reservation.get();
-        }
+    if (connectorZeroCount == 0) {
+        MO_DBG_DEBUG("no reservation");
+        return nullptr;
     }
 
+    Reservation *blockingReservation = byConnector[0]; //any reservation which blocks this connector now
+
+    //Check if there are enough free connectors to satisfy all reservations at connectorId 0
+    unsigned int unspecifiedReservations = connectorZeroCount;
+
     unsigned int availableCount = 0;
     for (unsigned int cId = 1; cId < context.getModel().getNumConnectors(); cId++) {
         if (cId == connectorId) {
@@ -173,9 +464,15 @@ Reservation *ReservationService::getReservation(unsigned int connectorId, const
 }
 
 Reservation *ReservationService::getReservationById(int reservationId) {
-    for (auto& reservation : reservations) {
-        if (reservation->isActive() && reservation->getReservationId() == reservationId) {
-            return reservation.get();
+    expire();
+
+    if (expiryHeap.empty()) {
+        return nullptr;
+    }
+
+    for (auto reservation = byId[hashReservationKey(reservationId) & bucketMask]; reservation; reservation = reservation->nextById) {
+        if (reservation->reservationId == reservationId) {
+            return reservation;
         }
     }
 
@@ -184,7 +481,8 @@ Reservation *ReservationService::getReservationById(int reservationId) {
 
 bool ReservationService::updateReservation(int reservationId, unsigned int connectorId, Timestamp expiryDate, const char *idTag, const char *parentIdTag) {
     if (auto reservation = getReservationById(reservationId)) {
-        if (getReservation(connectorId) && getReservation(connectorId) != reservation && getReservation(connectorId)->isActive()) {
+        auto blocking = getReservation(connectorId);
+        if (blocking && blocking != reservation) {
             MO_DBG_DEBUG("found blocking reservation at connectorId %u", connectorId);
             return false; //cannot transfer reservation to other connector with existing reservation
         }
@@ -205,7 +503,7 @@ bool ReservationService::updateReservation(int reservationId, unsigned int conne
 
     //update free reservation slot
     for (auto& reservation : reservations) {
-        if (!reservation->isActive()) {
+        if (reservation->connectorId < 0) {
             reservation->update(reservationId, connectorId, expiryDate, idTag, parentIdTag);
             return true;
         }
@@ -10,6 +10,8 @@
 #if MO_ENABLE_RESERVATION
 
 #include <MicroOcpp/Model/Reservation/Reservation.h>
+#include <MicroOcpp/Core/Configuration.h>
+#include <MicroOcpp/Core/FilesystemAdapter.h>
 #include <MicroOcpp/Core/Memory.h>
 
 #include <memory>
@@ -21,14 +23,40 @@ class Context;
 class ReservationService : public MemoryManaged {
 private:
     Context& context;
+    std::shared_ptr<FilesystemAdapter> filesystem;
 
     const int maxReservations; // = number of physical connectors
     Vector<std::unique_ptr<Reservation>> reservations;
 
+    /*
+     * Indexes over all valid reservations. The lists are chained through the Reservation objects. Reservations
+     * are removed from the indexes when they're cleared or expire, so all lookups only visit active reservations
+     */
+    Vector<Reservation*> byConnector; //list per connectorId. There is at most one reservation per connectorId > 0
+    Vector<Reservation*> byId; //hash buckets
+    Vector<Reservation*> byIdTag; //hash buckets
+    Vector<Reservation*> byParentIdTag; //hash buckets, without empty parentIdTags
+    size_t bucketMask = 0;
+    unsigned int connectorZeroCount = 0;
+
+    Vector<Reservation*> expiryHeap; //min-heap ordered by expiryDate
+
+    friend class Reservation;
+    void index(Reservation& reservation);
+    void unindex(Reservation& reservation);
+    bool store(Reservation& reservation);
+    bool load();
+
+    void heapSwap(size_t i, size_t j);
+    void heapSiftUp(size_t pos);
+    void heapSiftDown(size_t pos);
+
+    void expire(); //clear all reservations which are past their expiryDate
+
     std::shared_ptr<Configuration> reserveConnectorZeroSupportedBool;
 
 public:
-    ReservationService(Context& context, unsigned int numConnectors);
+    ReservationService(Context& context, unsigned int numConnectors, std::shared_ptr<FilesystemAdapter> filesystem = nullptr);
 
     void loop();
 
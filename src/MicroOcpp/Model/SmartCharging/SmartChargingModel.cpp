@@ -18,7 +18,11 @@ ChargeRate MicroOcpp::chargeRate_min(const ChargeRate& a, const ChargeRate& b) {
     return res;
 }
 
+#if MO_ENABLE_INLINE_SCHEDULE_PERIODS
+ChargingSchedule::ChargingSchedule() : MemoryManaged("v16.SmartCharging.SmartChargingModel") {
+#else
 ChargingSchedule::ChargingSchedule() : MemoryManaged("v16.SmartCharging.SmartChargingModel"), chargingSchedulePeriod{makeVector<ChargingSchedulePeriod>(getMemoryTag())} {
+#endif
 
 }
 
@@ -5,6 +5,8 @@
 #ifndef SMARTCHARGINGMODEL_H
 #define SMARTCHARGINGMODEL_H
 
+#include <MicroOcpp/Profile.h>
+
 #ifndef MO_ChargeProfileMaxStackLevel
 #define MO_ChargeProfileMaxStackLevel 8
 #endif
@@ -17,6 +19,15 @@
 #define MO_MaxChargingProfilesInstalled 10
 #endif
 
+/*
+ * Store the ChargingSchedulePeriods inline in the ChargingSchedule instead of a heap Vector. Each schedule then
+ * takes MO_ChargingScheduleMaxPeriods * sizeof(ChargingSchedulePeriod) (12 bytes on 32-bit MCUs) regardless of the
+ * actual number of periods, so this is only enabled with small capacities (see MO_PROFILE_SMALL)
+ */
+#ifndef MO_ENABLE_INLINE_SCHEDULE_PERIODS
+#define MO_ENABLE_INLINE_SCHEDULE_PERIODS 0
+#endif
+
 #include <memory>
 #include <limits>
 
@@ -80,7 +91,11 @@ public:
     int duration = -1;
     Timestamp startSchedule;
     ChargingRateUnitType chargingRateUnit;
+#if MO_ENABLE_INLINE_SCHEDULE_PERIODS
+    InlineVector<ChargingSchedulePeriod, MO_ChargingScheduleMaxPeriods> chargingSchedulePeriod;
+#else
     Vector<ChargingSchedulePeriod> chargingSchedulePeriod;
+#endif
     float minChargingRate = -1.0f;
 
     ChargingProfileKindType chargingProfileKind; //copied from ChargingProfile to increase cohesion of limit algorithms
@@ -347,6 +347,7 @@ public:
 
     unsigned int seqNoEnd = 0; // increment by 1 for each event
     Vector<unsigned int> seqNos; //track stored txEvents
+    unsigned int txEventLog = 0; //active txEvent log file (0 or 1). Alternates when the log is compacted
 
     bool silent = false; //silent Tx: process tx locally, without reporting to the server
 
@@ -5,6 +5,7 @@
 #include <MicroOcpp/Model/Transactions/TransactionStore.h>
 #include <MicroOcpp/Model/Transactions/TransactionDeserialize.h>
 #include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Core/Metrics.h>
 #include <MicroOcpp/Debug.h>
 
 using namespace MicroOcpp;
@@ -147,6 +148,11 @@ bool ConnectorTransactionStore::commit(Transaction *transaction) {
         return false;
     }
 
+    if (!filesystem->flush(fn)) { //transaction data must be persisted before continuing
+        MO_DBG_ERR("FS error");
+        return false;
+    }
+
     //success
     return true;
 }
@@ -225,6 +231,8 @@ bool TransactionStore::remove(unsigned int connectorId, unsigned int txNr) {
 #if MO_ENABLE_V201
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace MicroOcpp {
 namespace Ocpp201 {
@@ -639,16 +647,742 @@ bool TransactionStoreEvse::deserializeTransactionEvent(TransactionEventData& txE
     return true;
 }
 
+namespace {
+
+bool equalsOptional(const char *a, const char *b) {
+    if (!a || !b) {
+        return a == b;
+    }
+    return !strcmp(a, b);
+}
+
+//if value can be delta-encoded without loss of precision
+bool isIntegral(double value) {
+    return value > -9007199254740992. && value < 9007199254740992. && value == (double)(int64_t)value;
+}
+
+//the MeterValue timestamps are stored relative to the txEvent timestamp as it is restored from flash
+Timestamp getLogReferenceTime(const Timestamp& eventTime) {
+    return eventTime > MIN_TIME ? eventTime : Timestamp();
+}
+
+//ArduinoJson writer which only computes the FNV-1a hash of the output
+struct HashWriter {
+    uint32_t hash = 2166136261UL;
+
+    size_t write(uint8_t c) {
+        hash ^= c;
+        hash *= 16777619UL;
+        return 1;
+    }
+
+    size_t write(const uint8_t *buf, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            write(buf[i]);
+        }
+        return len;
+    }
+};
+
+//reads the txEvent log record by record
+class TxEventLogReader {
+private:
+    std::unique_ptr<FileAdapter> file;
+    size_t offset = 0;
+
+    //ArduinoJson reader which tracks the read position
+    struct Input {
+        FileAdapter *file;
+        size_t *offset;
+
+        int read() {
+            int c = file->read();
+            if (c >= 0) {
+                (*offset)++;
+            }
+            return c;
+        }
+
+        size_t readBytes(char *buf, size_t len) {
+            auto ret = file->read(buf, len);
+            *offset += ret;
+            return ret;
+        }
+    };
+public:
+    enum class Status {
+        Record,
+        End,
+        Corrupt
+    };
+
+    bool open(FilesystemAdapter& filesystem, const char *fn, size_t offset) {
+        size_t size;
+        if (filesystem.stat(fn, &size) != 0) {
+            return false;
+        }
+        file = filesystem.open(fn, "r");
+        if (!file) {
+            MO_DBG_ERR("could not open %s", fn);
+            return false;
+        }
+        if (offset > 0) {
+            file->seek(offset);
+        }
+        this->offset = offset;
+        return true;
+    }
+
+    Status next(JsonDoc& record) {
+        size_t recordBegin = offset;
+        size_t capacity = std::max(record.capacity(), (size_t)256);
+
+        while (true) {
+            if (record.capacity() < capacity) {
+                record = initJsonDoc("v201.Transactions.TransactionStore", capacity);
+            }
+            record.clear();
+
+            Input input {file.get(), &offset};
+            auto err = deserializeJson(record, input);
+
+            if (err == DeserializationError::Ok) {
+                return Status::Record;
+            } else if (err == DeserializationError::EmptyInput) {
+                return Status::End;
+            } else if (err == DeserializationError::NoMemory && capacity < MO_MAX_JSON_CAPACITY) {
+                //parse the record again with more capacity
+                capacity *= 2;
+                file->seek(recordBegin);
+                offset = recordBegin;
+                continue;
+            }
+
+            MO_DBG_ERR("txEvent log corrupt at %zu: %s", recordBegin, err.c_str());
+            return Status::Corrupt;
+        }
+    }
+
+    size_t getOffset() {
+        return offset;
+    }
+};
+
+} //namespace
+
+StoredSampledValueProperties::StoredSampledValueProperties(const char *measurand, const char *phase, const char *location, const char *unitOfMeasureUnit, int unitOfMeasureMultiplier) :
+        MemoryManaged("v201.Transactions.TransactionStore"),
+        measurand(makeString(getMemoryTag(), measurand ? measurand : "")),
+        phase(makeString(getMemoryTag(), phase ? phase : "")),
+        location(makeString(getMemoryTag(), location ? location : "")),
+        unitOfMeasureUnit(makeString(getMemoryTag(), unitOfMeasureUnit ? unitOfMeasureUnit : "")) {
+
+    //properties refer to the own string copies
+    if (measurand) {
+        properties.setMeasurand(this->measurand.c_str());
+    }
+    if (phase) {
+        properties.setPhase(this->phase.c_str());
+    }
+    if (location) {
+        properties.setLocation(this->location.c_str());
+    }
+    if (unitOfMeasureUnit) {
+        properties.setUnitOfMeasureUnit(this->unitOfMeasureUnit.c_str());
+    }
+    properties.setUnitOfMeasureMultiplier(unitOfMeasureMultiplier);
+}
+
 TransactionStoreEvse::TransactionStoreEvse(TransactionStore& txStore, unsigned int evseId, std::shared_ptr<FilesystemAdapter> filesystem) :
         MemoryManaged("v201.Transactions.TransactionStore"),
         txStore(txStore),
         evseId(evseId),
-        filesystem(filesystem) {
+        filesystem(filesystem),
+        storedProperties(makeVector<std::unique_ptr<StoredSampledValueProperties>>(getMemoryTag())),
+        writerSamples(makeVector<TxEventLogSample>(getMemoryTag())),
+        readerSamples(makeVector<TxEventLogSample>(getMemoryTag())) {
+
+}
+
+SampledValueProperties *TransactionStoreEvse::getStoredProperties(const char *measurand, const char *phase, const char *location, const char *unitOfMeasureUnit, int unitOfMeasureMultiplier) {
+
+    for (auto& stored : storedProperties) {
+        auto& properties = stored->properties;
+        if (equalsOptional(properties.getMeasurand(), measurand) &&
+                equalsOptional(properties.getPhase(), phase) &&
+                equalsOptional(properties.getLocation(), location) &&
+                equalsOptional(properties.getUnitOfMeasureUnit(), unitOfMeasureUnit) &&
+                properties.getUnitOfMeasureMultiplier() == unitOfMeasureMultiplier) {
+            return &properties;
+        }
+    }
+
+    auto stored = std::unique_ptr<StoredSampledValueProperties>(new StoredSampledValueProperties(measurand, phase, location, unitOfMeasureUnit, unitOfMeasureMultiplier));
+    if (!stored) {
+        MO_DBG_ERR("OOM");
+        return nullptr;
+    }
+
+    storedProperties.push_back(std::move(stored));
+    return &storedProperties.back()->properties;
+}
+
+bool TransactionStoreEvse::serializeMeterValue(MeterValue& meterValue, const Timestamp& eventTime, Vector<TxEventLogSample>& samples, JsonObject meterValueJson) {
+
+    int dt = meterValue.getTimestamp() - eventTime;
+    if (eventTime + dt == meterValue.getTimestamp()) {
+        if (dt != 0) {
+            meterValueJson["t"] = dt;
+        }
+    } else {
+        char timeStr [JSONDATE_LENGTH + 1] = {'\0'};
+        meterValue.getTimestamp().toJsonString(timeStr, JSONDATE_LENGTH + 1);
+        meterValueJson["timestamp"] = timeStr;
+    }
+
+    JsonArray sampledValueJson = meterValueJson.createNestedArray("sv");
+
+    auto next = makeVector<TxEventLogSample>(getMemoryTag());
+    next.reserve(meterValue.getSampledValueSize());
+
+    for (size_t i = 0; i < meterValue.getSampledValueSize(); i++) {
+        auto& sampledValue = meterValue.getSampledValue(i);
+        const auto& properties = sampledValue.getProperties();
+
+        TxEventLogSample sample;
+        sample.value = sampledValue.getValue();
+        sample.readingContext = sampledValue.getReadingContext();
+        sample.properties = getStoredProperties(
+                properties.getMeasurand(),
+                properties.getPhase(),
+                properties.getLocation(),
+                properties.getUnitOfMeasureUnit(),
+                properties.getUnitOfMeasureMultiplier());
+        if (!sample.properties) {
+            return false;
+        }
+
+        if (i < samples.size() &&
+                samples[i].properties == sample.properties &&
+                samples[i].readingContext == sample.readingContext &&
+                isIntegral(sample.value) &&
+                isIntegral(samples[i].value) &&
+                std::abs(sample.value - samples[i].value) <= (double)std::numeric_limits<int32_t>::max()) {
+            //same series as in the previous MeterValue. Store delta
+            sampledValueJson.add((int32_t)(sample.value - samples[i].value));
+        } else {
+            JsonObject sv = sampledValueJson.createNestedObject();
+            sv["v"] = sample.value;
+            if (sample.readingContext != ReadingContext_SamplePeriodic) {
+                sv["c"] = serializeReadingContext(sample.readingContext);
+            }
+            if (sample.properties->getMeasurand()) {
+                sv["m"] = sample.properties->getMeasurand();
+            }
+            if (sample.properties->getPhase()) {
+                sv["p"] = sample.properties->getPhase();
+            }
+            if (sample.properties->getLocation()) {
+                sv["l"] = sample.properties->getLocation();
+            }
+            if (sample.properties->getUnitOfMeasureUnit()) {
+                sv["u"] = sample.properties->getUnitOfMeasureUnit();
+            }
+            if (sample.properties->getUnitOfMeasureMultiplier()) {
+                sv["x"] = sample.properties->getUnitOfMeasureMultiplier();
+            }
+        }
+
+        next.push_back(sample);
+    }
+
+    samples = std::move(next);
+    return true;
+}
+
+bool TransactionStoreEvse::deserializeMeterValue(JsonObject meterValueJson, const Timestamp& eventTime, Vector<TxEventLogSample>& samples, std::unique_ptr<MeterValue> *out) {
+
+    Timestamp timestamp = eventTime;
+    if (meterValueJson.containsKey("timestamp")) {
+        if (!timestamp.setTime(meterValueJson["timestamp"] | "_Undefined")) {
+            return false;
+        }
+    } else {
+        timestamp += meterValueJson["t"] | 0;
+    }
+
+    JsonArray sampledValueJson = meterValueJson["sv"];
+
+    auto next = makeVector<TxEventLogSample>(getMemoryTag());
+    next.reserve(sampledValueJson.size());
+
+    for (JsonVariant sv : sampledValueJson) {
+        TxEventLogSample sample;
+        if (sv.is<JsonObject>()) {
+            if (!sv["v"].is<double>()) {
+                return false;
+            }
+            sample.value = sv["v"];
+            sample.readingContext = deserializeReadingContext(sv["c"] | "Sample.Periodic");
+            if (sample.readingContext == ReadingContext_UNDEFINED) {
+                return false;
+            }
+            sample.properties = getStoredProperties(
+                    sv["m"] | (const char*)nullptr,
+                    sv["p"] | (const char*)nullptr,
+                    sv["l"] | (const char*)nullptr,
+                    sv["u"] | (const char*)nullptr,
+                    sv["x"] | 0);
+            if (!sample.properties) {
+                return false;
+            }
+        } else if (sv.is<long>() && next.size() < samples.size()) {
+            //delta to the previous MeterValue
+            sample = samples[next.size()];
+            sample.value += sv.as<long>();
+        } else {
+            MO_DBG_ERR("format error");
+            return false;
+        }
+        next.push_back(sample);
+    }
+
+    if (out) {
+        if (next.empty()) {
+            MO_DBG_ERR("format error");
+            return false;
+        }
+
+        SampledValue **sampledValue = static_cast<SampledValue**>(MO_MALLOC(getMemoryTag(), next.size() * sizeof(SampledValue*)));
+        if (!sampledValue) {
+            MO_DBG_ERR("OOM");
+            return false;
+        }
+
+        size_t samplesWritten = 0;
+        for (size_t i = 0; i < next.size(); i++) {
+            auto sample = new SampledValue(next[i].value, next[i].readingContext, *next[i].properties);
+            if (!sample) {
+                break;
+            }
+            sampledValue[samplesWritten++] = sample;
+        }
+
+        std::unique_ptr<MeterValue> meterValue;
+        if (samplesWritten == next.size()) {
+            meterValue = std::unique_ptr<MeterValue>(new MeterValue(timestamp, sampledValue, samplesWritten));
+        }
 
+        if (!meterValue) {
+            //meterValue did not take ownership, so clean resources manually
+            for (size_t i = 0; i < samplesWritten; i++) {
+                delete sampledValue[i];
+            }
+            MO_FREE(sampledValue);
+            MO_DBG_ERR("OOM");
+            return false;
+        }
+
+        *out = std::move(meterValue);
+    }
+
+    samples = std::move(next);
+    return true;
+}
+
+bool TransactionStoreEvse::printTxFn(char *fn, size_t size, unsigned int txNr) {
+    auto ret = snprintf(fn, size, MO_FILENAME_PREFIX "tx201" "-%u-%u.json", evseId, txNr);
+    if (ret < 0 || (size_t)ret >= size) {
+        MO_DBG_ERR("fn error: %i", ret);
+        return false;
+    }
+    return true;
+}
+
+bool TransactionStoreEvse::printLogFn(char *fn, size_t size, unsigned int txNr, unsigned int log) {
+    auto ret = snprintf(fn, size, MO_FILENAME_PREFIX "tx201" "-%u-%u-l%u.jsn", evseId, txNr, log);
+    if (ret < 0 || (size_t)ret >= size) {
+        MO_DBG_ERR("fn error: %i", ret);
+        return false;
+    }
+    return true;
+}
+
+bool TransactionStoreEvse::commitTxState(Transaction& tx, bool force) {
+
+    auto txDoc = initJsonDoc("v201.Transactions.TransactionStoreEvse", 1024);
+
+    if (!serializeTransaction(tx, txDoc.createNestedObject("tx"))) {
+        MO_DBG_ERR("Serialization error");
+        return false;
+    }
+
+    if (tx.txEventLog) {
+        txDoc["log"] = tx.txEventLog;
+    }
+
+    HashWriter hashWriter;
+    serializeJson(txDoc, hashWriter);
+
+    if (!force && txStateValid && txStateTxNr == tx.txNr && txStateHash == hashWriter.hash) {
+        //tx state on flash is up to date
+        return true;
+    }
+
+    char fn [MO_MAX_PATH_SIZE];
+    if (!printTxFn(fn, sizeof(fn), tx.txNr)) {
+        return false;
+    }
+
+    if (!FilesystemUtils::storeJson(filesystem, fn, txDoc)) {
+        MO_DBG_ERR("FS error");
+        txStateValid = false;
+        return false;
+    }
+
+    txStateValid = true;
+    txStateTxNr = tx.txNr;
+    txStateHash = hashWriter.hash;
+    return true;
+}
+
+size_t TransactionStoreEvse::getLogSize(Transaction& tx) {
+    char fn [MO_MAX_PATH_SIZE];
+    size_t size = 0;
+    if (!printLogFn(fn, sizeof(fn), tx.txNr, tx.txEventLog) || filesystem->stat(fn, &size) != 0) {
+        return 0;
+    }
+    return size;
+}
+
+bool TransactionStoreEvse::flushTx(Transaction& tx) {
+
+    char fnTx [MO_MAX_PATH_SIZE];
+    char fnLog [MO_MAX_PATH_SIZE];
+    if (!printTxFn(fnTx, sizeof(fnTx), tx.txNr) ||
+            !printLogFn(fnLog, sizeof(fnLog), tx.txNr, tx.txEventLog)) {
+        return false;
+    }
+
+    //only the files of this tx. Buffered writes of other files don't delay the commit or fail it
+    bool success = filesystem->flush(fnLog);
+    success &= filesystem->flush(fnTx);
+    return success;
+}
+
+bool TransactionStoreEvse::appendLog(Transaction& tx, JsonDoc& record) {
+
+    char fn [MO_MAX_PATH_SIZE];
+    if (!printLogFn(fn, sizeof(fn), tx.txNr, tx.txEventLog)) {
+        return false;
+    }
+
+    if (record.isNull() || record.overflowed()) {
+        MO_DBG_ERR("Serialization error");
+        return false;
+    }
+
+    auto file = filesystem->open(fn, "a");
+    if (!file) {
+        MO_DBG_ERR("could not open %s", fn);
+        return false;
+    }
+
+    ArduinoJsonFileAdapter fileWriter {file.get()};
+    size_t written = serializeJson(record, fileWriter);
+    written += file->write("\n", 1);
+    bool closed = file->close();
+    file.reset();
+
+    MO_METRICS_COUNT(MO_METRICS_FS_BYTES_WRITTEN, written);
+
+    if (written != measureJson(record) + 1 || !closed) {
+        MO_DBG_ERR("FS error: %s", fn);
+        //the log may end with a partial record now, so that further records would be lost. Rewrite
+        compactLog(tx, false);
+        return false;
+    }
+
+    return true;
+}
+
+bool TransactionStoreEvse::appendTxEvent(Transaction& tx, TransactionEventData& txEvent) {
+
+    size_t capacity = JSON_OBJECT_SIZE(18) + 2 * (JSONDATE_LENGTH + 1) + 2 * JSON_OBJECT_SIZE(2);
+    if (!txEvent.meterValue.empty()) {
+        capacity += JSON_ARRAY_SIZE(txEvent.meterValue.size());
+    }
+    for (size_t i = 0; i < txEvent.meterValue.size(); i++) {
+        size_t sampledValueSize = txEvent.meterValue[i]->getSampledValueSize();
+        capacity += JSON_OBJECT_SIZE(2) + JSONDATE_LENGTH + 1 +
+                    JSON_ARRAY_SIZE(sampledValueSize) +
+                    sampledValueSize * JSON_OBJECT_SIZE(7);
+    }
+
+    Timestamp eventTime = getLogReferenceTime(txEvent.timestamp);
+
+    for (unsigned int pass = 0; pass < 2; pass++) {
+
+        //delta-encode against the last MeterValue in the log
+        auto samples = makeVector<TxEventLogSample>(getMemoryTag());
+        if (writerValid && writerTxNr == tx.txNr && writerLog == tx.txEventLog) {
+            samples = writerSamples;
+        }
+
+        auto record = initJsonDoc(getMemoryTag(), capacity);
+        record["seq"] = txEvent.seqNo;
+
+        if (!serializeTransactionEvent(txEvent, record.as<JsonObject>())) {
+            MO_DBG_ERR("Serialization error");
+            return false;
+        }
+
+        if (!txEvent.meterValue.empty()) {
+            JsonArray meterValueJson = record.createNestedArray("mv");
+            for (size_t i = 0; i < txEvent.meterValue.size(); i++) {
+                if (!serializeMeterValue(*txEvent.meterValue[i], eventTime, samples, meterValueJson.createNestedObject())) {
+                    MO_DBG_ERR("Serialization error");
+                    return false;
+                }
+            }
+        }
+
+        if (pass == 0 && getLogSize(tx) + measureJson(record) + 1 > MO_TXEVENTLOG_SIZE_V201) {
+            //flash budget exceeded. Drop removed txEvents. If that's not enough, thin out intermediate offline txEvents
+            MO_DBG_DEBUG("txEvent log %u-%u full, compact", evseId, tx.txNr);
+            if (!compactLog(tx, false)) {
+                return false;
+            }
+            for (unsigned int i = 0; i < 4 && getLogSize(tx) + measureJson(record) + 1 > MO_TXEVENTLOG_SIZE_V201 * 3 / 4; i++) {
+                size_t seqNosSize = tx.seqNos.size();
+                if (!compactLog(tx, true)) {
+                    return false;
+                }
+                if (tx.seqNos.size() == seqNosSize) {
+                    MO_DBG_WARN("txEvent log %u-%u exceeds flash budget", evseId, tx.txNr);
+                    break;
+                }
+            }
+            continue; //the compaction restarts the delta-encoding. Encode again
+        }
+
+        if (!appendLog(tx, record)) {
+            return false;
+        }
+
+        writerValid = true;
+        writerTxNr = tx.txNr;
+        writerLog = tx.txEventLog;
+        writerSamples = std::move(samples);
+        return true;
+    }
+
+    MO_DBG_ERR("internal error");
+    return false;
+}
+
+bool TransactionStoreEvse::resetLog(Transaction& tx) {
+
+    //all txEvents have been removed. Start over with a log which only keeps seqNoEnd
+    char fn [MO_MAX_PATH_SIZE];
+    if (!printLogFn(fn, sizeof(fn), tx.txNr, tx.txEventLog)) {
+        return false;
+    }
+
+    auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(1));
+    record["end"] = tx.seqNoEnd;
+
+    invalidateLogPositions(tx.txNr);
+
+    return FilesystemUtils::storeJson(filesystem, fn, record);
+}
+
+bool TransactionStoreEvse::compactLog(Transaction& tx, bool thinOut) {
+
+    char fnSrc [MO_MAX_PATH_SIZE];
+    char fnDst [MO_MAX_PATH_SIZE];
+    if (!printLogFn(fnSrc, sizeof(fnSrc), tx.txNr, tx.txEventLog) ||
+            !printLogFn(fnDst, sizeof(fnDst), tx.txNr, tx.txEventLog ^ 1)) {
+        return false;
+    }
+
+    invalidateLogPositions(tx.txNr);
+
+    auto thinnedOut = makeVector<unsigned int>(getMemoryTag());
+    bool success = true;
+
+    {
+        TxEventLogReader reader;
+        if (!reader.open(*filesystem, fnSrc, 0)) {
+            //no log yet
+            return true;
+        }
+
+        //the new log becomes active after the tx state refers to it. Remove leftovers from interrupted compactions
+        size_t msize;
+        if (filesystem->stat(fnDst, &msize) == 0) {
+            filesystem->remove(fnDst);
+        }
+
+        auto file = filesystem->open(fnDst, "a");
+        if (!file) {
+            MO_DBG_ERR("could not open %s", fnDst);
+            return false;
+        }
+
+        ArduinoJsonFileAdapter fileWriter {file.get()};
+
+        auto writeRecord = [&file, &fileWriter, &success] (JsonDoc& out) {
+            if (out.overflowed()) {
+                success = false;
+                return;
+            }
+            size_t written = serializeJson(out, fileWriter);
+            written += file->write("\n", 1);
+            if (written != measureJson(out) + 1) {
+                success = false;
+            }
+        };
+
+        auto header = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(1));
+        header["end"] = tx.seqNoEnd;
+        writeRecord(header);
+
+        auto decoded = makeVector<TxEventLogSample>(getMemoryTag());
+        auto encoded = makeVector<TxEventLogSample>(getMemoryTag());
+
+        auto attempt = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(3) + JSONDATE_LENGTH + 1);
+        bool attemptValid = false;
+
+        size_t liveIndex = 0;
+
+        auto record = initJsonDoc(getMemoryTag());
+        TxEventLogReader::Status status;
+        while (success && (status = reader.next(record)) == TxEventLogReader::Status::Record) {
+
+            if (record.containsKey("seq")) {
+                unsigned int seqNo = record["seq"] | 0;
+                bool live = std::binary_search(tx.seqNos.begin(), tx.seqNos.end(), seqNo);
+
+                //decode MeterValues of all txEvents to keep the delta-encoding in sync
+                Timestamp eventTime;
+                if (record.containsKey("timestamp") && !eventTime.setTime(record["timestamp"] | "_Undefined")) {
+                    MO_DBG_ERR("format error");
+                    break;
+                }
+
+                auto meterValues = makeVector<std::unique_ptr<MeterValue>>(getMemoryTag());
+                for (JsonObject meterValueJson : record["mv"].as<JsonArray>()) {
+                    std::unique_ptr<MeterValue> meterValue;
+                    if (!deserializeMeterValue(meterValueJson, eventTime, decoded, live ? &meterValue : nullptr)) {
+                        MO_DBG_ERR("format error");
+                        success = false;
+                        break;
+                    }
+                    if (meterValue) {
+                        meterValues.push_back(std::move(meterValue));
+                    }
+                }
+
+                if (!success || !live) {
+                    continue;
+                }
+
+                if (thinOut &&
+                        seqNo != tx.seqNos.front() &&
+                        seqNo != tx.seqNos.back() &&
+                        liveIndex++ % 2 == 1 &&
+                        !strcmp(record["eventType"] | "Updated", "Updated")) {
+                    //halve the number of intermediate txEvents. Always keep the first, final, Started and Ended txEvent
+                    thinnedOut.push_back(seqNo);
+                    continue;
+                }
+
+                if (meterValues.empty()) {
+                    writeRecord(record);
+                    continue;
+                }
+
+                //re-encode MeterValues against the previous MeterValue in the new log
+                size_t capacity = record.memoryUsage() + JSON_ARRAY_SIZE(meterValues.size());
+                for (size_t i = 0; i < meterValues.size(); i++) {
+                    size_t sampledValueSize = meterValues[i]->getSampledValueSize();
+                    capacity += JSON_OBJECT_SIZE(2) + JSONDATE_LENGTH + 1 +
+                                JSON_ARRAY_SIZE(sampledValueSize) +
+                                sampledValueSize * JSON_OBJECT_SIZE(7);
+                }
+
+                auto out = initJsonDoc(getMemoryTag(), capacity);
+                out.set(record);
+                out.remove("mv");
+                JsonArray meterValueJson = out.createNestedArray("mv");
+                for (size_t i = 0; i < meterValues.size(); i++) {
+                    if (!serializeMeterValue(*meterValues[i], eventTime, encoded, meterValueJson.createNestedObject())) {
+                        success = false;
+                        break;
+                    }
+                }
+
+                if (success) {
+                    writeRecord(out);
+                }
+            } else if (record.containsKey("upd")) {
+                //keep the latest send attempt
+                attempt.set(record);
+                attemptValid = true;
+            }
+            //removed txEvents and the previous seqNoEnd are implied by the new log
+        }
+
+        if (success && status == TxEventLogReader::Status::Corrupt) {
+            MO_DBG_WARN("drop corrupt tail of txEvent log %u-%u", evseId, tx.txNr);
+        }
+
+        if (success && attemptValid && std::binary_search(tx.seqNos.begin(), tx.seqNos.end(), attempt["upd"] | 0U)) {
+            writeRecord(attempt);
+        }
+
+        success &= file->close();
+        file.reset();
+    }
+
+    if (!success || !filesystem->flush(fnDst)) {
+        MO_DBG_ERR("FS error: %s", fnDst);
+        filesystem->remove(fnDst);
+        return false;
+    }
+
+    //switch to the new log
+    tx.txEventLog ^= 1;
+    if (!commitTxState(tx, true) || !flushTx(tx)) {
+        MO_DBG_ERR("FS error");
+        tx.txEventLog ^= 1;
+        return false;
+    }
+
+    filesystem->remove(fnSrc);
+
+    for (auto seqNo : thinnedOut) {
+        MO_DBG_DEBUG("thinned out intermediate txEvent %u-%u-%u", evseId, tx.txNr, seqNo);
+        tx.seqNos.erase(std::remove(tx.seqNos.begin(), tx.seqNos.end(), seqNo), tx.seqNos.end());
+    }
+
+    MO_DBG_DEBUG("compacted txEvent log %u-%u, seqNos.size()=%zu", evseId, tx.txNr, tx.seqNos.size());
+    return true;
+}
+
+void TransactionStoreEvse::invalidateLogPositions(unsigned int txNr) {
+    if (writerTxNr == txNr) {
+        writerValid = false;
+    }
+    if (readerTxNr == txNr) {
+        readerValid = false;
+    }
 }
 
 bool TransactionStoreEvse::discoverStoredTx(unsigned int& txNrBeginOut, unsigned int& txNrEndOut) {
 
+
     if (!filesystem) {
         MO_DBG_DEBUG("no FS adapter");
         return true;
@@ -710,46 +1444,14 @@ std::unique_ptr<Transaction> TransactionStoreEvse::loadTransaction(unsigned int
         return nullptr;
     }
 
-    char fnPrefix [MO_MAX_PATH_SIZE];
-    auto ret= snprintf(fnPrefix, sizeof(fnPrefix), "tx201-%u-%u-", evseId, txNr);
-    if (ret < 0 || (size_t)ret >= sizeof(fnPrefix)) {
-        MO_DBG_ERR("fn error");
-        return nullptr;
-    }
-    size_t fnPrefixLen = strlen(fnPrefix);
-
-    Vector<unsigned int> seqNos = makeVector<unsigned int>(getMemoryTag());
-
-    filesystem->ftw_root([fnPrefix, fnPrefixLen, &seqNos] (const char *fn) {
-        if (!strncmp(fn, fnPrefix, fnPrefixLen)) {
-            unsigned int parsedSeqNo = 0;
-            for (size_t i = fnPrefixLen; fn[i] >= '0' && fn[i] <= '9'; i++) {
-                parsedSeqNo *= 10;
-                parsedSeqNo += fn[i] - '0';
-            }
-
-            seqNos.push_back(parsedSeqNo);
-        }
-        return 0;
-    });
-
-    if (seqNos.empty()) {
-        MO_DBG_DEBUG("no tx at tx201-%u-%u", evseId, txNr);
-        return nullptr;
-    }
-
-    std::sort(seqNos.begin(), seqNos.end());
-
-    char fn [MO_MAX_PATH_SIZE] = {'\0'};
-    ret = snprintf(fn, MO_MAX_PATH_SIZE, MO_FILENAME_PREFIX "tx201" "-%u-%u-%u.json", evseId, txNr, seqNos.back());
-    if (ret < 0 || ret >= MO_MAX_PATH_SIZE) {
-        MO_DBG_ERR("fn error: %i", ret);
+    char fn [MO_MAX_PATH_SIZE];
+    if (!printTxFn(fn, sizeof(fn), txNr)) {
         return nullptr;
     }
 
     size_t msize;
     if (filesystem->stat(fn, &msize) != 0) {
-        MO_DBG_ERR("tx201-%u-%u memory corruption", evseId, txNr);
+        MO_DBG_DEBUG("no tx at tx201-%u-%u", evseId, txNr);
         return nullptr;
     }
 
@@ -768,7 +1470,6 @@ std::unique_ptr<Transaction> TransactionStoreEvse::loadTransaction(unsigned int
 
     transaction->evseId = evseId;
     transaction->txNr = txNr;
-    transaction->seqNos = std::move(seqNos);
 
     JsonObject txJson = (*doc)["tx"];
 
@@ -777,14 +1478,64 @@ std::unique_ptr<Transaction> TransactionStoreEvse::loadTransaction(unsigned int
         return nullptr;
     }
 
-    //determine seqNoEnd and trim seqNos record
-    if (doc->containsKey("txEvent")) {
-        //last tx201 file contains txEvent -> txNoEnd is one place after tx201 file and seqNos is accurate
-        transaction->seqNoEnd = transaction->seqNos.back() + 1;
-    } else {
-        //last tx201 file contains only tx status information, but no txEvent -> remove from seqNos record and set seqNoEnd to this
-        transaction->seqNoEnd = transaction->seqNos.back();
-        transaction->seqNos.pop_back();
+    int txEventLog = (*doc)["log"] | 0;
+    if (txEventLog != 0 && txEventLog != 1) {
+        MO_DBG_ERR("deserialization error");
+        return nullptr;
+    }
+    transaction->txEventLog = (unsigned int)txEventLog;
+
+    doc.reset();
+
+    //replay txEvent log to restore seqNos and seqNoEnd
+    char fnLog [MO_MAX_PATH_SIZE];
+    if (!printLogFn(fnLog, sizeof(fnLog), txNr, transaction->txEventLog)) {
+        return nullptr;
+    }
+
+    auto removed = makeVector<unsigned int>(getMemoryTag());
+    bool corrupt = false;
+
+    TxEventLogReader reader;
+    if (reader.open(*filesystem, fnLog, 0)) {
+        auto record = initJsonDoc(getMemoryTag());
+        TxEventLogReader::Status status;
+        while ((status = reader.next(record)) == TxEventLogReader::Status::Record) {
+            if (record.containsKey("seq")) {
+                unsigned int seqNo = record["seq"] | 0;
+                transaction->seqNos.push_back(seqNo);
+                if (seqNo + 1 > transaction->seqNoEnd) {
+                    transaction->seqNoEnd = seqNo + 1;
+                }
+
+                //the txEvent can be on flash before the tx state has been updated
+                const char *eventType = record["eventType"] | "Updated";
+                if (!strcmp(eventType, "Started")) {
+                    transaction->started = true;
+                } else if (!strcmp(eventType, "Ended")) {
+                    transaction->stopped = true;
+                }
+            } else if (record.containsKey("del")) {
+                removed.push_back(record["del"] | 0U);
+            } else if (record.containsKey("end")) {
+                unsigned int seqNoEnd = record["end"] | 0U;
+                if (seqNoEnd > transaction->seqNoEnd) {
+                    transaction->seqNoEnd = seqNoEnd;
+                }
+            }
+        }
+        corrupt = (status == TxEventLogReader::Status::Corrupt);
+    }
+
+    std::sort(transaction->seqNos.begin(), transaction->seqNos.end());
+    for (auto seqNo : removed) {
+        auto& seqNos = transaction->seqNos;
+        seqNos.erase(std::remove(seqNos.begin(), seqNos.end(), seqNo), seqNos.end());
+    }
+
+    if (corrupt) {
+        //partial record from a power loss. Rewrite log without it
+        compactLog(*transaction, false);
     }
 
     MO_DBG_DEBUG("loaded tx %u-%u, seqNos.size()=%zu", evseId, txNr, transaction->seqNos.size());
@@ -842,136 +1593,186 @@ std::unique_ptr<TransactionEventData> TransactionStoreEvse::loadTransactionEvent
         return nullptr;
     }
 
-    bool found = false;
-    for (size_t i = 0; i < tx.seqNos.size(); i++) {
-        if (tx.seqNos[i] == seqNo) {
-            found = true;
-        }
-    }
-    if (!found) {
+    if (!std::binary_search(tx.seqNos.begin(), tx.seqNos.end(), seqNo)) {
         MO_DBG_DEBUG("%u-%u-%u does not exist", evseId, tx.txNr, seqNo);
         return nullptr;
     }
 
-    char fn [MO_MAX_PATH_SIZE] = {'\0'};
-    auto ret = snprintf(fn, MO_MAX_PATH_SIZE, MO_FILENAME_PREFIX "tx201" "-%u-%u-%u.json", evseId, tx.txNr, seqNo);
-    if (ret < 0 || ret >= MO_MAX_PATH_SIZE) {
-        MO_DBG_ERR("fn error: %i", ret);
+    char fn [MO_MAX_PATH_SIZE];
+    if (!printLogFn(fn, sizeof(fn), tx.txNr, tx.txEventLog)) {
         return nullptr;
     }
 
-    size_t msize;
-    if (filesystem->stat(fn, &msize) != 0) {
-        MO_DBG_ERR("seqNos out of sync: could not find %u-%u-%u", evseId, tx.txNr, seqNo);
-        return nullptr;
-    }
+    auto record = initJsonDoc(getMemoryTag());
 
-    auto doc = FilesystemUtils::loadJson(filesystem, fn, getMemoryTag());
+    if (!readerValid || readerTxNr != tx.txNr || readerLog != tx.txEventLog || seqNo < readerSeqNoNext) {
+        //rewind. Send attempts are appended after the txEvents, so look them up first
+        readerValid = false;
+        readerOffset = 0;
+        readerSeqNoNext = 0;
+        readerSamples.clear();
+        readerAttemptValid = false;
 
-    if (!doc) {
-        MO_DBG_ERR("memory corruption");
-        return nullptr;
-    }
+        TxEventLogReader scan;
+        if (!scan.open(*filesystem, fn, 0)) {
+            MO_DBG_ERR("seqNos out of sync: could not find %s", fn);
+            return nullptr;
+        }
 
-    if (!doc->containsKey("txEvent")) {
-        MO_DBG_DEBUG("%u-%u-%u does not contain txEvent", evseId, tx.txNr, seqNo);
-        return nullptr;
-    }
+        while (scan.next(record) == TxEventLogReader::Status::Record) {
+            if (record.containsKey("upd")) {
+                readerAttemptValid = true;
+                readerAttemptSeqNo = record["upd"] | 0U;
+                readerAttemptNr = record["attemptNr"] | 0U;
+                readerAttemptTime = MIN_TIME;
+                if (record.containsKey("attemptTime")) {
+                    readerAttemptTime.setTime(record["attemptTime"] | "_Undefined");
+                }
+            }
+        }
 
-    auto txEvent = std::unique_ptr<TransactionEventData>(new TransactionEventData(&tx, seqNo));
-    if (!txEvent) {
-        MO_DBG_ERR("OOM");
-        return nullptr;
+        readerValid = true;
+        readerTxNr = tx.txNr;
+        readerLog = tx.txEventLog;
     }
 
-    if (!deserializeTransactionEvent(*txEvent, (*doc)["txEvent"])) {
-        MO_DBG_ERR("deserialization error");
+    TxEventLogReader reader;
+    if (!reader.open(*filesystem, fn, readerOffset)) {
+        MO_DBG_ERR("seqNos out of sync: could not find %s", fn);
+        readerValid = false;
         return nullptr;
     }
 
-    return txEvent;
-}
+    while (reader.next(record) == TxEventLogReader::Status::Record) {
 
-bool TransactionStoreEvse::commit(Transaction& tx, TransactionEventData *txEvent) {
-
-    if (!filesystem) {
-        MO_DBG_DEBUG("no FS: nothing to commit");
-        return true;
-    }
+        if (record.containsKey("upd")) {
+            readerAttemptValid = true;
+            readerAttemptSeqNo = record["upd"] | 0U;
+            readerAttemptNr = record["attemptNr"] | 0U;
+            readerAttemptTime = MIN_TIME;
+            if (record.containsKey("attemptTime")) {
+                readerAttemptTime.setTime(record["attemptTime"] | "_Undefined");
+            }
+        }
 
-    unsigned int seqNo = 0;
+        if (!record.containsKey("seq")) {
+            readerOffset = reader.getOffset();
+            continue;
+        }
 
-    if (txEvent) {
-        seqNo = txEvent->seqNo;
-    } else {
-        //update tx state in new or reused tx201 file
-        seqNo = tx.seqNoEnd;
-    }
+        unsigned int recordSeqNo = record["seq"] | 0U;
 
-    size_t seqNosNewSize = tx.seqNos.size() + 1;
-    for (size_t i = 0; i < tx.seqNos.size(); i++) {
-        if (tx.seqNos[i] == seqNo) {
-            seqNosNewSize -= 1;
+        Timestamp eventTime;
+        if (record.containsKey("timestamp") && !eventTime.setTime(record["timestamp"] | "_Undefined")) {
+            MO_DBG_ERR("deserialization error");
             break;
         }
-    }
 
-    // Check if to delete intermediate offline txEvent
-    if (seqNosNewSize > MO_TXEVENTRECORD_SIZE_V201) {
-        auto deltaMin = std::numeric_limits<unsigned int>::max();
-        size_t indexMin = tx.seqNos.size();
-        for (size_t i = 2; i + 1 <= tx.seqNos.size(); i++) { //always keep first and final txEvent
-            size_t t0 = tx.seqNos.size() - i - 1;
-            size_t t1 = tx.seqNos.size() - i;
-            size_t t2 = tx.seqNos.size() - i + 1;
+        if (recordSeqNo != seqNo) {
+            //skip txEvent, but keep track of its MeterValues for the delta-encoding
+            bool success = true;
+            for (JsonObject meterValueJson : record["mv"].as<JsonArray>()) {
+                success &= deserializeMeterValue(meterValueJson, eventTime, readerSamples, nullptr);
+            }
+            if (!success) {
+                MO_DBG_ERR("deserialization error");
+                break;
+            }
+            readerOffset = reader.getOffset();
+            readerSeqNoNext = recordSeqNo + 1;
+            continue;
+        }
+
+        auto txEvent = std::unique_ptr<TransactionEventData>(new TransactionEventData(&tx, seqNo));
+        if (!txEvent) {
+            MO_DBG_ERR("OOM");
+            break;
+        }
 
-            auto delta = tx.seqNos[t2] - tx.seqNos[t0];
+        if (!deserializeTransactionEvent(*txEvent, record.as<JsonObject>())) {
+            MO_DBG_ERR("deserialization error");
+            break;
+        }
 
-            if (delta < deltaMin) {
-                deltaMin = delta;
-                indexMin = t1;
+        bool success = true;
+        for (JsonObject meterValueJson : record["mv"].as<JsonArray>()) {
+            std::unique_ptr<MeterValue> meterValue;
+            success &= deserializeMeterValue(meterValueJson, eventTime, readerSamples, &meterValue);
+            if (!success) {
+                break;
             }
+            txEvent->meterValue.push_back(std::move(meterValue));
+        }
+        if (!success) {
+            MO_DBG_ERR("deserialization error");
+            break;
         }
 
-        if (indexMin < tx.seqNos.size()) {
-            MO_DBG_DEBUG("delete intermediate txEvent %u-%u-%u - delta=%u", evseId, tx.txNr, tx.seqNos[indexMin], deltaMin);
-            remove(tx, tx.seqNos[indexMin]); //remove can call commit() again. Ensure that remove is not executed for last element
-        } else {
-            MO_DBG_ERR("internal error");
-            return false;
+        if (readerAttemptValid && readerAttemptSeqNo == seqNo) {
+            txEvent->attemptNr = readerAttemptNr;
+            txEvent->attemptTime = readerAttemptTime;
         }
+
+        readerOffset = reader.getOffset();
+        readerSeqNoNext = seqNo + 1;
+
+        return txEvent;
     }
 
-    char fn [MO_MAX_PATH_SIZE] = {'\0'};
-    auto ret = snprintf(fn, MO_MAX_PATH_SIZE, MO_FILENAME_PREFIX "tx201" "-%u-%u-%u.json", evseId, tx.txNr, seqNo);
-    if (ret < 0 || ret >= MO_MAX_PATH_SIZE) {
-        MO_DBG_ERR("fn error: %i", ret);
-        return false;
+    MO_DBG_ERR("seqNos out of sync: could not load %u-%u-%u", evseId, tx.txNr, seqNo);
+    readerValid = false;
+    return nullptr;
+}
+
+bool TransactionStoreEvse::commit(Transaction& tx, TransactionEventData *txEvent) {
+
+    if (!filesystem) {
+        MO_DBG_DEBUG("no FS: nothing to commit");
+        return true;
     }
 
-    auto txDoc = initJsonDoc("v201.Transactions.TransactionStoreEvse", 2048);
+    bool appended = false;
 
-    if (!serializeTransaction(tx, txDoc.createNestedObject("tx"))) {
-        MO_DBG_ERR("Serialization error");
-        return false;
+    if (txEvent && txEvent->seqNo == tx.seqNoEnd) {
+        //new txEvent
+        if (!appendTxEvent(tx, *txEvent)) {
+            MO_DBG_ERR("FS error");
+            return false;
+        }
+        appended = true;
+    } else if (txEvent && std::binary_search(tx.seqNos.begin(), tx.seqNos.end(), txEvent->seqNo)) {
+        //stored txEvent. Only the send attempt can have changed
+        auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(3) + JSONDATE_LENGTH + 1);
+        record["upd"] = txEvent->seqNo;
+        record["attemptNr"] = txEvent->attemptNr;
+        if (txEvent->attemptTime > MIN_TIME) {
+            char timeStr [JSONDATE_LENGTH + 1] = {'\0'};
+            txEvent->attemptTime.toJsonString(timeStr, JSONDATE_LENGTH + 1);
+            record["attemptTime"] = timeStr;
+        }
+
+        if (!appendLog(tx, record)) {
+            MO_DBG_ERR("FS error");
+            return false;
+        }
     }
 
-    if (txEvent && !serializeTransactionEvent(*txEvent, txDoc.createNestedObject("txEvent"))) {
-        MO_DBG_ERR("Serialization error");
+    if (!commitTxState(tx, false)) {
+        MO_DBG_ERR("FS error");
         return false;
     }
 
-    if (!FilesystemUtils::storeJson(filesystem, fn, txDoc)) {
+    if (!flushTx(tx)) { //transaction data must be persisted before continuing
         MO_DBG_ERR("FS error");
         return false;
     }
 
-    if (txEvent && seqNo == tx.seqNoEnd) {
-        tx.seqNos.push_back(seqNo);
+    if (appended) {
+        tx.seqNos.push_back(txEvent->seqNo);
         tx.seqNoEnd++;
     }
 
-    MO_DBG_DEBUG("comitted tx %u-%u-%u", evseId, tx.txNr, seqNo);
+    MO_DBG_DEBUG("comitted tx %u-%u-%u", evseId, tx.txNr, txEvent ? txEvent->seqNo : tx.seqNoEnd);
 
     //success
     return true;
@@ -993,15 +1794,21 @@ bool TransactionStoreEvse::remove(unsigned int txNr) {
     }
 
     char fnPrefix [MO_MAX_PATH_SIZE];
-    auto ret= snprintf(fnPrefix, sizeof(fnPrefix), "tx201-%u-%u-", evseId, txNr);
+    auto ret= snprintf(fnPrefix, sizeof(fnPrefix), "tx201-%u-%u", evseId, txNr);
     if (ret < 0 || (size_t)ret >= sizeof(fnPrefix)) {
         MO_DBG_ERR("fn error");
         return false;
     }
     size_t fnPrefixLen = strlen(fnPrefix);
 
+    invalidateLogPositions(txNr);
+    if (txStateTxNr == txNr) {
+        txStateValid = false;
+    }
+
+    //tx state file, txEvent logs and per-txEvent files of previous versions
     auto success = FilesystemUtils::remove_if(filesystem, [fnPrefix, fnPrefixLen] (const char *fn) {
-        return !strncmp(fn, fnPrefix, fnPrefixLen);
+        return !strncmp(fn, fnPrefix, fnPrefixLen) && (fn[fnPrefixLen] == '.' || fn[fnPrefixLen] == '-');
     });
 
     return success;
@@ -1009,75 +1816,34 @@ bool TransactionStoreEvse::remove(unsigned int txNr) {
 
 bool TransactionStoreEvse::remove(Transaction& tx, unsigned int seqNo) {
 
-    if (tx.seqNos.empty()) {
-        //nothing to do
+    if (!std::binary_search(tx.seqNos.begin(), tx.seqNos.end(), seqNo)) {
+        MO_DBG_DEBUG("%u-%u-%u does not exist", evseId, tx.txNr, seqNo);
         return true;
     }
 
-    if (tx.seqNos.back() == seqNo) {
-        //special case: deletion of last tx201 file could also delete information about tx. Make sure all tx-related
-        //information is commited into tx201 file at seqNoEnd, then delete file at seqNo
-
-        char fn [MO_MAX_PATH_SIZE];
-        auto ret = snprintf(fn, sizeof(fn), "%stx201-%u-%u-%u.json", MO_FILENAME_PREFIX, evseId, tx.txNr, tx.seqNoEnd);
-        if (ret < 0 || (size_t)ret >= sizeof(fn)) {
-            MO_DBG_ERR("fn error");
-            return false;
-        }
-
-        auto doc = FilesystemUtils::loadJson(filesystem, fn, getMemoryTag());
-        
-        if (!doc || !doc->containsKey("tx")) {
-            //no valid tx201 file at seqNoEnd. Commit tx into file seqNoEnd, then remove file at seqNo
-
-            if (!commit(tx, nullptr)) {
-                MO_DBG_ERR("fs error");
-                return false;
-            }
-        }
+    tx.seqNos.erase(std::remove(tx.seqNos.begin(), tx.seqNos.end(), seqNo), tx.seqNos.end());
 
-        //seqNoEnd contains all tx data which should be persisted. Continue
-    }
-
-    bool found = false;
-    for (size_t i = 0; i < tx.seqNos.size(); i++) {
-        if (tx.seqNos[i] == seqNo) {
-            found = true;
-        }
-    }
-    if (!found) {
-        MO_DBG_DEBUG("%u-%u-%u does not exist", evseId, tx.txNr, seqNo);
+    if (!filesystem) {
         return true;
     }
 
     bool success = true;
 
-    if (filesystem) {
-        char fn [MO_MAX_PATH_SIZE];
-        auto ret = snprintf(fn, sizeof(fn), "%stx201-%u-%u-%u.json", MO_FILENAME_PREFIX, evseId, tx.txNr, seqNo);
-        if (ret < 0 || (size_t)ret >= sizeof(fn)) {
-            MO_DBG_ERR("fn error");
-            return false;
-        }
-
-        size_t msize;
-        if (filesystem->stat(fn, &msize) == 0) {
-            success &= filesystem->remove(fn);
-        } else {
-            MO_DBG_ERR("internal error: seqNos out of sync");
-            (void)0;
-        }
+    if (tx.seqNos.empty()) {
+        //no txEvents left. Drop the log
+        success &= resetLog(tx);
+    } else if (getLogSize(tx) + 32 > MO_TXEVENTLOG_SIZE_V201) {
+        success &= compactLog(tx, false);
+    } else {
+        auto record = initJsonDoc(getMemoryTag(), JSON_OBJECT_SIZE(1));
+        record["del"] = seqNo;
+        success &= appendLog(tx, record);
     }
 
-    if (success) {
-        auto it = tx.seqNos.begin();
-        while (it != tx.seqNos.end()) {
-            if (*it == seqNo) {
-                it = tx.seqNos.erase(it);
-            } else {
-                it++;
-            }
-        }
+    success &= flushTx(tx);
+
+    if (!success) {
+        MO_DBG_ERR("FS error");
     }
 
     return success;
@@ -57,8 +57,8 @@ public:
 
 #if MO_ENABLE_V201
 
-#ifndef MO_TXEVENTRECORD_SIZE_V201
-#define MO_TXEVENTRECORD_SIZE_V201 10 //maximum number of of txEvents per tx to hold on flash storage
+#ifndef MO_TXEVENTLOG_SIZE_V201
+#define MO_TXEVENTLOG_SIZE_V201 (64 * 1024) //flash budget of the txEvent log of a tx in bytes. If exceeded, the log is compacted and intermediate offline txEvents are thinned out
 #endif
 
 namespace MicroOcpp {
@@ -66,6 +66,40 @@ namespace Ocpp201 {
 
 class TransactionStore;
 
+/*
+ * SampledValueProperties with their own string storage. MeterValues which are restored from flash refer to
+ * these. Each distinct set of properties is stored once per EVSE
+ */
+struct StoredSampledValueProperties : public MemoryManaged {
+    String measurand;
+    String phase;
+    String location;
+    String unitOfMeasureUnit;
+    SampledValueProperties properties;
+
+    StoredSampledValueProperties(const char *measurand, const char *phase, const char *location, const char *unitOfMeasureUnit, int unitOfMeasureMultiplier);
+};
+
+//reference for delta-encoding the SampledValues of the next MeterValue in the txEvent log
+struct TxEventLogSample {
+    double value;
+    ReadingContext readingContext;
+    SampledValueProperties *properties;
+};
+
+/*
+ * The tx state is stored in tx201-<evseId>-<txNr>.json. The txEvents of a tx are appended to the txEvent log
+ * tx201-<evseId>-<txNr>-l<0|1>.jsn, one JSON record per line:
+ *
+ *     {"seq":<seqNo>, ...txEvent..., "mv":[{"t":<secs after txEvent timestamp>,"sv":[...]}]}
+ *     {"upd":<seqNo>,"attemptNr":<n>,"attemptTime":<timestamp>} //txEvent has been sent
+ *     {"del":<seqNo>} //txEvent has been removed
+ *     {"end":<seqNoEnd>} //first record after compaction
+ *
+ * SampledValues are delta-encoded: a SampledValue with the same properties and reading context as the
+ * SampledValue at the same position of the previous MeterValue in the log is stored as an integer delta.
+ * When the log exceeds MO_TXEVENTLOG_SIZE_V201, the live records are rewritten into the other log file.
+ */
 class TransactionStoreEvse : public MemoryManaged {
 private:
     TransactionStore& txStore;
@@ -73,11 +107,52 @@ private:
 
     std::shared_ptr<FilesystemAdapter> filesystem;
 
+    Vector<std::unique_ptr<StoredSampledValueProperties>> storedProperties;
+    SampledValueProperties *getStoredProperties(const char *measurand, const char *phase, const char *location, const char *unitOfMeasureUnit, int unitOfMeasureMultiplier);
+
+    //append position of the txEvent log
+    bool writerValid = false;
+    unsigned int writerTxNr = 0;
+    unsigned int writerLog = 0;
+    Vector<TxEventLogSample> writerSamples;
+
+    //replay position of the txEvent log. Replay goes in seqNo order, so the reader only rewinds when switching the tx
+    bool readerValid = false;
+    unsigned int readerTxNr = 0;
+    unsigned int readerLog = 0;
+    size_t readerOffset = 0;
+    unsigned int readerSeqNoNext = 0;
+    Vector<TxEventLogSample> readerSamples;
+    bool readerAttemptValid = false; //only the front txEvent can have been sent before the reader rewinded
+    unsigned int readerAttemptSeqNo = 0;
+    unsigned int readerAttemptNr = 0;
+    Timestamp readerAttemptTime;
+
+    //skip writing the tx state if unchanged
+    bool txStateValid = false;
+    unsigned int txStateTxNr = 0;
+    uint32_t txStateHash = 0;
+
     bool serializeTransaction(Transaction& tx, JsonObject out);
     bool serializeTransactionEvent(TransactionEventData& txEvent, JsonObject out);
     bool deserializeTransaction(Transaction& tx, JsonObject in);
     bool deserializeTransactionEvent(TransactionEventData& txEvent, JsonObject in);
 
+    bool serializeMeterValue(MeterValue& meterValue, const Timestamp& eventTime, Vector<TxEventLogSample>& samples, JsonObject out);
+    bool deserializeMeterValue(JsonObject in, const Timestamp& eventTime, Vector<TxEventLogSample>& samples, std::unique_ptr<MeterValue> *out); //out can be null to only advance samples
+
+    bool printTxFn(char *fn, size_t size, unsigned int txNr);
+    bool printLogFn(char *fn, size_t size, unsigned int txNr, unsigned int log);
+
+    bool commitTxState(Transaction& tx, bool force);
+    bool flushTx(Transaction& tx); //durability barrier for the tx state file and the active txEvent log
+    size_t getLogSize(Transaction& tx);
+    bool appendLog(Transaction& tx, JsonDoc& record);
+    bool appendTxEvent(Transaction& tx, TransactionEventData& txEvent);
+    bool resetLog(Transaction& tx);
+    bool compactLog(Transaction& tx, bool thinOut);
+    void invalidateLogPositions(unsigned int txNr);
+
     bool commit(Transaction& transaction, TransactionEventData *transactionEvent);
 
 public:
@@ -0,0 +1,439 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Implementation of the UCs N04 - N07 (custom Variable monitoring)
+ */
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
+#include <MicroOcpp/Model/Variables/VariableService.h>
+#include <MicroOcpp/Model/Transactions/TransactionService.h>
+#include <MicroOcpp/Model/Model.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Operations/SetVariableMonitoring.h>
+#include <MicroOcpp/Operations/ClearVariableMonitoring.h>
+#include <MicroOcpp/Operations/NotifyEvent.h>
+
+#include <cstdlib>
+
+#include <MicroOcpp/Debug.h>
+
+#define VALUE_BUFSIZE 30 // for primitives (int)
+
+namespace MicroOcpp {
+
+//numerical interpretation of the Variable value for threshold and delta monitors. Returns false if not numeric
+bool getMonitoringValue(Variable *variable, float& out) {
+    switch (variable->getInternalDataType()) {
+        case Variable::InternalDataType::Int:
+            out = (float) variable->getInt();
+            return true;
+        case Variable::InternalDataType::String: {
+            if (variable->getVariableDataType() != VariableCharacteristics::DataType::decimal &&
+                    variable->getVariableDataType() != VariableCharacteristics::DataType::integer) {
+                return false;
+            }
+            const char *value = variable->getString();
+            char *end = nullptr;
+            out = (float) strtod(value, &end);
+            return end != value && *end == '\0';
+        }
+        default:
+            return false;
+    }
+}
+
+MonitoringService::MonitoredVariable::MonitoredVariable(Variable *variable, const char *memoryTag) :
+        variable(variable), writeCount(variable->getWriteCount()), monitors(makeVector<MonitorState>(memoryTag)) {
+
+}
+
+MonitoringService::PeriodicMonitor::PeriodicMonitor(Variable *variable, int monitorId, const char *memoryTag) :
+        MemoryManaged(memoryTag), variable(variable), monitorId(monitorId) {
+
+}
+
+MonitoringService::MonitoringService(Context& context, VariableService& variableService) :
+            MemoryManaged("v201.Variables.MonitoringService"),
+            context(context), variableService(variableService),
+            watchList(makeVector<MonitoredVariable>(getMemoryTag())),
+            periodicMonitors(makeVector<std::unique_ptr<PeriodicMonitor>>(getMemoryTag())),
+            events(makeVector<MonitoringEvent>(getMemoryTag())) {
+
+    context.getOperationRegistry().registerOperation("SetVariableMonitoring", [this] () {
+        return new Ocpp201::SetVariableMonitoring(*this);});
+    context.getOperationRegistry().registerOperation("ClearVariableMonitoring", [this] () {
+        return new Ocpp201::ClearVariableMonitoring(*this);});
+}
+
+void MonitoringService::loop() {
+
+    //evaluate the monitors of Variables which have been written since the last loop. Variables without monitors aren't visited
+    for (auto& entry : watchList) {
+        auto writeCount = entry.variable->getWriteCount();
+        if (writeCount == entry.writeCount) {
+            continue;
+        }
+        entry.writeCount = writeCount;
+
+        for (auto& state : entry.monitors) {
+            evaluate(entry.variable, state);
+        }
+    }
+
+    sendEvents();
+}
+
+void MonitoringService::evaluate(Variable *variable, MonitorState& state) {
+
+    const auto& monitor = state.monitor;
+
+    if (monitor.isTransaction() && !isTransactionRunning(variable->getComponentId())) {
+        return;
+    }
+
+    switch (monitor.getType()) {
+        case VariableMonitor::Type::UpperThreshold:
+        case VariableMonitor::Type::LowerThreshold: {
+            float value;
+            if (!getMonitoringValue(variable, value)) {
+                break;
+            }
+            bool alerting = monitor.getType() == VariableMonitor::Type::UpperThreshold ?
+                    value > monitor.getValue() :
+                    value < monitor.getValue();
+            if (alerting != state.alerting) {
+                state.alerting = alerting;
+                addEvent(variable, monitor, "Alerting", !alerting);
+            }
+            break;
+        }
+        case VariableMonitor::Type::Delta: {
+            float value;
+            if (getMonitoringValue(variable, value)) {
+                if (value - state.reference > monitor.getValue() || state.reference - value > monitor.getValue()) {
+                    state.reference = value;
+                    addEvent(variable, monitor, "Delta");
+                }
+            } else {
+                //non-numerical Variables: report every change
+                addEvent(variable, monitor, "Delta");
+            }
+            break;
+        }
+        case VariableMonitor::Type::Periodic:
+        case VariableMonitor::Type::PeriodicClockAligned:
+            //scheduled on the timer wheel
+            break;
+    }
+}
+
+void MonitoringService::addEvent(Variable *variable, const VariableMonitor& monitor, const char *trigger, bool cleared) {
+
+    if (events.size() >= MO_MONITORING_EVENTS_MAX) {
+        MO_DBG_WARN("event queue full. Drop oldest event");
+        events.erase(events.begin());
+    }
+
+    events.emplace_back(getMemoryTag());
+    auto& event = events.back();
+
+    event.eventId = nextEventId++;
+    if (nextEventId < 0) {
+        nextEventId = 1;
+    }
+    event.timestamp = context.getModel().getClock().now();
+    event.trigger = trigger;
+    event.cleared = cleared;
+    event.variable = variable;
+    event.variableMonitoringId = monitor.getId();
+
+    switch (variable->getInternalDataType()) {
+        case Variable::InternalDataType::Int: {
+            char valbuf [VALUE_BUFSIZE];
+            auto ret = snprintf(valbuf, VALUE_BUFSIZE, "%i", variable->getInt());
+            if (ret < 0 || ret >= VALUE_BUFSIZE) {
+                break;
+            }
+            event.actualValue = valbuf;
+            break;
+        }
+        case Variable::InternalDataType::Bool:
+            event.actualValue = variable->getBool() ? "true" : "false";
+            break;
+        case Variable::InternalDataType::String:
+            event.actualValue = variable->getString();
+            break;
+        default:
+            MO_DBG_ERR("internal error");
+            break;
+    }
+}
+
+void MonitoringService::sendEvents() {
+
+    if (events.empty()) {
+        return;
+    }
+
+    //batch the events of this loop into NotifyEvent messages
+    auto generatedAt = context.getModel().getClock().now();
+    int seqNo = 0;
+
+    size_t i = 0;
+    while (i < events.size()) {
+        auto eventData = makeVector<MonitoringEvent>(getMemoryTag());
+        for (size_t pageEnd = i + MO_NOTIFYEVENT_MAX_EVENTS; i < pageEnd && i < events.size(); i++) {
+            eventData.push_back(std::move(events[i]));
+        }
+
+        bool tbc = i < events.size();
+
+        context.initiateRequest(makeRequest(new Ocpp201::NotifyEvent(generatedAt, tbc, seqNo, std::move(eventData))));
+        seqNo++;
+    }
+
+    events.clear();
+}
+
+void MonitoringService::schedule(Variable *variable, const VariableMonitor& monitor) {
+
+    int interval = (int) monitor.getValue();
+    if (interval < 1) {
+        MO_DBG_ERR("invalid interval");
+        return;
+    }
+
+    int delay = interval;
+
+    auto& timestampNow = context.getModel().getClock().now();
+    if (monitor.getType() == VariableMonitor::Type::PeriodicClockAligned && timestampNow >= MIN_TIME) {
+        //align with midnight, like ClockAlignedDataInterval
+        Timestamp midnightBase = Timestamp(2010,0,0,0,0,0);
+        int secondsOfDay = (timestampNow - midnightBase) % (3600 * 24);
+        delay = interval - secondsOfDay % interval;
+        if (secondsOfDay + delay > 3600 * 24) {
+            //next event is tomorrow; set to precisely 00:00
+            delay = 3600 * 24 - secondsOfDay;
+        }
+    }
+
+    PeriodicMonitor *periodic = nullptr;
+    for (auto& entry : periodicMonitors) {
+        if (entry->monitorId == monitor.getId()) {
+            periodic = entry.get();
+            break;
+        }
+    }
+
+    if (!periodic) {
+        periodicMonitors.emplace_back(new PeriodicMonitor(variable, monitor.getId(), getMemoryTag()));
+        periodic = periodicMonitors.back().get();
+        periodic->timer.setCallback([this, periodic] () {
+            onPeriodicTimer(*periodic);
+        });
+    }
+
+    context.getTimerWheel().schedule(periodic->timer, (unsigned long) delay * 1000UL);
+}
+
+void MonitoringService::unschedule(int monitorId) {
+    for (auto entry = periodicMonitors.begin(); entry != periodicMonitors.end(); entry++) {
+        if ((*entry)->monitorId == monitorId) {
+            periodicMonitors.erase(entry); //cancels the timer
+            return;
+        }
+    }
+}
+
+void MonitoringService::onPeriodicTimer(PeriodicMonitor& periodic) {
+    auto state = getMonitor(periodic.monitorId);
+    if (!state) {
+        MO_DBG_ERR("internal error");
+        return;
+    }
+
+    if (!state->monitor.isTransaction() || isTransactionRunning(periodic.variable->getComponentId())) {
+        addEvent(periodic.variable, state->monitor, "Periodic");
+    }
+
+    schedule(periodic.variable, state->monitor); //reuses the timer of periodic
+}
+
+MonitoringService::MonitoredVariable *MonitoringService::getMonitoredVariable(Variable *variable) {
+    for (auto& entry : watchList) {
+        if (entry.variable == variable) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+MonitoringService::MonitorState *MonitoringService::getMonitor(int monitorId, Variable **variableOut) {
+    for (auto& entry : watchList) {
+        for (auto& state : entry.monitors) {
+            if (state.monitor.getId() == monitorId) {
+                if (variableOut) {
+                    *variableOut = entry.variable;
+                }
+                return &state;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool MonitoringService::isTransactionRunning(const ComponentId& component) {
+    auto txService = context.getModel().getTransactionService();
+    if (!txService) {
+        return false;
+    }
+
+    for (unsigned int evseId = 1; evseId < MO_NUM_EVSEID; evseId++) {
+        if (component.evse.id >= 1 && (unsigned int) component.evse.id != evseId) {
+            continue;
+        }
+        auto evse = txService->getEvse(evseId);
+        auto tx = evse ? evse->getTransaction() : nullptr;
+        if (tx && tx->started && !tx->stopped) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+SetMonitoringStatus MonitoringService::setMonitor(int& monitorId, bool transaction, float value, VariableMonitor::Type type, int severity, const ComponentId& component, const char *variableName) {
+
+    Variable *variable = nullptr;
+    switch (variableService.getVariable(Variable::AttributeType::Actual, component, variableName, &variable)) {
+        case GetVariableStatus::Accepted:
+            break;
+        case GetVariableStatus::UnknownComponent:
+            return SetMonitoringStatus::UnknownComponent;
+        case GetVariableStatus::UnknownVariable:
+            return SetMonitoringStatus::UnknownVariable;
+        default:
+            return SetMonitoringStatus::Rejected;
+    }
+
+    if (!variable->getSupportsMonitoring()) {
+        MO_DBG_INFO("monitoring not supported: %s", variableName);
+        return SetMonitoringStatus::Rejected;
+    }
+
+    switch (type) {
+        case VariableMonitor::Type::UpperThreshold:
+        case VariableMonitor::Type::LowerThreshold: {
+            float dummy;
+            if (!getMonitoringValue(variable, dummy)) {
+                return SetMonitoringStatus::UnsupportedMonitorType;
+            }
+            break;
+        }
+        case VariableMonitor::Type::Delta:
+            if (value < 0.f) {
+                return SetMonitoringStatus::Rejected;
+            }
+            break;
+        case VariableMonitor::Type::Periodic:
+        case VariableMonitor::Type::PeriodicClockAligned:
+            if (value < 1.f || value > 3600.f * 24.f) {
+                return SetMonitoringStatus::Rejected;
+            }
+            break;
+    }
+
+    if (monitorId >= 0) {
+        //replace existing monitor. The monitor must belong to the same Variable
+        Variable *replaceVariable = nullptr;
+        if (!getMonitor(monitorId, &replaceVariable) || replaceVariable != variable) {
+            return SetMonitoringStatus::Rejected;
+        }
+    }
+
+    if (auto entry = getMonitoredVariable(variable)) {
+        for (const auto& state : entry->monitors) {
+            if (state.monitor.getId() != monitorId &&
+                    state.monitor.getType() == type &&
+                    state.monitor.getSeverity() == severity) {
+                return SetMonitoringStatus::Duplicate;
+            }
+        }
+    }
+
+    if (monitorId >= 0) {
+        clearMonitor(monitorId);
+    } else {
+        if (nMonitors >= MO_MONITORS_MAX) {
+            MO_DBG_WARN("exceeded MO_MONITORS_MAX");
+            return SetMonitoringStatus::Rejected;
+        }
+        monitorId = nextMonitorId++;
+    }
+
+    auto entry = getMonitoredVariable(variable);
+    if (!entry) {
+        watchList.emplace_back(variable, getMemoryTag());
+        entry = &watchList.back();
+    }
+
+    entry->monitors.emplace_back(VariableMonitor(monitorId, transaction, value, type, severity));
+    nMonitors++;
+
+    auto& state = entry->monitors.back();
+
+    //initial state
+    switch (type) {
+        case VariableMonitor::Type::UpperThreshold:
+        case VariableMonitor::Type::LowerThreshold:
+            evaluate(variable, state);
+            break;
+        case VariableMonitor::Type::Delta:
+            getMonitoringValue(variable, state.reference);
+            break;
+        case VariableMonitor::Type::Periodic:
+        case VariableMonitor::Type::PeriodicClockAligned:
+            schedule(variable, state.monitor);
+            break;
+    }
+
+    return SetMonitoringStatus::Accepted;
+}
+
+ClearMonitoringStatus MonitoringService::clearMonitor(int monitorId) {
+    for (auto entry = watchList.begin(); entry != watchList.end(); entry++) {
+        for (auto state = entry->monitors.begin(); state != entry->monitors.end(); state++) {
+            if (state->monitor.getId() != monitorId) {
+                continue;
+            }
+
+            auto type = state->monitor.getType();
+
+            entry->monitors.erase(state);
+            nMonitors--;
+
+            if (entry->monitors.empty()) {
+                watchList.erase(entry);
+            }
+
+            if (type == VariableMonitor::Type::Periodic || type == VariableMonitor::Type::PeriodicClockAligned) {
+                unschedule(monitorId);
+            }
+
+            return ClearMonitoringStatus::Accepted;
+        }
+    }
+
+    return ClearMonitoringStatus::NotFound;
+}
+
+} // namespace MicroOcpp
+
+#endif // MO_ENABLE_V201
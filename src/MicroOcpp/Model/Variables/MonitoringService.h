@@ -0,0 +1,144 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Implementation of the UCs N04 - N07 (custom Variable monitoring)
+ *
+ * Monitors are evaluated event-driven: only Variables which have a monitor are tracked, and their monitors are
+ * only evaluated when the write count of the Variable changed. Periodic monitors are scheduled on the TimerWheel of
+ * the Context.
+ * The resulting events are batched into NotifyEvent messages once per loop.
+ */
+
+#ifndef MO_MONITORINGSERVICE_H
+#define MO_MONITORINGSERVICE_H
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Model/Variables/Variable.h>
+#include <MicroOcpp/Core/Time.h>
+#include <MicroOcpp/Core/TimerWheel.h>
+#include <MicroOcpp/Core/Memory.h>
+
+#ifndef MO_MONITORS_MAX
+#define MO_MONITORS_MAX 20 //max number of custom monitors
+#endif
+
+#ifndef MO_MONITORING_EVENTS_MAX
+#define MO_MONITORING_EVENTS_MAX 20 //max number of events waiting to be sent. If exceeded, drop the oldest
+#endif
+
+#ifndef MO_NOTIFYEVENT_MAX_EVENTS
+#define MO_NOTIFYEVENT_MAX_EVENTS 10 //max number of eventData entries per NotifyEvent message
+#endif
+
+namespace MicroOcpp {
+
+// SetMonitoringStatusEnumType (3.77)
+enum class SetMonitoringStatus : uint8_t {
+    Accepted,
+    UnknownComponent,
+    UnknownVariable,
+    UnsupportedMonitorType,
+    Rejected,
+    Duplicate
+};
+
+// ClearMonitoringStatusEnumType (3.15)
+enum class ClearMonitoringStatus : uint8_t {
+    Accepted,
+    Rejected,
+    NotFound
+};
+
+// EventDataType (2.27)
+struct MonitoringEvent {
+    int eventId;
+    Timestamp timestamp;
+    const char *trigger; //EventTriggerEnumType (3.33), string literal
+    bool cleared = false;
+    String actualValue;
+    Variable *variable; //component and variable name are taken from here
+    int variableMonitoringId;
+
+    MonitoringEvent(const char *memoryTag = nullptr) : actualValue(makeString(memoryTag)) { }
+};
+
+class Context;
+class VariableService;
+
+class MonitoringService : public MemoryManaged {
+private:
+    Context& context;
+    VariableService& variableService;
+
+    struct MonitorState {
+        VariableMonitor monitor;
+        bool alerting = false; //threshold monitors: value is beyond the threshold
+        float reference = 0.f; //delta monitors: value at the last event
+
+        MonitorState(const VariableMonitor& monitor) : monitor(monitor) { }
+    };
+
+    struct MonitoredVariable {
+        Variable *variable;
+        uint16_t writeCount; //write count when the monitors were evaluated the last time
+        Vector<MonitorState> monitors;
+
+        MonitoredVariable(Variable *variable, const char *memoryTag);
+    };
+
+    Vector<MonitoredVariable> watchList; //only Variables with at least one monitor
+    size_t nMonitors = 0;
+    int nextMonitorId = 1;
+
+    //timers of the periodic monitors
+    struct PeriodicMonitor : public MemoryManaged {
+        Timer timer;
+        Variable *variable;
+        int monitorId;
+
+        PeriodicMonitor(Variable *variable, int monitorId, const char *memoryTag);
+    };
+
+    Vector<std::unique_ptr<PeriodicMonitor>> periodicMonitors;
+
+    void schedule(Variable *variable, const VariableMonitor& monitor);
+    void unschedule(int monitorId);
+    void onPeriodicTimer(PeriodicMonitor& periodic);
+
+    Vector<MonitoringEvent> events;
+    int nextEventId = 1;
+
+    void evaluate(Variable *variable, MonitorState& state);
+    void addEvent(Variable *variable, const VariableMonitor& monitor, const char *trigger, bool cleared = false);
+    void sendEvents();
+
+    MonitoredVariable *getMonitoredVariable(Variable *variable);
+    MonitorState *getMonitor(int monitorId, Variable **variableOut = nullptr);
+
+    bool isTransactionRunning(const ComponentId& component);
+public:
+    MonitoringService(Context& context, VariableService& variableService);
+
+    void loop();
+
+    /*
+     * Add or replace a custom monitor. If monitorId is >= 0, replace the existing monitor with that id. On success,
+     * monitorId is set to the id of the new monitor
+     */
+    SetMonitoringStatus setMonitor(int& monitorId, bool transaction, float value, VariableMonitor::Type type, int severity, const ComponentId& component, const char *variableName);
+
+    ClearMonitoringStatus clearMonitor(int monitorId);
+
+    size_t getMonitorCount() {return nMonitors;}
+};
+
+} // namespace MicroOcpp
+
+#endif // MO_ENABLE_V201
+
+#endif
@@ -106,6 +106,12 @@ public:
     VariableMonitor() = delete;
     VariableMonitor(int id, bool transaction, float value, Type type, int severity) :
             id(id), transaction(transaction), value(value), type(type), severity(severity) { }
+
+    int getId() const {return id;}
+    bool isTransaction() const {return transaction;}
+    float getValue() const {return value;}
+    Type getType() const {return type;}
+    int getSeverity() const {return severity;}
 };
 
 // ComponentType (2.16)
@@ -177,8 +183,7 @@ private:
 
     AttributeTypeSet attributes;
 
-    // VariableMonitoringType (2.52)
-    //std::vector<VariableMonitor> monitors; // uncomment when testing Monitors
+    // VariableMonitoringType (2.52): managed by the MonitoringService
 public:
     Variable(AttributeTypeSet attributes);
 
@@ -219,8 +224,6 @@ public:
     void setConstant();
     bool isConstant();
 
-    //bool addMonitor(int id, bool transaction, float value, VariableMonitor::Type type, int severity);
-    
     virtual uint16_t getWriteCount() = 0; //get write count (use this as a pre-check if the value changed)
 };
 
@@ -74,6 +74,117 @@ VariableContainerOwning& VariableService::getContainerInternalByVariable(const C
     return containersInternal[hash % MO_VARIABLESTORE_BUCKETS];
 }
 
+uint32_t hashComponentId(const ComponentId& component) {
+    //FNV-1a
+    uint32_t hash = 2166136261U;
+    for (const char *c = component.name; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+    }
+    //undefined evse ids are all equal (see ComponentId::equals)
+    hash = (hash ^ (uint32_t)(component.evse.id >= 0 ? component.evse.id + 1 : 0)) * 16777619U;
+    hash = (hash ^ (uint32_t)(component.evse.connectorId >= 0 ? component.evse.connectorId + 1 : 0)) * 16777619U;
+    return hash;
+}
+
+uint32_t hashVariableKey(const ComponentId& component, const char *name) {
+    uint32_t hash = hashComponentId(component);
+    for (const char *c = name; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+    }
+    return hash;
+}
+
+//insert into hash table, unless an equal entry exists already. Grows the table at a load factor of 3/4
+void insertVariableIndex(Vector<Variable*>& table, size_t& count, Variable *variable, uint32_t (*hashFn)(Variable*), bool (*equalFn)(Variable*, Variable*)) {
+
+    if ((count + 1) * 4 > table.size() * 3) {
+        Vector<Variable*> resized (table.get_allocator());
+        resized.resize(table.empty() ? 16 : 2 * table.size(), nullptr);
+        size_t mask = resized.size() - 1;
+        for (auto entry : table) {
+            if (!entry) {
+                continue;
+            }
+            size_t i = hashFn(entry) & mask;
+            while (resized[i]) {
+                i = (i + 1) & mask;
+            }
+            resized[i] = entry;
+        }
+        table.swap(resized);
+    }
+
+    size_t mask = table.size() - 1;
+    for (size_t i = hashFn(variable) & mask; ; i = (i + 1) & mask) {
+        if (!table[i]) {
+            table[i] = variable;
+            count++;
+            return;
+        }
+        if (equalFn(table[i], variable)) {
+            return;
+        }
+    }
+}
+
+void VariableService::addToIndex(Variable *variable, bool external) {
+
+    insertVariableIndex(external ? externalIndex : variableIndex, external ? externalIndexCount : variableIndexCount, variable,
+        [] (Variable *v) {
+            return hashVariableKey(v->getComponentId(), v->getName());
+        },
+        [] (Variable *a, Variable *b) {
+            return !strcmp(a->getName(), b->getName()) && a->getComponentId().equals(b->getComponentId());
+        });
+
+    insertVariableIndex(componentIndex, componentIndexCount, variable,
+        [] (Variable *v) {
+            return hashComponentId(v->getComponentId());
+        },
+        [] (Variable *a, Variable *b) {
+            return a->getComponentId().equals(b->getComponentId());
+        });
+}
+
+Variable *getIndexedVariable(const Vector<Variable*>& table, const ComponentId& component, const char *name) {
+    if (table.empty()) {
+        return nullptr;
+    }
+
+    size_t mask = table.size() - 1;
+    for (size_t i = hashVariableKey(component, name) & mask; table[i]; i = (i + 1) & mask) {
+        auto variable = table[i];
+        if (!strcmp(variable->getName(), name) && variable->getComponentId().equals(component)) {
+            return variable;
+        }
+    }
+
+    return nullptr;
+}
+
+bool VariableService::hasComponent(const ComponentId& component) {
+    if (!componentIndex.empty()) {
+        size_t mask = componentIndex.size() - 1;
+        for (size_t i = hashComponentId(component) & mask; componentIndex[i]; i = (i + 1) & mask) {
+            if (componentIndex[i]->getComponentId().equals(component)) {
+                return true;
+            }
+        }
+    }
+
+    //containers which have been added via addContainer()
+    for (size_t i = containersIndexed; i < containers.size(); i++) {
+        auto container = containers[i];
+        for (size_t j = 0; j < container->size(); j++) {
+            if (container->getVariable(j)->getComponentId().equals(component)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 void VariableService::addContainer(VariableContainer *container) {
     containers.push_back(container);
 }
@@ -107,17 +218,38 @@ bool VariableService::registerValidator<const char*>(const ComponentId& componen
 
 Variable *VariableService::getVariable(const ComponentId& component, const char *name) {
 
-    if (auto variable = getContainerInternalByVariable(component, name).getVariable(component, name)) {
+    if (auto variable = getIndexedVariable(variableIndex, component, name)) {
         return variable;
     }
 
-    for (size_t i = 0; i < containers.size(); i++) {
-        auto container = containers[containers.size() - i - 1]; //search from back, because internal containers at front don't contain variable
+    //containers which have been added via addContainer()
+    for (size_t i = containers.size(); i > containersIndexed; i--) {
+        auto container = containers[i - 1]; //search from back, latest added container first
         if (auto variable = container->getVariable(component, name)) {
             return variable;
         }
     }
 
+    return getIndexedVariable(externalIndex, component, name);
+}
+
+Variable *VariableService::lookupVariable(const ComponentId& component, const char *name) {
+
+    if (auto variable = getIndexedVariable(variableIndex, component, name)) {
+        return variable;
+    }
+
+    if (auto variable = getIndexedVariable(externalIndex, component, name)) {
+        return variable;
+    }
+
+    //containers which have been added via addContainer()
+    for (size_t i = containersIndexed; i < containers.size(); i++) {
+        if (auto variable = containers[i]->getVariable(component, name)) {
+            return variable;
+        }
+    }
+
     return nullptr;
 }
 
@@ -125,6 +257,9 @@ VariableService::VariableService(Context& context, std::shared_ptr<FilesystemAda
             MemoryManaged("v201.Variables.VariableService"),
             context(context), filesystem(filesystem),
             containers(makeVector<VariableContainer*>(getMemoryTag())),
+            variableIndex(makeVector<Variable*>(getMemoryTag())),
+            externalIndex(makeVector<Variable*>(getMemoryTag())),
+            componentIndex(makeVector<Variable*>(getMemoryTag())),
             validatorInt(makeVector<VariableValidator<int>>(getMemoryTag())),
             validatorBool(makeVector<VariableValidator<bool>>(getMemoryTag())),
             validatorString(makeVector<VariableValidator<const char*>>(getMemoryTag())) {
@@ -142,6 +277,7 @@ VariableService::VariableService(Context& context, std::shared_ptr<FilesystemAda
         containers.push_back(&containersInternal[i]);
     }
     containers.push_back(&containerExternal);
+    containersIndexed = containers.size();
 
     context.getOperationRegistry().registerOperation("SetVariables", [this] () {
         return new Ocpp201::SetVariables(*this);});
@@ -230,6 +366,8 @@ Variable *VariableService::declareVariable(const ComponentId& component, const c
         if (!getContainerInternalByVariable(component, name).add(std::move(variable))) {
             return nullptr;
         }
+
+        addToIndex(res, false);
     }
 
     loadVariableCharacteristics(*res, mutability, persistent, rebootRequired, getInternalDataType<T>());
@@ -241,11 +379,20 @@ template Variable *VariableService::declareVariable<bool>(       const Component
 template Variable *VariableService::declareVariable<const char*>(const ComponentId&, const char*, const char*, Variable::Mutability, bool, Variable::AttributeTypeSet, bool);
 
 bool VariableService::addVariable(Variable *variable) {
-    return containerExternal.add(variable);
+    if (!containerExternal.add(variable)) {
+        return false;
+    }
+    addToIndex(variable, true);
+    return true;
 }
 
 bool VariableService::addVariable(std::unique_ptr<Variable> variable) {
-    return getContainerInternalByVariable(variable->getComponentId(), variable->getName()).add(std::move(variable));
+    auto variablePtr = variable.get();
+    if (!getContainerInternalByVariable(variable->getComponentId(), variable->getName()).add(std::move(variable))) {
+        return false;
+    }
+    addToIndex(variablePtr, false);
+    return true;
 }
 
 bool VariableService::load() {
@@ -274,34 +421,10 @@ bool VariableService::commit() {
 
 SetVariableStatus VariableService::setVariable(Variable::AttributeType attrType, const char *value, const ComponentId& component, const char *variableName) {
 
-    Variable *variable = nullptr;
-
-    bool foundComponent = false;
-    for (size_t i = 0; i < containers.size(); i++) {
-        auto container = containers[i];
-
-        for (size_t i = 0; i < container->size(); i++) {
-            auto entry = container->getVariable(i);
-
-            if (entry->getComponentId().equals(component)) {
-                foundComponent = true;
-
-                if (!strcmp(entry->getName(), variableName)) {
-                    // found variable. Search terminated in this block
-
-                    variable = entry;
-                    break;
-                }
-            }
-        }
-        if (variable) {
-            // result found in inner for-loop
-            break;
-        }
-    }
+    Variable *variable = lookupVariable(component, variableName);
 
     if (!variable) {
-        if (foundComponent) {
+        if (hasComponent(component)) {
             return SetVariableStatus::UnknownVariable;
         } else {
             return SetVariableStatus::UnknownComponent; 
@@ -411,38 +534,25 @@ SetVariableStatus VariableService::setVariable(Variable::AttributeType attrType,
 
 GetVariableStatus VariableService::getVariable(Variable::AttributeType attrType, const ComponentId& component, const char *variableName, Variable **result) {
 
-    bool foundComponent = false;
-    for (size_t i = 0; i < containers.size(); i++) {
-        auto container = containers[i];
-
-        for (size_t i = 0; i < container->size(); i++) {
-            auto variable = container->getVariable(i);
+    auto variable = lookupVariable(component, variableName);
 
-            if (variable->getComponentId().equals(component)) {
-                foundComponent = true;
-
-                if (!strcmp(variable->getName(), variableName)) {
-                    // found variable. Search terminated in this block
-
-                    if (variable->getMutability() == Variable::Mutability::WriteOnly) {
-                        return GetVariableStatus::Rejected;
-                    }
-
-                    if (variable->hasAttribute(attrType)) {
-                        *result = variable;
-                        return GetVariableStatus::Accepted;
-                    } else {
-                        return GetVariableStatus::NotSupportedAttributeType;
-                    }
-                }
-            }
+    if (!variable) {
+        if (hasComponent(component)) {
+            return GetVariableStatus::UnknownVariable;
+        } else {
+            return GetVariableStatus::UnknownComponent; 
         }
     }
 
-    if (foundComponent) {
-        return GetVariableStatus::UnknownVariable;
+    if (variable->getMutability() == Variable::Mutability::WriteOnly) {
+        return GetVariableStatus::Rejected;
+    }
+
+    if (variable->hasAttribute(attrType)) {
+        *result = variable;
+        return GetVariableStatus::Accepted;
     } else {
-        return GetVariableStatus::UnknownComponent; 
+        return GetVariableStatus::NotSupportedAttributeType;
     }
 }
 
@@ -452,39 +562,52 @@ GenericDeviceModelStatus VariableService::getBaseReport(int requestId, ReportBas
         return GenericDeviceModelStatus_NotSupported;
     }
 
-    Vector<Variable*> variables = makeVector<Variable*>(getMemoryTag());
+    //snapshot of the selected Variables. The pages only serialize their share of it
+    auto reportData = std::allocate_shared<Vector<Variable*>>(makeAllocator<Vector<Variable*>>(getMemoryTag()), makeVector<Variable*>(getMemoryTag()));
 
-    for (size_t i = 0; i < containers.size(); i++) {
-        auto container = containers[i];
-
-        for (size_t i = 0; i < container->size(); i++) {
-            auto variable = container->getVariable(i);
-
-            if (reportBase == ReportBase_ConfigurationInventory && variable->getMutability() == Variable::Mutability::ReadOnly) {
-                continue;
-            }
-
-            variables.push_back(variable);
-        }
+    size_t containerIndex = 0, variableIndex = 0;
+    while (auto variable = getReportVariable(reportBase, containerIndex, variableIndex)) {
+        reportData->push_back(variable);
+        variableIndex++;
     }
 
-    if (variables.empty()) {
+    if (reportData->empty()) {
         return GenericDeviceModelStatus_EmptyResultSet;
     }
 
+    //each page enqueues the following page when confirmed
     auto notifyReport = makeRequest(new Ocpp201::NotifyReport(
-            context.getModel(), 
+            context,
             requestId,
             context.getModel().getClock().now(),
-            false,
-            0,
-            variables));
+            std::move(reportData)));
 
-    context.initiateRequest(std::move(notifyReport));
+    if (!context.initiateRequest(std::move(notifyReport))) {
+        return GenericDeviceModelStatus_Rejected;
+    }
 
     return GenericDeviceModelStatus_Accepted;
 }
 
+Variable *VariableService::getReportVariable(ReportBase reportBase, size_t& containerIndex, size_t& variableIndex) {
+
+    for (; containerIndex < containers.size(); containerIndex++, variableIndex = 0) {
+        auto container = containers[containerIndex];
+
+        for (; variableIndex < container->size(); variableIndex++) {
+            auto variable = container->getVariable(variableIndex);
+
+            if (reportBase == ReportBase_ConfigurationInventory && variable->getMutability() == Variable::Mutability::ReadOnly) {
+                continue;
+            }
+
+            return variable;
+        }
+    }
+
+    return nullptr;
+}
+
 } // namespace MicroOcpp
 
 #endif // MO_ENABLE_V201
@@ -53,10 +53,31 @@ private:
     Context& context;
     std::shared_ptr<FilesystemAdapter> filesystem;
     Vector<VariableContainer*> containers;
+    size_t containersIndexed = 0; //the first containers hold the Variables of the index; the following are added via addContainer()
     VariableContainerNonOwning containerExternal;
     VariableContainerOwning containersInternal [MO_VARIABLESTORE_BUCKETS];
     VariableContainerOwning& getContainerInternalByVariable(const ComponentId& component, const char *name);
 
+    /*
+     * Hash indexes over all Variables which are added via declareVariable() or addVariable(). Open addressing
+     * with linear probing, the capacity is a power of two. Containers which are added via addContainer() can
+     * change their content at any time and are searched linearly.
+     *
+     * The internal and the external container have separate indexes to keep the container precedence for
+     * duplicate keys (see getVariable() and lookupVariable())
+     */
+    Vector<Variable*> variableIndex; //containersInternal
+    size_t variableIndexCount = 0;
+    Vector<Variable*> externalIndex; //containerExternal
+    size_t externalIndexCount = 0;
+    Vector<Variable*> componentIndex; //one Variable per component
+    size_t componentIndexCount = 0;
+    void addToIndex(Variable *variable, bool external);
+    bool hasComponent(const ComponentId& component);
+
+    //lookup for Get-/SetVariables: internal containers, external container, then addContainer() containers in order of adding
+    Variable *lookupVariable(const ComponentId& component, const char *name);
+
     Vector<VariableValidator<int>> validatorInt;
     Vector<VariableValidator<bool>> validatorBool;
     Vector<VariableValidator<const char*>> validatorString;
@@ -90,6 +111,12 @@ public:
     GetVariableStatus getVariable(Variable::AttributeType attrType, const ComponentId& component, const char *variableName, Variable **result);
 
     GenericDeviceModelStatus getBaseReport(int requestId, ReportBase reportBase);
+
+    /*
+     * Report cursor: return the first Variable which belongs to reportBase at or after the position (containerIndex,
+     * variableIndex) and move the position to it. Returns nullptr if there are no further Variables
+     */
+    Variable *getReportVariable(ReportBase reportBase, size_t& containerIndex, size_t& variableIndex);
 };
 
 } // namespace MicroOcpp
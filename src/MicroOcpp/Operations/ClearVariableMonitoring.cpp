@@ -0,0 +1,77 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Operations/ClearVariableMonitoring.h>
+#include <MicroOcpp/Debug.h>
+
+using MicroOcpp::Ocpp201::ClearVariableMonitoring;
+using MicroOcpp::JsonDoc;
+
+ClearVariableMonitoring::ClearVariableMonitoring(MonitoringService& monitoringService) : MemoryManaged("v201.Operation.", "ClearVariableMonitoring"), monitoringService(monitoringService), results(makeVector<ClearMonitoringResult>(getMemoryTag())) {
+
+}
+
+const char* ClearVariableMonitoring::getOperationType(){
+    return "ClearVariableMonitoring";
+}
+
+void ClearVariableMonitoring::processReq(JsonObject payload) {
+    for (JsonVariant id : payload["id"].as<JsonArray>()) {
+        if (!id.is<int>() || id.as<int>() < 0) {
+            errorCode = "FormationViolation";
+            MO_DBG_ERR("invalid id");
+            return;
+        }
+        results.push_back({id.as<int>(), ClearMonitoringStatus::Rejected});
+    }
+
+    if (results.empty()) {
+        errorCode = "FormationViolation";
+        return;
+    }
+
+    for (auto& result : results) {
+        result.status = monitoringService.clearMonitor(result.id);
+    }
+}
+
+std::unique_ptr<JsonDoc> ClearVariableMonitoring::createConf(){
+    auto doc = makeJsonDoc(getMemoryTag(),
+            JSON_OBJECT_SIZE(1) +
+            JSON_ARRAY_SIZE(results.size()) +
+            results.size() * JSON_OBJECT_SIZE(2));
+
+    JsonObject payload = doc->to<JsonObject>();
+    JsonArray clearMonitoringResult = payload.createNestedArray("clearMonitoringResult");
+
+    for (const auto& result : results) {
+        JsonObject clearMonitoring = clearMonitoringResult.createNestedObject();
+
+        const char *statusCstr = "Rejected";
+        switch (result.status) {
+            case ClearMonitoringStatus::Accepted:
+                statusCstr = "Accepted";
+                break;
+            case ClearMonitoringStatus::Rejected:
+                statusCstr = "Rejected";
+                break;
+            case ClearMonitoringStatus::NotFound:
+                statusCstr = "NotFound";
+                break;
+            default:
+                MO_DBG_ERR("internal error");
+                break;
+        }
+        clearMonitoring["status"] = statusCstr;
+        clearMonitoring["id"] = result.id;
+    }
+
+    return doc;
+}
+
+#endif // MO_ENABLE_V201
@@ -0,0 +1,49 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_CLEARVARIABLEMONITORING_H
+#define MO_CLEARVARIABLEMONITORING_H
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Core/Operation.h>
+#include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
+
+namespace MicroOcpp {
+namespace Ocpp201 {
+
+// ClearMonitoringResultType (2.14)
+struct ClearMonitoringResult {
+    int id;
+    ClearMonitoringStatus status;
+};
+
+class ClearVariableMonitoring : public Operation, public MemoryManaged {
+private:
+    MonitoringService& monitoringService;
+    Vector<ClearMonitoringResult> results;
+
+    const char *errorCode = nullptr;
+public:
+    ClearVariableMonitoring(MonitoringService& monitoringService);
+
+    const char* getOperationType() override;
+
+    void processReq(JsonObject payload) override;
+
+    std::unique_ptr<JsonDoc> createConf() override;
+
+    const char *getErrorCode() override {return errorCode;}
+
+};
+
+} //namespace Ocpp201
+} //namespace MicroOcpp
+
+#endif //MO_ENABLE_V201
+
+#endif
@@ -38,6 +38,15 @@ void DataTransfer::processConf(JsonObject payload){
     }
 }
 
+bool DataTransfer::processConfView(const JsonView& payload) {
+    if (payload.get("status").equals("Accepted")) {
+        MO_DBG_DEBUG("Request has been accepted");
+    } else {
+        MO_DBG_INFO("Request has been denied");
+    }
+    return true;
+}
+
 void DataTransfer::processReq(JsonObject payload) {
     // Do nothing - we're just required to reject these DataTransfer requests
 }
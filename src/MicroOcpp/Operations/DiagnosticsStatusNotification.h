@@ -24,6 +24,8 @@ public:
 
     void processConf(JsonObject payload) override;
 
+    bool hasEmptyConf() override {return true;}
+
 };
 
 } //end namespace Ocpp16
@@ -25,6 +25,8 @@ public:
 
     void processConf(JsonObject payload) override;
 
+    bool hasEmptyConf() override {return true;}
+
 };
 
 } //end namespace Ocpp16
@@ -37,6 +37,21 @@ void Heartbeat::processConf(JsonObject payload) {
     }
 }
 
+bool Heartbeat::processConfView(const JsonView& payload) {
+    char currentTime [JSONDATE_LENGTH + 8];
+    if (!payload.get("currentTime").copyString(currentTime, sizeof(currentTime))) {
+        return false; //processConf() reports the error
+    }
+
+    if (model.getClock().setTime(currentTime)) {
+        //success
+        MO_DBG_DEBUG("Request has been accepted");
+    } else {
+        MO_DBG_WARN("Could not read time string. Expect format like 2020-02-01T20:53:32.486Z");
+    }
+    return true;
+}
+
 void Heartbeat::processReq(JsonObject payload) {
 
     /**
@@ -25,6 +25,8 @@ public:
 
     void processConf(JsonObject payload) override;
 
+    bool processConfView(const JsonView& payload) override;
+
     void processReq(JsonObject payload) override;
 
     std::unique_ptr<JsonDoc> createConf() override;
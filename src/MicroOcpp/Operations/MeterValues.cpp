@@ -5,6 +5,7 @@
 #include <MicroOcpp/Operations/MeterValues.h>
 #include <MicroOcpp/Model/Model.h>
 #include <MicroOcpp/Model/Metering/MeterValue.h>
+#include <MicroOcpp/Model/Metering/MeteringConnector.h>
 #include <MicroOcpp/Model/Transactions/Transaction.h>
 #include <MicroOcpp/Debug.h>
 
@@ -26,6 +27,11 @@ MeterValues::MeterValues(Model& model, std::unique_ptr<MeterValue> meterValue, u
     this->meterValueOwnership = std::move(meterValue);
 }
 
+MeterValues::MeterValues(Model& model, MeteringConnector& meteringConnector, MeterValue *meterValue, unsigned int connectorId, std::shared_ptr<Transaction> transaction)
+      : MeterValues(model, meterValue, connectorId, transaction) {
+    this->meteringConnector = &meteringConnector;
+}
+
 MeterValues::~MeterValues(){
 
 }
@@ -77,6 +83,10 @@ std::unique_ptr<JsonDoc> MeterValues::createReq() {
 
 void MeterValues::processConf(JsonObject payload) {
     MO_DBG_DEBUG("Request has been confirmed");
+
+    if (meteringConnector) {
+        meteringConnector->confirmMeterValue(meterValue);
+    }
 }
 
 
@@ -13,6 +13,7 @@ namespace MicroOcpp {
 
 class Model;
 class MeterValue;
+class MeteringConnector;
 class Transaction;
 
 namespace Ocpp16 {
@@ -22,6 +23,7 @@ private:
     Model& model; //for adjusting the timestamp if MeterValue has been created before BootNotification
     MeterValue *meterValue = nullptr;
     std::unique_ptr<MeterValue> meterValueOwnership;
+    MeteringConnector *meteringConnector = nullptr; //queue which holds meterValue. Drops it on confirmation
 
     unsigned int connectorId = 0;
 
@@ -30,6 +32,7 @@ private:
 public:
     MeterValues(Model& model, MeterValue *meterValue, unsigned int connectorId, std::shared_ptr<Transaction> transaction = nullptr);
     MeterValues(Model& model, std::unique_ptr<MeterValue> meterValue, unsigned int connectorId, std::shared_ptr<Transaction> transaction = nullptr);
+    MeterValues(Model& model, MeteringConnector& meteringConnector, MeterValue *meterValue, unsigned int connectorId, std::shared_ptr<Transaction> transaction = nullptr);
 
     MeterValues(Model& model); //for debugging only. Make this for the server pendant
 
@@ -41,6 +44,8 @@ public:
 
     void processConf(JsonObject payload) override;
 
+    bool hasEmptyConf() override {return true;}
+
     void processReq(JsonObject payload) override;
 
     std::unique_ptr<JsonDoc> createConf() override;
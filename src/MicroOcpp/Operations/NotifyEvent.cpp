@@ -0,0 +1,96 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Operations/NotifyEvent.h>
+#include <MicroOcpp/Debug.h>
+
+using MicroOcpp::Ocpp201::NotifyEvent;
+using MicroOcpp::JsonDoc;
+
+NotifyEvent::NotifyEvent(const Timestamp& generatedAt, bool tbc, int seqNo, Vector<MonitoringEvent>&& eventData)
+        : MemoryManaged("v201.Operation.", "NotifyEvent"), generatedAt(generatedAt), tbc(tbc), seqNo(seqNo), eventData(std::move(eventData)) {
+
+}
+
+const char* NotifyEvent::getOperationType() {
+    return "NotifyEvent";
+}
+
+std::unique_ptr<JsonDoc> NotifyEvent::createReq() {
+
+    size_t capacity =
+            JSON_OBJECT_SIZE(4) + //total of 4 fields
+            JSONDATE_LENGTH + 1; //timestamp string
+
+    capacity += JSON_ARRAY_SIZE(eventData.size());
+    for (const auto& event : eventData) {
+        capacity += JSON_OBJECT_SIZE(9); //total of 9 fields
+        capacity += JSONDATE_LENGTH + 1; //timestamp string
+        capacity += event.actualValue.length() + 1;
+        capacity += 2 * JSON_OBJECT_SIZE(2); //component composite
+        capacity += JSON_OBJECT_SIZE(1); //variable composite
+    }
+
+    auto doc = makeJsonDoc(getMemoryTag(), capacity);
+
+    JsonObject payload = doc->to<JsonObject>();
+
+    char generatedAtCstr [JSONDATE_LENGTH + 1];
+    generatedAt.toJsonString(generatedAtCstr, sizeof(generatedAtCstr));
+    payload["generatedAt"] = generatedAtCstr;
+
+    if (tbc) {
+        payload["tbc"] = true;
+    }
+
+    payload["seqNo"] = seqNo;
+
+    JsonArray eventDataJsonArray = payload.createNestedArray("eventData");
+
+    for (const auto& event : eventData) {
+        JsonObject eventDataJson = eventDataJsonArray.createNestedObject();
+
+        eventDataJson["eventId"] = event.eventId;
+
+        char timestampCstr [JSONDATE_LENGTH + 1];
+        event.timestamp.toJsonString(timestampCstr, sizeof(timestampCstr));
+        eventDataJson["timestamp"] = timestampCstr;
+
+        eventDataJson["trigger"] = event.trigger;
+        eventDataJson["actualValue"] = event.actualValue.c_str(); // zero-copy: eventData outlives the JSON doc
+
+        if (event.cleared) {
+            eventDataJson["cleared"] = true;
+        }
+
+        eventDataJson["variableMonitoringId"] = event.variableMonitoringId;
+        eventDataJson["eventNotificationType"] = "CustomMonitor";
+
+        auto variable = event.variable;
+
+        eventDataJson["component"]["name"] = variable->getComponentId().name; // zero-copy
+
+        if (variable->getComponentId().evse.id >= 0) {
+            eventDataJson["component"]["evse"]["id"] = variable->getComponentId().evse.id;
+        }
+
+        if (variable->getComponentId().evse.connectorId >= 0) {
+            eventDataJson["component"]["evse"]["connectorId"] = variable->getComponentId().evse.connectorId;
+        }
+
+        eventDataJson["variable"]["name"] = variable->getName(); // zero-copy
+    }
+
+    return doc;
+}
+
+void NotifyEvent::processConf(JsonObject payload) {
+    // empty payload
+}
+
+#endif // MO_ENABLE_V201
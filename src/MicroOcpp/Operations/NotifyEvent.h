@@ -0,0 +1,42 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_NOTIFYEVENT_H
+#define MO_NOTIFYEVENT_H
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Core/Operation.h>
+#include <MicroOcpp/Core/Time.h>
+#include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
+
+namespace MicroOcpp {
+namespace Ocpp201 {
+
+class NotifyEvent : public Operation, public MemoryManaged {
+private:
+    Timestamp generatedAt;
+    bool tbc;
+    int seqNo;
+    Vector<MonitoringEvent> eventData;
+public:
+
+    NotifyEvent(const Timestamp& generatedAt, bool tbc, int seqNo, Vector<MonitoringEvent>&& eventData);
+
+    const char* getOperationType() override;
+
+    std::unique_ptr<JsonDoc> createReq() override;
+
+    void processConf(JsonObject payload) override;
+
+    bool hasEmptyConf() override {return true;}
+};
+
+} //end namespace Ocpp201
+} //end namespace MicroOcpp
+#endif // MO_ENABLE_V201
+#endif
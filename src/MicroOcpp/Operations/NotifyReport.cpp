@@ -7,15 +7,81 @@
 #if MO_ENABLE_V201
 
 #include <MicroOcpp/Operations/NotifyReport.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/Request.h>
 #include <MicroOcpp/Model/Model.h>
 #include <MicroOcpp/Model/Variables/Variable.h>
+#include <MicroOcpp/Model/Variables/VariableService.h>
 #include <MicroOcpp/Debug.h>
 
 using namespace MicroOcpp::Ocpp201;
 using MicroOcpp::JsonDoc;
 
-NotifyReport::NotifyReport(Model& model, int requestId, const Timestamp& generatedAt, bool tbc, int seqNo, const Vector<Variable*>& reportData)
-        : MemoryManaged("v201.Operation.", "NotifyReport"), model(model), requestId(requestId), generatedAt(generatedAt), tbc(tbc), seqNo(seqNo), reportData(reportData) {
+#define VALUE_BUFSIZE 30 // for primitives (int)
+
+namespace MicroOcpp {
+namespace Ocpp201 {
+
+const Variable::AttributeType enumerateAttributeTypes [] = {
+    Variable::AttributeType::Actual,
+    Variable::AttributeType::Target,
+    Variable::AttributeType::MinSet,
+    Variable::AttributeType::MaxSet
+};
+
+//JSON capacity of one reportData entry
+size_t measureReportData(Variable *variable) {
+
+    size_t capacity = JSON_ARRAY_SIZE(1); //entry in reportData array
+    capacity += JSON_OBJECT_SIZE(4); //total of 4 fields
+    capacity += 2 * JSON_OBJECT_SIZE(2); //component composite
+    capacity += JSON_OBJECT_SIZE(1); //variable composite
+    capacity += strlen(variable->getComponentId().name) + 1; //component name, stored in copy-mode
+    capacity += strlen(variable->getName()) + 1; //variable name, stored in copy-mode
+
+    size_t nAttributes = 0;
+    size_t valueCapacity = 0;
+    for (auto attributeType : enumerateAttributeTypes) {
+        if (!variable->hasAttribute(attributeType)) {
+            continue;
+        }
+        nAttributes++;
+        switch (variable->getInternalDataType()) {
+            case Variable::InternalDataType::Int: {
+                // measure int size by printing to a dummy buf
+                char valbuf [VALUE_BUFSIZE];
+                auto ret = snprintf(valbuf, VALUE_BUFSIZE, "%i", variable->getInt());
+                if (ret < 0 || ret >= VALUE_BUFSIZE) {
+                    continue;
+                }
+                valueCapacity += (size_t) ret + 1;
+                break;
+            }
+            case Variable::InternalDataType::Bool:
+                // bool will be stored in zero-copy mode (string literal "true" or "false")
+                break;
+            case Variable::InternalDataType::String:
+                valueCapacity += strlen(variable->getString()) + 1; // TODO limit by ReportingValueSize
+                break;
+            default:
+                MO_DBG_ERR("internal error");
+                break;
+        }
+    }
+
+    capacity += nAttributes * JSON_OBJECT_SIZE(5); //variableAttribute composite
+    capacity += valueCapacity; //variableAttribute value total size
+
+    capacity += JSON_OBJECT_SIZE(2); //variableCharacteristics composite: only send two data fields
+
+    return capacity;
+}
+
+} //end namespace Ocpp201
+} //end namespace MicroOcpp
+
+NotifyReport::NotifyReport(Context& context, int requestId, const Timestamp& generatedAt, std::shared_ptr<Vector<Variable*>> reportData, int seqNo, size_t offset)
+        : MemoryManaged("v201.Operation.", "NotifyReport"), context(context), requestId(requestId), generatedAt(generatedAt), reportData(std::move(reportData)), seqNo(seqNo), offset(offset) {
 
 }
 
@@ -25,62 +91,25 @@ const char* NotifyReport::getOperationType() {
 
 std::unique_ptr<JsonDoc> NotifyReport::createReq() {
 
-    #define VALUE_BUFSIZE 30 // for primitives (int)
-
-    const Variable::AttributeType enumerateAttributeTypes [] = {
-        Variable::AttributeType::Actual,
-        Variable::AttributeType::Target,
-        Variable::AttributeType::MinSet,
-        Variable::AttributeType::MaxSet
-    };
-
     size_t capacity = 
             JSON_OBJECT_SIZE(5) + //total of 5 fields
             JSONDATE_LENGTH + 1; //timestamp string
 
-    capacity += JSON_ARRAY_SIZE(reportData.size());
-    for (auto variable : reportData) {
-        capacity += JSON_OBJECT_SIZE(4); //total of 4 fields
-        capacity += 2 * JSON_OBJECT_SIZE(2); //component composite
-        capacity += JSON_OBJECT_SIZE(1); //variable composite
+    //select the variables of this page, bounded by the page size and the max JSON capacity
+    offsetNext = offset;
 
-        size_t nAttributes = 0;
-        size_t valueCapacity = 0;
-        for (auto attributeType : enumerateAttributeTypes) {
-            if (!variable->hasAttribute(attributeType)) {
-                continue;
-            }
-            nAttributes++;
-            switch (variable->getInternalDataType()) {
-                case Variable::InternalDataType::Int: {
-                    // measure int size by printing to a dummy buf
-                    char valbuf [VALUE_BUFSIZE];
-                    auto ret = snprintf(valbuf, VALUE_BUFSIZE, "%i", variable->getInt());
-                    if (ret < 0 || ret >= VALUE_BUFSIZE) {
-                        continue;
-                    }
-                    valueCapacity = (size_t) ret + 1;
-                    break;
-                }
-                case Variable::InternalDataType::Bool:
-                    // bool will be stored in zero-copy mode (string literal "true" or "false")
-                    valueCapacity = 0;
-                    break;
-                case Variable::InternalDataType::String:
-                    valueCapacity = strlen(variable->getString()); // TODO limit by ReportingValueSize
-                    break;
-                default:
-                    MO_DBG_ERR("internal error");
-                    break;
-            }
+    while (offsetNext < reportData->size() && offsetNext - offset < MO_NOTIFYREPORT_PAGE_SIZE) {
+        size_t variableCapacity = measureReportData((*reportData)[offsetNext]);
+        if (offsetNext > offset && capacity + variableCapacity > MO_MAX_JSON_CAPACITY) {
+            break; //continue on next page
         }
 
-        capacity += nAttributes * JSON_OBJECT_SIZE(5); //variableAttribute composite
-        capacity += valueCapacity; //variableAttribute value total size
-
-        capacity += JSON_OBJECT_SIZE(2); //variableCharacteristics composite: only send two data fields
+        capacity += variableCapacity;
+        offsetNext++;
     }
 
+    bool tbc = offsetNext < reportData->size();
+
     auto doc = makeJsonDoc(getMemoryTag(), capacity);
 
     JsonObject payload = doc->to<JsonObject>();
@@ -98,7 +127,8 @@ std::unique_ptr<JsonDoc> NotifyReport::createReq() {
 
     JsonArray reportDataJsonArray = payload.createNestedArray("reportData");
 
-    for (auto variable : reportData) {
+    for (size_t i = offset; i < offsetNext; i++) {
+        auto variable = (*reportData)[i];
         JsonObject reportDataJson = reportDataJsonArray.createNestedObject();
 
         reportDataJson["component"]["name"] = (char*) variable->getComponentId().name; // force copy-mode
@@ -235,8 +265,26 @@ std::unique_ptr<JsonDoc> NotifyReport::createReq() {
     return doc;
 }
 
+void NotifyReport::initiateNextPage() {
+    if (offsetNext >= reportData->size()) {
+        return; //last page
+    }
+
+    //enqueue next page only after this page has been confirmed, so that the pages arrive in order
+    if (!context.initiateRequest(makeRequest(new NotifyReport(context, requestId, generatedAt, reportData, seqNo + 1, offsetNext)))) {
+        MO_DBG_ERR("could not enqueue NotifyReport page %i. Report %i incomplete", seqNo + 1, requestId);
+    }
+}
+
 void NotifyReport::processConf(JsonObject payload) {
     // empty payload
+    initiateNextPage();
+}
+
+bool NotifyReport::processConfView(const JsonView& payload) {
+    //empty payload
+    initiateNextPage();
+    return true;
 }
 
 #endif // MO_ENABLE_V201
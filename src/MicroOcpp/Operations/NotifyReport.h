@@ -12,32 +12,47 @@
 #include <MicroOcpp/Core/Operation.h>
 #include <MicroOcpp/Core/Time.h>
 #include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Model/Variables/Variable.h>
+
+#ifndef MO_NOTIFYREPORT_PAGE_SIZE
+#define MO_NOTIFYREPORT_PAGE_SIZE 20 //max number of reportData entries per NotifyReport message
+#endif
 
 namespace MicroOcpp {
 
-class Model;
-class Variable;
+class Context;
 
 namespace Ocpp201 {
 
+/*
+ * One page of a report. GetBaseReport takes a snapshot of the selected Variables which all pages share, so
+ * that changes of the device model during the report don't shift the pages. The page serializes its entries
+ * when it's about to be sent, starting at offset. If further Variables follow, the page sets tbc and
+ * enqueues the next page when the CSMS has confirmed it. Only one page is serialized at a time
+ */
 class NotifyReport : public Operation, public MemoryManaged {
 private:
-    Model& model;
+    Context& context;
 
     int requestId;
     Timestamp generatedAt;
-    bool tbc;
+    std::shared_ptr<Vector<Variable*>> reportData;
     int seqNo;
-    Vector<Variable*> reportData;
+    size_t offset;
+    size_t offsetNext = 0; //start of the next page, determined by createReq()
+
+    void initiateNextPage();
 public:
 
-    NotifyReport(Model& model, int requestId, const Timestamp& generatedAt, bool tbc, int seqNo, const Vector<Variable*>& reportData);
+    NotifyReport(Context& context, int requestId, const Timestamp& generatedAt, std::shared_ptr<Vector<Variable*>> reportData, int seqNo = 0, size_t offset = 0);
 
     const char* getOperationType() override;
 
     std::unique_ptr<JsonDoc> createReq() override;
 
     void processConf(JsonObject payload) override;
+
+    bool processConfView(const JsonView& payload) override;
 };
 
 } //end namespace Ocpp201
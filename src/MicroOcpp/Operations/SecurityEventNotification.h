@@ -32,6 +32,8 @@ public:
 
     void processConf(JsonObject payload) override;
 
+    bool hasEmptyConf() override {return true;}
+
     const char *getErrorCode() override {return errorCode;}
 
     void processReq(JsonObject payload) override;
@@ -0,0 +1,205 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Operations/SetVariableMonitoring.h>
+#include <MicroOcpp/Debug.h>
+
+using MicroOcpp::Ocpp201::SetMonitoringData;
+using MicroOcpp::Ocpp201::SetVariableMonitoring;
+using MicroOcpp::JsonDoc;
+
+namespace MicroOcpp {
+
+const char *serializeMonitorType(VariableMonitor::Type type) {
+    switch (type) {
+        case VariableMonitor::Type::UpperThreshold:
+            return "UpperThreshold";
+        case VariableMonitor::Type::LowerThreshold:
+            return "LowerThreshold";
+        case VariableMonitor::Type::Delta:
+            return "Delta";
+        case VariableMonitor::Type::Periodic:
+            return "Periodic";
+        case VariableMonitor::Type::PeriodicClockAligned:
+            return "PeriodicClockAligned";
+    }
+    MO_DBG_ERR("internal error");
+    return "";
+}
+
+bool deserializeMonitorType(const char *typeCstr, VariableMonitor::Type& out) {
+    if (!strcmp(typeCstr, "UpperThreshold")) {
+        out = VariableMonitor::Type::UpperThreshold;
+    } else if (!strcmp(typeCstr, "LowerThreshold")) {
+        out = VariableMonitor::Type::LowerThreshold;
+    } else if (!strcmp(typeCstr, "Delta")) {
+        out = VariableMonitor::Type::Delta;
+    } else if (!strcmp(typeCstr, "Periodic")) {
+        out = VariableMonitor::Type::Periodic;
+    } else if (!strcmp(typeCstr, "PeriodicClockAligned")) {
+        out = VariableMonitor::Type::PeriodicClockAligned;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} //namespace MicroOcpp
+
+SetMonitoringData::SetMonitoringData(const char *memory_tag) : componentName{makeString(memory_tag)}, variableName{makeString(memory_tag)} {
+
+}
+
+SetVariableMonitoring::SetVariableMonitoring(MonitoringService& monitoringService) : MemoryManaged("v201.Operation.", "SetVariableMonitoring"), monitoringService(monitoringService), queries(makeVector<SetMonitoringData>(getMemoryTag())) {
+
+}
+
+const char* SetVariableMonitoring::getOperationType(){
+    return "SetVariableMonitoring";
+}
+
+void SetVariableMonitoring::processReq(JsonObject payload) {
+    for (JsonObject setMonitoring : payload["setMonitoringData"].as<JsonArray>()) {
+
+        queries.emplace_back(getMemoryTag());
+        auto& data = queries.back();
+
+        data.id = setMonitoring["id"] | -1;
+        data.transaction = setMonitoring["transaction"] | false;
+
+        if (!setMonitoring["value"].is<float>()) {
+            errorCode = "FormationViolation";
+            MO_DBG_ERR("missing value");
+            return;
+        }
+        data.value = setMonitoring["value"];
+
+        if (!deserializeMonitorType(setMonitoring["type"] | "_Undefined", data.type)) {
+            errorCode = "FormationViolation";
+            MO_DBG_ERR("invalid type");
+            return;
+        }
+
+        data.severity = setMonitoring["severity"] | -1;
+        if (data.severity < 0 || data.severity > 9) {
+            errorCode = "FormationViolation";
+            MO_DBG_ERR("invalid severity");
+            return;
+        }
+
+        const char *componentNameCstr = setMonitoring["component"]["name"] | (const char*) nullptr;
+        const char *variableNameCstr = setMonitoring["variable"]["name"] | (const char*) nullptr;
+
+        if (!componentNameCstr ||
+                !variableNameCstr) {
+            errorCode = "FormationViolation";
+            return;
+        }
+
+        data.componentName = componentNameCstr;
+        data.variableName = variableNameCstr;
+
+        data.componentEvseId = setMonitoring["component"]["evse"]["id"] | -1;
+        data.componentEvseConnectorId = setMonitoring["component"]["evse"]["connectorId"] | -1;
+
+        if (setMonitoring["component"].containsKey("evse") && data.componentEvseId < 0) {
+            errorCode = "FormationViolation";
+            MO_DBG_ERR("malformatted / missing evseId");
+            return;
+        }
+    }
+
+    if (queries.empty()) {
+        errorCode = "FormationViolation";
+        return;
+    }
+
+    MO_DBG_DEBUG("processing %zu setMonitoring queries", queries.size());
+
+    for (auto& query : queries) {
+        query.status = monitoringService.setMonitor(
+                query.id,
+                query.transaction,
+                query.value,
+                query.type,
+                query.severity,
+                ComponentId(query.componentName.c_str(),
+                    EvseId(query.componentEvseId, query.componentEvseConnectorId)),
+                query.variableName.c_str());
+    }
+}
+
+std::unique_ptr<JsonDoc> SetVariableMonitoring::createConf(){
+    size_t capacity = JSON_ARRAY_SIZE(queries.size());
+    for (const auto& data : queries) {
+        capacity +=
+            JSON_OBJECT_SIZE(6) + // setMonitoringResult
+                JSON_OBJECT_SIZE(2) + // component
+                    data.componentName.length() + 1 +
+                    JSON_OBJECT_SIZE(2) + // evse
+                JSON_OBJECT_SIZE(1) + // variable
+                    data.variableName.length() + 1;
+    }
+    auto doc = makeJsonDoc(getMemoryTag(), capacity);
+
+    JsonObject payload = doc->to<JsonObject>();
+    JsonArray setMonitoringResult = payload.createNestedArray("setMonitoringResult");
+
+    for (const auto& data : queries) {
+        JsonObject setMonitoring = setMonitoringResult.createNestedObject();
+
+        if (data.status == SetMonitoringStatus::Accepted) {
+            setMonitoring["id"] = data.id;
+        }
+
+        const char *statusCstr = "Rejected";
+        switch (data.status) {
+            case SetMonitoringStatus::Accepted:
+                statusCstr = "Accepted";
+                break;
+            case SetMonitoringStatus::UnknownComponent:
+                statusCstr = "UnknownComponent";
+                break;
+            case SetMonitoringStatus::UnknownVariable:
+                statusCstr = "UnknownVariable";
+                break;
+            case SetMonitoringStatus::UnsupportedMonitorType:
+                statusCstr = "UnsupportedMonitorType";
+                break;
+            case SetMonitoringStatus::Rejected:
+                statusCstr = "Rejected";
+                break;
+            case SetMonitoringStatus::Duplicate:
+                statusCstr = "Duplicate";
+                break;
+            default:
+                MO_DBG_ERR("internal error");
+                break;
+        }
+        setMonitoring["status"] = statusCstr;
+
+        setMonitoring["type"] = serializeMonitorType(data.type);
+        setMonitoring["severity"] = data.severity;
+
+        setMonitoring["component"]["name"] = (char*) data.componentName.c_str(); // force copy-mode
+
+        if (data.componentEvseId >= 0) {
+            setMonitoring["component"]["evse"]["id"] = data.componentEvseId;
+        }
+
+        if (data.componentEvseConnectorId >= 0) {
+            setMonitoring["component"]["evse"]["connectorId"] = data.componentEvseConnectorId;
+        }
+
+        setMonitoring["variable"]["name"] = (char*) data.variableName.c_str(); // force copy-mode
+    }
+
+    return doc;
+}
+
+#endif // MO_ENABLE_V201
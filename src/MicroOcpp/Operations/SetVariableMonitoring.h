@@ -0,0 +1,63 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_SETVARIABLEMONITORING_H
+#define MO_SETVARIABLEMONITORING_H
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp/Core/Operation.h>
+#include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
+
+namespace MicroOcpp {
+namespace Ocpp201 {
+
+// SetMonitoringDataType (2.42) and
+// SetMonitoringResultType (2.43)
+struct SetMonitoringData {
+    // SetMonitoringDataType
+    int id = -1;
+    bool transaction = false;
+    float value = 0.f;
+    VariableMonitor::Type type = VariableMonitor::Type::UpperThreshold;
+    int severity = 0;
+    String componentName;
+    int componentEvseId = -1;
+    int componentEvseConnectorId = -1;
+    String variableName;
+
+    // SetMonitoringResultType
+    SetMonitoringStatus status;
+
+    SetMonitoringData(const char *memory_tag = nullptr);
+};
+
+class SetVariableMonitoring : public Operation, public MemoryManaged {
+private:
+    MonitoringService& monitoringService;
+    Vector<SetMonitoringData> queries;
+
+    const char *errorCode = nullptr;
+public:
+    SetVariableMonitoring(MonitoringService& monitoringService);
+
+    const char* getOperationType() override;
+
+    void processReq(JsonObject payload) override;
+
+    std::unique_ptr<JsonDoc> createConf() override;
+
+    const char *getErrorCode() override {return errorCode;}
+
+};
+
+} //namespace Ocpp201
+} //namespace MicroOcpp
+
+#endif //MO_ENABLE_V201
+
+#endif
@@ -32,6 +32,8 @@ public:
 
     void processConf(JsonObject payload) override;
 
+    bool hasEmptyConf() override {return true;}
+
     void processReq(JsonObject payload) override;
 
     std::unique_ptr<JsonDoc> createConf() override;
@@ -64,6 +66,8 @@ public:
     std::unique_ptr<JsonDoc> createReq() override;
 
     void processConf(JsonObject payload) override;
+
+    bool hasEmptyConf() override {return true;}
 };
 
 } // namespace Ocpp201
@@ -41,6 +41,20 @@ unsigned long mocpp_tick_ms_custom() {
         return 0;
     }
 }
+
+unsigned long (*mocpp_tick_us_impl)() = nullptr;
+
+void mocpp_set_timer_us(unsigned long (*get_us)()) {
+    mocpp_tick_us_impl = get_us;
+}
+
+unsigned long mocpp_tick_us_custom() {
+    if (mocpp_tick_us_impl) {
+        return mocpp_tick_us_impl();
+    } else {
+        return mocpp_tick_ms_custom() * 1000UL;
+    }
+}
 #else
 
 #if MO_PLATFORM == MO_PLATFORM_ESPIDF
@@ -61,6 +75,12 @@ unsigned long mocpp_tick_ms_espidf() {
     return MicroOcpp::mocpp_millis_count;
 }
 
+#include "esp_timer.h"
+
+unsigned long mocpp_tick_us_espidf() {
+    return (unsigned long) esp_timer_get_time();
+}
+
 #elif MO_PLATFORM == MO_PLATFORM_UNIX
 #include <chrono>
 
@@ -80,6 +100,16 @@ unsigned long mocpp_tick_ms_unix() {
         std::chrono::steady_clock::now() - MicroOcpp::clock_reference);
     return (unsigned long) ms.count();
 }
+
+unsigned long mocpp_tick_us_unix() {
+    if (!MicroOcpp::clock_initialized) {
+        MicroOcpp::clock_reference = std::chrono::steady_clock::now();
+        MicroOcpp::clock_initialized = true;
+    }
+    std::chrono::microseconds us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - MicroOcpp::clock_reference);
+    return (unsigned long) us.count();
+}
 #endif
 #endif
 
@@ -99,6 +99,29 @@ MO_EXTERN_C unsigned long mocpp_tick_ms_unix();
 #endif
 #endif
 
+/*
+ * Microsecond timer for performance measurements (e.g. metrics, loop budget). It's not used for the OCPP
+ * timing logic and may wrap around. With a custom timer, it falls back to the ms timer unless set separately
+ */
+#ifdef MO_CUSTOM_TIMER
+MO_EXTERN_C void mocpp_set_timer_us(unsigned long (*get_us)());
+
+MO_EXTERN_C unsigned long mocpp_tick_us_custom();
+#define mocpp_tick_us mocpp_tick_us_custom
+#else
+
+#if MO_PLATFORM == MO_PLATFORM_ARDUINO
+#include <Arduino.h>
+#define mocpp_tick_us micros
+#elif MO_PLATFORM == MO_PLATFORM_ESPIDF
+MO_EXTERN_C unsigned long mocpp_tick_us_espidf();
+#define mocpp_tick_us mocpp_tick_us_espidf
+#elif MO_PLATFORM == MO_PLATFORM_UNIX
+MO_EXTERN_C unsigned long mocpp_tick_us_unix();
+#define mocpp_tick_us mocpp_tick_us_unix
+#endif
+#endif
+
 #ifdef MO_CUSTOM_RNG
 MO_EXTERN_C void mocpp_set_rng(uint32_t (*rng)());
 MO_EXTERN_C uint32_t mocpp_rng_custom();
@@ -0,0 +1,76 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#ifndef MO_PROFILE_H
+#define MO_PROFILE_H
+
+/*
+ * Build profiles: presets for the capacities and optional features of the library. Select a profile with the
+ * build flag MO_PROFILE, e.g. -D MO_PROFILE=MO_PROFILE_SMALL. Build flags which are set individually take
+ * precedence over the profile.
+ *
+ * MO_PROFILE_DEFAULT: no presets; every module uses its own defaults
+ * MO_PROFILE_SMALL: small fixed capacities for single-connector or dual-connector chargers on small MCUs.
+ *     The number of request queues is derived from MO_NUMCONNECTORS. ChargingSchedulePeriods are stored inline
+ *     (8 periods, 96 bytes per schedule). Reservations and the Local Authorization List are compiled out
+ */
+
+#define MO_PROFILE_DEFAULT 0
+#define MO_PROFILE_SMALL   1
+
+#ifndef MO_PROFILE
+#define MO_PROFILE MO_PROFILE_DEFAULT
+#endif
+
+#if MO_PROFILE == MO_PROFILE_SMALL
+
+#ifndef MO_REQUEST_CACHE_MAXSIZE
+#define MO_REQUEST_CACHE_MAXSIZE 4
+#endif
+
+#ifndef MO_NUM_REQUEST_QUEUES
+//default queue, PreBoot queue, one Connector and one MeteringConnector per connector (incl. connector 0), v201 TransactionService
+#if defined(MO_NUMCONNECTORS)
+#define MO_PROFILE_NUMCONNECTORS MO_NUMCONNECTORS
+#else
+#define MO_PROFILE_NUMCONNECTORS 2
+#endif
+#if MO_ENABLE_V201
+#define MO_NUM_REQUEST_QUEUES (2 + 2 * MO_PROFILE_NUMCONNECTORS + 1)
+#else
+#define MO_NUM_REQUEST_QUEUES (2 + 2 * MO_PROFILE_NUMCONNECTORS)
+#endif
+#endif
+
+#ifndef MO_METERVALUES_CACHE_MAXSIZE
+#define MO_METERVALUES_CACHE_MAXSIZE 4
+#endif
+
+#ifndef MO_ChargeProfileMaxStackLevel
+#define MO_ChargeProfileMaxStackLevel 2
+#endif
+
+#ifndef MO_ChargingScheduleMaxPeriods
+#define MO_ChargingScheduleMaxPeriods 8
+#endif
+
+#ifndef MO_MaxChargingProfilesInstalled
+#define MO_MaxChargingProfilesInstalled 4
+#endif
+
+#ifndef MO_ENABLE_INLINE_SCHEDULE_PERIODS
+#define MO_ENABLE_INLINE_SCHEDULE_PERIODS 1
+#endif
+
+#ifndef MO_ENABLE_RESERVATION
+#define MO_ENABLE_RESERVATION 0
+#endif
+
+#ifndef MO_ENABLE_LOCAL_AUTH
+#define MO_ENABLE_LOCAL_AUTH 0
+#endif
+
+#endif //MO_PROFILE == MO_PROFILE_SMALL
+
+#endif
@@ -5,6 +5,8 @@
 #ifndef MO_VERSION_H
 #define MO_VERSION_H
 
+#include <MicroOcpp/Profile.h>
+
 /*
  * Version specification of MicroOcpp library (not related with the OCPP version)
  */
@@ -357,6 +357,21 @@ void ocpp_addMeterValueInput_m(unsigned int connectorId, MeterValueInput *meterV
 }
 
 
+#if MO_ENABLE_METER_AGGREGATION
+OCPP_MeterSampleRing *ocpp_addMeterValueAggregatedInput(MeterAggregation aggregation, const char *measurand, const char *unit, const char *location, const char *phase) {
+    return ocpp_addMeterValueAggregatedInput_m(1, aggregation, measurand, unit, location, phase);
+}
+OCPP_MeterSampleRing *ocpp_addMeterValueAggregatedInput_m(unsigned int connectorId, MeterAggregation aggregation, const char *measurand, const char *unit, const char *location, const char *phase) {
+    return reinterpret_cast<OCPP_MeterSampleRing*>(addMeterValueAggregatedInput(aggregation, measurand, unit, location, phase, connectorId));
+}
+bool ocpp_pushMeterSample(OCPP_MeterSampleRing *ring, float value) {
+    if (!ring) {
+        return false;
+    }
+    return reinterpret_cast<MicroOcpp::MeterSampleRing*>(ring)->push(value);
+}
+#endif //MO_ENABLE_METER_AGGREGATION
+
 #if MO_ENABLE_CONNECTOR_LOCK
 void ocpp_setOnUnlockConnectorInOut(PollUnlockResult onUnlockConnectorInOut) {
     setOnUnlockConnectorInOut(adaptFn(onUnlockConnectorInOut));
@@ -380,6 +395,55 @@ void ocpp_setStopTxReadyInput_m(unsigned int connectorId, InputBool_m stopTxRead
     setStopTxReadyInput(adaptFn(connectorId, stopTxReady), connectorId);
 }
 
+void ocpp_notifyPlugged(bool plugged) {
+    notifyPlugged(plugged);
+}
+void ocpp_notifyPlugged_m(unsigned int connectorId, bool plugged) {
+    notifyPlugged(plugged, connectorId);
+}
+
+void ocpp_notifyEvReady(bool evReady) {
+    notifyEvReady(evReady);
+}
+void ocpp_notifyEvReady_m(unsigned int connectorId, bool evReady) {
+    notifyEvReady(evReady, connectorId);
+}
+
+void ocpp_notifyEvseReady(bool evseReady) {
+    notifyEvseReady(evseReady);
+}
+void ocpp_notifyEvseReady_m(unsigned int connectorId, bool evseReady) {
+    notifyEvseReady(evseReady, connectorId);
+}
+
+void ocpp_notifyOccupied(bool occupied) {
+    notifyOccupied(occupied);
+}
+void ocpp_notifyOccupied_m(unsigned int connectorId, bool occupied) {
+    notifyOccupied(occupied, connectorId);
+}
+
+void ocpp_notifyStartTxReady(bool startTxReady) {
+    notifyStartTxReady(startTxReady);
+}
+void ocpp_notifyStartTxReady_m(unsigned int connectorId, bool startTxReady) {
+    notifyStartTxReady(startTxReady, connectorId);
+}
+
+void ocpp_notifyStopTxReady(bool stopTxReady) {
+    notifyStopTxReady(stopTxReady);
+}
+void ocpp_notifyStopTxReady_m(unsigned int connectorId, bool stopTxReady) {
+    notifyStopTxReady(stopTxReady, connectorId);
+}
+
+void ocpp_notifyErrorCode(const char *errorCode) {
+    notifyErrorCode(errorCode);
+}
+void ocpp_notifyErrorCode_m(unsigned int connectorId, const char *errorCode) {
+    notifyErrorCode(errorCode, connectorId);
+}
+
 void ocpp_setTxNotificationOutput(void (*notificationOutput)(OCPP_Transaction*, TxNotification)) {
     setTxNotificationOutput([notificationOutput] (MicroOcpp::Transaction *tx, TxNotification notification) {
         notificationOutput(reinterpret_cast<OCPP_Transaction*>(tx), notification);
@@ -13,6 +13,7 @@
 #include <MicroOcpp/Model/Transactions/Transaction.h>
 #include <MicroOcpp/Model/Certificates/Certificate_c.h>
 #include <MicroOcpp/Model/Metering/ReadingContext.h>
+#include <MicroOcpp/Model/Metering/MeterSampleAggregator.h>
 
 struct OCPP_Connection;
 typedef struct OCPP_Connection OCPP_Connection;
@@ -20,6 +21,9 @@ typedef struct OCPP_Connection OCPP_Connection;
 struct MeterValueInput;
 typedef struct MeterValueInput MeterValueInput;
 
+struct OCPP_MeterSampleRing;
+typedef struct OCPP_MeterSampleRing OCPP_MeterSampleRing;
+
 struct FilesystemAdapterC;
 typedef struct FilesystemAdapterC FilesystemAdapterC;
 
@@ -165,6 +169,13 @@ void ocpp_addMeterValueInputIntTx_m(unsigned int connectorId, int (*valueInput)(
 void ocpp_addMeterValueInput(MeterValueInput *meterValueInput); //takes ownership of meterValueInput
 void ocpp_addMeterValueInput_m(unsigned int connectorId, MeterValueInput *meterValueInput); //takes ownership of meterValueInput
 
+#if MO_ENABLE_METER_AGGREGATION
+//High-rate metering Input, see MicroOcpp.h. Push samples with ocpp_pushMeterSample() from one sampling thread or ISR
+OCPP_MeterSampleRing *ocpp_addMeterValueAggregatedInput(MeterAggregation aggregation, const char *measurand, const char *unit, const char *location, const char *phase); //unit, location and phase can be NULL
+OCPP_MeterSampleRing *ocpp_addMeterValueAggregatedInput_m(unsigned int connectorId, MeterAggregation aggregation, const char *measurand, const char *unit, const char *location, const char *phase);
+bool ocpp_pushMeterSample(OCPP_MeterSampleRing *ring, float value); //returns false if the ring is full
+#endif //MO_ENABLE_METER_AGGREGATION
+
 void ocpp_setOccupiedInput(InputBool occupied);
 void ocpp_setOccupiedInput_m(unsigned int connectorId, InputBool_m occupied);
 
@@ -174,6 +185,31 @@ void ocpp_setStartTxReadyInput_m(unsigned int connectorId, InputBool_m startTxRe
 void ocpp_setStopTxReadyInput(InputBool stopTxReady);
 void ocpp_setStopTxReadyInput_m(unsigned int connectorId, InputBool_m stopTxReady);
 
+/*
+ * Push-based alternative to the Inputs above (OCPP 1.6 only). See MicroOcpp.h
+ */
+
+void ocpp_notifyPlugged(bool plugged);
+void ocpp_notifyPlugged_m(unsigned int connectorId, bool plugged);
+
+void ocpp_notifyEvReady(bool evReady);
+void ocpp_notifyEvReady_m(unsigned int connectorId, bool evReady);
+
+void ocpp_notifyEvseReady(bool evseReady);
+void ocpp_notifyEvseReady_m(unsigned int connectorId, bool evseReady);
+
+void ocpp_notifyOccupied(bool occupied);
+void ocpp_notifyOccupied_m(unsigned int connectorId, bool occupied);
+
+void ocpp_notifyStartTxReady(bool startTxReady);
+void ocpp_notifyStartTxReady_m(unsigned int connectorId, bool startTxReady);
+
+void ocpp_notifyStopTxReady(bool stopTxReady);
+void ocpp_notifyStopTxReady_m(unsigned int connectorId, bool stopTxReady);
+
+void ocpp_notifyErrorCode(const char *errorCode); //NULL clears the error. The string must stay valid until cleared
+void ocpp_notifyErrorCode_m(unsigned int connectorId, const char *errorCode);
+
 void ocpp_setTxNotificationOutput(void (*notificationOutput)(OCPP_Transaction*, TxNotification));
 void ocpp_setTxNotificationOutput_m(unsigned int connectorId, void (*notificationOutput)(unsigned int, OCPP_Transaction*, TxNotification));
 
@@ -427,6 +427,91 @@ TEST_CASE( "Boot Behavior" ) {
         REQUIRE( !strcmp(declareConfiguration<const char*>("neverDeclaredInsideMO", "newVal")->getString(), "newVal") ); //config has been removed
     }
 
+    SECTION("Heartbeat suppression") {
+
+        declareConfiguration<bool>(MO_CONFIG_EXT_PREFIX "HeartbeatSuppression", false)->setBool(true);
+
+        getOcppContext()->getOperationRegistry().registerOperation("BootNotification",
+            [] () {
+                return new Ocpp16::CustomOperation("BootNotification",
+                    [] (JsonObject payload) {
+                        //ignore req
+                    },
+                    [] () {
+                        //create conf
+                        auto conf = makeJsonDoc(UNIT_MEM_TAG, 1024);
+                        (*conf)["currentTime"] = BASE_TIME;
+                        (*conf)["interval"] = 3600;
+                        (*conf)["status"] = "Accepted";
+                        return conf;
+                    });
+            });
+
+        unsigned int nHeartbeats = 0;
+
+        getOcppContext()->getOperationRegistry().setOnRequest("Heartbeat",
+            [&nHeartbeats] (JsonObject) {
+                nHeartbeats++;
+            });
+
+        loop();
+
+        REQUIRE( getOcppContext()->getModel().getClock().now() >= MIN_TIME );
+
+        //other messages within the HeartbeatInterval replace the Heartbeat
+        mtime += 3000 * 1000;
+        loopback.sendTXT(GET_CONFIGURATION, sizeof(GET_CONFIGURATION) - 1);
+        loop();
+
+        mtime += 700 * 1000;
+        loop();
+
+        REQUIRE( nHeartbeats == 0 );
+
+        //no traffic and the connection doesn't support pings
+        mtime += 3600 * 1000;
+        loop();
+
+        REQUIRE( nHeartbeats == 1 );
+
+        //clock synchronization requires a Heartbeat at least once per day
+        nHeartbeats = 0;
+        for (unsigned long i = 0; i < 86400 / 1800 + 2; i++) {
+            mtime += 1800 * 1000;
+            loopback.sendTXT(GET_CONFIGURATION, sizeof(GET_CONFIGURATION) - 1);
+            loop();
+        }
+
+        REQUIRE( nHeartbeats == 1 );
+    }
+
+    SECTION("BootNotification timeout while offline") {
+
+        unsigned int nBootNotifications = 0;
+
+        getOcppContext()->getOperationRegistry().setOnRequest("BootNotification",
+            [&nBootNotifications] (JsonObject) {
+                nBootNotifications++;
+            });
+
+        loopback.setConnected( false );
+
+        //BootService retries every 60s. Each BootNotification times out when the next one is queued
+        for (unsigned int i = 0; i < 5; i++) {
+            loop();
+            mtime += MO_BOOT_INTERVAL_DEFAULT * 1000UL;
+        }
+
+        loop();
+
+        loopback.setConnected( true );
+
+        loop();
+
+        REQUIRE( nBootNotifications == 1 );
+        REQUIRE( isOperative() );
+    }
+
     SECTION("Boot with v201") {
 
         mocpp_deinitialize();
@@ -252,6 +252,59 @@ TEST_CASE( "M - Certificates" ) {
         REQUIRE( checkProcessed );
     }
 
+#if MO_ENABLE_CERT_STORE_INDEX
+    SECTION("Cert hash index") {
+        auto ret = certs->installCertificate(InstallCertificateType_CSMSRootCertificate, root_cert);
+        REQUIRE(ret == InstallCertificateStatus_Accepted);
+
+        size_t msize;
+        REQUIRE(filesystem->stat(MO_FILENAME_PREFIX MO_CERT_FN_PREFIX MO_CERT_FN_INDEX, &msize) == 0);
+
+        char fn [MO_MAX_PATH_SIZE];
+        printCertFn(MO_CERT_FN_CSMS_ROOT, 0, fn, MO_MAX_PATH_SIZE);
+
+        //replace cert with unparsable content of the same size. The store uses the index and doesn't parse the cert again
+        auto garbage = makeString("UnitTests");
+        garbage.append(strlen(root_cert), 'x');
+        {
+            auto file = filesystem->open(fn, "w");
+            REQUIRE(file);
+            REQUIRE(file->write(garbage.c_str(), garbage.length()) == garbage.length());
+        }
+
+        //index survives reboots
+        mocpp_deinitialize();
+        mocpp_initialize(loopback, ChargerCredentials("test-runner"));
+        certs = getOcppContext()->getModel().getCertificateService()->getCertificateStore();
+
+        auto chain = makeVector<CertificateChainHash>("UnitTests");
+        REQUIRE(certs->getCertificateIds({GetCertificateIdType_CSMSRootCertificate}, chain) == GetInstalledCertificateStatus_Accepted);
+        REQUIRE(chain.size() == 1);
+
+        char buf [MO_CERT_HASH_ISSUER_NAME_KEY_SIZE];
+        ocpp_cert_print_issuerNameHash(&chain.front().certificateHashData, buf, sizeof(buf));
+        REQUIRE(!strcmp(buf, root_cert_hash_issuer_name));
+
+        //size mismatch invalidates the index entry
+        garbage.append("x");
+        {
+            auto file = filesystem->open(fn, "w");
+            REQUIRE(file);
+            REQUIRE(file->write(garbage.c_str(), garbage.length()) == garbage.length());
+        }
+
+        REQUIRE(certs->getCertificateIds({GetCertificateIdType_CSMSRootCertificate}, chain) == GetInstalledCertificateStatus_NotFound);
+
+        //reinstall and delete via index
+        filesystem->remove(fn);
+        REQUIRE(certs->installCertificate(InstallCertificateType_CSMSRootCertificate, root_cert) == InstallCertificateStatus_Accepted);
+        REQUIRE(certs->getCertificateIds({GetCertificateIdType_CSMSRootCertificate}, chain) == GetInstalledCertificateStatus_Accepted);
+        REQUIRE(chain.size() == 1);
+        REQUIRE(certs->deleteCertificate(chain.front().certificateHashData) == DeleteCertificateStatus_Accepted);
+        REQUIRE(certs->getCertificateIds({GetCertificateIdType_CSMSRootCertificate}, chain) == GetInstalledCertificateStatus_NotFound);
+    }
+#endif //MO_ENABLE_CERT_STORE_INDEX
+
     mocpp_deinitialize();
 }
 
@@ -1230,6 +1230,94 @@ TEST_CASE( "Charging sessions" ) {
         REQUIRE( checkProcessed );
     }
 
+    SECTION("Push-based Inputs") {
+
+        mocpp_deinitialize();
+
+        mocpp_initialize(loopback, ChargerCredentials());
+
+        bool checkProcessed = false;
+        const char *checkStatus = "";
+        const char *checkErrorCode = "NoError";
+
+        getOcppContext()->getOperationRegistry().setOnRequest("StatusNotification",
+            [&checkProcessed, &checkStatus, &checkErrorCode] (JsonObject payload) {
+                //process req
+                if (payload["connectorId"].as<int>() == 1) {
+                    checkProcessed = true;
+                    REQUIRE( !strcmp(payload["status"] | "_Undefined", checkStatus) );
+                    REQUIRE( !strcmp(payload["errorCode"] | "_Undefined", checkErrorCode) );
+                }
+            });
+
+        checkStatus = "Available";
+        loop();
+        REQUIRE( checkProcessed );
+
+        checkStatus = "Preparing";
+        checkProcessed = false;
+        notifyPlugged(true);
+        loop();
+        REQUIRE( checkProcessed );
+
+        //pushed value takes precedence over the polled Input
+        setConnectorPluggedInput([] () {return false;});
+        notifyPlugged(true);
+        checkProcessed = false;
+        loop();
+        REQUIRE( !checkProcessed );
+
+        checkStatus = "Charging";
+        checkProcessed = false;
+        beginTransaction("mIdTag");
+        loop();
+        REQUIRE( checkProcessed );
+        REQUIRE( isTransactionRunning() );
+
+        checkStatus = "SuspendedEV";
+        checkProcessed = false;
+        notifyEvReady(false);
+        loop();
+        REQUIRE( checkProcessed );
+
+        checkStatus = "Charging";
+        checkProcessed = false;
+        notifyEvReady(true);
+        loop();
+        REQUIRE( checkProcessed );
+
+        checkStatus = "Faulted";
+        checkErrorCode = "GroundFailure";
+        checkProcessed = false;
+        notifyErrorCode("GroundFailure");
+        loop();
+        REQUIRE( checkProcessed );
+
+        checkStatus = "Charging";
+        checkErrorCode = "NoError";
+        checkProcessed = false;
+        notifyErrorCode(nullptr);
+        loop();
+        REQUIRE( checkProcessed );
+
+        //stopTxReady delays StopTx
+        checkStatus = "SuspendedEVSE";
+        checkProcessed = false;
+        notifyStopTxReady(false);
+        endTransaction();
+        loop();
+        REQUIRE( isTransactionRunning() );
+        REQUIRE( checkProcessed );
+
+        checkStatus = "Available";
+        checkProcessed = false;
+        notifyStopTxReady(true);
+        notifyPlugged(false);
+        loop();
+        REQUIRE( !isTransactionRunning() );
+        REQUIRE( checkProcessed );
+    }
+
     SECTION("No filesystem access behavior") {
 
         //re-init without filesystem access
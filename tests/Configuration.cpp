@@ -28,6 +28,22 @@ using namespace MicroOcpp;
 #define UNKOWN_KEY "__UnknownKey"
 #define GET_CONFIG_KNOWN_UNKOWN "[2,\"test-mst\",\"GetConfiguration\",{\"key\":[\"" KNOWN_KEY "\",\"" UNKOWN_KEY "\"]}]"
 
+#if MO_ENABLE_CONFIG_LOG
+class RemoveFailingFilesystemAdapter : public FilesystemAdapter {
+private:
+    std::shared_ptr<FilesystemAdapter> filesystem;
+public:
+    bool failRemove = false;
+
+    RemoveFailingFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem) : filesystem(std::move(filesystem)) { }
+
+    int stat(const char *path, size_t *size) override {return filesystem->stat(path, size);}
+    std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) override {return filesystem->open(fn, mode);}
+    bool remove(const char *fn) override {return !failRemove && filesystem->remove(fn);}
+    int ftw_root(std::function<int(const char *fpath)> fn) override {return filesystem->ftw_root(fn);}
+};
+#endif //MO_ENABLE_CONFIG_LOG
+
 // some globals for the C-API tests
 bool g_checkProcessed [10];
 ocpp_configuration g_configs [2];
@@ -113,6 +129,157 @@ TEST_CASE( "Configuration" ) {
         REQUIRE( !strcmp(cString2->getString(), "mValue") );
     }
 
+#if MO_ENABLE_CONFIG_LOG
+    SECTION("Incremental persistency with key-value log") {
+
+        const char *fn = MO_FILENAME_PREFIX "persistent1.jsn";
+        const char *fnLog = MO_FILENAME_PREFIX "persistent1.jsn" MO_CONFIG_LOG_SUFFIX;
+
+        auto container = makeConfigurationContainerFlash(filesystem, fn, true);
+        REQUIRE( container->load() );
+
+        auto cInt = container->createConfiguration(TConfig::Int, "cInt");
+        auto cString = container->createConfiguration(TConfig::String, "cString");
+        cInt->setInt(1);
+        cString->setString("mValue");
+        REQUIRE( container->save() );
+
+        size_t fsize = 0, logSize = 0;
+        REQUIRE( filesystem->stat(fn, &fsize) == 0 );
+        REQUIRE( filesystem->stat(fnLog, &logSize) == 0 );
+
+        //changing one config appends one small record and leaves the configs file untouched
+        cInt->setInt(2);
+        REQUIRE( container->save() );
+
+        size_t fsize2 = 0, logSize2 = 0;
+        REQUIRE( filesystem->stat(fn, &fsize2) == 0 );
+        REQUIRE( filesystem->stat(fnLog, &logSize2) == 0 );
+        REQUIRE( fsize2 == fsize );
+        REQUIRE( logSize2 > logSize );
+        REQUIRE( logSize2 - logSize < 64 );
+
+        //no change, no write
+        REQUIRE( container->save() );
+        REQUIRE( filesystem->stat(fnLog, &logSize) == 0 );
+        REQUIRE( logSize == logSize2 );
+
+        //the log is compacted into the configs file when exceeding its size limit
+        for (int i = 3; i < 100; i++) {
+            cInt->setInt(i);
+            REQUIRE( container->save() );
+            if (filesystem->stat(fnLog, &logSize) == 0) {
+                REQUIRE( logSize <= MO_CONFIG_LOG_MAXSIZE );
+            }
+        }
+
+        container.reset();
+
+        auto container2 = makeConfigurationContainerFlash(filesystem, fn, true);
+        REQUIRE( container2->load() );
+        REQUIRE( container2->getConfiguration("cInt")->getInt() == 99 );
+        REQUIRE( !strcmp(container2->getConfiguration("cString")->getString(), "mValue") );
+
+        //removing a config rewrites the configs file
+        container2->remove(container2->getConfiguration("cString").get());
+        REQUIRE( container2->save() );
+        REQUIRE( filesystem->stat(fnLog, &logSize) != 0 );
+
+        container2.reset();
+
+        auto container3 = makeConfigurationContainerFlash(filesystem, fn, true);
+        REQUIRE( container3->load() );
+        REQUIRE( container3->getConfiguration("cInt")->getInt() == 99 );
+        REQUIRE( container3->getConfiguration("cString") == nullptr );
+    }
+
+    SECTION("Key-value log with torn tail") {
+
+        const char *fn = MO_FILENAME_PREFIX "persistent1.jsn";
+        const char *fnLog = MO_FILENAME_PREFIX "persistent1.jsn" MO_CONFIG_LOG_SUFFIX;
+
+        auto container = makeConfigurationContainerFlash(filesystem, fn, true);
+        REQUIRE( container->load() );
+
+        auto cInt = container->createConfiguration(TConfig::Int, "cInt");
+        auto cString = container->createConfiguration(TConfig::String, "cString");
+        cInt->setInt(1);
+        cString->setString("mValue");
+        REQUIRE( container->save() );
+
+        cInt->setInt(2);
+        REQUIRE( container->save() );
+        cString->setString("mValue2");
+        REQUIRE( container->save() );
+
+        container.reset();
+
+        //power loss during the next append
+        size_t logSize = 0;
+        REQUIRE( filesystem->stat(fnLog, &logSize) == 0 );
+        {
+            auto file = filesystem->open(fnLog, "a");
+            REQUIRE( file );
+            const char *torn = "{\"type\":\"int\",\"key\":\"cInt\",\"val";
+            REQUIRE( file->write(torn, strlen(torn)) == strlen(torn) );
+        }
+
+        //the complete records before the torn one apply
+        auto container2 = makeConfigurationContainerFlash(filesystem, fn, true);
+        REQUIRE( container2->load() );
+        REQUIRE( container2->getConfiguration("cInt")->getInt() == 2 );
+        REQUIRE( !strcmp(container2->getConfiguration("cString")->getString(), "mValue2") );
+
+        //next save drops the corrupt log
+        REQUIRE( container2->save() );
+        REQUIRE( filesystem->stat(fnLog, &logSize) != 0 );
+
+        container2->getConfiguration("cInt")->setInt(3);
+        REQUIRE( container2->save() );
+        container2.reset();
+
+        auto container3 = makeConfigurationContainerFlash(filesystem, fn, true);
+        REQUIRE( container3->load() );
+        REQUIRE( container3->getConfiguration("cInt")->getInt() == 3 );
+        REQUIRE( !strcmp(container3->getConfiguration("cString")->getString(), "mValue2") );
+    }
+
+    SECTION("Key-value log removal fails") {
+
+        const char *fn = MO_FILENAME_PREFIX "persistent1.jsn";
+        const char *fnLog = MO_FILENAME_PREFIX "persistent1.jsn" MO_CONFIG_LOG_SUFFIX;
+
+        auto failing = std::make_shared<RemoveFailingFilesystemAdapter>(filesystem);
+
+        auto container = makeConfigurationContainerFlash(failing, fn, true);
+        REQUIRE( container->load() );
+
+        auto cInt = container->createConfiguration(TConfig::Int, "cInt");
+        auto cString = container->createConfiguration(TConfig::String, "cString");
+        cInt->setInt(1);
+        REQUIRE( container->save() );
+        cInt->setInt(2);
+        REQUIRE( container->save() );
+
+        //compaction can't remove the log
+        failing->failRemove = true;
+        container->remove(cString.get());
+        REQUIRE( container->save() );
+        size_t logSize = 0;
+        REQUIRE( filesystem->stat(fnLog, &logSize) == 0 );
+
+        //the first append after compaction replaces the stale log
+        cInt->setInt(3);
+        REQUIRE( container->save() );
+        container.reset();
+
+        auto container2 = makeConfigurationContainerFlash(failing, fn, true);
+        REQUIRE( container2->load() );
+        REQUIRE( container2->getConfiguration("cInt")->getInt() == 3 );
+        REQUIRE( container2->getConfiguration("cString") == nullptr );
+    }
+#endif //MO_ENABLE_CONFIG_LOG
+
     SECTION("Configuration API") {
 
         //declare configs
@@ -0,0 +1,236 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/ConnectionQueue.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/OperationRegistry.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#if MO_ENABLE_CONNECTION_QUEUE
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BASE_TIME "2023-01-01T00:00:00.000Z"
+
+using namespace MicroOcpp;
+
+//transport which only accepts frames while online
+class StalledConnection : public Connection {
+public:
+    bool online = false;
+    std::vector<std::string> sent;
+
+    void loop() override { }
+    bool sendTXT(const char *msg, size_t length) override {
+        if (!online) {
+            return false;
+        }
+        sent.emplace_back(msg, length);
+        return true;
+    }
+    void setReceiveTXTcallback(ReceiveTXTcallback&) override { }
+    unsigned long getLastConnected() override {return 0;}
+    bool isConnected() override {return online;}
+
+    unsigned int pings = 0;
+    bool sendPing() override {
+        if (!online) {
+            return false;
+        }
+        pings++;
+        return true;
+    }
+};
+
+TEST_CASE( "Connection queue" ) {
+    printf("\nRun %s\n",  "Connection queue");
+
+    SECTION("SPSC frame queue") {
+
+        SpscFrameQueue queue {64};
+        REQUIRE( queue.getCapacity() == 64 );
+        REQUIRE( queue.empty() );
+
+        size_t len = 0;
+        REQUIRE( queue.front(&len) == nullptr );
+
+        //fill and drain multiple times to cover the wrap-around
+        for (unsigned int i = 0; i < 100; i++) {
+            char frame [20];
+            auto frameLen = (size_t)snprintf(frame, sizeof(frame), "frame-%u", i);
+            REQUIRE( queue.push(frame, frameLen) );
+
+            const char *out = queue.front(&len);
+            REQUIRE( out != nullptr );
+            REQUIRE( len == frameLen );
+            REQUIRE( !strncmp(out, frame, len) );
+            queue.pop();
+            REQUIRE( queue.empty() );
+        }
+
+        //reject frames when full
+        unsigned int pushed = 0;
+        while (queue.push("12345678", 8)) {
+            pushed++;
+        }
+        REQUIRE( pushed == 64 / 16 ); //8 bytes header + 8 bytes payload per frame
+
+        //reject frames which exceed half the capacity
+        SpscFrameQueue queue2 {64};
+        char large [40] = {'\0'};
+        REQUIRE( !queue2.push(large, sizeof(large)) );
+    }
+
+    SECTION("SPSC frame queue on two threads") {
+
+        SpscFrameQueue queue {256};
+
+        const unsigned int nFrames = 100000;
+
+        std::thread producer ([&queue, nFrames] () {
+            char frame [64];
+            for (unsigned int i = 0; i < nFrames; i++) {
+                //vary frame length to cover all wrap-around offsets
+                auto frameLen = (size_t)snprintf(frame, sizeof(frame), "%u-%.*s", i, (int)(i % 32), "................................");
+                while (!queue.push(frame, frameLen)) {
+                    std::this_thread::yield(); //full
+                }
+            }
+        });
+
+        unsigned int received = 0;
+        bool inOrder = true;
+        while (received < nFrames) {
+            size_t len;
+            const char *out = queue.front(&len);
+            if (!out) {
+                std::this_thread::yield(); //empty
+                continue;
+            }
+            char expected [64];
+            auto expectedLen = (size_t)snprintf(expected, sizeof(expected), "%u-%.*s", received, (int)(received % 32), "................................");
+            if (len != expectedLen || strncmp(out, expected, len)) {
+                inOrder = false;
+            }
+            queue.pop();
+            received++;
+        }
+
+        producer.join();
+
+        REQUIRE( inOrder );
+        REQUIRE( received == nFrames );
+        REQUIRE( queue.empty() );
+    }
+
+    SECTION("Drop expired outbound frames") {
+
+        mocpp_set_timer(custom_timer_cb);
+
+        StalledConnection transport;
+        QueuedConnection queuedConnection {transport};
+
+        REQUIRE( queuedConnection.sendTXT("stale", strlen("stale")) );
+
+        //transport is offline and the frame stays queued
+        queuedConnection.networkLoop();
+        REQUIRE( transport.sent.empty() );
+
+        mtime += MO_CONNECTION_QUEUE_OUTBOUND_TTL;
+        REQUIRE( queuedConnection.sendTXT("fresh", strlen("fresh")) );
+
+        //after reconnecting, only the fresh frame goes out
+        transport.online = true;
+        queuedConnection.networkLoop();
+        REQUIRE( transport.sent.size() == 1 );
+        REQUIRE( transport.sent[0] == "fresh" );
+    }
+
+    SECTION("Forward pings to the network thread") {
+
+        mocpp_set_timer(custom_timer_cb);
+
+        StalledConnection transport;
+        QueuedConnection queuedConnection {transport};
+
+        //no ping has gone through yet, so the caller sends a Heartbeat instead
+        REQUIRE( !queuedConnection.sendPing() );
+        queuedConnection.networkLoop();
+        REQUIRE( transport.pings == 0 );
+        REQUIRE( !queuedConnection.sendPing() );
+
+        transport.online = true;
+        queuedConnection.networkLoop();
+        REQUIRE( transport.pings == 1 );
+
+        //pings keep their order with the frames and don't reach sendTXT()
+        REQUIRE( queuedConnection.sendTXT("frame", strlen("frame")) );
+        REQUIRE( queuedConnection.sendPing() );
+        queuedConnection.networkLoop();
+        REQUIRE( transport.sent.size() == 1 );
+        REQUIRE( transport.sent[0] == "frame" );
+        REQUIRE( transport.pings == 2 );
+
+        //transport stops accepting pings
+        transport.online = false;
+        REQUIRE( queuedConnection.sendPing() );
+        queuedConnection.networkLoop();
+        REQUIRE( !queuedConnection.sendPing() );
+    }
+
+    SECTION("Run OCPP over queued connection") {
+
+        LoopbackConnection loopback;
+        QueuedConnection queuedConnection {loopback};
+
+        mocpp_initialize(queuedConnection, ChargerCredentials("test-runner1234"));
+
+        mocpp_set_timer(custom_timer_cb);
+
+        bool checkProcessed = false;
+
+        getOcppContext()->getOperationRegistry().registerOperation("BootNotification",
+            [&checkProcessed] () {
+                return new Ocpp16::CustomOperation("BootNotification",
+                    [&checkProcessed] (JsonObject) {
+                        checkProcessed = true;
+                    },
+                    [] () {
+                        //create conf
+                        auto conf = makeJsonDoc(UNIT_MEM_TAG, JSON_OBJECT_SIZE(3));
+                        (*conf)["currentTime"] = BASE_TIME;
+                        (*conf)["interval"] = 3600;
+                        (*conf)["status"] = "Accepted";
+                        return conf;
+                    });
+            });
+
+        REQUIRE( !isOperative() );
+
+        //OCPP thread doesn't reach the transport on its own
+        loop();
+        REQUIRE( !checkProcessed );
+
+        //interleave network thread and OCPP thread
+        for (unsigned int i = 0; i < 30; i++) {
+            queuedConnection.networkLoop();
+            mtime += 100;
+            mocpp_loop();
+        }
+
+        REQUIRE( checkProcessed );
+        REQUIRE( isOperative() );
+
+        mocpp_deinitialize();
+    }
+}
+
+#endif //MO_ENABLE_CONNECTION_QUEUE
@@ -0,0 +1,132 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#include <cstdio>
+
+#if MO_ENABLE_ATOMIC_FILE_WRITE
+
+#define FN MO_FILENAME_PREFIX "atomic.jsn"
+
+using namespace MicroOcpp;
+
+TEST_CASE( "Filesystem" ) {
+    printf("\nRun %s\n",  "Filesystem");
+
+    //clean state
+    auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+    auto doc = makeJsonDoc(UNIT_MEM_TAG, JSON_OBJECT_SIZE(1));
+    (*doc)["val"] = 1;
+    REQUIRE( FilesystemUtils::storeJson(filesystem, FN, *doc) );
+
+    SECTION("Atomic file replacement") {
+
+        {
+            auto file = filesystem->open(FN, "w");
+            REQUIRE( file );
+
+            //partially written file doesn't affect the previous version
+            const char partial [] = "{\"val\":";
+            REQUIRE( file->write(partial, sizeof(partial) - 1) == sizeof(partial) - 1 );
+
+            auto loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+            REQUIRE( loaded );
+            REQUIRE( ((*loaded)["val"] | -1) == 1 );
+
+            const char rest [] = "2}";
+            REQUIRE( file->write(rest, sizeof(rest) - 1) == sizeof(rest) - 1 );
+        } //closing the file replaces the previous version
+
+        auto loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 2 );
+    }
+
+    SECTION("Hide interrupted writes") {
+
+        //temporary file left behind by a power loss
+        auto tmpFile = fopen(FN MO_TMPFILE_SUFFIX, "w");
+        REQUIRE( tmpFile );
+        fputs("{\"val\":", tmpFile);
+        fclose(tmpFile);
+
+        unsigned int count = 0;
+        filesystem->ftw_root([&count] (const char *fname) {
+            REQUIRE( strcmp(fname, "atomic.jsn" MO_TMPFILE_SUFFIX) );
+            count++;
+            return 0;
+        });
+        REQUIRE( count == 1 );
+
+        auto loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 1 );
+
+        //next write overwrites the temporary file
+        (*doc)["val"] = 3;
+        REQUIRE( FilesystemUtils::storeJson(filesystem, FN, *doc) );
+
+        loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 3 );
+
+        auto tmpCheck = fopen(FN MO_TMPFILE_SUFFIX, "r");
+        if (tmpCheck) {
+            fclose(tmpCheck);
+        }
+        REQUIRE( tmpCheck == nullptr );
+    }
+
+    SECTION("Collect interrupted writes at mount") {
+
+        //temporary file left behind by a power loss
+        auto tmpFile = fopen(FN MO_TMPFILE_SUFFIX, "w");
+        REQUIRE( tmpFile );
+        fputs("{\"val\":", tmpFile);
+        fclose(tmpFile);
+
+        //remount
+        filesystem.reset();
+        filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+        REQUIRE( filesystem );
+
+        auto tmpCheck = fopen(FN MO_TMPFILE_SUFFIX, "r");
+        if (tmpCheck) {
+            fclose(tmpCheck);
+        }
+        REQUIRE( tmpCheck == nullptr );
+
+        auto loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 1 );
+    }
+
+    SECTION("Explicit close") {
+
+        auto file = filesystem->open(FN, "w");
+        REQUIRE( file );
+
+        const char content [] = "{\"val\":4}";
+        REQUIRE( file->write(content, sizeof(content) - 1) == sizeof(content) - 1 );
+
+        //close() commits the new version and reports the result
+        REQUIRE( file->close() );
+        REQUIRE( file->close() ); //repeated close returns the same result
+
+        auto loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 4 );
+    }
+
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+}
+
+#endif //MO_ENABLE_ATOMIC_FILE_WRITE
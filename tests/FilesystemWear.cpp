@@ -0,0 +1,166 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Core/FilesystemWear.h>
+#include <MicroOcpp/Core/FilesystemWriteBehind.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#if MO_ENABLE_FS_WEAR && MO_ENABLE_FS_WRITE_BEHIND
+
+#define FN_PROFILE MO_FILENAME_PREFIX "sc-tx-1-0.jsn"
+#define FN_BOOT MO_FILENAME_PREFIX "bootstats.jsn"
+
+#define SCPROFILE_TX_16A "[2,\"testmsg\",\"SetChargingProfile\",{\"connectorId\":1,\"csChargingProfiles\":{\"chargingProfileId\":10,\"stackLevel\":0,\"chargingProfilePurpose\":\"TxProfile\",\"chargingProfileKind\":\"Relative\",\"chargingSchedule\":{\"chargingRateUnit\":\"A\",\"chargingSchedulePeriod\":[{\"startPeriod\":0,\"limit\":16,\"numberPhases\":3}]}}}]"
+#define SCPROFILE_TX_20A "[2,\"testmsg\",\"SetChargingProfile\",{\"connectorId\":1,\"csChargingProfiles\":{\"chargingProfileId\":10,\"stackLevel\":0,\"chargingProfilePurpose\":\"TxProfile\",\"chargingProfileKind\":\"Relative\",\"chargingSchedule\":{\"chargingRateUnit\":\"A\",\"chargingSchedulePeriod\":[{\"startPeriod\":0,\"limit\":20,\"numberPhases\":3}]}}}]"
+
+using namespace MicroOcpp;
+
+//run one charging session and return the bytes written to flash during the session. The CSMS adjusts the
+//TxProfile in bursts of two updates per minute, like a load management which reacts to several meter readings
+static size_t runSession(std::shared_ptr<FilesystemAdapter> filesystem, WearAccountingFilesystemAdapter& wear) {
+    LoopbackConnection loopback;
+    mocpp_initialize(loopback, ChargerCredentials(), filesystem);
+
+    loop();
+    filesystem->flush();
+    wear.resetStats();
+
+    beginTransaction("mIdTag");
+    loop();
+    REQUIRE( isTransactionRunning() );
+
+    for (unsigned int i = 0; i < 10; i++) {
+        mtime += 60000;
+        loopback.sendTXT(SCPROFILE_TX_16A, strlen(SCPROFILE_TX_16A));
+        loopback.sendTXT(SCPROFILE_TX_20A, strlen(SCPROFILE_TX_20A));
+        loop();
+    }
+
+    endTransaction();
+    loop();
+    REQUIRE( !isTransactionRunning() );
+
+    filesystem->flush();
+
+    char report [512];
+    REQUIRE( wear.writeReportJson(report, sizeof(report)) > 0 );
+    MO_DBG_INFO("flash writes per session: %s", report);
+
+    mocpp_deinitialize();
+
+    return wear.getTotalStats().bytesWritten;
+}
+
+TEST_CASE( "Filesystem wear accounting" ) {
+    printf("\nRun %s\n",  "Filesystem wear accounting");
+
+    //clean state
+    auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+    mocpp_set_timer(custom_timer_cb);
+
+    auto wear = makeWearAccountingFilesystemAdapter(filesystem);
+    REQUIRE( wear );
+
+    auto doc = makeJsonDoc(UNIT_MEM_TAG, JSON_OBJECT_SIZE(1));
+    (*doc)["val"] = 1;
+
+    SECTION("Count writes per file class") {
+
+        REQUIRE( FilesystemUtils::storeJson(wear, FN_PROFILE, *doc) );
+
+        size_t size;
+        REQUIRE( filesystem->stat(FN_PROFILE, &size) == 0 );
+        REQUIRE( wear->getStats(FsWriteClass::ChargingProfile).bytesWritten == size );
+        REQUIRE( wear->getStats(FsWriteClass::ChargingProfile).fileWrites == 1 );
+        REQUIRE( wear->getStats(FsWriteClass::Transaction).bytesWritten == 0 );
+
+        REQUIRE( wear->remove(FN_PROFILE) );
+        REQUIRE( wear->getStats(FsWriteClass::ChargingProfile).removes == 1 );
+
+        REQUIRE( getFsWriteClass(MO_FILENAME_PREFIX "tx-1-2.jsn") == FsWriteClass::Transaction );
+        REQUIRE( getFsWriteClass(MO_FILENAME_PREFIX "sd-1-2-3.jsn") == FsWriteClass::StopTxData );
+        REQUIRE( getFsWriteClass(MO_FILENAME_PREFIX "ocpp-config.jsn") == FsWriteClass::Configuration );
+        REQUIRE( getFsWriteClass(MO_FILENAME_PREFIX "unknown.jsn") == FsWriteClass::Other );
+
+        char report [256];
+        REQUIRE( wear->writeReportJson(report, sizeof(report)) > 0 );
+        REQUIRE( strstr(report, "\"ChargingProfile\"") );
+        REQUIRE( !strstr(report, "\"Transaction\"") );
+
+        wear->resetStats();
+        REQUIRE( wear->getTotalStats().bytesWritten == 0 );
+    }
+
+    SECTION("Write budget") {
+
+        wear->setBudget(FsWriteClass::Boot, 4);
+        REQUIRE( !wear->isOverBudget(FsWriteClass::Boot) );
+        REQUIRE( wear->getCoalescingWindow(FN_BOOT) == MO_FS_WEAR_WINDOW );
+
+        REQUIRE( FilesystemUtils::storeJson(wear, FN_BOOT, *doc) );
+
+        REQUIRE( wear->isOverBudget(FsWriteClass::Boot) );
+        REQUIRE( wear->getCoalescingWindow(FN_BOOT) == MO_FS_WEAR_OVERBUDGET_WINDOW );
+        REQUIRE( wear->getCoalescingWindow(FN_PROFILE) == MO_FS_WEAR_WINDOW );
+
+        wear->resetStats();
+        REQUIRE( !wear->isOverBudget(FsWriteClass::Boot) );
+    }
+
+    SECTION("Coalesce with window per file class") {
+
+        auto writeBehind = makeWriteBehindFilesystemAdapter(wear);
+        writeBehind->setCoalescingWindow([wear] (const char *path) {return wear->getCoalescingWindow(path);});
+
+        wear->setCoalescingWindow(FsWriteClass::Boot, 1000);
+
+        for (int i = 0; i < 5; i++) {
+            (*doc)["val"] = i;
+            REQUIRE( FilesystemUtils::storeJson(writeBehind, FN_BOOT, *doc) );
+            mtime += 100;
+            writeBehind->loop();
+        }
+
+        REQUIRE( wear->getStats(FsWriteClass::Boot).fileWrites == 0 );
+
+        mtime += 1000;
+        writeBehind->loop();
+
+        REQUIRE( wear->getStats(FsWriteClass::Boot).fileWrites == 1 );
+
+        auto loaded = FilesystemUtils::loadJson(filesystem, FN_BOOT, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 4 );
+    }
+
+    SECTION("Bytes written per session") {
+
+        size_t bytesDirect = runSession(wear, *wear);
+
+        FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+        auto writeBehind = makeWriteBehindFilesystemAdapter(wear);
+        writeBehind->setCoalescingWindow([wear] (const char *path) {return wear->getCoalescingWindow(path);});
+
+        wear->setCoalescingWindow(FsWriteClass::ChargingProfile, 1000);
+
+        size_t bytesCoalesced = runSession(writeBehind, *wear);
+
+        MO_DBG_INFO("bytes written per session: %zu direct, %zu coalesced", bytesDirect, bytesCoalesced);
+
+        REQUIRE( bytesDirect > 0 );
+        REQUIRE( bytesCoalesced > 0 );
+        REQUIRE( bytesCoalesced < bytesDirect );
+    }
+}
+
+#endif //MO_ENABLE_FS_WEAR && MO_ENABLE_FS_WRITE_BEHIND
@@ -0,0 +1,185 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Core/FilesystemWriteBehind.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#if MO_ENABLE_FS_WRITE_BEHIND
+
+#define FN MO_FILENAME_PREFIX "wb-test.jsn"
+
+using namespace MicroOcpp;
+
+//forwards to the platform filesystem. Writes fail while fail is set
+class FailingFilesystemAdapter : public FilesystemAdapter {
+private:
+    std::shared_ptr<FilesystemAdapter> filesystem;
+public:
+    bool fail = false;
+
+    FailingFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem) : filesystem(std::move(filesystem)) { }
+
+    int stat(const char *path, size_t *size) override {return filesystem->stat(path, size);}
+    std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) override {
+        if (fail && strcmp(mode, "r")) {
+            return nullptr;
+        }
+        return filesystem->open(fn, mode);
+    }
+    bool remove(const char *fn) override {return !fail && filesystem->remove(fn);}
+    int ftw_root(std::function<int(const char *fpath)> fn) override {return filesystem->ftw_root(fn);}
+};
+
+TEST_CASE( "Filesystem write-behind" ) {
+    printf("\nRun %s\n",  "Filesystem write-behind");
+
+    //clean state
+    auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+    mocpp_set_timer(custom_timer_cb);
+
+    auto writeBehind = makeWriteBehindFilesystemAdapter(filesystem);
+    REQUIRE( writeBehind );
+
+    auto doc = makeJsonDoc(UNIT_MEM_TAG, JSON_OBJECT_SIZE(1));
+
+    SECTION("Coalesce writes") {
+
+        (*doc)["val"] = 1;
+        REQUIRE( FilesystemUtils::storeJson(writeBehind, FN, *doc) );
+        (*doc)["val"] = 2;
+        REQUIRE( FilesystemUtils::storeJson(writeBehind, FN, *doc) );
+
+        REQUIRE( writeBehind->getPendingCount() == 1 );
+
+        //pending file is visible through the decorator, but not written yet
+        size_t size;
+        REQUIRE( writeBehind->stat(FN, &size) == 0 );
+        REQUIRE( filesystem->stat(FN, &size) != 0 );
+
+        auto loaded = FilesystemUtils::loadJson(writeBehind, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 2 );
+
+        //wait for coalescing delay, then the next loop writes the file
+        writeBehind->loop();
+        REQUIRE( writeBehind->getPendingCount() == 1 );
+
+        mtime += MO_FS_WRITE_BEHIND_DELAY;
+        writeBehind->loop();
+        REQUIRE( writeBehind->getPendingCount() == 0 );
+
+        loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 2 );
+    }
+
+    SECTION("Remove and enumerate files") {
+
+        (*doc)["val"] = 1;
+        REQUIRE( FilesystemUtils::storeJson(filesystem, FN, *doc) );
+
+        REQUIRE( writeBehind->remove(FN) );
+
+        size_t size;
+        REQUIRE( writeBehind->stat(FN, &size) != 0 );
+        REQUIRE( filesystem->stat(FN, &size) == 0 );
+
+        unsigned int count = 0;
+        writeBehind->ftw_root([&count] (const char*) {
+            count++;
+            return 0;
+        });
+        REQUIRE( count == 0 );
+
+        //pending writes are enumerated
+        REQUIRE( FilesystemUtils::storeJson(writeBehind, MO_FILENAME_PREFIX "wb-test2.jsn", *doc) );
+
+        writeBehind->ftw_root([&count] (const char*) {
+            count++;
+            return 0;
+        });
+        REQUIRE( count == 1 );
+
+        //durability barrier
+        REQUIRE( writeBehind->flush() );
+        REQUIRE( writeBehind->getPendingCount() == 0 );
+        REQUIRE( filesystem->stat(FN, &size) != 0 );
+        REQUIRE( filesystem->stat(MO_FILENAME_PREFIX "wb-test2.jsn", &size) == 0 );
+    }
+
+    SECTION("Flush single file") {
+
+        auto failing = std::make_shared<FailingFilesystemAdapter>(filesystem);
+        writeBehind = makeWriteBehindFilesystemAdapter(failing);
+
+        (*doc)["val"] = 1;
+        REQUIRE( FilesystemUtils::storeJson(writeBehind, FN, *doc) );
+        REQUIRE( FilesystemUtils::storeJson(writeBehind, MO_FILENAME_PREFIX "wb-test2.jsn", *doc) );
+
+        //only the requested file passes the barrier
+        size_t size;
+        REQUIRE( writeBehind->flush(MO_FILENAME_PREFIX "wb-test2.jsn") );
+        REQUIRE( filesystem->stat(MO_FILENAME_PREFIX "wb-test2.jsn", &size) == 0 );
+        REQUIRE( filesystem->stat(FN, &size) != 0 );
+        REQUIRE( writeBehind->getPendingCount() == 1 );
+
+        //failed writes are kept for retry and don't fail the barrier of other files
+        failing->fail = true;
+        REQUIRE( !writeBehind->flush(FN) );
+        REQUIRE( writeBehind->getPendingCount() == 1 );
+
+        REQUIRE( FilesystemUtils::storeJson(writeBehind, MO_FILENAME_PREFIX "wb-test3.jsn", *doc) );
+        failing->fail = false;
+        REQUIRE( writeBehind->flush(MO_FILENAME_PREFIX "wb-test3.jsn") );
+        REQUIRE( writeBehind->getPendingCount() == 1 );
+
+        mtime += MO_FS_WRITE_BEHIND_DELAY;
+        writeBehind->loop();
+        REQUIRE( writeBehind->getPendingCount() == 0 );
+
+        auto loaded = FilesystemUtils::loadJson(filesystem, FN, UNIT_MEM_TAG);
+        REQUIRE( loaded );
+        REQUIRE( ((*loaded)["val"] | -1) == 1 );
+    }
+
+    SECTION("Transactions are persisted immediately") {
+
+        LoopbackConnection loopback;
+        mocpp_initialize(loopback, ChargerCredentials(), writeBehind);
+
+        loop();
+
+        beginTransaction("mIdTag");
+
+        loop();
+
+        REQUIRE( isTransactionRunning() );
+
+        //tx file has passed the barrier, regardless of the coalescing delay
+        unsigned int txFiles = 0;
+        filesystem->ftw_root([&txFiles] (const char *fname) {
+            if (!strncmp(fname, "tx-", strlen("tx-"))) {
+                txFiles++;
+            }
+            return 0;
+        });
+        REQUIRE( txFiles > 0 );
+
+        endTransaction();
+
+        loop();
+
+        mocpp_deinitialize();
+    }
+}
+
+#endif //MO_ENABLE_FS_WRITE_BEHIND
@@ -17,12 +17,90 @@
 
 #include <MicroOcpp/Model/FirmwareManagement/FirmwareService.h>
 
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+#include <mbedtls/md.h>
+#endif
+
 #define BASE_TIME     "2023-01-01T00:00:00.000Z"
 #define BASE_TIME_1H  "2023-01-01T01:00:00.000Z"
 #define FTP_URL       "ftps://localhost/firmware.bin"
 
 using namespace MicroOcpp;
 
+//local FTP stand-in which serves one file in fixed chunks and drops the link once at dropAt
+class FtpStandIn : public FtpClient {
+public:
+    String file = makeString("UnitTests");
+    size_t chunkSize = 4096;
+    size_t dropAt = 0; //0 to disable
+    size_t bytesSent = 0;
+    Vector<size_t> requestedOffsets = makeVector<size_t>("UnitTests");
+
+    class Download : public FtpDownload {
+    public:
+        FtpStandIn& server;
+        size_t pos;
+        std::function<size_t(unsigned char *data, size_t len)> fileWriter;
+        std::function<void(MO_FtpCloseReason reason)> onClose;
+
+        Download(FtpStandIn& server, size_t offset) : server(server), pos(offset) { }
+
+        ~Download() {
+            if (onClose) {
+                onClose(MO_FtpCloseReason_Failure);
+            }
+        }
+
+        void close(MO_FtpCloseReason reason) {
+            auto onClose = std::move(this->onClose);
+            this->onClose = nullptr;
+            onClose(reason);
+        }
+
+        void loop() override {
+            if (!onClose) {
+                return;
+            }
+            if (pos >= server.file.length()) {
+                close(MO_FtpCloseReason_Success);
+                return;
+            }
+            size_t len = std::min(server.chunkSize, server.file.length() - pos);
+            bool drop = server.dropAt > pos && server.dropAt <= pos + len;
+            if (drop) {
+                len = server.dropAt - pos;
+                server.dropAt = 0; //drop only once
+            }
+            auto written = fileWriter((unsigned char*) server.file.c_str() + pos, len);
+            pos += written;
+            server.bytesSent += written;
+            if (drop || written == 0) {
+                close(MO_FtpCloseReason_Failure);
+            }
+        }
+
+        bool isActive() override {
+            return (bool) onClose;
+        }
+    };
+
+    std::unique_ptr<FtpDownload> getFile(const char *ftp_url, std::function<size_t(unsigned char *data, size_t len)> fileWriter, std::function<void(MO_FtpCloseReason reason)> onClose, const char *ca_cert = nullptr) override {
+        return getFileFrom(ftp_url, 0, fileWriter, onClose, ca_cert);
+    }
+
+    std::unique_ptr<FtpDownload> getFileFrom(const char *ftp_url, size_t offset, std::function<size_t(unsigned char *data, size_t len)> fileWriter, std::function<void(MO_FtpCloseReason reason)> onClose, const char *ca_cert = nullptr) override {
+        requestedOffsets.push_back(offset);
+        auto download = std::unique_ptr<Download>(new Download(*this, offset));
+        download->fileWriter = fileWriter;
+        download->onClose = onClose;
+        return download;
+    }
+
+    std::unique_ptr<FtpUpload> postFile(const char *ftp_url, std::function<size_t(unsigned char *out, size_t buffsize)> fileReader, std::function<void(MO_FtpCloseReason reason)> onClose, const char *ca_cert = nullptr) override {
+        return nullptr;
+    }
+};
+
 TEST_CASE( "FirmwareManagement" ) {
     printf("\nRun %s\n",  "FirmwareManagement");
 
@@ -592,6 +670,82 @@ TEST_CASE( "FirmwareManagement" ) {
         REQUIRE( checkProcessedOnInstallStatus == 2 );
     }
 
+    SECTION("Resume interrupted FTP download") {
+
+        auto ftpServer = new FtpStandIn();
+        for (size_t i = 0; i < 64 * 1024; i++) {
+            ftpServer->file.push_back((char) ((i * 7) % 251));
+        }
+        ftpServer->dropAt = 40000;
+        getOcppContext()->setFtpClient(std::unique_ptr<FtpClient>(ftpServer));
+
+        auto image = makeString("UnitTests");
+        bool checkClosed = false;
+        fwService->setDownloadFileWriter(
+            [&image] (const unsigned char *buf, size_t size) -> size_t {
+                image.append((const char*) buf, size);
+                return size;
+            }, [&checkClosed] (MO_FtpCloseReason reason) {
+                checkClosed = reason == MO_FtpCloseReason_Success;
+            });
+
+        auto resumeOffsets = makeVector<size_t>("UnitTests");
+        fwService->setDownloadResumeHandler([&image, &resumeOffsets] (size_t offset) {
+            resumeOffsets.push_back(offset);
+            if (offset == image.length()) {
+                return true;
+            }
+            image.clear();
+            return false;
+        });
+
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+        unsigned char expectedSha256 [32];
+        REQUIRE( !mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), (const unsigned char*) ftpServer->file.c_str(), ftpServer->file.length(), expectedSha256) );
+
+        bool checkVerified = false;
+        fwService->setDownloadVerifier([&checkVerified, &expectedSha256] (const unsigned char *sha256) {
+            checkVerified = !memcmp(sha256, expectedSha256, sizeof(expectedSha256));
+            return checkVerified;
+        });
+#endif //MO_ENABLE_FW_DOWNLOAD_HASH
+
+        getOcppContext()->initiateRequest(makeRequest(new Ocpp16::CustomOperation(
+                "UpdateFirmware",
+                [] () {
+                    //create req
+                    auto doc = makeJsonDoc("UnitTests", JSON_OBJECT_SIZE(4));
+                    auto payload = doc->to<JsonObject>();
+                    payload["location"] = FTP_URL;
+                    payload["retries"] = 2;
+                    payload["retrieveDate"] = BASE_TIME;
+                    payload["retryInterval"] = 10;
+                    return doc;},
+                [] (JsonObject) { } //ignore conf
+        )));
+
+        for (unsigned int i = 0; i < 20; i++) {
+            loop();
+            mtime += 5000;
+        }
+
+        REQUIRE( fwService->getFirmwareStatus() == Ocpp16::FirmwareStatus::Installed );
+        REQUIRE( checkClosed );
+        REQUIRE( image == ftpServer->file );
+
+        //second attempt continued at the drop and didn't transfer the first part again
+        REQUIRE( ftpServer->requestedOffsets.size() == 2 );
+        REQUIRE( ftpServer->requestedOffsets[0] == 0 );
+        REQUIRE( ftpServer->requestedOffsets[1] == 40000 );
+        REQUIRE( resumeOffsets.size() == 1 );
+        REQUIRE( resumeOffsets[0] == 40000 );
+        REQUIRE( ftpServer->bytesSent == ftpServer->file.length() );
+
+#if MO_ENABLE_FW_DOWNLOAD_HASH
+        REQUIRE( checkVerified );
+#endif
+    }
+
     mocpp_deinitialize();
 
 }
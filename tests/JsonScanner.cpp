@@ -0,0 +1,141 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/JsonScanner.h>
+
+#if MO_ENABLE_JSON_SCANNER
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#include <string>
+
+using namespace MicroOcpp;
+
+TEST_CASE( "JsonScanner" ) {
+    printf("\nRun %s\n",  "JsonScanner");
+
+    //message with escape sequences, structural characters in strings and strings across block boundaries
+    std::string msg = "[2,\"msgId01\",\"SendLocalList\",{\"listVersion\":1,\"updateType\":\"Full\",\"localAuthorizationList\":[";
+    for (unsigned int i = 0; i < 20; i++) {
+        if (i > 0) {
+            msg += ",";
+        }
+        msg += "{\"idTag\":\"tag[" + std::to_string(i) + "]:\\\"{,}\\\\\",\"idTagInfo\":{\"status\":\"Accepted\",\"expiryDate\":\"2023-01-01T00:00:00.000Z\"}}";
+    }
+    msg += "]}]";
+
+    SECTION("All implementations agree") {
+
+        JsonScanResult reference;
+        uint32_t referenceIndex [512];
+        REQUIRE( JsonScanner::scan(msg.c_str(), msg.length(), reference, referenceIndex, 512, JsonScanImpl::Scalar) );
+        REQUIRE( reference.nStructurals <= 512 );
+
+        REQUIRE( reference.nContainers == 3 + 2 * 20 );
+        REQUIRE( reference.nStrings == 6 + 7 * 20 );
+        REQUIRE( reference.maxDepth == 5 );
+
+        for (auto impl : {JsonScanImpl::SSE2, JsonScanImpl::AVX2, JsonScanImpl::NEON}) {
+            if (!JsonScanner::isSupported(impl)) {
+                continue;
+            }
+
+            MO_DBG_INFO("check %s", JsonScanner::getImplName(impl));
+
+            JsonScanResult result;
+            uint32_t index [512];
+            REQUIRE( JsonScanner::scan(msg.c_str(), msg.length(), result, index, 512, impl) );
+
+            REQUIRE( result.nStructurals == reference.nStructurals );
+            REQUIRE( result.nContainers == reference.nContainers );
+            REQUIRE( result.nSeparators == reference.nSeparators );
+            REQUIRE( result.nStrings == reference.nStrings );
+            REQUIRE( result.stringBytes == reference.stringBytes );
+            REQUIRE( result.maxDepth == reference.maxDepth );
+
+            for (size_t i = 0; i < reference.nStructurals; i++) {
+                REQUIRE( index[i] == referenceIndex[i] );
+            }
+        }
+    }
+
+    SECTION("Capacity estimate") {
+
+        JsonScanResult result;
+        REQUIRE( JsonScanner::scan(msg.c_str(), msg.length(), result) );
+
+        auto doc = initJsonDoc("UnitTests", JsonScanner::estimateCapacity(result));
+        REQUIRE( deserializeJson(doc, msg.c_str(), msg.length()) == DeserializationError::Ok );
+        REQUIRE( !strcmp(doc[3]["localAuthorizationList"][19]["idTagInfo"]["status"] | "_Undefined", "Accepted") );
+    }
+
+    SECTION("Invalid input") {
+
+        JsonScanResult result;
+
+        const char *unterminated = "[2,\"msgId01\",\"Heartbeat\",{\"key\":\"val}]";
+        REQUIRE( !JsonScanner::scan(unterminated, strlen(unterminated), result) );
+
+        const char *unbalanced = "[2,\"msgId01\",\"Heartbeat\",{}]]";
+        REQUIRE( !JsonScanner::scan(unbalanced, strlen(unbalanced), result) );
+
+        const char *escapedQuote = "[2,\"msgId01\",\"Heartbeat\",{\"key\":\"val\\\"}]";
+        REQUIRE( !JsonScanner::scan(escapedQuote, strlen(escapedQuote), result) );
+    }
+
+    SECTION("Reject oversized message without deserialization") {
+
+        LoopbackConnection loopback;
+        mocpp_initialize(loopback, ChargerCredentials());
+
+        mocpp_set_timer(custom_timer_cb);
+
+        bool checkProcessed = false;
+
+        getOcppContext()->getOperationRegistry().registerOperation("SendLocalList",
+            [&checkProcessed] () {
+                return new Ocpp16::CustomOperation("SendLocalList",
+                    [&checkProcessed] (JsonObject payload) {
+                        //process req
+                        checkProcessed = true;
+                        REQUIRE( payload["localAuthorizationList"].size() == 20 );
+                    },
+                    [] () {
+                        //create conf
+                        return createEmptyDocument();
+                    });
+            });
+
+        //message fits into the JsonDoc
+        loopback.sendTXT(msg.c_str(), msg.length());
+        loop();
+        REQUIRE( checkProcessed );
+
+        //exceeds MO_MAX_JSON_CAPACITY
+        std::string bigMsg = "[2,\"msgId02\",\"SendLocalList\",{\"localAuthorizationList\":[";
+        for (unsigned int i = 0; i < MO_MAX_JSON_CAPACITY / 16; i++) {
+            if (i > 0) {
+                bigMsg += ",";
+            }
+            bigMsg += "{\"idTag\":\"" + std::to_string(i) + "\"}";
+        }
+        bigMsg += "]}]";
+
+        checkProcessed = false;
+        loopback.sendTXT(bigMsg.c_str(), bigMsg.length());
+        loop();
+        REQUIRE( !checkProcessed );
+
+        mocpp_deinitialize();
+    }
+}
+
+#endif //MO_ENABLE_JSON_SCANNER
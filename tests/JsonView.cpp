@@ -0,0 +1,175 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/JsonView.h>
+#include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Operations/DiagnosticsStatusNotification.h>
+#include <MicroOcpp/Operations/Heartbeat.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#include <limits.h>
+
+#define BASE_TIME "2023-01-01T00:00:00.000Z"
+
+using namespace MicroOcpp;
+
+TEST_CASE( "JsonView" ) {
+    printf("\nRun %s\n",  "JsonView");
+
+    SECTION("Field access") {
+
+        const char *msg = " [3, \"msgId\\\"01\", {\"currentTime\": \"" BASE_TIME "\", \"idTagInfo\": {\"status\":\"Accepted\","
+                "\"list\":[1, -25, {\"text\":\"x\\u00e4\\n\"}], \"limit\": 1.5e2, \"flag\": true, \"none\": null}, \"empty\": {}}]";
+        JsonView view {msg, strlen(msg)};
+
+        REQUIRE( view.isArray() );
+        REQUIRE( view.size() == 3 );
+        REQUIRE( view.at(0).asInt(-1) == 3 );
+        REQUIRE( view.at(1).equals("msgId\"01") );
+        REQUIRE( !view.at(1).equals("msgId\"0") );
+        REQUIRE( view.at(3).isNull() );
+
+        auto payload = view.at(2);
+        REQUIRE( payload.isObject() );
+        REQUIRE( payload.size() == 3 );
+
+        //zero-copy slice
+        const char *str;
+        size_t len;
+        REQUIRE( payload.get("currentTime").getString(str, len) );
+        REQUIRE( len == strlen(BASE_TIME) );
+        REQUIRE( !strncmp(str, BASE_TIME, len) );
+        REQUIRE( str > msg );
+        REQUIRE( str < msg + strlen(msg) );
+
+        REQUIRE( payload.getPath("idTagInfo/status").equals("Accepted") );
+        REQUIRE( payload.getPath("idTagInfo/list").size() == 3 );
+        REQUIRE( payload.getPath("idTagInfo/list/1").asInt() == -25 );
+
+        //int range
+        const char *numbers = "[2147483647, -2147483648, 2147483648, -2147483649, 99999999999999999999, 0]";
+        JsonView numbersView {numbers, strlen(numbers)};
+        REQUIRE( numbersView.at(0).asInt(-1) == INT_MAX );
+        REQUIRE( numbersView.at(1).asInt(-1) == INT_MIN );
+        REQUIRE( numbersView.at(2).asInt(-1) == -1 );
+        REQUIRE( numbersView.at(3).asInt(-1) == -1 );
+        REQUIRE( numbersView.at(4).asInt(-1) == -1 );
+        REQUIRE( numbersView.at(5).asInt(-1) == 0 );
+        REQUIRE( payload.getPath("idTagInfo/limit").asFloat() == 150.f );
+        REQUIRE( payload.getPath("idTagInfo/flag").asBool() );
+        REQUIRE( payload.getPath("idTagInfo/none").isNull() );
+        REQUIRE( payload.getPath("idTagInfo/undefined").isNull() );
+        REQUIRE( payload.getPath("idTagInfo/list/3").isNull() );
+        REQUIRE( payload.get("empty").isObject() );
+        REQUIRE( payload.get("empty").size() == 0 );
+
+        char text [8];
+        REQUIRE( payload.getPath("idTagInfo/list/2/text").copyString(text, sizeof(text)) );
+        REQUIRE( !strcmp(text, "x\xc3\xa4\n") );
+
+        char tooShort [4];
+        REQUIRE( !payload.getPath("idTagInfo/list/2/text").copyString(tooShort, sizeof(tooShort)) );
+    }
+
+    SECTION("Malformed input") {
+
+        const char *truncated = "[3,\"msgId01\",{\"currentTime\":\"2023-01-01";
+        JsonView view {truncated, strlen(truncated)};
+
+        REQUIRE( view.at(2).isObject() );
+        REQUIRE( view.at(2).get("currentTime").isString() );
+
+        char buf [32];
+        REQUIRE( !view.at(2).get("currentTime").copyString(buf, sizeof(buf)) );
+        REQUIRE( view.at(3).isNull() );
+    }
+
+    SECTION("Response frame validation") {
+
+        Request request {std::unique_ptr<Operation>(new Ocpp16::DiagnosticsStatusNotification(Ocpp16::DiagnosticsStatus::Uploaded))};
+        auto req = initJsonDoc("UnitTests");
+        REQUIRE( request.createRequest(req) == Request::CreateRequestResult::Success );
+
+        char msgId [64];
+        snprintf(msgId, sizeof(msgId), "%s", req[1].as<const char*>());
+
+        auto receive = [&request] (const char *msg) {
+            return request.receiveResponse(JsonView(msg, strlen(msg)));
+        };
+
+        char msg [128];
+
+        //message id as number
+        REQUIRE( !receive("[3,1,{}]") );
+
+        //message type id as string
+        snprintf(msg, sizeof(msg), "[\"3\",\"%s\",{}]", msgId);
+        REQUIRE( !receive(msg) );
+
+        //wrong arity
+        snprintf(msg, sizeof(msg), "[3,\"%s\"]", msgId);
+        REQUIRE( !receive(msg) );
+        snprintf(msg, sizeof(msg), "[3,\"%s\",{},{}]", msgId);
+        REQUIRE( !receive(msg) );
+
+        //truncated payload
+        snprintf(msg, sizeof(msg), "[3,\"%s\",{\"x\":", msgId);
+        REQUIRE( !receive(msg) );
+
+        //other message id
+        REQUIRE( !receive("[3,\"other\",{}]") );
+
+        //Operation with empty conf accepts the response without deserialization
+        snprintf(msg, sizeof(msg), "[3,\"%s\",{}]", msgId);
+        REQUIRE( receive(msg) );
+    }
+
+    SECTION("Process conf without deserialization") {
+
+        LoopbackConnection loopback;
+        mocpp_initialize(loopback, ChargerCredentials());
+
+        mocpp_set_timer(custom_timer_cb);
+
+        auto& model = getOcppContext()->getModel();
+        model.getClock().setTime(BASE_TIME);
+
+        //server side of the loopback responds with a different time
+        const char *serverTime = "2024-06-01T12:00:00.000Z";
+        getOcppContext()->getOperationRegistry().registerOperation("Heartbeat",
+            [serverTime] () {
+                return new Ocpp16::CustomOperation("Heartbeat",
+                    [] (JsonObject) {
+                        //ignore req
+                    },
+                    [serverTime] () {
+                        //create conf
+                        auto conf = makeJsonDoc("UnitTests", JSON_OBJECT_SIZE(1));
+                        (*conf)["currentTime"] = serverTime;
+                        return conf;
+                    });
+            });
+
+        Ocpp16::Heartbeat heartbeat {model};
+        auto conf = "{\"currentTime\":\"2024-06-01T12:00:00.000Z\"}";
+        REQUIRE( heartbeat.processConfView(JsonView(conf, strlen(conf))) );
+
+        model.getClock().setTime(BASE_TIME);
+
+        getOcppContext()->initiateRequest(makeRequest(new Ocpp16::Heartbeat(model)));
+        loop();
+
+        Timestamp expected;
+        expected.setTime(serverTime);
+        REQUIRE( model.getClock().now() - expected >= 0 );
+        REQUIRE( model.getClock().now() - expected < 10 );
+
+        mocpp_deinitialize();
+    }
+}
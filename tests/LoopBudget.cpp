@@ -0,0 +1,92 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/LoopBudget.h>
+#include <MicroOcpp/Core/Metrics.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#define BASE_TIME "2023-01-01T00:00:00.000Z"
+
+using namespace MicroOcpp;
+
+unsigned long budget_test_us = 0;
+
+//each access to the us timer simulates 10us of work
+unsigned long busy_timer_us() {
+    budget_test_us += 10;
+    return budget_test_us;
+}
+
+TEST_CASE( "LoopBudget" ) {
+    printf("\nRun %s\n",  "LoopBudget");
+
+    //initialize Context with dummy socket
+    LoopbackConnection loopback;
+    mocpp_initialize(loopback, ChargerCredentials());
+
+    mocpp_set_timer(custom_timer_cb);
+    mocpp_set_timer_us(busy_timer_us);
+
+    getOcppContext()->getModel().getClock().setTime(BASE_TIME);
+
+    loop();
+
+#if MO_ENABLE_METRICS
+    mo_metrics_reset();
+#endif
+
+    SECTION("Services yield and resume") {
+
+        mocpp_set_loop_budget(1); //used up after the first task
+        REQUIRE( mocpp_get_loop_budget() == 1 );
+
+        REQUIRE( !LoopBudget::exhausted() ); //only limits mocpp_loop()
+
+        beginTransaction_authorized("mIdTag");
+
+        //connectors run on every call, even with the budget used up
+        mocpp_loop();
+        REQUIRE( isTransactionRunning() );
+
+        endTransaction();
+        loop();
+        REQUIRE( !isTransactionRunning() );
+
+#if MO_ENABLE_METRICS
+        unsigned long yields = 0;
+        REQUIRE( mo_metrics_get_counter(MO_METRICS_LOOP_YIELDS, &yields) );
+        REQUIRE( yields > 0 );
+
+        //loop time is bounded by the budget plus one task
+        mo_metrics_histogram loopTime;
+        REQUIRE( mo_metrics_get_histogram(MO_METRICS_LOOP_TIME, &loopTime) );
+        REQUIRE( loopTime.max_us < 1000 );
+#endif
+    }
+
+    SECTION("No budget") {
+
+        mocpp_set_loop_budget(0);
+
+        beginTransaction_authorized("mIdTag");
+        mocpp_loop();
+        REQUIRE( isTransactionRunning() );
+
+#if MO_ENABLE_METRICS
+        unsigned long yields = 0;
+        REQUIRE( mo_metrics_get_counter(MO_METRICS_LOOP_YIELDS, &yields) );
+        REQUIRE( yields == 0 );
+#endif
+    }
+
+    mocpp_set_loop_budget(MO_LOOP_BUDGET_US);
+    mocpp_set_timer_us(nullptr);
+
+    mocpp_deinitialize();
+}
@@ -7,6 +7,7 @@
 #include <MicroOcpp/Core/Context.h>
 #include <MicroOcpp/Model/Model.h>
 #include <MicroOcpp/Model/Metering/MeteringConnector.h>
+#include <MicroOcpp/Model/Metering/MeterSampleAggregator.h>
 #include <MicroOcpp/Core/Configuration.h>
 #include <MicroOcpp/Operations/CustomOperation.h>
 #include <catch2/catch.hpp>
@@ -539,6 +540,85 @@ TEST_CASE("Metering") {
 
     }
 
+    SECTION("MeterValues cache overflow policies") {
+
+        Timestamp base;
+        base.setTime(BASE_TIME);
+        model.getClock().setTime(BASE_TIME);
+
+        addMeterValueInput([base] () {
+            //simulate 3600W consumption
+            return getOcppContext()->getModel().getClock().now() - base;
+        }, "Energy.Active.Import.Register");
+
+        auto MeterValuesSampledDataString = declareConfiguration<const char*>("MeterValuesSampledData","", CONFIGURATION_FN);
+        MeterValuesSampledDataString->setString("Energy.Active.Import.Register");
+
+        auto MeterValueSampleIntervalInt = declareConfiguration<int>("MeterValueSampleInterval",0, CONFIGURATION_FN);
+        MeterValueSampleIntervalInt->setInt(10);
+
+        auto meterValuesCacheOverflowString = declareConfiguration<const char*>(MO_CONFIG_EXT_PREFIX "MeterValuesCacheOverflow", "");
+
+        unsigned int countProcessed = 0;
+        Timestamp tFirst, tLast;
+
+        setOnReceiveRequest("MeterValues", [&countProcessed, &tFirst, &tLast] (JsonObject payload) {
+            Timestamp t0;
+            t0.setTime(payload["meterValue"][0]["timestamp"] | "");
+
+            if (countProcessed == 0) {
+                tFirst = t0;
+            } else {
+                REQUIRE( t0 - tLast > 0 ); //preserve order
+            }
+            tLast = t0;
+            countProcessed++;
+        });
+
+        const unsigned int nrInitiated = 10 + MO_METERVALUES_CACHE_MAXSIZE;
+
+        SECTION("Spill") {
+            meterValuesCacheOverflowString->setString("Spill");
+        }
+
+        SECTION("Downsample") {
+            meterValuesCacheOverflowString->setString("Downsample");
+        }
+
+        loop();
+
+        beginTransaction_authorized("mIdTag");
+
+        auto trackMtime = mtime;
+
+        loop();
+
+        loopback.setConnected(false);
+
+        for (unsigned long i = 1; i <= nrInitiated; i++) {
+            mtime = trackMtime + i * 10 * 1000;
+            loop();
+        }
+
+        loopback.setConnected(true);
+
+        loop();
+
+        if (!strcmp(meterValuesCacheOverflowString->getString(), "Spill")) {
+            REQUIRE( countProcessed == nrInitiated );
+        } else {
+            REQUIRE( countProcessed <= MO_METERVALUES_CACHE_MAXSIZE );
+            REQUIRE( countProcessed >= MO_METERVALUES_CACHE_MAXSIZE / 2 );
+            REQUIRE( tLast - tFirst >= 10 * ((int)nrInitiated - 1) - 1 ); //oldest and newest MV are kept
+        }
+
+        endTransaction();
+
+        loop();
+
+        meterValuesCacheOverflowString->setString(MO_METERVALUES_CACHE_OVERFLOW);
+    }
+
     SECTION("Drop MeterValues for silent tx") {
 
         loopback.setConnected(false);
@@ -688,6 +768,116 @@ TEST_CASE("Metering") {
         REQUIRE(attemptNr == 3);
     }
 
+#if MO_ENABLE_METER_AGGREGATION
+    SECTION("High-rate sampling aggregation") {
+
+        SampledValueProperties properties;
+        properties.setMeasurand("Power.Active.Import");
+
+        MeterSampleAggregator average {properties, MeterAggregation_Average};
+        MeterSampleAggregator minimum {properties, MeterAggregation_Minimum};
+        MeterSampleAggregator maximum {properties, MeterAggregation_Maximum};
+        MeterSampleAggregator integral {properties, MeterAggregation_Integral};
+
+        auto t0 = mtime;
+
+        for (auto aggregator : {&average, &minimum, &maximum, &integral}) {
+            //3600W for 5s, then 7200W for 5s
+            REQUIRE( aggregator->getRing().push(3600.f, t0) );
+            REQUIRE( aggregator->getRing().push(3600.f, t0 + 2000) );
+            REQUIRE( aggregator->getRing().push(7200.f, t0 + 5000) );
+        }
+
+        mtime = t0 + 10000;
+
+        //sampling point
+        for (auto aggregator : {&average, &minimum, &maximum, &integral}) {
+            aggregator->closeInterval(ReadingContext_SamplePeriodic);
+        }
+
+        REQUIRE( average.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 4800 );
+        REQUIRE( minimum.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 3600 );
+        REQUIRE( maximum.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 7200 );
+        REQUIRE( integral.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 15 ); //Wh
+
+        //second reader of the same interval (e.g. StopTxnSampledData)
+        REQUIRE( average.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 4800 );
+
+        //clock-aligned interval is independent of the periodic interval
+        maximum.closeInterval(ReadingContext_SampleClock);
+        REQUIRE( maximum.takeValue(ReadingContext_SampleClock)->toInteger() == 7200 );
+
+        //next interval without new samples holds the last value
+        mtime = t0 + 20000;
+        average.closeInterval(ReadingContext_SamplePeriodic);
+        integral.closeInterval(ReadingContext_SamplePeriodic);
+        REQUIRE( average.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 7200 );
+        REQUIRE( integral.takeValue(ReadingContext_SamplePeriodic)->toInteger() == 20 );
+
+        //ring overflow
+        for (unsigned int i = 0; i < MO_METER_SAMPLE_RING_SIZE; i++) {
+            REQUIRE( average.getRing().push(1.f) );
+        }
+        REQUIRE( !average.getRing().push(1.f) );
+        REQUIRE( average.getRing().getDropped() == 1 );
+        average.drain();
+        REQUIRE( average.getRing().push(1.f) );
+
+        //report aggregate in MeterValues
+        auto ring = addMeterValueAggregatedInput(MeterAggregation_Average, "Power.Active.Import", "W");
+        REQUIRE( ring != nullptr );
+
+        auto MeterValuesSampledDataString = declareConfiguration<const char*>("MeterValuesSampledData","", CONFIGURATION_FN);
+        MeterValuesSampledDataString->setString("Power.Active.Import");
+
+        auto MeterValueSampleIntervalInt = declareConfiguration<int>("MeterValueSampleInterval",0, CONFIGURATION_FN);
+        MeterValueSampleIntervalInt->setInt(10);
+
+        bool checkProcessed = false;
+
+        setOnReceiveRequest("MeterValues", [&checkProcessed] (JsonObject payload) {
+            checkProcessed = true;
+            REQUIRE( !strcmp(payload["meterValue"][0]["sampledValue"][0]["context"] | "", "Sample.Periodic") );
+            REQUIRE( !strcmp(payload["meterValue"][0]["sampledValue"][0]["value"] | "", "2000.00") );
+        });
+
+        beginTransaction_authorized("mIdTag");
+        loop();
+
+        //measurand which is not selected yet
+        auto ringCurrent = addMeterValueAggregatedInput(MeterAggregation_Maximum, "Current.Import", "A");
+        REQUIRE( ringCurrent != nullptr );
+
+        ring->push(1000.f);
+        ringCurrent->push(32.f);
+        mtime += 5000;
+        ring->push(3000.f);
+        mtime += 5000;
+
+        loop();
+
+        REQUIRE( checkProcessed );
+
+        //the interval of the unselected measurand has been closed at the sampling point as well
+        MeterValuesSampledDataString->setString("Current.Import");
+
+        checkProcessed = false;
+
+        setOnReceiveRequest("MeterValues", [&checkProcessed] (JsonObject payload) {
+            checkProcessed = true;
+            REQUIRE( !strcmp(payload["meterValue"][0]["sampledValue"][0]["measurand"] | "", "Current.Import") );
+            REQUIRE( !strcmp(payload["meterValue"][0]["sampledValue"][0]["value"] | "", "16.00") );
+        });
+
+        ringCurrent->push(16.f);
+        mtime += 10000;
+
+        loop();
+
+        REQUIRE( checkProcessed );
+    }
+#endif //MO_ENABLE_METER_AGGREGATION
+
     SECTION("TriggerMessage") {
         
         addMeterValueInput([] () {
@@ -0,0 +1,207 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Core/OperationRegistry.h>
+#include <MicroOcpp/Core/Metrics.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#if MO_ENABLE_METRICS
+
+using namespace MicroOcpp;
+
+//filesystem which takes `delay` ms for opening a file
+class SlowFilesystemAdapter : public FilesystemAdapter {
+private:
+    std::shared_ptr<FilesystemAdapter> filesystem;
+public:
+    unsigned long delay = 0;
+
+    SlowFilesystemAdapter(std::shared_ptr<FilesystemAdapter> filesystem) : filesystem(std::move(filesystem)) { }
+
+    int stat(const char *path, size_t *size) override {return filesystem->stat(path, size);}
+    std::unique_ptr<FileAdapter> open(const char *fn, const char *mode) override {
+        mtime += delay;
+        return filesystem->open(fn, mode);
+    }
+    bool remove(const char *fn) override {return filesystem->remove(fn);}
+    int ftw_root(std::function<int(const char *fpath)> fn) override {return filesystem->ftw_root(fn);}
+};
+
+TEST_CASE( "Metrics" ) {
+    printf("\nRun %s\n",  "Metrics");
+
+    //initialize Context with dummy socket
+    LoopbackConnection loopback;
+    mocpp_initialize(loopback, ChargerCredentials());
+
+    mocpp_set_timer(custom_timer_cb);
+
+    mo_metrics_reset();
+
+    getOcppContext()->getOperationRegistry().registerOperation("Authorize",
+        [] () {
+            return new Ocpp16::CustomOperation("Authorize",
+                [] (JsonObject) {}, //ignore req
+                [] () {
+                    //create conf
+                    auto conf = makeJsonDoc(UNIT_MEM_TAG, JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(1));
+                    (*conf)["idTagInfo"]["status"] = "Accepted";
+                    return conf;
+                });
+        });
+
+    loop();
+
+    SECTION("Count operations") {
+
+        authorize("mIdTag");
+
+        loop();
+
+        unsigned long val = 0;
+        REQUIRE( mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_REQ_SENT, &val) );
+        REQUIRE( val == 1 );
+        REQUIRE( mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_REQ_RECEIVED, &val) ); //loopback: this device also receives the request
+        REQUIRE( val == 1 );
+        REQUIRE( mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_CONF_RECEIVED, &val) );
+        REQUIRE( val == 1 );
+        REQUIRE( mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_TIMEOUT, &val) );
+        REQUIRE( val == 0 );
+
+        mo_metrics_histogram hist;
+        REQUIRE( mo_metrics_get_op_histogram("Authorize", MO_METRICS_OP_ROUNDTRIP_TIME, &hist) );
+        REQUIRE( hist.count == 1 );
+        REQUIRE( mo_metrics_get_op_histogram("Authorize", MO_METRICS_OP_QUEUE_TIME, &hist) );
+        REQUIRE( hist.count == 1 );
+
+        REQUIRE( !mo_metrics_get_op_counter("UnknownOperation", MO_METRICS_OP_REQ_SENT, &val) );
+
+        REQUIRE( mo_metrics_get_counter(MO_METRICS_MSG_SENT, &val) );
+        REQUIRE( val >= 2 ); //Authorize.req and Authorize.conf
+        REQUIRE( mo_metrics_get_counter(MO_METRICS_BYTES_RECEIVED, &val) );
+        REQUIRE( val > 0 );
+    }
+
+    SECTION("Timeouts") {
+
+        loopback.setOnline(false);
+
+        authorize("mIdTag");
+
+        mtime += 60000;
+
+        loop();
+
+        unsigned long val = 0;
+        REQUIRE( mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_TIMEOUT, &val) );
+        REQUIRE( val == 1 );
+        REQUIRE( mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_CONF_RECEIVED, &val) );
+        REQUIRE( val == 0 );
+
+        loopback.setOnline(true);
+    }
+
+    SECTION("Loop and filesystem timings") {
+
+        mo_metrics_histogram hist;
+        REQUIRE( mo_metrics_get_histogram(MO_METRICS_LOOP_TIME, &hist) );
+        REQUIRE( hist.count >= 30 ); //helper loop() runs 30 iterations
+
+        unsigned long bucketSum = 0;
+        for (size_t i = 0; i < MO_METRICS_BUCKETS; i++) {
+            bucketSum += hist.buckets[i];
+        }
+        REQUIRE( bucketSum == hist.count );
+    }
+
+    SECTION("Filesystem load and store histograms") {
+
+        auto slowFilesystem = std::make_shared<SlowFilesystemAdapter>(makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail));
+
+        mo_metrics_reset();
+
+        auto doc = makeJsonDoc(UNIT_MEM_TAG, JSON_OBJECT_SIZE(1));
+        (*doc)["val"] = 42;
+
+        //store: 7ms, falls into the 10ms bucket
+        slowFilesystem->delay = 7;
+        REQUIRE( FilesystemUtils::storeJson(slowFilesystem, MO_FILENAME_PREFIX "metrics.jsn", *doc) );
+
+        //load twice: 70ms each, falls into the 100ms bucket
+        slowFilesystem->delay = 70;
+        REQUIRE( FilesystemUtils::loadJson(slowFilesystem, MO_FILENAME_PREFIX "metrics.jsn", UNIT_MEM_TAG) );
+        REQUIRE( FilesystemUtils::loadJson(slowFilesystem, MO_FILENAME_PREFIX "metrics.jsn", UNIT_MEM_TAG) );
+
+        mo_metrics_histogram hist;
+        REQUIRE( mo_metrics_get_histogram(MO_METRICS_FS_STORE_TIME, &hist) );
+        REQUIRE( hist.count == 1 );
+        REQUIRE( hist.buckets[3] == 1 ); //<= 10ms
+        REQUIRE( hist.max_us == 7000 );
+        REQUIRE( hist.sum_us == 7000 );
+
+        REQUIRE( mo_metrics_get_histogram(MO_METRICS_FS_LOAD_TIME, &hist) );
+        REQUIRE( hist.count == 2 );
+        REQUIRE( hist.buckets[5] == 2 ); //<= 100ms
+        REQUIRE( hist.max_us == 70000 );
+        REQUIRE( hist.sum_us == 140000 );
+
+        unsigned long val = 0;
+        REQUIRE( mo_metrics_get_counter(MO_METRICS_FS_BYTES_WRITTEN, &val) );
+        REQUIRE( val == strlen("{\"val\":42}") );
+
+        char buf [4096];
+        int ret = mo_metrics_write_stats_json(buf, sizeof(buf));
+        REQUIRE( ret > 0 );
+
+        auto stats = makeJsonDoc(UNIT_MEM_TAG, 8192);
+        REQUIRE( !deserializeJson(*stats, buf, (size_t)ret) );
+        REQUIRE( ((*stats)["fs_store"]["count"] | 0) == 1 );
+        REQUIRE( ((*stats)["fs_load"]["count"] | 0) == 2 );
+        REQUIRE( ((*stats)["fs_load"]["avg_us"] | 0UL) == 70000UL );
+        REQUIRE( ((*stats)["fs_load"]["buckets"][5] | 0) == 2 );
+
+        slowFilesystem->remove(MO_FILENAME_PREFIX "metrics.jsn");
+    }
+
+    SECTION("JSON export") {
+
+        authorize("mIdTag");
+
+        loop();
+
+        char buf [4096];
+        int ret = mo_metrics_write_stats_json(buf, sizeof(buf));
+        REQUIRE( ret > 0 );
+
+        auto doc = makeJsonDoc(UNIT_MEM_TAG, 8192);
+        REQUIRE( !deserializeJson(*doc, buf, (size_t)ret) );
+
+        bool foundAuthorize = false;
+        for (JsonObject op : (*doc)["operations"].as<JsonArray>()) {
+            if (!strcmp(op["operation"] | "_Undefined", "Authorize")) {
+                foundAuthorize = true;
+                REQUIRE( (op["req_sent"] | 0) == 1 );
+                REQUIRE( (op["roundtrip_time"]["count"] | 0) == 1 );
+            }
+        }
+        REQUIRE( foundAuthorize );
+        REQUIRE( (*doc)["loop"]["count"].as<unsigned long>() > 0 );
+
+        mo_metrics_reset();
+
+        unsigned long val = 0;
+        REQUIRE( !mo_metrics_get_op_counter("Authorize", MO_METRICS_OP_REQ_SENT, &val) );
+    }
+
+    mocpp_deinitialize();
+}
+
+#endif //MO_ENABLE_METRICS
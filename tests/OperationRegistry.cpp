@@ -0,0 +1,117 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Core/OperationRegistry.h>
+#include <MicroOcpp/Core/Operation.h>
+#include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+using namespace MicroOcpp;
+
+#define N_OPERATIONS 200 //grows the index from 64 to 512 slots
+
+static char operationTypes [N_OPERATIONS][24];
+
+static std::function<Operation*()> makeCreator(const char *operationType) {
+    return [operationType] () {
+        return new Ocpp16::CustomOperation(operationType,
+            [] (JsonObject) {}, //ignore req
+            [] () {return createEmptyDocument();});
+    };
+}
+
+//check which creator the registry selects for operationType. expected == nullptr: NotImplemented
+static bool deserializesTo(OperationRegistry& registry, const char *operationType, const char *expected) {
+    auto request = registry.deserializeOperation(operationType);
+    if (!request) {
+        return false;
+    }
+    if (request->getOperation()->getErrorCode()) {
+        return expected == nullptr && !strcmp(request->getOperation()->getErrorCode(), "NotImplemented");
+    }
+    return expected != nullptr && !strcmp(request->getOperationType(), expected);
+}
+
+TEST_CASE( "OperationRegistry" ) {
+    printf("\nRun %s\n",  "OperationRegistry");
+
+    OperationRegistry registry;
+
+    SECTION("Lookup") {
+
+        for (size_t i = 0; i < N_OPERATIONS; i++) {
+            snprintf(operationTypes[i], sizeof(operationTypes[i]), "mOperation%zu", i);
+            registry.registerOperation(operationTypes[i], makeCreator(operationTypes[i]));
+
+            //all previous entries remain reachable after growing the index
+            REQUIRE( deserializesTo(registry, operationTypes[i / 2], operationTypes[i / 2]) );
+        }
+
+        for (size_t i = 0; i < N_OPERATIONS; i++) {
+            REQUIRE( deserializesTo(registry, operationTypes[i], operationTypes[i]) );
+        }
+
+        //lookup compares the string, not the pointer
+        char copy [24];
+        snprintf(copy, sizeof(copy), "%s", operationTypes[42]);
+        REQUIRE( deserializesTo(registry, copy, operationTypes[42]) );
+    }
+
+    SECTION("Collisions") {
+
+        //find action names which share a slot of the initial 64-slot index
+        const size_t nColliding = 4;
+        size_t found = 0;
+        uint32_t slot = hashOperationType("mCollision0") & 63;
+        for (unsigned int i = 0; found < nColliding && i < 100000; i++) {
+            char name [24];
+            snprintf(name, sizeof(name), "mCollision%u", i);
+            if ((hashOperationType(name) & 63) == slot) {
+                snprintf(operationTypes[found], sizeof(operationTypes[found]), "%s", name);
+                found++;
+            }
+        }
+        REQUIRE( found == nColliding );
+
+        for (size_t i = 0; i < nColliding; i++) {
+            registry.registerOperation(operationTypes[i], makeCreator(operationTypes[i]));
+        }
+
+        for (size_t i = 0; i < nColliding; i++) {
+            REQUIRE( deserializesTo(registry, operationTypes[i], operationTypes[i]) );
+        }
+
+        //re-register a colliding entry: replaced in place, the others stay reachable
+        const char *replacement = "mReplacement";
+        registry.registerOperation(operationTypes[1], makeCreator(replacement));
+        REQUIRE( deserializesTo(registry, operationTypes[1], replacement) );
+        REQUIRE( deserializesTo(registry, operationTypes[0], operationTypes[0]) );
+        REQUIRE( deserializesTo(registry, operationTypes[2], operationTypes[2]) );
+        REQUIRE( deserializesTo(registry, operationTypes[3], operationTypes[3]) );
+    }
+
+    SECTION("Fallback to NotImplemented") {
+
+        //empty registry
+        auto request = registry.deserializeOperation("mUnknown");
+        REQUIRE( request );
+        REQUIRE( request->getOperation()->getErrorCode() != nullptr );
+        REQUIRE( !strcmp(request->getOperation()->getErrorCode(), "NotImplemented") );
+
+        registry.registerOperation("mKnown", makeCreator("mKnown"));
+
+        REQUIRE( deserializesTo(registry, "mKnown", "mKnown") );
+        REQUIRE( deserializesTo(registry, "mUnknown", nullptr) );
+        REQUIRE( deserializesTo(registry, "mKnow", nullptr) );
+        REQUIRE( deserializesTo(registry, "mKnown2", nullptr) );
+        REQUIRE( deserializesTo(registry, "", nullptr) );
+
+        //a creator which fails falls back as well
+        registry.registerOperation("mFailing", [] () -> Operation* {return nullptr;});
+        REQUIRE( deserializesTo(registry, "mFailing", nullptr) );
+    }
+}
@@ -0,0 +1,74 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#include <array>
+
+#define BASE_TIME "2023-01-01T00:00:00.000Z"
+
+using namespace MicroOcpp;
+
+//runs with every build profile, see the mo_unit_tests_small target for MO_PROFILE_SMALL
+TEST_CASE( "Build profile" ) {
+    printf("\nRun %s\n",  "Build profile");
+
+    //clean state
+    auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+    filesystem.reset();
+
+    LoopbackConnection loopback;
+    mocpp_initialize(loopback, ChargerCredentials());
+
+    mocpp_set_timer(custom_timer_cb);
+    getOcppContext()->getModel().getClock().setTime(BASE_TIME);
+
+    loop();
+
+    SECTION("Transaction on each connector") {
+
+        std::array<unsigned int, MO_NUMCONNECTORS> started {};
+
+        getOcppContext()->getOperationRegistry().setOnRequest("StartTransaction", [&started] (JsonObject payload) {
+            unsigned int connectorId = payload["connectorId"] | 0U;
+            if (connectorId < MO_NUMCONNECTORS) {
+                started[connectorId]++;
+            }
+        });
+
+        unsigned int stopped = 0;
+
+        getOcppContext()->getOperationRegistry().setOnRequest("StopTransaction", [&stopped] (JsonObject) {
+            stopped++;
+        });
+
+        for (unsigned int cId = 1; cId < MO_NUMCONNECTORS; cId++) {
+            char idTag [IDTAG_LEN_MAX + 1];
+            snprintf(idTag, sizeof(idTag), "mIdTag%u", cId);
+            REQUIRE( beginTransaction_authorized(idTag, nullptr, cId) );
+            loop();
+            REQUIRE( isTransactionRunning(cId) );
+            REQUIRE( started[cId] == 1 );
+        }
+
+        mtime += 60000;
+        loop();
+
+        for (unsigned int cId = 1; cId < MO_NUMCONNECTORS; cId++) {
+            REQUIRE( endTransaction(nullptr, nullptr, cId) );
+            loop();
+            REQUIRE( !isTransactionRunning(cId) );
+            REQUIRE( stopped == cId );
+        }
+    }
+
+    mocpp_deinitialize();
+}
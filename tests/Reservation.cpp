@@ -302,6 +302,44 @@ TEST_CASE( "Reservation" ) {
         REQUIRE( getOcppContext()->getModel().getConnector(connectorId)->getStatus() == ChargePointStatus_Available );
     }
 
+    SECTION("Expiry order") {
+        //two reservations with different expiry dates. The one which expires first must be cleared first
+        Timestamp expiryEarly = model.getClock().now() + 600;
+        Timestamp expiryLate = model.getClock().now() + 3600;
+
+        REQUIRE( rService->updateReservation(2000, 2, expiryLate, "mIdTag2", "mParentIdTag") );
+        REQUIRE( rService->updateReservation(1000, 1, expiryEarly, "mIdTag1") );
+
+        REQUIRE( rService->getReservation("mIdTag1") == rService->getReservationById(1000) );
+        REQUIRE( rService->getReservation("unknownIdTag", "mParentIdTag") == rService->getReservationById(2000) );
+
+        Timestamp afterEarly = expiryEarly + 1;
+        char afterEarly_cstr [JSONDATE_LENGTH + 1];
+        afterEarly.toJsonString(afterEarly_cstr, JSONDATE_LENGTH + 1);
+        model.getClock().setTime(afterEarly_cstr);
+
+        loop();
+
+        REQUIRE( !rService->getReservationById(1000) );
+        REQUIRE( !rService->getReservation("mIdTag1") );
+        REQUIRE( model.getConnector(1)->getStatus() == ChargePointStatus_Available );
+        REQUIRE( model.getConnector(2)->getStatus() == ChargePointStatus_Reserved );
+
+        //only the remaining reservation is restored after reboot
+        mocpp_deinitialize();
+
+        mocpp_initialize(loopback, ChargerCredentials("test-runner1234"));
+        getOcppContext()->getModel().getClock().setTime(afterEarly_cstr);
+        loop();
+
+        rService = getOcppContext()->getModel().getReservationService();
+        REQUIRE( !rService->getReservationById(1000) );
+        REQUIRE( rService->getReservationById(2000) );
+        REQUIRE( rService->getReservationById(2000)->getExpiryDate() == expiryLate );
+        REQUIRE( !strcmp(rService->getReservationById(2000)->getParentIdTag(), "mParentIdTag") );
+        REQUIRE( getOcppContext()->getModel().getConnector(2)->getStatus() == ChargePointStatus_Reserved );
+    }
+
     SECTION("ReserveNow") {
 
         REQUIRE( connector->getStatus() == ChargePointStatus_Available );
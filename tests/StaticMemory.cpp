@@ -0,0 +1,152 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <cstddef>
+#include <cstdint>
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Core/Memory.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+#if MO_OVERRIDE_ALLOCATION && MO_ENABLE_STATIC_MEMORY
+
+using namespace MicroOcpp;
+
+alignas(std::max_align_t) unsigned char static_pool [1024 * 1024];
+
+bool inPool(void *ptr) {
+    return (unsigned char*)ptr >= static_pool && (unsigned char*)ptr < static_pool + sizeof(static_pool);
+}
+
+void pool_exhausted_cb(const char*, size_t) {
+    //return for testing, i.e. MO_MALLOC returns NULL
+}
+
+unsigned int poolExhaustedCount;
+
+void counting_pool_exhausted_cb(const char *tag, size_t size) {
+    poolExhaustedCount++;
+    MO_DBG_ERR("allocation missed the pool: %zu B (%s)", size, tag ? tag : "unspecified");
+}
+
+TEST_CASE( "Static memory" ) {
+    printf("\nRun %s\n",  "Static memory");
+
+    mo_mem_pool_stats stats;
+
+    SECTION("Pool allocator") {
+
+        REQUIRE( mo_mem_set_pool(static_pool, 1024) );
+        mo_mem_seal();
+
+        void *a = MO_MALLOC(UNIT_MEM_TAG, 100);
+        void *b = MO_MALLOC(UNIT_MEM_TAG, 100);
+        REQUIRE( a );
+        REQUIRE( b );
+        REQUIRE( inPool(a) );
+        REQUIRE( inPool(b) );
+        REQUIRE( (uintptr_t)a % alignof(std::max_align_t) == 0 );
+        REQUIRE( (uintptr_t)b % alignof(std::max_align_t) == 0 );
+
+        REQUIRE( mo_mem_get_pool_stats(&stats) );
+        REQUIRE( stats.used >= 200 );
+
+        //pool in use
+        REQUIRE( !mo_mem_set_pool(nullptr, 0) );
+
+        //exhausted
+        mo_mem_set_pool_exhausted_cb(pool_exhausted_cb);
+        REQUIRE( MO_MALLOC(UNIT_MEM_TAG, 2048) == nullptr );
+        REQUIRE( mo_mem_get_pool_stats(&stats) );
+        REQUIRE( stats.failed == 1 );
+        mo_mem_set_pool_exhausted_cb(nullptr);
+
+        MO_FREE(a);
+        MO_FREE(b);
+
+        REQUIRE( mo_mem_get_pool_stats(&stats) );
+        REQUIRE( stats.used == 0 );
+
+        //free blocks are merged again
+        void *c = MO_MALLOC(UNIT_MEM_TAG, 900);
+        REQUIRE( c );
+        REQUIRE( inPool(c) );
+        MO_FREE(c);
+
+        //unsealed allocator uses heap
+        mo_mem_unseal();
+        void *d = MO_MALLOC(UNIT_MEM_TAG, 100);
+        REQUIRE( d );
+        REQUIRE( !inPool(d) );
+        MO_FREE(d);
+
+        REQUIRE( mo_mem_set_pool(nullptr, 0) );
+        REQUIRE( !mo_mem_get_pool_stats(&stats) );
+    }
+
+    SECTION("No heap allocation after initialization") {
+
+        //clean state
+        auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+        FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+        filesystem.reset();
+
+        REQUIRE( mo_mem_set_pool(static_pool, sizeof(static_pool)) );
+
+        //in strict mode, every MO_MALLOC which doesn't fit into the pool ends up in this callback
+        mo_mem_set_pool_exhausted_cb(counting_pool_exhausted_cb);
+        poolExhaustedCount = 0;
+
+        {
+            LoopbackConnection loopback;
+            mocpp_initialize(loopback, ChargerCredentials());
+            mocpp_set_timer(custom_timer_cb);
+
+            //sealed by mocpp_initialize(). From here on, every MO_MALLOC must be served by the pool
+            REQUIRE( mo_mem_get_pool_stats(&stats) );
+            REQUIRE( stats.used == 0 );
+
+            loop();
+
+            beginTransaction("mIdTag");
+            loop();
+            REQUIRE( isTransactionRunning() );
+
+            for (unsigned int i = 0; i < 10; i++) {
+                mtime += 60000;
+                loop();
+            }
+
+            endTransaction();
+            loop();
+            REQUIRE( !isTransactionRunning() );
+
+            REQUIRE( poolExhaustedCount == 0 );
+
+            //the session has actually been running on the pool
+            REQUIRE( mo_mem_get_pool_stats(&stats) );
+            MO_DBG_INFO("static memory pool: %zu B in use, max. %zu B", stats.used, stats.max_used);
+            REQUIRE( stats.max_used > 0 );
+            REQUIRE( stats.failed == 0 );
+            REQUIRE( stats.heap_allocs == 0 );
+
+            mocpp_deinitialize();
+        }
+
+        mo_mem_set_pool_exhausted_cb(nullptr);
+
+        //all pool blocks have been released
+        REQUIRE( mo_mem_get_pool_stats(&stats) );
+        REQUIRE( stats.used == 0 );
+        REQUIRE( stats.failed == 0 );
+        REQUIRE( stats.heap_allocs == 0 );
+
+        REQUIRE( mo_mem_set_pool(nullptr, 0) );
+    }
+}
+
+#endif //MO_OVERRIDE_ALLOCATION && MO_ENABLE_STATIC_MEMORY
@@ -0,0 +1,154 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Core/TimerWheel.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+using namespace MicroOcpp;
+
+TEST_CASE( "TimerWheel" ) {
+    printf("\nRun %s\n",  "TimerWheel");
+
+    mocpp_set_timer(custom_timer_cb);
+
+    SECTION("Fire timers in order") {
+
+        TimerWheel wheel;
+
+        unsigned long firedShort = 0, firedMedium = 0, firedLong = 0;
+
+        Timer timerShort, timerMedium, timerLong;
+        timerShort.setCallback([&firedShort] () {firedShort = mtime;});
+        timerMedium.setCallback([&firedMedium] () {firedMedium = mtime;});
+        timerLong.setCallback([&firedLong] () {firedLong = mtime;});
+
+        unsigned long t0 = mtime;
+
+        //inner wheel, outer wheel and overflow list
+        const unsigned long delayShort = 1500;
+        const unsigned long delayMedium = 40000;
+        const unsigned long delayLong = 3 * MO_TIMERWHEEL_SLOTS * MO_TIMERWHEEL_SLOTS * MO_TIMERWHEEL_RESOLUTION + 250;
+
+        wheel.schedule(timerShort, delayShort);
+        wheel.schedule(timerMedium, delayMedium);
+        wheel.schedule(timerLong, delayLong);
+
+        REQUIRE( wheel.getScheduledCount() == 3 );
+
+        while (mtime - t0 <= delayLong + MO_TIMERWHEEL_RESOLUTION) {
+            mtime += 50;
+            wheel.loop();
+        }
+
+        //never early, at most one resolution step late
+        REQUIRE( firedShort - t0 >= delayShort );
+        REQUIRE( firedShort - t0 <= delayShort + MO_TIMERWHEEL_RESOLUTION );
+        REQUIRE( firedMedium - t0 >= delayMedium );
+        REQUIRE( firedMedium - t0 <= delayMedium + MO_TIMERWHEEL_RESOLUTION );
+        REQUIRE( firedLong - t0 >= delayLong );
+        REQUIRE( firedLong - t0 <= delayLong + MO_TIMERWHEEL_RESOLUTION );
+
+        REQUIRE( wheel.getScheduledCount() == 0 );
+        REQUIRE( wheel.getFiredCount() == 3 );
+    }
+
+    SECTION("Cancel and reschedule") {
+
+        TimerWheel wheel;
+
+        unsigned int nFired = 0;
+
+        Timer timer;
+        timer.setCallback([&nFired] () {nFired++;});
+
+        wheel.schedule(timer, 1000);
+        timer.cancel();
+        REQUIRE( !timer.isScheduled() );
+
+        mtime += 2000;
+        wheel.loop();
+        REQUIRE( nFired == 0 );
+
+        wheel.schedule(timer, 1000);
+        wheel.schedule(timer, 5000); //replaces the first schedule
+
+        mtime += 2000;
+        wheel.loop();
+        REQUIRE( nFired == 0 );
+
+        mtime += 3100;
+        wheel.loop();
+        REQUIRE( nFired == 1 );
+
+        {
+            //destroying a timer unlinks it
+            Timer timerScoped;
+            timerScoped.setCallback([&nFired] () {nFired++;});
+            wheel.schedule(timerScoped, 1000);
+            REQUIRE( wheel.getScheduledCount() == 1 );
+        }
+        REQUIRE( wheel.getScheduledCount() == 0 );
+
+        //timers can reschedule themselves
+        timer.setCallback([&nFired, &timer, &wheel] () {
+            nFired++;
+            if (nFired < 4) {
+                wheel.schedule(timer, 1000);
+            }
+        });
+        wheel.schedule(timer, 1000);
+
+        for (unsigned int i = 0; i < 50; i++) {
+            mtime += 100;
+            wheel.loop();
+        }
+        REQUIRE( nFired == 4 );
+    }
+
+    SECTION("Request timeout") {
+
+        LoopbackConnection loopback;
+        mocpp_initialize(loopback, ChargerCredentials());
+
+        mocpp_set_timer(custom_timer_cb);
+
+        loopback.setConnected(false);
+
+        bool checkTimeout = false;
+
+        auto request = makeRequest(new Ocpp16::CustomOperation("UnitTest",
+                [] () {
+                    //create req
+                    return createEmptyDocument();
+                },
+                [] (JsonObject) {
+                    //ignore conf
+                }));
+        request->setTimeout(10000);
+        request->setOnTimeoutListener([&checkTimeout] () {
+            checkTimeout = true;
+        });
+
+        getOcppContext()->initiateRequest(std::move(request));
+
+        loop();
+        loop();
+        loop();
+
+        REQUIRE( !checkTimeout );
+
+        loop();
+
+        REQUIRE( checkTimeout );
+
+        mocpp_deinitialize();
+    }
+}
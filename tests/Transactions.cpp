@@ -16,6 +16,7 @@
 #include <MicroOcpp/Debug.h>
 #include <MicroOcpp/Core/Memory.h>
 #include <catch2/catch.hpp>
+#include <vector>
 #include "./helpers/testHelper.h"
 
 #define BASE_TIME "2023-01-01T00:00:00.000Z"
@@ -335,17 +336,30 @@ TEST_CASE( "Transactions" ) {
         REQUIRE( checkReceivedEnded );
     }
 
-    SECTION("TxEvents queue size limit") {
+    SECTION("TxEvents offline log") {
 
         getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("TxCtrlr", "TxStartPoint", "")->setString("Authorized");
         getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("TxCtrlr", "TxStopPoint", "")->setString("Authorized");
+        getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("SampledDataCtrlr", "TxUpdatedMeasurands", "")->setString("Energy.Active.Import.Register");
+        getOcppContext()->getModel().getVariableService()->declareVariable<int>("SampledDataCtrlr", "TxUpdatedInterval", 0)->setInt(1);
 
-        bool checkReceivedStarted = false, checkReceivedEnded = false;
-        size_t checkSeqNosSize = 0;
+        float energy = 0.f;
+        addMeterValueInput([&energy] () {
+            energy += 10.f;
+            return energy;
+        }, "Energy.Active.Import.Register", "Wh", nullptr, nullptr, 1);
 
-        getOcppContext()->getOperationRegistry().registerOperation("TransactionEvent", [&checkReceivedStarted, &checkReceivedEnded, &checkSeqNosSize] () {
+        bool checkReceivedStarted = false, checkReceivedEnded = false;
+        unsigned int checkSeqNosSize = 0;
+        bool checkSeqNosInOrder = true;
+        unsigned int checkMeterValues = 0;
+        float checkEnergy = 0.f;
+        bool checkEnergyIncreasing = true;
+
+        getOcppContext()->getOperationRegistry().registerOperation("TransactionEvent",
+                [&checkReceivedStarted, &checkReceivedEnded, &checkSeqNosSize, &checkSeqNosInOrder, &checkMeterValues, &checkEnergy, &checkEnergyIncreasing] () {
             return new Ocpp16::CustomOperation("TransactionEvent",
-                [&checkReceivedStarted, &checkReceivedEnded, &checkSeqNosSize] (JsonObject request) {
+                [&checkReceivedStarted, &checkReceivedEnded, &checkSeqNosSize, &checkSeqNosInOrder, &checkMeterValues, &checkEnergy, &checkEnergyIncreasing] (JsonObject request) {
                     //process req
                     const char *eventType = request["eventType"] | (const char*)nullptr;
                     if (!strcmp(eventType, "Started")) {
@@ -353,7 +367,26 @@ TEST_CASE( "Transactions" ) {
                     } else if (!strcmp(eventType, "Ended")) {
                         checkReceivedEnded = true;
                     }
+
+                    //no txEvent is lost
+                    if ((request["seqNo"] | -1) != (int)checkSeqNosSize) {
+                        checkSeqNosInOrder = false;
+                    }
                     checkSeqNosSize++;
+
+                    for (JsonObject meterValue : request["meterValue"].as<JsonArray>()) {
+                        for (JsonObject sampledValue : meterValue["sampledValue"].as<JsonArray>()) {
+                            if (!strcmp(sampledValue["measurand"] | "", "Energy.Active.Import.Register") &&
+                                    !strcmp(sampledValue["context"] | "Sample.Periodic", "Sample.Periodic")) {
+                                float value = sampledValue["value"] | -1.f;
+                                if (value <= checkEnergy) {
+                                    checkEnergyIncreasing = false;
+                                }
+                                checkEnergy = value;
+                                checkMeterValues++;
+                            }
+                        }
+                    }
                 },
                 [] () {
                     //create conf
@@ -374,7 +407,7 @@ TEST_CASE( "Transactions" ) {
         auto tx = context->getModel().getTransactionService()->getEvse(1)->getTransaction();
         REQUIRE( tx != nullptr );
 
-        for (size_t i = 0; i < MO_TXEVENTRECORD_SIZE_V201 * 2; i++) {
+        for (size_t i = 0; i < 40; i++) {
             setEvReadyInput([] () {return false;});
             loop();
             setEvReadyInput([] () {return true;});
@@ -383,17 +416,11 @@ TEST_CASE( "Transactions" ) {
             loop();
         }
 
-        REQUIRE( tx->seqNos.size() == MO_TXEVENTRECORD_SIZE_V201 );
+        //all offline txEvents are stored
+        REQUIRE( tx->seqNos.size() == tx->seqNoEnd );
+        REQUIRE( tx->seqNos.size() > 40 );
 
-        for (auto seqNo : tx->seqNos) {
-            MO_DBG_DEBUG("stored seqNo %u", seqNo);
-            (void)seqNo;
-        }
-
-        for (size_t i = 1; i < tx->seqNos.size(); i++) {
-            auto delta = tx->seqNos[i] - tx->seqNos[i-1];
-            REQUIRE(delta <= 2 * tx->seqNos.back() / MO_TXEVENTRECORD_SIZE_V201 );
-        }
+        unsigned int seqNoEnd = tx->seqNoEnd;
 
         context->getModel().getTransactionService()->getEvse(1)->endAuthorization();
 
@@ -406,7 +433,162 @@ TEST_CASE( "Transactions" ) {
 
         REQUIRE( checkReceivedStarted );
         REQUIRE( checkReceivedEnded );
-        REQUIRE( checkSeqNosSize == MO_TXEVENTRECORD_SIZE_V201 );
+        REQUIRE( checkSeqNosSize == seqNoEnd + 1 );
+        REQUIRE( checkSeqNosInOrder );
+        REQUIRE( checkMeterValues > 40 );
+        REQUIRE( checkEnergyIncreasing );
+    }
+
+    SECTION("TxEvents offline log compaction and reload") {
+
+        getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("TxCtrlr", "TxStartPoint", "")->setString("Authorized");
+        getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("TxCtrlr", "TxStopPoint", "")->setString("Authorized");
+        getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("SampledDataCtrlr", "TxUpdatedMeasurands", "")->setString("Energy.Active.Import.Register");
+        getOcppContext()->getModel().getVariableService()->declareVariable<int>("SampledDataCtrlr", "TxUpdatedInterval", 0)->setInt(1);
+
+        float energy = 0.f;
+        addMeterValueInput([&energy] () {
+            energy += 10.f;
+            return energy;
+        }, "Energy.Active.Import.Register", "Wh", nullptr, nullptr, 1);
+
+        loopback.setConnected(false);
+
+        getOcppContext()->getModel().getTransactionService()->getEvse(1)->beginAuthorization("mIdToken", false);
+        loop();
+
+        auto tx = getOcppContext()->getModel().getTransactionService()->getEvse(1)->getTransaction();
+        REQUIRE( tx != nullptr );
+        auto txNr = tx->txNr;
+
+        //fill the log until it exceeds the flash budget. Compaction switches the log file and thins out txEvents
+        unsigned int logSwitches = 0;
+        unsigned int txEventLog = tx->txEventLog;
+        for (unsigned int i = 0; i < 4000 && tx->seqNos.size() == tx->seqNoEnd; i++) {
+            mtime += 1000;
+            mocpp_loop();
+            if (tx->txEventLog != txEventLog) {
+                logSwitches++;
+                txEventLog = tx->txEventLog;
+            }
+        }
+
+        REQUIRE( logSwitches > 0 );
+        REQUIRE( tx->seqNos.size() < tx->seqNoEnd ); //thinned out
+        REQUIRE( tx->seqNos.front() == 0 ); //Started txEvent is kept
+
+        std::vector<unsigned int> seqNos (tx->seqNos.begin(), tx->seqNos.end());
+        unsigned int seqNoEnd = tx->seqNoEnd;
+
+        char fnLog [MO_MAX_PATH_SIZE];
+        char fnLogInactive [MO_MAX_PATH_SIZE];
+        snprintf(fnLog, sizeof(fnLog), MO_FILENAME_PREFIX "tx201-1-%u-l%u.jsn", txNr, txEventLog);
+        snprintf(fnLogInactive, sizeof(fnLogInactive), MO_FILENAME_PREFIX "tx201-1-%u-l%u.jsn", txNr, txEventLog ^ 1);
+
+        //power cut while appending a record
+        mocpp_deinitialize();
+
+        auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+        size_t size;
+        REQUIRE( filesystem->stat(fnLog, &size) == 0 );
+        REQUIRE( filesystem->stat(fnLogInactive, &size) != 0 ); //previous log has been removed after the switch
+        {
+            auto file = filesystem->open(fnLog, "a");
+            REQUIRE( file );
+            const char torn [] = "{\"seq\":";
+            REQUIRE( file->write(torn, sizeof(torn) - 1) == sizeof(torn) - 1 );
+            REQUIRE( file->close() );
+        }
+
+        //power restored
+        mocpp_initialize(loopback,
+            ChargerCredentials(),
+            filesystem,
+            false,
+            ProtocolVersion(2,0,1));
+        mocpp_set_timer(custom_timer_cb);
+
+        getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("TxCtrlr", "TxStartPoint", "")->setString("Authorized");
+        getOcppContext()->getModel().getVariableService()->declareVariable<const char*>("TxCtrlr", "TxStopPoint", "")->setString("Authorized");
+
+        addMeterValueInput([&energy] () {
+            energy += 10.f;
+            return energy;
+        }, "Energy.Active.Import.Register", "Wh", nullptr, nullptr, 1);
+
+        unsigned int checkSeqNosSize = 0;
+        bool checkSeqNosInOrder = true;
+        int checkSeqNoLast = -1;
+        bool checkReceivedStarted = false, checkReceivedEnded = false;
+        float checkEnergy = 0.f;
+        bool checkEnergyIncreasing = true;
+
+        getOcppContext()->getOperationRegistry().registerOperation("TransactionEvent",
+                [&checkSeqNosSize, &checkSeqNosInOrder, &checkSeqNoLast, &checkReceivedStarted, &checkReceivedEnded, &checkEnergy, &checkEnergyIncreasing] () {
+            return new Ocpp16::CustomOperation("TransactionEvent",
+                [&checkSeqNosSize, &checkSeqNosInOrder, &checkSeqNoLast, &checkReceivedStarted, &checkReceivedEnded, &checkEnergy, &checkEnergyIncreasing] (JsonObject request) {
+                    //process req
+                    const char *eventType = request["eventType"] | "";
+                    if (!strcmp(eventType, "Started")) {
+                        checkReceivedStarted = true;
+                    } else if (!strcmp(eventType, "Ended")) {
+                        checkReceivedEnded = true;
+                    }
+
+                    int seqNo = request["seqNo"] | -1;
+                    if (seqNo <= checkSeqNoLast) {
+                        checkSeqNosInOrder = false;
+                    }
+                    checkSeqNoLast = seqNo;
+                    checkSeqNosSize++;
+
+                    for (JsonObject meterValue : request["meterValue"].as<JsonArray>()) {
+                        for (JsonObject sampledValue : meterValue["sampledValue"].as<JsonArray>()) {
+                            if (!strcmp(sampledValue["measurand"] | "", "Energy.Active.Import.Register") &&
+                                    !strcmp(sampledValue["context"] | "Sample.Periodic", "Sample.Periodic")) {
+                                float value = sampledValue["value"] | -1.f;
+                                if (value <= checkEnergy) {
+                                    checkEnergyIncreasing = false;
+                                }
+                                checkEnergy = value;
+                            }
+                        }
+                    }
+                },
+                [] () {
+                    //create conf
+                    auto doc = makeJsonDoc("UnitTests", 2 * JSON_OBJECT_SIZE(1));
+                    auto payload = doc->to<JsonObject>();
+                    payload["idTokenInfo"]["status"] = "Accepted";
+                    return doc;
+                });});
+
+        tx = getOcppContext()->getModel().getTransactionService()->getEvse(1)->getTransaction();
+        REQUIRE( tx != nullptr );
+        REQUIRE( tx->txNr == txNr );
+
+        //torn record is dropped, all complete records are restored
+        REQUIRE( tx->seqNoEnd == seqNoEnd );
+        REQUIRE( std::vector<unsigned int>(tx->seqNos.begin(), tx->seqNos.end()) == seqNos );
+
+        //recovery rewrites the log into the other file
+        REQUIRE( tx->txEventLog == (txEventLog ^ 1) );
+        REQUIRE( filesystem->stat(fnLog, &size) != 0 );
+
+        getOcppContext()->getModel().getTransactionService()->getEvse(1)->endAuthorization();
+        loop();
+
+        loopback.setConnected(true);
+        for (unsigned int i = 0; i < 100 && !checkReceivedEnded; i++) {
+            loop();
+        }
+
+        REQUIRE( getOcppContext()->getModel().getTransactionService()->getEvse(1)->getTransaction() == nullptr );
+        REQUIRE( checkReceivedStarted );
+        REQUIRE( checkReceivedEnded );
+        REQUIRE( checkSeqNosInOrder );
+        REQUIRE( checkSeqNosSize >= seqNos.size() + 1 );
+        REQUIRE( checkEnergyIncreasing );
     }
 
     SECTION("Tx queue") {
@@ -0,0 +1,300 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+#include <MicroOcpp/Version.h>
+
+#if MO_ENABLE_V201
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/Connection.h>
+#include <MicroOcpp/Core/Context.h>
+#include <MicroOcpp/Core/Request.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Model/Model.h>
+#include <MicroOcpp/Model/Variables/VariableService.h>
+#include <MicroOcpp/Model/Variables/MonitoringService.h>
+#include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Debug.h>
+#include <catch2/catch.hpp>
+#include "./helpers/testHelper.h"
+
+using namespace MicroOcpp;
+
+TEST_CASE( "VariableMonitoring" ) {
+    printf("\nRun %s\n",  "VariableMonitoring");
+
+    //clean state
+    auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+    LoopbackConnection loopback;
+    mocpp_initialize(loopback, ChargerCredentials(), filesystem, false, ProtocolVersion(2,0,1));
+
+    mocpp_set_timer(custom_timer_cb);
+
+    auto vs = getOcppContext()->getModel().getVariableService();
+    auto ms = getOcppContext()->getModel().getMonitoringService();
+    REQUIRE( ms != nullptr );
+
+    auto varInt = vs->declareVariable<int>("mComponent", "mInt", 0);
+    REQUIRE( varInt != nullptr );
+    varInt->setSupportsMonitoring();
+
+    auto varBool = vs->declareVariable<bool>("mComponent", "mBool", false);
+    REQUIRE( varBool != nullptr );
+    varBool->setSupportsMonitoring();
+
+    auto varUnmonitored = vs->declareVariable<int>("mComponent", "mUnmonitored", 0);
+    REQUIRE( varUnmonitored != nullptr );
+
+    //collect NotifyEvent messages
+    unsigned int nEvents = 0;
+    int lastMonitorId = -1;
+    const char *lastTrigger = "";
+    char lastActualValue [16] = {'\0'};
+    bool lastCleared = false;
+
+    getOcppContext()->getOperationRegistry().registerOperation("NotifyEvent",
+        [&nEvents, &lastMonitorId, &lastTrigger, &lastActualValue, &lastCleared] () {
+            return new Ocpp16::CustomOperation("NotifyEvent",
+                [&nEvents, &lastMonitorId, &lastTrigger, &lastActualValue, &lastCleared] (JsonObject payload) {
+                    //process req
+                    for (JsonObject eventData : payload["eventData"].as<JsonArray>()) {
+                        nEvents++;
+                        lastMonitorId = eventData["variableMonitoringId"] | -1;
+                        const char *trigger = eventData["trigger"] | "_Undefined";
+                        lastTrigger = !strcmp(trigger, "Alerting") ? "Alerting" :
+                                      !strcmp(trigger, "Delta") ? "Delta" :
+                                      !strcmp(trigger, "Periodic") ? "Periodic" : "_Undefined";
+                        snprintf(lastActualValue, sizeof(lastActualValue), "%s", eventData["actualValue"] | "_Undefined");
+                        lastCleared = eventData["cleared"] | false;
+                        REQUIRE( !strcmp(eventData["component"]["name"] | "_Undefined", "mComponent") );
+                        REQUIRE( !strcmp(eventData["eventNotificationType"] | "_Undefined", "CustomMonitor") );
+                    }
+                },
+                [] () {
+                    //create conf
+                    return createEmptyDocument();
+                });
+        });
+
+    loop();
+
+    SECTION("SetVariableMonitoring request") {
+
+        bool checkProcessed = false;
+        int monitorId = -1;
+
+        getOcppContext()->initiateRequest(makeRequest(
+            new Ocpp16::CustomOperation("SetVariableMonitoring",
+                [] () {
+                    //create req
+                    auto doc = makeJsonDoc("UnitTests",
+                            JSON_OBJECT_SIZE(1) +
+                            JSON_ARRAY_SIZE(2) +
+                            2 * JSON_OBJECT_SIZE(5) +
+                            2 * JSON_OBJECT_SIZE(1) +
+                            2 * JSON_OBJECT_SIZE(1));
+                    auto payload = doc->to<JsonObject>();
+                    auto setMonitoringData = payload.createNestedArray("setMonitoringData");
+                    setMonitoringData[0]["value"] = 10;
+                    setMonitoringData[0]["type"] = "UpperThreshold";
+                    setMonitoringData[0]["severity"] = 5;
+                    setMonitoringData[0]["component"]["name"] = "mComponent";
+                    setMonitoringData[0]["variable"]["name"] = "mInt";
+                    setMonitoringData[1]["value"] = 10;
+                    setMonitoringData[1]["type"] = "UpperThreshold";
+                    setMonitoringData[1]["severity"] = 5;
+                    setMonitoringData[1]["component"]["name"] = "mComponent";
+                    setMonitoringData[1]["variable"]["name"] = "mUnknown";
+                    return doc;
+                },
+                [&checkProcessed, &monitorId] (JsonObject payload) {
+                    //process conf
+                    JsonArray setMonitoringResult = payload["setMonitoringResult"];
+                    REQUIRE( !strcmp(setMonitoringResult[0]["status"] | "_Undefined", "Accepted") );
+                    REQUIRE( !strcmp(setMonitoringResult[0]["type"] | "_Undefined", "UpperThreshold") );
+                    monitorId = setMonitoringResult[0]["id"] | -1;
+                    REQUIRE( !strcmp(setMonitoringResult[1]["status"] | "_Undefined", "UnknownVariable") );
+                    checkProcessed = true;
+                })));
+
+        loop();
+
+        REQUIRE( checkProcessed );
+        REQUIRE( monitorId >= 0 );
+        REQUIRE( ms->getMonitorCount() == 1 );
+        REQUIRE( nEvents == 0 );
+
+        //exceed threshold
+        varInt->setInt(11);
+
+        loop();
+
+        REQUIRE( nEvents == 1 );
+        REQUIRE( lastMonitorId == monitorId );
+        REQUIRE( !strcmp(lastTrigger, "Alerting") );
+        REQUIRE( !strcmp(lastActualValue, "11") );
+        REQUIRE( !lastCleared );
+
+        //still beyond threshold: no new event
+        varInt->setInt(12);
+
+        loop();
+
+        REQUIRE( nEvents == 1 );
+
+        //back to normal
+        varInt->setInt(5);
+
+        loop();
+
+        REQUIRE( nEvents == 2 );
+        REQUIRE( lastCleared );
+
+        //writes to Variables without monitors don't create events
+        varUnmonitored->setInt(100);
+
+        loop();
+
+        REQUIRE( nEvents == 2 );
+
+        bool checkCleared = false;
+
+        getOcppContext()->initiateRequest(makeRequest(
+            new Ocpp16::CustomOperation("ClearVariableMonitoring",
+                [monitorId] () {
+                    //create req
+                    auto doc = makeJsonDoc("UnitTests",
+                            JSON_OBJECT_SIZE(1) +
+                            JSON_ARRAY_SIZE(2));
+                    auto payload = doc->to<JsonObject>();
+                    auto id = payload.createNestedArray("id");
+                    id.add(monitorId);
+                    id.add(monitorId + 1000);
+                    return doc;
+                },
+                [&checkCleared] (JsonObject payload) {
+                    //process conf
+                    JsonArray clearMonitoringResult = payload["clearMonitoringResult"];
+                    REQUIRE( !strcmp(clearMonitoringResult[0]["status"] | "_Undefined", "Accepted") );
+                    REQUIRE( !strcmp(clearMonitoringResult[1]["status"] | "_Undefined", "NotFound") );
+                    checkCleared = true;
+                })));
+
+        loop();
+
+        REQUIRE( checkCleared );
+        REQUIRE( ms->getMonitorCount() == 0 );
+
+        varInt->setInt(20);
+
+        loop();
+
+        REQUIRE( nEvents == 2 );
+    }
+
+    SECTION("Delta monitor") {
+
+        int monitorId = -1;
+        REQUIRE( ms->setMonitor(monitorId, false, 5.f, VariableMonitor::Type::Delta, 5, "mComponent", "mInt") == SetMonitoringStatus::Accepted );
+
+        varInt->setInt(3);
+
+        loop();
+
+        REQUIRE( nEvents == 0 );
+
+        varInt->setInt(6);
+
+        loop();
+
+        REQUIRE( nEvents == 1 );
+        REQUIRE( !strcmp(lastTrigger, "Delta") );
+        REQUIRE( !strcmp(lastActualValue, "6") );
+
+        //non-numerical Variables report any change
+        int monitorIdBool = -1;
+        REQUIRE( ms->setMonitor(monitorIdBool, false, 0.f, VariableMonitor::Type::Delta, 5, "mComponent", "mBool") == SetMonitoringStatus::Accepted );
+
+        varBool->setBool(true);
+
+        loop();
+
+        REQUIRE( nEvents == 2 );
+        REQUIRE( lastMonitorId == monitorIdBool );
+        REQUIRE( !strcmp(lastActualValue, "true") );
+    }
+
+    SECTION("Periodic monitor") {
+
+        int monitorId = -1;
+        REQUIRE( ms->setMonitor(monitorId, false, 5.f, VariableMonitor::Type::Periodic, 5, "mComponent", "mInt") == SetMonitoringStatus::Accepted );
+
+        loop(); //3s
+
+        REQUIRE( nEvents == 0 );
+
+        loop(); //6s
+
+        REQUIRE( nEvents == 1 );
+        REQUIRE( lastMonitorId == monitorId );
+        REQUIRE( !strcmp(lastTrigger, "Periodic") );
+
+        mtime += 100 * 1000; //delays exceeding the timer wheel
+        loop();
+
+        REQUIRE( nEvents >= 2 );
+
+        //replace monitor with longer interval than the inner and outer timer wheel, i.e. the timer goes into the overflow list
+        const unsigned long wheelSpan = (unsigned long) MO_TIMERWHEEL_SLOTS * MO_TIMERWHEEL_SLOTS * MO_TIMERWHEEL_RESOLUTION / 1000; //in s
+        unsigned int nEventsBefore = nEvents;
+
+        REQUIRE( ms->setMonitor(monitorId, false, (float) (2 * wheelSpan + 5), VariableMonitor::Type::Periodic, 5, "mComponent", "mInt") == SetMonitoringStatus::Accepted );
+        REQUIRE( ms->getMonitorCount() == 1 );
+
+        mtime += (2 * wheelSpan) * 1000;
+        loop();
+
+        REQUIRE( nEvents == nEventsBefore );
+
+        mtime += 10 * 1000;
+        loop();
+
+        REQUIRE( nEvents == nEventsBefore + 1 );
+
+        REQUIRE( ms->clearMonitor(monitorId) == ClearMonitoringStatus::Accepted );
+
+        mtime += (4 * wheelSpan) * 1000;
+        loop();
+
+        REQUIRE( nEvents == nEventsBefore + 1 );
+    }
+
+    SECTION("Rejected monitors") {
+
+        int monitorId = -1;
+
+        //Variable doesn't support monitoring
+        REQUIRE( ms->setMonitor(monitorId, false, 10.f, VariableMonitor::Type::UpperThreshold, 5, "mComponent", "mUnmonitored") == SetMonitoringStatus::Rejected );
+
+        //thresholds require numerical values
+        REQUIRE( ms->setMonitor(monitorId, false, 10.f, VariableMonitor::Type::UpperThreshold, 5, "mComponent", "mBool") == SetMonitoringStatus::UnsupportedMonitorType );
+
+        REQUIRE( ms->setMonitor(monitorId, false, 10.f, VariableMonitor::Type::UpperThreshold, 5, "mUnknown", "mInt") == SetMonitoringStatus::UnknownComponent );
+
+        REQUIRE( ms->setMonitor(monitorId, false, 0.f, VariableMonitor::Type::Periodic, 5, "mComponent", "mInt") == SetMonitoringStatus::Rejected );
+
+        REQUIRE( ms->setMonitor(monitorId, false, 10.f, VariableMonitor::Type::UpperThreshold, 5, "mComponent", "mInt") == SetMonitoringStatus::Accepted );
+
+        int monitorIdDuplicate = -1;
+        REQUIRE( ms->setMonitor(monitorIdDuplicate, false, 20.f, VariableMonitor::Type::UpperThreshold, 5, "mComponent", "mInt") == SetMonitoringStatus::Duplicate );
+
+        REQUIRE( ms->getMonitorCount() == 1 );
+    }
+
+    mocpp_deinitialize();
+}
+
+#endif // MO_ENABLE_V201
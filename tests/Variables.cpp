@@ -18,6 +18,7 @@
 #include <MicroOcpp/Core/Context.h>
 #include <MicroOcpp/Core/Request.h>
 #include <MicroOcpp/Operations/CustomOperation.h>
+#include <MicroOcpp/Operations/NotifyReport.h>
 
 using namespace MicroOcpp;
 
@@ -215,6 +216,78 @@ TEST_CASE( "Variable" ) {
         REQUIRE( cInt7->isRebootRequired() );
     }
 
+    SECTION("Variable lookup") {
+
+        mocpp_initialize(loopback, ChargerCredentials(), filesystem, false, ProtocolVersion(2,0,1));
+        auto vs = getOcppContext()->getModel().getVariableService();
+
+        //enough variables to grow the index multiple times
+        const size_t nLookupVars = 100;
+        static char lookupVarNames [nLookupVars][20];
+        Variable *lookupVars [nLookupVars] = {nullptr};
+        for (size_t i = 0; i < nLookupVars; i++) {
+            snprintf(lookupVarNames[i], sizeof(lookupVarNames[i]), "mLookupVar%zu", i);
+            lookupVars[i] = vs->declareVariable<int>(ComponentId("mLookupComponent", EvseId((int) (i % 3))), lookupVarNames[i], (int) i);
+            REQUIRE( lookupVars[i] != nullptr );
+        }
+
+        for (size_t i = 0; i < nLookupVars; i++) {
+            REQUIRE( vs->getVariable(ComponentId("mLookupComponent", EvseId((int) (i % 3))), lookupVarNames[i]) == lookupVars[i] );
+            REQUIRE( vs->getVariable(ComponentId("mLookupComponent", EvseId((int) ((i + 1) % 3))), lookupVarNames[i]) == nullptr );
+        }
+
+        Variable *result = nullptr;
+        REQUIRE( vs->getVariable(Variable::AttributeType::Actual, ComponentId("mLookupComponent", EvseId(1)), "mLookupVar1", &result) == GetVariableStatus::Accepted );
+        REQUIRE( result == lookupVars[1] );
+        REQUIRE( vs->getVariable(Variable::AttributeType::Actual, ComponentId("mLookupComponent", EvseId(1)), "mUnknown", &result) == GetVariableStatus::UnknownVariable );
+        REQUIRE( vs->getVariable(Variable::AttributeType::Actual, ComponentId("mLookupComponent", EvseId(3)), "mLookupVar1", &result) == GetVariableStatus::UnknownComponent );
+        REQUIRE( vs->setVariable(Variable::AttributeType::Actual, "5", ComponentId("mUnknown"), "mLookupVar1") == SetVariableStatus::UnknownComponent );
+        REQUIRE( vs->setVariable(Variable::AttributeType::Actual, "5", ComponentId("mLookupComponent", EvseId(1)), "mLookupVar1") == SetVariableStatus::Accepted );
+        REQUIRE( lookupVars[1]->getInt() == 5 );
+
+        //Variables in custom containers
+        VariableContainerNonOwning container;
+        auto customVar = makeVariable(Variable::InternalDataType::Int, Variable::AttributeType::Actual);
+        customVar->setName("mCustomVar");
+        customVar->setComponentId("mCustomComponent");
+        container.add(customVar.get());
+        vs->addContainer(&container);
+
+        REQUIRE( vs->getVariable("mCustomComponent", "mCustomVar") == customVar.get() );
+        REQUIRE( vs->getVariable(Variable::AttributeType::Actual, "mCustomComponent", "mUnknown", &result) == GetVariableStatus::UnknownVariable );
+
+        //duplicate keys resolve in container order, as without the index
+        auto internalDup = makeVariable(Variable::InternalDataType::Int, Variable::AttributeType::Actual);
+        internalDup->setName("mLookupVar1");
+        internalDup->setComponentId(ComponentId("mLookupComponent", EvseId(1)));
+        container.add(internalDup.get());
+
+        auto externalDup = makeVariable(Variable::InternalDataType::Int, Variable::AttributeType::Actual);
+        externalDup->setName("mDupVar");
+        externalDup->setComponentId("mCustomComponent");
+        REQUIRE( vs->addVariable(externalDup.get()) );
+
+        auto customDup = makeVariable(Variable::InternalDataType::Int, Variable::AttributeType::Actual);
+        customDup->setName("mDupVar");
+        customDup->setComponentId("mCustomComponent");
+        container.add(customDup.get());
+
+        //internal containers first
+        REQUIRE( vs->getVariable(ComponentId("mLookupComponent", EvseId(1)), "mLookupVar1") == lookupVars[1] );
+        REQUIRE( vs->getVariable(Variable::AttributeType::Actual, ComponentId("mLookupComponent", EvseId(1)), "mLookupVar1", &result) == GetVariableStatus::Accepted );
+        REQUIRE( result == lookupVars[1] );
+
+        //getVariable() prefers addContainer() containers over the external container; Get-/SetVariables the other way round
+        REQUIRE( vs->getVariable("mCustomComponent", "mDupVar") == customDup.get() );
+        REQUIRE( vs->getVariable(Variable::AttributeType::Actual, "mCustomComponent", "mDupVar", &result) == GetVariableStatus::Accepted );
+        REQUIRE( result == externalDup.get() );
+        REQUIRE( vs->setVariable(Variable::AttributeType::Actual, "7", "mCustomComponent", "mDupVar") == SetVariableStatus::Accepted );
+        REQUIRE( externalDup->getInt() == 7 );
+        REQUIRE( customDup->getInt() == 0 );
+
+        mocpp_deinitialize();
+    }
+
 #if 0
     SECTION("Main lib integration") {
 
@@ -594,31 +667,57 @@ TEST_CASE( "Variable" ) {
         REQUIRE( varString != nullptr );
         REQUIRE( !strcmp(varString->getString(), "") );
 
+        //enough variables to split the report into multiple pages
+        const size_t nPagingVars = 3 * MO_NOTIFYREPORT_PAGE_SIZE;
+        static char pagingVarNames [nPagingVars][20];
+        for (size_t i = 0; i < nPagingVars; i++) {
+            snprintf(pagingVarNames[i], sizeof(pagingVarNames[i]), "mPagingVar%zu", i);
+            REQUIRE( vs->declareVariable<int>("mPagingComponent", pagingVarNames[i], 0) != nullptr );
+        }
+
         loop();
 
         MO_MEM_RESET();
 
         bool checkProcessedNotification = false;
         Timestamp checkTimestamp;
+        int nextSeqNo = 0;
+        bool checkLastPage = false;
+        bool foundVar = false;
+        bool foundLateVar = false;
+        size_t nReportData = 0;
 
         getOcppContext()->getOperationRegistry().registerOperation("NotifyReport",
-            [&checkProcessedNotification, &checkTimestamp] () {
+            [&checkProcessedNotification, &checkTimestamp, &nextSeqNo, &checkLastPage, &foundVar, &foundLateVar, &nReportData, vs] () {
                 return new Ocpp16::CustomOperation("NotifyReport",
-                    [ &checkProcessedNotification, &checkTimestamp] (JsonObject payload) {
+                    [ &checkProcessedNotification, &checkTimestamp, &nextSeqNo, &checkLastPage, &foundVar, &foundLateVar, &nReportData, vs] (JsonObject payload) {
                         //process req
                         checkProcessedNotification = true;
                         REQUIRE( (payload["requestId"] | -1) == 1);
                         checkTimestamp.setTime(payload["generatedAt"] | "_Undefined");
-                        REQUIRE( (payload["seqNo"] | -1) == 0);
+                        REQUIRE( (payload["seqNo"] | -1) == nextSeqNo);
+                        nextSeqNo++;
+
+                        REQUIRE( !checkLastPage );
+                        checkLastPage = !(payload["tbc"] | false);
+
+                        REQUIRE( payload["reportData"].size() <= MO_NOTIFYREPORT_PAGE_SIZE );
+                        nReportData += payload["reportData"].size();
 
-                        bool foundVar = false;
                         for (auto reportData : payload["reportData"].as<JsonArray>()) {
                             if (!strcmp(reportData["component"]["name"] | "_Undefined", "mComponent") &&
                                     !strcmp(reportData["variable"]["name"] | "_Undefined", "mString")) {
                                 foundVar = true;
                             }
+                            if (!strcmp(reportData["variable"]["name"] | "_Undefined", "mLateVar")) {
+                                foundLateVar = true;
+                            }
+                        }
+
+                        //change the device model during the report. The following pages are not shifted
+                        if (nextSeqNo == 1) {
+                            REQUIRE( vs->declareVariable<int>("mComponent", "mLateVar", 0) != nullptr );
                         }
-                        REQUIRE( foundVar );
                     },
                     [] () {
                         //create conf
@@ -650,6 +749,11 @@ TEST_CASE( "Variable" ) {
         REQUIRE( checkProcessed );
         REQUIRE( checkProcessedNotification );
         REQUIRE( std::abs(getOcppContext()->getModel().getClock().now() - checkTimestamp) <= 10 );
+        REQUIRE( foundVar );
+        REQUIRE( !foundLateVar ); //not part of the snapshot
+        REQUIRE( checkLastPage );
+        REQUIRE( nextSeqNo >= 3 );
+        REQUIRE( nReportData >= nPagingVars + 1 );
 
         MO_MEM_PRINT_STATS();
 
@@ -0,0 +1,101 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Measures the time to load a full transaction store from the filesystem. Build with MO_BUILD_BENCHMARKS=ON
+ * and compare mo_boot_benchmark (MO_ENABLE_MMAP=1) with mo_boot_benchmark_nommap (MO_ENABLE_MMAP=0)
+ *
+ * Usage (from a working directory which contains the folder mo_store/):
+ *
+ *     mo_boot_benchmark [number of transactions per connector]
+ */
+
+#include <MicroOcpp.h>
+#include <MicroOcpp/Core/FilesystemAdapter.h>
+#include <MicroOcpp/Core/FilesystemUtils.h>
+#include <MicroOcpp/Model/Transactions/TransactionStore.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace MicroOcpp;
+
+int main(int argc, char **argv) {
+
+    unsigned int nTx = 200;
+    if (argc >= 2) {
+        nTx = (unsigned int) atoi(argv[1]);
+    }
+
+    auto filesystem = makeDefaultFilesystemAdapter(FilesystemOpt::Use_Mount_FormatOnFail);
+    if (!filesystem) {
+        printf("filesystem not available\n");
+        return 1;
+    }
+
+    //populate store
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+    {
+        TransactionStore txStore {MO_NUMCONNECTORS, filesystem};
+
+        for (unsigned int cId = 1; cId < MO_NUMCONNECTORS; cId++) {
+            for (unsigned int txNr = 0; txNr < nTx; txNr++) {
+                auto tx = txStore.createTransaction(cId, txNr);
+                if (!tx) {
+                    printf("createTransaction error\n");
+                    return 1;
+                }
+                tx->setIdTag("mIdTag");
+                tx->setMeterStart(1000 * txNr);
+                tx->setTransactionId(txNr);
+                tx->getStartSync().setRequested();
+                tx->setStopIdTag("mIdTag");
+                tx->setMeterStop(1000 * txNr + 500);
+                tx->setStopReason("Local");
+                tx->getStopSync().setRequested();
+                tx->commit();
+            }
+        }
+    }
+
+    //measure loading time
+    auto t_start = std::chrono::steady_clock::now();
+
+    unsigned int loaded = 0;
+
+    {
+        TransactionStore txStore {MO_NUMCONNECTORS, filesystem};
+
+        for (unsigned int cId = 1; cId < MO_NUMCONNECTORS; cId++) {
+            for (unsigned int txNr = 0; txNr < nTx; txNr++) {
+                if (txStore.getTransaction(cId, txNr)) {
+                    loaded++;
+                }
+            }
+        }
+    }
+
+    auto t_load = std::chrono::steady_clock::now();
+
+    //measure complete boot routine including the config files
+    LoopbackConnection loopback;
+    mocpp_initialize(loopback, ChargerCredentials(), filesystem);
+    mocpp_loop();
+
+    auto t_boot = std::chrono::steady_clock::now();
+
+    mocpp_deinitialize();
+
+    FilesystemUtils::remove_if(filesystem, [] (const char*) {return true;});
+
+    printf("mmap: %s\n", MO_ENABLE_MMAP ? "enabled" : "disabled");
+    printf("loaded %u transactions in %lld us\n", loaded,
+            (long long) std::chrono::duration_cast<std::chrono::microseconds>(t_load - t_start).count());
+    printf("mocpp_initialize in %lld us\n",
+            (long long) std::chrono::duration_cast<std::chrono::microseconds>(t_boot - t_load).count());
+
+    return loaded == nTx * (MO_NUMCONNECTORS - 1) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// matth-x/MicroOcpp
+// Copyright Matthias Akstaller 2019 - 2024
+// MIT License
+
+/*
+ * Measures the parsing throughput for incoming OCPP messages. Compares the structural scanner implementations
+ * and the deserialization with the capacity estimate of the scanner against the previous approach, which
+ * doubles the capacity until the message fits. Build with MO_BUILD_BENCHMARKS=ON
+ *
+ * Usage:
+ *
+ *     mo_json_benchmark [number of iterations]
+ */
+
+#include <MicroOcpp/Core/JsonScanner.h>
+#include <MicroOcpp/Core/Memory.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace MicroOcpp;
+
+std::string makeSendLocalList(unsigned int n) {
+    std::string msg = "[2,\"a1b2c3d4\",\"SendLocalList\",{\"listVersion\":42,\"updateType\":\"Full\",\"localAuthorizationList\":[";
+    for (unsigned int i = 0; i < n; i++) {
+        if (i > 0) {
+            msg += ",";
+        }
+        msg += "{\"idTag\":\"TAG" + std::to_string(100000 + i) + "\",\"idTagInfo\":{\"status\":\"Accepted\",\"expiryDate\":\"2030-01-01T00:00:00.000Z\",\"parentIdTag\":\"FLEET01\"}}";
+    }
+    msg += "]}]";
+    return msg;
+}
+
+std::string makeGetConfigurationConf(unsigned int n) {
+    std::string msg = "[3,\"a1b2c3d4\",{\"configurationKey\":[";
+    for (unsigned int i = 0; i < n; i++) {
+        if (i > 0) {
+            msg += ",";
+        }
+        msg += "{\"key\":\"ConfigurationKey" + std::to_string(i) + "\",\"readonly\":false,\"value\":\"Value with \\\"quotes\\\" " + std::to_string(i) + "\"}";
+    }
+    msg += "]}]";
+    return msg;
+}
+
+std::string makeSetChargingProfile(unsigned int nPeriods) {
+    std::string msg = "[2,\"a1b2c3d4\",\"SetChargingProfile\",{\"connectorId\":1,\"csChargingProfiles\":{\"chargingProfileId\":7,\"stackLevel\":1,"
+            "\"chargingProfilePurpose\":\"TxDefaultProfile\",\"chargingProfileKind\":\"Absolute\",\"chargingSchedule\":{\"duration\":86400,"
+            "\"startSchedule\":\"2024-01-01T00:00:00.000Z\",\"chargingRateUnit\":\"W\",\"chargingSchedulePeriod\":[";
+    for (unsigned int i = 0; i < nPeriods; i++) {
+        if (i > 0) {
+            msg += ",";
+        }
+        msg += "{\"startPeriod\":" + std::to_string(i * 900) + ",\"limit\":" + std::to_string(11000 - i * 10) + ".5,\"numberPhases\":3}";
+    }
+    msg += "]}}}]";
+    return msg;
+}
+
+//previous approach of the RequestQueue: start with 1.5x the input length, double the capacity until it fits
+bool parseDoubling(const std::string& msg) {
+    size_t capacity_init = (3 * msg.length()) / 2;
+    size_t capacity = 128;
+    while (capacity < capacity_init && capacity < MO_MAX_JSON_CAPACITY) {
+        capacity *= 2;
+    }
+    if (capacity > MO_MAX_JSON_CAPACITY) {
+        capacity = MO_MAX_JSON_CAPACITY;
+    }
+
+    DeserializationError err = DeserializationError::NoMemory;
+    while (err == DeserializationError::NoMemory && capacity <= MO_MAX_JSON_CAPACITY) {
+        auto doc = initJsonDoc("Benchmark", capacity);
+        err = deserializeJson(doc, msg.c_str(), msg.length());
+        capacity *= 2;
+    }
+    return err == DeserializationError::Ok;
+}
+
+bool parseScanned(const std::string& msg) {
+    JsonScanResult result;
+    if (!JsonScanner::scan(msg.c_str(), msg.length(), result)) {
+        return false;
+    }
+    size_t capacity = JsonScanner::estimateCapacity(result);
+    if (capacity > MO_MAX_JSON_CAPACITY) {
+        return false;
+    }
+    auto doc = initJsonDoc("Benchmark", capacity);
+    return deserializeJson(doc, msg.c_str(), msg.length()) == DeserializationError::Ok;
+}
+
+template <class F>
+double measureMBps(const std::string& msg, unsigned int iterations, F parse) {
+    auto t_start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+        if (!parse(msg)) {
+            printf("parse error\n");
+            exit(1);
+        }
+    }
+    auto t_end = std::chrono::steady_clock::now();
+    double us = (double) std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count();
+    return us > 0. ? ((double) msg.length() * iterations) / us : 0.; //bytes per us = MB/s
+}
+
+int main(int argc, char **argv) {
+
+    unsigned int iterations = 2000;
+    if (argc >= 2) {
+        iterations = (unsigned int) atoi(argv[1]);
+    }
+
+    struct {
+        const char *name;
+        std::string msg;
+    } messages [] = {
+        {"SendLocalList", makeSendLocalList(40)},
+        {"GetConfiguration.conf", makeGetConfigurationConf(60)},
+        {"SetChargingProfile", makeSetChargingProfile(48)},
+    };
+
+    printf("default scanner: %s\n", JsonScanner::getImplName(JsonScanner::getDefaultImpl()));
+
+    for (auto& message : messages) {
+        printf("%s (%zu bytes):\n", message.name, message.msg.length());
+
+        for (auto impl : {JsonScanImpl::Scalar, JsonScanImpl::SSE2, JsonScanImpl::AVX2, JsonScanImpl::NEON}) {
+            if (!JsonScanner::isSupported(impl)) {
+                continue;
+            }
+            double mbps = measureMBps(message.msg, iterations, [impl] (const std::string& msg) {
+                JsonScanResult result;
+                return JsonScanner::scan(msg.c_str(), msg.length(), result, nullptr, 0, impl);
+            });
+            printf("    scan %-6s %10.1f MB/s\n", JsonScanner::getImplName(impl), mbps);
+        }
+
+        printf("    deserialize (doubling capacity) %10.1f MB/s\n", measureMBps(message.msg, iterations, parseDoubling));
+        printf("    deserialize (scanned capacity)  %10.1f MB/s\n", measureMBps(message.msg, iterations, parseScanned));
+    }
+
+    return 0;
+}
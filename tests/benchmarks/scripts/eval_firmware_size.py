@@ -47,6 +47,7 @@ def categorize_table(df):
     MODULE_METERVALUES = 'J - MeterValues'
     MODULE_SMARTCHARGING = 'K - SmartCharging'
     MODULE_CERTS = 'M - Certificate Management'
+    MODULE_MONITORING = 'N - Diagnostics - Monitoring'
 
     df.at['MicroOcpp.cpp', 'v16'] = TICK
     df.at['MicroOcpp.cpp', 'v201'] = TICK
@@ -194,6 +195,9 @@ def categorize_table(df):
         df.at['Model/Transactions/TransactionService.cpp', 'Module'] = MODULE_TX
     df.at['Model/Transactions/TransactionStore.cpp', 'v16'] = TICK
     df.at['Model/Transactions/TransactionStore.cpp', 'Module'] = MODULE_TX
+    if 'Model/Variables/MonitoringService.cpp' in df.index:
+        df.at['Model/Variables/MonitoringService.cpp', 'v201'] = TICK
+        df.at['Model/Variables/MonitoringService.cpp', 'Module'] = MODULE_MONITORING
     if 'Model/Variables/Variable.cpp' in df.index:
         df.at['Model/Variables/Variable.cpp', 'v201'] = TICK
         df.at['Model/Variables/Variable.cpp', 'Module'] = MODULE_PROVISIONING_VARS
@@ -219,6 +223,9 @@ def categorize_table(df):
     df.at['Operations/ClearCache.cpp', 'Module'] = MODULE_CORE
     df.at['Operations/ClearChargingProfile.cpp', 'v16'] = TICK
     df.at['Operations/ClearChargingProfile.cpp', 'Module'] = MODULE_SMARTCHARGING
+    if 'Operations/ClearVariableMonitoring.cpp' in df.index:
+        df.at['Operations/ClearVariableMonitoring.cpp', 'v201'] = TICK
+        df.at['Operations/ClearVariableMonitoring.cpp', 'Module'] = MODULE_MONITORING
     df.at['Operations/CustomOperation.cpp', 'v16'] = TICK
     df.at['Operations/CustomOperation.cpp', 'v201'] = TICK
     df.at['Operations/CustomOperation.cpp', 'Module'] = MODULE_RPC
@@ -256,6 +263,9 @@ def categorize_table(df):
     df.at['Operations/InstallCertificate.cpp', 'Module'] = MODULE_CERTS
     df.at['Operations/MeterValues.cpp', 'v16'] = TICK
     df.at['Operations/MeterValues.cpp', 'Module'] = MODULE_METERVALUES
+    if 'Operations/NotifyEvent.cpp' in df.index:
+        df.at['Operations/NotifyEvent.cpp', 'v201'] = TICK
+        df.at['Operations/NotifyEvent.cpp', 'Module'] = MODULE_MONITORING
     if 'Operations/NotifyReport.cpp' in df.index:
         df.at['Operations/NotifyReport.cpp', 'v201'] = TICK
         df.at['Operations/NotifyReport.cpp', 'Module'] = MODULE_PROVISIONING_VARS
@@ -284,6 +294,9 @@ def categorize_table(df):
     if 'Operations/SetVariables.cpp' in df.index:
         df.at['Operations/SetVariables.cpp', 'v201'] = TICK
         df.at['Operations/SetVariables.cpp', 'Module'] = MODULE_PROVISIONING_VARS
+    if 'Operations/SetVariableMonitoring.cpp' in df.index:
+        df.at['Operations/SetVariableMonitoring.cpp', 'v201'] = TICK
+        df.at['Operations/SetVariableMonitoring.cpp', 'Module'] = MODULE_MONITORING
     df.at['Operations/StartTransaction.cpp', 'v16'] = TICK
     df.at['Operations/StartTransaction.cpp', 'Module'] = MODULE_TX
     df.at['Operations/StatusNotification.cpp', 'v16'] = TICK